@@ -0,0 +1,141 @@
+#include <array>
+#include <cstdio>
+#include <cstring>
+
+#include "atecc_command.hpp"
+
+extern "C" {
+#include "atecc_sim.h"
+#include "sim_p256.h"
+}
+
+// Checks of the compile-time command descriptors in atecc_command.hpp: packets
+// against atecc_packet_build(), bounds against the atecc_exec.c table, and a run of
+// each kind of command against the ATECC608 model. Exits non-zero if any check fails.
+
+using namespace atecc;
+
+// The Info packet from the datasheet, CRC included, built at compile time
+constexpr cmd::info_revision::packet_t info_packet = build_packet<cmd::info_revision>(0x0000, {});
+static_assert(info_packet.size() == 8 && info_packet[1] == 0x07 && info_packet[2] == ATCA_INFO);
+static_assert(info_packet[6] == 0x03 && info_packet[7] == 0x5D);
+static_assert(cmd::aes_encrypt::packet_size == ATECC_PACKET_OVERHEAD + AES_BLOCK_SIZE);
+static_assert(cmd::verify_external::packet_size == ATECC_PACKET_OVERHEAD + 128);
+static_assert(cmd::sha_end<0>::response_length == SHA256_DIGEST_SIZE + 3);
+static_assert(cmd::nonce_passthrough::response_length == 4);
+// Replayable as in the C commands: a repeated Nonce only draws a new random number
+static_assert(cmd::nonce_random::flags == ATECC_EXEC_REPLAYABLE);
+
+#define AES_KEY_SLOT    (3u)
+#define ECC_GENKEY_SLOT (1u)
+
+static int failures;
+
+#define CHECK(cond) check((cond), #cond, __LINE__)
+
+static void check(bool ok, const char *what, int line) {
+    if (!ok) {
+        printf("❌ FAIL line %d: %s\n", line, what);
+        failures++;
+    }
+}
+
+// A descriptor builds the packet atecc_packet_build() does and carries the table's bounds
+template <typename Cmd>
+static void check_descriptor(uint16_t param2) {
+    typename Cmd::data_t data;
+    uint8_t packet[ATECC_I2C_MAX_TRANSFER];
+
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = (uint8_t)(i * 7 + 1);
+    }
+    atecc_fragment_t fragment = { data.data(), data.size() };
+    size_t length = atecc_packet_build(packet, sizeof(packet), Cmd::opcode, Cmd::mode, param2, &fragment, 1);
+    auto built = build_packet<Cmd>(param2, data);
+
+    CHECK(length == built.size() && memcmp(packet, built.data(), length) == 0);
+
+    const atecc_exec_time_t *timing = atecc_exec_lookup(Cmd::opcode);
+    CHECK(timing->typical_us == Cmd::timing.typical_us && timing->max_us == Cmd::timing.max_us);
+}
+
+static void check_descriptors() {
+    check_descriptor<cmd::info_revision>(0x0000);
+    check_descriptor<cmd::random>(0x0000);
+    check_descriptor<cmd::nonce_random>(0x0000);
+    check_descriptor<cmd::nonce_passthrough>(0x0000);
+    check_descriptor<cmd::read_word<ATCA_ZONE_CONFIG>>(0x0001);
+    check_descriptor<cmd::read_block<ATCA_ZONE_DATA>>(0x0040);
+    check_descriptor<cmd::sha_start>(0x0000);
+    check_descriptor<cmd::sha_update>(0x0000);
+    check_descriptor<cmd::sha_end<3>>(3);
+    check_descriptor<cmd::aes_encrypt>(AES_KEY_SLOT);
+    check_descriptor<cmd::aes_decrypt>(AES_KEY_SLOT);
+    check_descriptor<cmd::sign_external>(ECC_GENKEY_SLOT);
+    check_descriptor<cmd::genkey_private>(ECC_GENKEY_SLOT);
+    check_descriptor<cmd::genkey_public>(ECC_GENKEY_SLOT);
+    check_descriptor<cmd::verify_external>(ATCA_VERIFY_KEY_P256);
+    check_descriptor<cmd::counter_read>(0);
+    check_descriptor<cmd::counter_increment>(0);
+}
+
+static void check_commands() {
+    std::array<uint8_t, 4> revision;
+    std::array<uint8_t, 32> random;
+    std::array<uint8_t, SHA256_DIGEST_SIZE> digest;
+    std::array<uint8_t, SHA256_DIGEST_SIZE> expected;
+    std::array<uint8_t, AES_BLOCK_SIZE> block;
+    std::array<uint8_t, ECC_P256_KEY_SIZE> public_key;
+    std::array<uint8_t, ECC_P256_SIG_SIZE> signature;
+    std::array<uint8_t, 4> counter;
+
+    CHECK(run<cmd::info_revision>(0x0000, {}, revision) == ATECC_OK && revision[2] == 0x60);
+    CHECK(run<cmd::random>(0x0000, {}, random) == ATECC_OK);
+
+    // "abc" as a single tail
+    const uint8_t message[3] = { 'a', 'b', 'c' };
+    sw_sha256(message, sizeof(message), expected.data());
+    CHECK(run<cmd::sha_start>(0x0000, {}) == ATECC_OK);
+    CHECK(run<cmd::sha_end<3>>(3, { 'a', 'b', 'c' }, digest) == ATECC_OK);
+    CHECK(digest == expected);
+
+    // FIPS-197 appendix C.1 in both directions
+    const cmd::aes_encrypt::data_t plaintext = { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+                                                 0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF };
+    const cmd::aes_decrypt::data_t ciphertext = { 0x69, 0xC4, 0xE0, 0xD8, 0x6A, 0x7B, 0x04, 0x30,
+                                                  0xD8, 0xCD, 0xB7, 0x80, 0x70, 0xB4, 0xC5, 0x5A };
+    CHECK(run<cmd::aes_encrypt>(AES_KEY_SLOT, plaintext, block) == ATECC_OK && block == ciphertext);
+    CHECK(run<cmd::aes_decrypt>(AES_KEY_SLOT, ciphertext, block) == ATECC_OK && block == plaintext);
+
+    // A fresh key signs the digest loaded into TempKey; the device and the software curve agree
+    CHECK(run<cmd::genkey_private>(ECC_GENKEY_SLOT, {}, public_key) == ATECC_OK);
+    CHECK(run<cmd::nonce_passthrough>(0x0000, expected) == ATECC_OK);
+    CHECK(run<cmd::sign_external>(ECC_GENKEY_SLOT, {}, signature) == ATECC_OK);
+    CHECK(sim_p256_verify(public_key.data(), expected.data(), signature.data()));
+
+    cmd::verify_external::data_t verify;
+    memcpy(verify.data(), signature.data(), signature.size());
+    memcpy(&verify[signature.size()], public_key.data(), public_key.size());
+    CHECK(run<cmd::nonce_passthrough>(0x0000, expected) == ATECC_OK);
+    CHECK(run<cmd::verify_external>(ATCA_VERIFY_KEY_P256, verify) == ATECC_OK);
+    verify[0] ^= 0x01;
+    CHECK(run<cmd::nonce_passthrough>(0x0000, expected) == ATECC_OK);
+    CHECK(run<cmd::verify_external>(ATCA_VERIFY_KEY_P256, verify) == ATECC_ERR_MISCOMPARE);
+
+    CHECK(run<cmd::counter_increment>(0, {}, counter) == ATECC_OK && counter[0] == 1);
+    CHECK(run<cmd::counter_read>(0, {}, counter) == ATECC_OK && counter[0] == 1);
+}
+
+int main() {
+    i2c_init(I2C_PORT, 100 * 1000);
+
+    check_descriptors();
+    check_commands();
+
+    if (failures) {
+        printf("❌ %d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("🎉 All command descriptor checks passed\n");
+    return 0;
+}
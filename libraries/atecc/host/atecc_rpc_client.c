@@ -0,0 +1,222 @@
+#include <string.h>
+
+#include "atecc_rpc_client.h"
+#include "atecc_ecc.h"
+#include "atecc_sha.h"
+
+/**
+ * @brief Prepares a client on a connected transport.
+ *
+ * @param[out] client    The client state.
+ * @param[in]  transport The byte stream to the device; reads may block up to a timeout.
+ */
+void atecc_rpc_client_init(atecc_rpc_client_t *client, const atecc_rpc_transport_t *transport) {
+    memset(client, 0, sizeof(*client));
+    client->transport = *transport;
+    atecc_rpc_parser_init(&client->parser);
+}
+
+/**
+ * @brief Sends one request without waiting for its response.
+ *
+ * @param[in,out] client  The client.
+ * @param[in]     opcode  The request opcode.
+ * @param[in]     param   The opcode's parameter byte.
+ * @param[in]     payload The payload, or NULL if length is 0.
+ * @param[in]     length  The payload length, at most ATECC_RPC_MAX_PAYLOAD.
+ * @param[out]    id      Receives the request id the response will carry.
+ * @return true if the whole frame was written, false otherwise.
+ */
+bool atecc_rpc_client_send(atecc_rpc_client_t *client, uint8_t opcode, uint8_t param,
+                           const uint8_t *payload, size_t length, uint16_t *id) {
+    uint8_t frame[ATECC_RPC_MAX_FRAME];
+    size_t frame_length = atecc_rpc_encode(opcode, param, ATECC_RPC_OK, client->next_id, payload, length, frame);
+
+    if (frame_length == 0) {
+        return false;
+    }
+    for (size_t sent = 0; sent < frame_length;) {
+        size_t written = client->transport.write(&frame[sent], frame_length - sent, client->transport.context);
+        if (written == 0) {
+            return false;
+        }
+        sent += written;
+    }
+    *id = client->next_id++;
+    return true;
+}
+
+/**
+ * @brief Waits for the next response frame, whichever request it answers.
+ *
+ * @param[in,out] client The client.
+ * @param[out]    frame  Receives the response.
+ * @return true if a frame arrived, false if the transport timed out.
+ */
+bool atecc_rpc_client_receive(atecc_rpc_client_t *client, atecc_rpc_frame_t *frame) {
+    for (;;) {
+        // A frame left in the parser after a resync completes without new bytes
+        bool complete;
+        client->rx_offset += atecc_rpc_parse(&client->parser, &client->rx[client->rx_offset],
+                                             client->rx_length - client->rx_offset, frame, &complete);
+        if (complete) {
+            return true;
+        }
+
+        client->rx_offset = 0;
+        client->rx_length = client->transport.read(client->rx, sizeof(client->rx), client->transport.context);
+        if (client->rx_length == 0) {
+            return false;
+        }
+    }
+}
+
+/**
+ * @brief Runs a batch of requests with up to window of them outstanding.
+ *
+ * Requests are sent in order as responses free the window; responses are matched by
+ * id, so they may complete in any order. Responses to requests outside the batch are
+ * skipped. A window of ATECC_RPC_MAX_IN_FLIGHT keeps the device busy without making
+ * it stop reading.
+ *
+ * @param[in,out] client The client.
+ * @param[in,out] calls  The requests; answered, status and output_length are filled in.
+ * @param[in]     count  The number of requests, below 65536.
+ * @param[in]     window The most requests outstanding at once.
+ * @return The number of requests answered, count unless the transport failed.
+ */
+size_t atecc_rpc_client_run(atecc_rpc_client_t *client, atecc_rpc_call_t *calls, size_t count, size_t window) {
+    uint16_t base = client->next_id;
+    size_t sent = 0;
+    size_t answered = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        calls[i].answered = false;
+    }
+    if (window == 0) {
+        window = 1;
+    }
+
+    while (answered < count) {
+        for (; sent < count && sent - answered < window; sent++) {
+            uint16_t id;
+            if (!atecc_rpc_client_send(client, calls[sent].opcode, calls[sent].param, calls[sent].input,
+                                       calls[sent].input_length, &id)) {
+                return answered;
+            }
+        }
+        if (!atecc_rpc_client_receive(client, &client->frame)) {
+            return answered;
+        }
+
+        atecc_rpc_frame_t *frame = &client->frame;
+        size_t index = (uint16_t)(frame->id - base);
+        if (index >= sent || calls[index].answered || frame->opcode != (calls[index].opcode | ATECC_RPC_RESPONSE)) {
+            continue;
+        }
+
+        atecc_rpc_call_t *call = &calls[index];
+        call->status = frame->status;
+        if (frame->length > call->output_length) {
+            call->status = ATECC_RPC_ERR_LENGTH;
+        } else {
+            memcpy(call->output, frame->payload, frame->length);
+            call->output_length = frame->length;
+        }
+        call->answered = true;
+        answered++;
+    }
+    return answered;
+}
+
+// One request, waiting for an OK response of exactly output_length bytes
+static bool call_one(atecc_rpc_client_t *client, uint8_t opcode, uint8_t param, const uint8_t *input,
+                     size_t input_length, uint8_t *output, size_t output_length) {
+    atecc_rpc_call_t call = {
+        .opcode = opcode,
+        .param = param,
+        .input = input,
+        .input_length = input_length,
+        .output = output,
+        .output_length = output_length,
+    };
+    return atecc_rpc_client_run(client, &call, 1, 1) == 1 && call.status == ATECC_RPC_OK &&
+           call.output_length == output_length;
+}
+
+/**
+ * @brief Fetches random bytes from the device RNG.
+ *
+ * @param[in,out] client The client.
+ * @param[out]    data   Receives length random bytes.
+ * @param[in]     length The number of bytes; longer requests are split.
+ * @return true on success, false otherwise.
+ */
+bool atecc_rpc_random(atecc_rpc_client_t *client, uint8_t *data, size_t length) {
+    while (length > 0) {
+        size_t chunk = length < ATECC_RPC_MAX_PAYLOAD ? length : ATECC_RPC_MAX_PAYLOAD;
+        uint8_t count[2] = { (uint8_t)chunk, (uint8_t)(chunk >> 8) };
+        if (!call_one(client, ATECC_RPC_RANDOM, 0, count, sizeof(count), data, chunk)) {
+            return false;
+        }
+        data += chunk;
+        length -= chunk;
+    }
+    return true;
+}
+
+/**
+ * @brief Hashes a message on the device.
+ *
+ * @param[in,out] client  The client.
+ * @param[in]     message The message.
+ * @param[in]     length  The message length, at most ATECC_RPC_MAX_PAYLOAD.
+ * @param[out]    digest  Receives the 32-byte SHA-256 digest.
+ * @return true on success, false otherwise.
+ */
+bool atecc_rpc_sha256(atecc_rpc_client_t *client, const uint8_t *message, size_t length, uint8_t *digest) {
+    return call_one(client, ATECC_RPC_SHA256, 0, message, length, digest, SHA256_DIGEST_SIZE);
+}
+
+/**
+ * @brief Encrypts 16-byte blocks with AES-128-ECB and a key slot.
+ *
+ * @param[in,out] client   The client.
+ * @param[in]     key_slot The AES key slot.
+ * @param[in]     input    The plaintext.
+ * @param[out]    output   Receives length bytes of ciphertext.
+ * @param[in]     length   A multiple of 16, at most ATECC_RPC_MAX_PAYLOAD.
+ * @return true on success, false otherwise.
+ */
+bool atecc_rpc_aes_encrypt(atecc_rpc_client_t *client, uint8_t key_slot, const uint8_t *input,
+                           uint8_t *output, size_t length) {
+    return call_one(client, ATECC_RPC_AES_ENCRYPT, key_slot, input, length, output, length);
+}
+
+/**
+ * @brief Decrypts 16-byte blocks with AES-128-ECB and a key slot.
+ *
+ * @param[in,out] client   The client.
+ * @param[in]     key_slot The AES key slot.
+ * @param[in]     input    The ciphertext.
+ * @param[out]    output   Receives length bytes of plaintext.
+ * @param[in]     length   A multiple of 16, at most ATECC_RPC_MAX_PAYLOAD.
+ * @return true on success, false otherwise.
+ */
+bool atecc_rpc_aes_decrypt(atecc_rpc_client_t *client, uint8_t key_slot, const uint8_t *input,
+                           uint8_t *output, size_t length) {
+    return call_one(client, ATECC_RPC_AES_DECRYPT, key_slot, input, length, output, length);
+}
+
+/**
+ * @brief Signs a digest with a P-256 private key slot.
+ *
+ * @param[in,out] client    The client.
+ * @param[in]     key_slot  The private key slot.
+ * @param[in]     digest    The 32-byte digest.
+ * @param[out]    signature Receives R || S.
+ * @return true on success, false otherwise.
+ */
+bool atecc_rpc_sign(atecc_rpc_client_t *client, uint8_t key_slot, const uint8_t *digest, uint8_t *signature) {
+    return call_one(client, ATECC_RPC_SIGN, key_slot, digest, ECC_DIGEST_SIZE, signature, ECC_P256_SIG_SIZE);
+}
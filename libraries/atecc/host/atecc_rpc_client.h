@@ -0,0 +1,51 @@
+#ifndef ATECC_RPC_CLIENT_H
+#define ATECC_RPC_CLIENT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "atecc_rpc.h"
+
+// Host end of the RPC protocol: sends requests over a transport (a serial port, or
+// the loopback) and matches the responses to them by request id. A batch keeps up to
+// a window of requests outstanding, so the device always has the next one queued.
+
+typedef struct {
+    atecc_rpc_transport_t transport;
+    atecc_rpc_parser_t parser;
+    atecc_rpc_frame_t frame;        // The response being parsed
+    uint8_t rx[256];
+    size_t rx_length;
+    size_t rx_offset;
+    uint16_t next_id;
+} atecc_rpc_client_t;
+
+// One request of a batch and, once answered, its result
+typedef struct {
+    uint8_t opcode;
+    uint8_t param;
+    const uint8_t *input;
+    size_t input_length;
+    uint8_t *output;
+    size_t output_length;           // Capacity on entry, response length once answered
+    uint8_t status;                 // atecc_rpc_status_t once answered
+    bool answered;
+} atecc_rpc_call_t;
+
+void atecc_rpc_client_init(atecc_rpc_client_t *client, const atecc_rpc_transport_t *transport);
+bool atecc_rpc_client_send(atecc_rpc_client_t *client, uint8_t opcode, uint8_t param,
+                           const uint8_t *payload, size_t length, uint16_t *id);
+bool atecc_rpc_client_receive(atecc_rpc_client_t *client, atecc_rpc_frame_t *frame);
+size_t atecc_rpc_client_run(atecc_rpc_client_t *client, atecc_rpc_call_t *calls, size_t count, size_t window);
+
+// One request at a time
+bool atecc_rpc_random(atecc_rpc_client_t *client, uint8_t *data, size_t length);
+bool atecc_rpc_sha256(atecc_rpc_client_t *client, const uint8_t *message, size_t length, uint8_t *digest);
+bool atecc_rpc_aes_encrypt(atecc_rpc_client_t *client, uint8_t key_slot, const uint8_t *input,
+                           uint8_t *output, size_t length);
+bool atecc_rpc_aes_decrypt(atecc_rpc_client_t *client, uint8_t key_slot, const uint8_t *input,
+                           uint8_t *output, size_t length);
+bool atecc_rpc_sign(atecc_rpc_client_t *client, uint8_t key_slot, const uint8_t *digest, uint8_t *signature);
+
+#endif // ATECC_RPC_CLIENT_H
@@ -0,0 +1,116 @@
+#include <string.h>
+
+#include "atecc_rpc_loopback.h"
+#include "atecc_power.h"
+
+#define LOOPBACK_PIPE_SIZE  (8u * ATECC_RPC_MAX_FRAME)
+
+// One direction of the link
+typedef struct {
+    uint8_t data[LOOPBACK_PIPE_SIZE];
+    size_t head;
+    size_t tail;
+} pipe_t;
+
+static struct {
+    atecc_rpc_server_t server;
+    pipe_t to_device;
+    pipe_t to_host;
+    atecc_request_t *queue[ATECC_RPC_MAX_IN_FLIGHT];
+    uint32_t queue_head;
+    uint32_t queue_tail;
+} loopback;
+
+static size_t pipe_write(pipe_t *pipe, const uint8_t *data, size_t length) {
+    size_t count = 0;
+    while (count < length && pipe->head - pipe->tail < LOOPBACK_PIPE_SIZE) {
+        pipe->data[pipe->head++ % LOOPBACK_PIPE_SIZE] = data[count++];
+    }
+    return count;
+}
+
+static size_t pipe_read(pipe_t *pipe, uint8_t *data, size_t length) {
+    size_t count = 0;
+    while (count < length && pipe->tail != pipe->head) {
+        data[count++] = pipe->data[pipe->tail++ % LOOPBACK_PIPE_SIZE];
+    }
+    return count;
+}
+
+// Device side of the pipes
+static size_t device_read(uint8_t *data, size_t length, void *context) {
+    (void)context;
+    return pipe_read(&loopback.to_device, data, length);
+}
+
+static size_t device_write(const uint8_t *data, size_t length, void *context) {
+    (void)context;
+    return pipe_write(&loopback.to_host, data, length);
+}
+
+// Executor with the service's contract, running on the host's only core
+static bool executor_submit(atecc_request_t *request) {
+    if (loopback.queue_head - loopback.queue_tail == ATECC_RPC_MAX_IN_FLIGHT) {
+        return false;
+    }
+    request->status = ATECC_REQUEST_QUEUED;
+    loopback.queue[loopback.queue_head++ % ATECC_RPC_MAX_IN_FLIGHT] = request;
+    return true;
+}
+
+static size_t executor_poll() {
+    if (loopback.queue_tail == loopback.queue_head) {
+        return 0;
+    }
+    atecc_request_t *request = loopback.queue[loopback.queue_tail++ % ATECC_RPC_MAX_IN_FLIGHT];
+    bool session = atecc_session_begin();
+    bool ok = session && atecc_request_run(request);
+    if (session) {
+        atecc_session_end();
+    }
+    request->status = ok ? ATECC_REQUEST_DONE : ATECC_REQUEST_FAILED;
+    if (request->callback) {
+        request->callback(request, request->user_data);
+    }
+    return 1;
+}
+
+// Host side: a read with nothing to return runs the device until it answers or idles
+static size_t host_read(uint8_t *data, size_t length, void *context) {
+    (void)context;
+    while (loopback.to_host.tail == loopback.to_host.head && atecc_rpc_server_poll(&loopback.server)) {
+    }
+    return pipe_read(&loopback.to_host, data, length);
+}
+
+static size_t host_write(const uint8_t *data, size_t length, void *context) {
+    (void)context;
+    size_t count = pipe_write(&loopback.to_device, data, length);
+    if (count == 0 && atecc_rpc_server_poll(&loopback.server)) {
+        count = pipe_write(&loopback.to_device, data, length);
+    }
+    return count;
+}
+
+/**
+ * @brief Starts a fresh loopback device and returns the host end of its link.
+ *
+ * @param[out] transport Receives the transport for atecc_rpc_client_init().
+ */
+void atecc_rpc_loopback_init(atecc_rpc_transport_t *transport) {
+    static const atecc_rpc_transport_t device = { device_read, device_write, NULL };
+    static const atecc_rpc_executor_t executor = { executor_submit, executor_poll };
+
+    memset(&loopback, 0, sizeof(loopback));
+    atecc_rpc_server_init(&loopback.server, &device, &executor);
+    *transport = (atecc_rpc_transport_t){ host_read, host_write, NULL };
+}
+
+/**
+ * @brief Gives access to the loopback server's counters.
+ *
+ * @return The server.
+ */
+const atecc_rpc_server_t *atecc_rpc_loopback_server() {
+    return &loopback.server;
+}
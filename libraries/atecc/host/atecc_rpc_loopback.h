@@ -0,0 +1,15 @@
+#ifndef ATECC_RPC_LOOPBACK_H
+#define ATECC_RPC_LOOPBACK_H
+
+#include "atecc_rpc.h"
+#include "atecc_rpc_server.h"
+
+// Stand-in for the Pico end of the RPC protocol on the host: the RPC server runs
+// in-process against the simulator, behind a pair of byte pipes in place of USB CDC.
+// It runs whenever the client waits for a response, one request per poll, the way
+// core1 completes them one at a time.
+
+void atecc_rpc_loopback_init(atecc_rpc_transport_t *transport);
+const atecc_rpc_server_t *atecc_rpc_loopback_server();
+
+#endif // ATECC_RPC_LOOPBACK_H
@@ -0,0 +1,82 @@
+#define _DEFAULT_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "atecc_rpc_serial.h"
+
+static size_t serial_read(uint8_t *data, size_t length, void *context) {
+    atecc_rpc_serial_t *serial = context;
+    struct pollfd fds = { .fd = serial->fd, .events = POLLIN };
+
+    if (poll(&fds, 1, serial->timeout_ms) <= 0) {
+        return 0;
+    }
+    ssize_t count = read(serial->fd, data, length);
+    return count > 0 ? (size_t)count : 0;
+}
+
+static size_t serial_write(const uint8_t *data, size_t length, void *context) {
+    atecc_rpc_serial_t *serial = context;
+    ssize_t count;
+
+    do {
+        count = write(serial->fd, data, length);
+    } while (count < 0 && errno == EINTR);
+    return count > 0 ? (size_t)count : 0;
+}
+
+/**
+ * @brief Opens a CDC ACM port in raw mode and returns a transport for it.
+ *
+ * The baud rate means nothing to USB CDC; only line discipline matters, so echo,
+ * CR/LF translation and flow-control characters are all switched off.
+ *
+ * @param[out] serial     The port state; must outlive the transport.
+ * @param[in]  path       The device, such as /dev/ttyACM0.
+ * @param[in]  timeout_ms How long a read waits for data.
+ * @param[out] transport  Receives the transport.
+ * @return true if the port was opened, false otherwise.
+ */
+bool atecc_rpc_serial_open(atecc_rpc_serial_t *serial, const char *path, int timeout_ms,
+                           atecc_rpc_transport_t *transport) {
+    struct termios tio;
+
+    serial->fd = open(path, O_RDWR | O_NOCTTY);
+    serial->timeout_ms = timeout_ms;
+    if (serial->fd < 0) {
+        return false;
+    }
+    if (tcgetattr(serial->fd, &tio) != 0) {
+        atecc_rpc_serial_close(serial);
+        return false;
+    }
+    cfmakeraw(&tio);
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 0;
+    if (tcsetattr(serial->fd, TCSANOW, &tio) != 0) {
+        atecc_rpc_serial_close(serial);
+        return false;
+    }
+    tcflush(serial->fd, TCIOFLUSH);
+
+    transport->read = serial_read;
+    transport->write = serial_write;
+    transport->context = serial;
+    return true;
+}
+
+/**
+ * @brief Closes a port opened with atecc_rpc_serial_open().
+ *
+ * @param[in,out] serial The port state.
+ */
+void atecc_rpc_serial_close(atecc_rpc_serial_t *serial) {
+    if (serial->fd >= 0) {
+        close(serial->fd);
+        serial->fd = -1;
+    }
+}
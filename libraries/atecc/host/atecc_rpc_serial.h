@@ -0,0 +1,18 @@
+#ifndef ATECC_RPC_SERIAL_H
+#define ATECC_RPC_SERIAL_H
+
+#include <stdbool.h>
+
+#include "atecc_rpc.h"
+
+// RPC transport over the Pico's USB CDC port on Linux (/dev/ttyACM*), in raw mode
+typedef struct {
+    int fd;
+    int timeout_ms;                 // How long a read waits for the first byte
+} atecc_rpc_serial_t;
+
+bool atecc_rpc_serial_open(atecc_rpc_serial_t *serial, const char *path, int timeout_ms,
+                           atecc_rpc_transport_t *transport);
+void atecc_rpc_serial_close(atecc_rpc_serial_t *serial);
+
+#endif // ATECC_RPC_SERIAL_H
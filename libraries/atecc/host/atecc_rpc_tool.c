@@ -0,0 +1,93 @@
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "atecc_rpc_client.h"
+#include "atecc_rpc_serial.h"
+#include "atecc_sha.h"
+
+// Talks to a Pico built with PICO_ATECC_RPC: checks the link, draws random bytes,
+// then streams SHA-256 requests one at a time and pipelined to show the difference.
+
+#define TOOL_TIMEOUT_MS     (2000)
+#define TOOL_MESSAGE_SIZE   (64u)
+#define TOOL_MAX_REQUESTS   (4096u)
+
+static double now_s() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Hashes count messages with up to window requests outstanding
+static bool stream_sha256(atecc_rpc_client_t *client, size_t count, size_t window) {
+    static uint8_t messages[TOOL_MAX_REQUESTS][TOOL_MESSAGE_SIZE];
+    static uint8_t digests[TOOL_MAX_REQUESTS][SHA256_DIGEST_SIZE];
+    static atecc_rpc_call_t calls[TOOL_MAX_REQUESTS];
+
+    for (size_t i = 0; i < count; i++) {
+        for (size_t j = 0; j < TOOL_MESSAGE_SIZE; j++) {
+            messages[i][j] = (uint8_t)(i + j);
+        }
+        calls[i] = (atecc_rpc_call_t){
+            .opcode = ATECC_RPC_SHA256,
+            .input = messages[i],
+            .input_length = TOOL_MESSAGE_SIZE,
+            .output = digests[i],
+            .output_length = SHA256_DIGEST_SIZE,
+        };
+    }
+
+    double start = now_s();
+    size_t answered = atecc_rpc_client_run(client, calls, count, window);
+    double elapsed = now_s() - start;
+
+    size_t ok = 0;
+    for (size_t i = 0; i < answered; i++) {
+        ok += calls[i].status == ATECC_RPC_OK;
+    }
+    printf("⏱️ SHA-256 of %u bytes, window %zu: %zu/%zu ok, %.1f requests/s\n",
+           TOOL_MESSAGE_SIZE, window, ok, count, elapsed > 0 ? (double)answered / elapsed : 0.0);
+    return ok == count;
+}
+
+int main(int argc, char **argv) {
+    atecc_rpc_serial_t serial;
+    atecc_rpc_transport_t transport;
+    atecc_rpc_client_t client;
+    uint8_t random[32];
+
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <device> [requests] [window]\n", argv[0]);
+        return 2;
+    }
+    size_t count = argc > 2 ? strtoul(argv[2], NULL, 0) : 64;
+    size_t window = argc > 3 ? strtoul(argv[3], NULL, 0) : ATECC_RPC_MAX_IN_FLIGHT;
+    if (count == 0 || count > TOOL_MAX_REQUESTS) {
+        fprintf(stderr, "requests must be 1 to %u\n", TOOL_MAX_REQUESTS);
+        return 2;
+    }
+
+    if (!atecc_rpc_serial_open(&serial, argv[1], TOOL_TIMEOUT_MS, &transport)) {
+        perror(argv[1]);
+        return 1;
+    }
+    atecc_rpc_client_init(&client, &transport);
+
+    if (!atecc_rpc_random(&client, random, sizeof(random))) {
+        printf("❌ No answer from %s; is the firmware built with PICO_ATECC_RPC?\n", argv[1]);
+        atecc_rpc_serial_close(&serial);
+        return 1;
+    }
+    printf("🎲 Random: ");
+    for (size_t i = 0; i < sizeof(random); i++) {
+        printf("%02X", random[i]);
+    }
+    printf("\n");
+
+    bool ok = stream_sha256(&client, count, 1) && stream_sha256(&client, count, window);
+    atecc_rpc_serial_close(&serial);
+    return ok ? 0 : 1;
+}
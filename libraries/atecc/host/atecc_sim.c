@@ -0,0 +1,1500 @@
+#include "atecc_sim.h"
+#include "hal_pico_i2c.h"
+#include "atecc_cmd.h"
+#include "atecc_config.h"
+#include "atecc_crc.h"
+#include "sim_p256.h"
+
+#include <sched.h>
+#include <string.h>
+
+// Simulated time. It only moves when the library sleeps or a transfer takes bus time.
+static uint64_t now_us;
+
+// Models reachable on the buses
+static atecc_sim_t *attached[ATECC_SIM_MAX_DEVICES];
+
+// The model answering at I2C_PORT/I2C_ADDR unless the caller attaches its own
+static atecc_sim_t default_sim;
+static bool default_initialized;
+
+i2c_inst_t i2c0_inst = { 0, 0 };
+i2c_inst_t i2c1_inst = { 1, 0 };
+
+// Typical execution times at the default clock divider; reads of the response are
+// NACKed for this long after the command packet has been received
+static uint32_t exec_times_us[256];
+static bool exec_times_ready;
+
+static const struct {
+    uint8_t opcode;
+    uint32_t us;
+} exec_defaults[] = {
+    { ATCA_AES,      600u },
+    { ATCA_COUNTER, 20000u },
+    { ATCA_ECDH,   38000u },
+    { ATCA_GENDIG,  5000u },
+    { ATCA_GENKEY, 59000u },
+    { ATCA_INFO,      50u },
+    { ATCA_KDF,     2000u },
+    { ATCA_LOCK,    9000u },
+    { ATCA_NONCE,    300u },
+    { ATCA_RANDOM,  1500u },
+    { ATCA_READ,     150u },
+    { ATCA_SHA,      250u },
+    { ATCA_SIGN,   42000u },
+    { ATCA_VERIFY, 38000u },
+    { ATCA_WRITE,  10000u },
+};
+
+// Used for op-codes the model rejects; parsing still takes the device some time
+#define ATECC_SIM_EXEC_DEFAULT_US   (100u)
+
+static void exec_times_init() {
+    for (size_t i = 0; i < 256; i++) {
+        exec_times_us[i] = ATECC_SIM_EXEC_DEFAULT_US;
+    }
+    for (size_t i = 0; i < sizeof(exec_defaults) / sizeof(exec_defaults[0]); i++) {
+        exec_times_us[exec_defaults[i].opcode] = exec_defaults[i].us;
+    }
+    exec_times_ready = true;
+}
+
+/**
+ * @brief Returns the simulated time.
+ *
+ * @return Microseconds since the start of the program.
+ */
+uint64_t atecc_sim_now_us() {
+    return now_us;
+}
+
+/**
+ * @brief Moves simulated time forward.
+ *
+ * @param us The number of microseconds to advance.
+ */
+void atecc_sim_advance_us(uint64_t us) {
+    now_us += us;
+}
+
+uint64_t time_us_64() {
+    return now_us;
+}
+
+void sleep_us(uint64_t us) {
+    now_us += us;
+}
+
+void sleep_ms(uint32_t ms) {
+    now_us += (uint64_t)ms * 1000u;
+}
+
+// No event ever arrives early: sleep until the timeout and report it as reached.
+// Yields, as the caller may be the core1 thread of atecc_service_check.
+bool best_effort_wfe_or_timeout(absolute_time_t timeout) {
+    if (timeout > now_us) {
+        now_us = timeout;
+    }
+    sched_yield();
+    return true;
+}
+
+/**
+ * @brief Sets the clock the simulator accounts bus time with.
+ *
+ * @param i2c      The bus.
+ * @param baudrate The SCL frequency in Hz.
+ * @return The frequency actually set.
+ */
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+    i2c->baudrate = baudrate;
+    return baudrate;
+}
+
+/**
+ * @brief Changes the clock of an initialised bus.
+ *
+ * @param i2c      The bus.
+ * @param baudrate The SCL frequency in Hz.
+ * @return The frequency actually set.
+ */
+uint i2c_set_baudrate(i2c_inst_t *i2c, uint baudrate) {
+    i2c->baudrate = baudrate;
+    return baudrate;
+}
+
+/**
+ * @brief Returns the execution time the model charges for a command.
+ *
+ * @param opcode The command op-code.
+ * @return Execution time in microseconds.
+ */
+uint32_t atecc_sim_exec_us(uint8_t opcode) {
+    if (!exec_times_ready) {
+        exec_times_init();
+    }
+    return exec_times_us[opcode];
+}
+
+/**
+ * @brief Overrides the execution time the model charges for a command.
+ *
+ * @param opcode The command op-code.
+ * @param us     Execution time in microseconds.
+ */
+void atecc_sim_set_exec_us(uint8_t opcode, uint32_t us) {
+    if (!exec_times_ready) {
+        exec_times_init();
+    }
+    exec_times_us[opcode] = us;
+}
+
+/**
+ * @brief Returns the time a transfer takes on a bus.
+ *
+ * Every byte, the address byte included, takes nine clocks with its ACK bit; START
+ * and STOP add one clock each.
+ *
+ * @param bus   The bus.
+ * @param bytes The number of bytes on the wire, address byte included.
+ * @return Transfer time in microseconds, rounded up.
+ */
+uint64_t atecc_sim_bus_us(const i2c_inst_t *bus, size_t bytes) {
+    uint64_t hz = bus->baudrate ? bus->baudrate : ATECC_SIM_I2C_DEFAULT_HZ;
+    uint64_t bits = 9u * (uint64_t)bytes + 2u;
+    return (bits * 1000000u + hz - 1u) / hz;
+}
+
+/**
+ * @brief Returns the size of a data zone slot.
+ *
+ * @param slot The slot number.
+ * @return The slot size in bytes, or 0 for an invalid slot.
+ */
+size_t atecc_sim_slot_size(uint8_t slot) {
+    if (slot < 8) {
+        return 36u;
+    }
+    if (slot == 8) {
+        return 416u;
+    }
+    return slot < ATECC_SIM_NUM_SLOTS ? 72u : 0u;
+}
+
+// Store a little-endian 16-bit config field
+static inline void put_u16(uint8_t *dest, uint16_t value) {
+    dest[0] = (uint8_t)(value & 0xFF);
+    dest[1] = (uint8_t)(value >> 8);
+}
+
+static inline uint16_t get_u16(const uint8_t *src) {
+    return (uint16_t)(src[0] | ((uint16_t)src[1] << 8));
+}
+
+/**
+ * @brief Initializes a model as a provisioned ATECC608A.
+ *
+ * Both zones are locked and AES is enabled. Slot 3 holds the FIPS-197 example key
+ * 000102...0F as an AES key. Slots 0-2 are P-256 private keys for signing and ECDH,
+ * empty until GenKey or atecc_sim_write_slot() fills them, and slot 10 takes a P-256
+ * public key for Verify. Slot 6 is the IO protection key for encrypted ECDH and KDF
+ * output, and slot 9 is only read and written encrypted with the key in slot 4; both
+ * keys are all zero until provisioned. The other slots are plain data, writable in
+ * clear. The model starts asleep at the simulated 100 kHz clock.
+ *
+ * @param sim     The model to initialize.
+ * @param bus     The bus the model answers on.
+ * @param address The 7-bit I2C address it answers to.
+ */
+void atecc_sim_init(atecc_sim_t *sim, i2c_inst_t *bus, uint8_t address) {
+    memset(sim, 0, sizeof(*sim));
+    sim->bus = bus;
+    sim->address = address;
+    sim->power = ATECC_SIM_SLEEP;
+
+    uint8_t *config = sim->config;
+    static const uint8_t serial_head[4] = { 0x01, 0x23, 0x5A, 0x11 };
+    static const uint8_t revision[4] = { 0x00, 0x00, 0x60, 0x02 };
+    static const uint8_t serial_tail[5] = { 0x9C, 0x2E, 0x41, 0x07, 0xEE };
+    memcpy(&config[0], serial_head, sizeof(serial_head));
+    memcpy(&config[4], revision, sizeof(revision));
+    memcpy(&config[8], serial_tail, sizeof(serial_tail));
+    config[ATECC_CFG_AES_ENABLE] = 0x01;
+    config[ATECC_CFG_I2C_ADDRESS] = (uint8_t)(address << 1);
+    config[ATECC_CFG_CHIP_MODE] = 0x00;
+    put_u16(&config[ATECC_CFG_CHIP_OPTIONS],
+            ATECC_CHIP_OPT_IO_PROT_ENABLE | (ATECC_SIM_IO_KEY_SLOT << ATECC_CHIP_OPT_IO_PROT_KEY_SHIFT));
+
+    for (uint8_t slot = 0; slot < ATECC_SIM_NUM_SLOTS; slot++) {
+        uint16_t slot_config;
+        uint16_t key_config;
+        if (slot < 3) {
+            slot_config = 0x2087;   // Secret, external signatures, ECDH, GenKey writes
+            key_config = (uint16_t)(ATECC_KEY_TYPE_P256 << 2) | 0x0033u;
+        } else if (slot == 3) {
+            slot_config = 0x0000;   // Readable, writable in clear
+            key_config = (uint16_t)(ATECC_KEY_TYPE_AES << 2);
+        } else if (slot == ATECC_SIM_ENCRYPTED_SLOT) {
+            // Secret, encrypted reads and writes, both keyed by ATECC_SIM_DATA_KEY_SLOT
+            slot_config = (uint16_t)(0x40C0u | (ATECC_SIM_DATA_KEY_SLOT << 8) | ATECC_SIM_DATA_KEY_SLOT);
+            key_config = (uint16_t)(ATECC_KEY_TYPE_SHA << 2);
+        } else if (slot == ATECC_SIM_PUBLIC_KEY_SLOT) {
+            slot_config = 0x0000;
+            key_config = (uint16_t)(ATECC_KEY_TYPE_P256 << 2);
+        } else {
+            slot_config = 0x0000;
+            key_config = (uint16_t)(ATECC_KEY_TYPE_SHA << 2);
+        }
+        put_u16(&config[ATECC_CFG_SLOT_CONFIG + 2u * slot], slot_config);
+        put_u16(&config[ATECC_CFG_KEY_CONFIG + 2u * slot], key_config);
+    }
+    memset(&config[ATECC_CFG_COUNTER0], 0xFF, 16);
+    put_u16(&config[ATECC_CFG_SLOT_LOCKED], 0xFFFF);
+    config[ATECC_CFG_LOCK_VALUE] = ATECC_LOCK_LOCKED;
+    config[ATECC_CFG_LOCK_CONFIG] = ATECC_LOCK_LOCKED;
+
+    for (uint8_t i = 0; i < 16; i++) {
+        sim->data[3][i] = i;
+    }
+    memset(sim->otp, 0xFF, sizeof(sim->otp));
+
+    // Distinct, reproducible RNG stream per bus address
+    for (size_t i = 0; i < sizeof(sim->rng_seed); i++) {
+        sim->rng_seed[i] = (uint8_t)(0xA5u ^ (i * 29u) ^ address ^ (bus->index << 7));
+    }
+}
+
+/**
+ * @brief Puts a model on its bus.
+ *
+ * @param sim The model, initialized with atecc_sim_init(); must stay valid until detached.
+ * @return true if attached, false if the address is taken or the table is full.
+ */
+bool atecc_sim_attach(atecc_sim_t *sim) {
+    atecc_sim_t **free_entry = NULL;
+    for (size_t i = 0; i < ATECC_SIM_MAX_DEVICES; i++) {
+        if (attached[i] == NULL) {
+            if (free_entry == NULL) {
+                free_entry = &attached[i];
+            }
+        } else if (attached[i]->bus == sim->bus && attached[i]->address == sim->address) {
+            return false;
+        }
+    }
+    if (free_entry == NULL) {
+        return false;
+    }
+    *free_entry = sim;
+    return true;
+}
+
+/**
+ * @brief Takes a model off its bus.
+ *
+ * @param sim The model.
+ */
+void atecc_sim_detach(atecc_sim_t *sim) {
+    for (size_t i = 0; i < ATECC_SIM_MAX_DEVICES; i++) {
+        if (attached[i] == sim) {
+            attached[i] = NULL;
+        }
+    }
+}
+
+/**
+ * @brief Returns the model at I2C_PORT/I2C_ADDR, attaching it on first use.
+ *
+ * @return Pointer to the default model.
+ */
+atecc_sim_t *atecc_sim_default() {
+    if (!default_initialized) {
+        atecc_sim_init(&default_sim, I2C_PORT, I2C_ADDR);
+        atecc_sim_attach(&default_sim);
+        default_initialized = true;
+    }
+    return &default_sim;
+}
+
+/**
+ * @brief Looks up the model answering at a bus address.
+ *
+ * @param bus     The bus.
+ * @param address The 7-bit I2C address.
+ * @return The model, or NULL if nothing answers there.
+ */
+atecc_sim_t *atecc_sim_find(i2c_inst_t *bus, uint8_t address) {
+    atecc_sim_default();
+    for (size_t i = 0; i < ATECC_SIM_MAX_DEVICES; i++) {
+        if (attached[i] != NULL && attached[i]->bus == bus && attached[i]->address == address) {
+            return attached[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Writes provisioning data into a slot without a command.
+ *
+ * @param sim    The model.
+ * @param slot   The slot number.
+ * @param offset The byte offset within the slot.
+ * @param data   The bytes to write.
+ * @param length The number of bytes.
+ * @return true if the range fits the slot, false otherwise.
+ */
+bool atecc_sim_write_slot(atecc_sim_t *sim, uint8_t slot, size_t offset, const uint8_t *data, size_t length) {
+    size_t size = atecc_sim_slot_size(slot);
+    if (size == 0 || offset > size || length > size - offset) {
+        return false;
+    }
+    memcpy(&sim->data[slot][offset], data, length);
+    return true;
+}
+
+/**
+ * @brief Sets the config and data zone lock bytes without a Lock command.
+ *
+ * @param sim           The model.
+ * @param config_locked true to lock the config zone.
+ * @param data_locked   true to lock the data and OTP zones.
+ */
+void atecc_sim_set_locks(atecc_sim_t *sim, bool config_locked, bool data_locked) {
+    sim->config[ATECC_CFG_LOCK_CONFIG] = config_locked ? ATECC_LOCK_LOCKED : ATECC_LOCK_UNLOCKED;
+    sim->config[ATECC_CFG_LOCK_VALUE] = data_locked ? ATECC_LOCK_LOCKED : ATECC_LOCK_UNLOCKED;
+}
+
+// ---------------------------------------------------------------------------
+// AES-128 and GF(2^128) multiplication for the AES command
+
+static uint8_t sbox[256];
+static uint8_t inv_sbox[256];
+static bool sbox_ready;
+
+static uint8_t gf_mul(uint8_t a, uint8_t b) {
+    uint8_t product = 0;
+    while (b) {
+        if (b & 1) {
+            product ^= a;
+        }
+        a = (uint8_t)((a << 1) ^ ((a & 0x80) ? 0x1B : 0x00));
+        b >>= 1;
+    }
+    return product;
+}
+
+static inline uint8_t rotl8(uint8_t value, unsigned shift) {
+    return (uint8_t)((value << shift) | (value >> (8 - shift)));
+}
+
+// Derive the S-box from its definition: multiplicative inverse, then the affine map
+static void sbox_init() {
+    for (unsigned x = 0; x < 256; x++) {
+        uint8_t inverse = 0;
+        for (unsigned y = 1; x != 0 && y < 256; y++) {
+            if (gf_mul((uint8_t)x, (uint8_t)y) == 1) {
+                inverse = (uint8_t)y;
+                break;
+            }
+        }
+        uint8_t s = (uint8_t)(inverse ^ rotl8(inverse, 1) ^ rotl8(inverse, 2) ^ rotl8(inverse, 3) ^
+                              rotl8(inverse, 4) ^ 0x63);
+        sbox[x] = s;
+        inv_sbox[s] = (uint8_t)x;
+    }
+    sbox_ready = true;
+}
+
+static void aes_expand_key(const uint8_t *key, uint8_t *round_keys) {
+    uint8_t rcon = 0x01;
+    memcpy(round_keys, key, 16);
+    for (size_t i = 16; i < 176; i += 4) {
+        uint8_t t[4];
+        memcpy(t, &round_keys[i - 4], 4);
+        if (i % 16 == 0) {
+            uint8_t first = t[0];
+            t[0] = (uint8_t)(sbox[t[1]] ^ rcon);
+            t[1] = sbox[t[2]];
+            t[2] = sbox[t[3]];
+            t[3] = sbox[first];
+            rcon = gf_mul(rcon, 0x02);
+        }
+        for (size_t j = 0; j < 4; j++) {
+            round_keys[i + j] = (uint8_t)(round_keys[i - 16 + j] ^ t[j]);
+        }
+    }
+}
+
+static void add_round_key(uint8_t *state, const uint8_t *round_key) {
+    for (size_t i = 0; i < 16; i++) {
+        state[i] ^= round_key[i];
+    }
+}
+
+// The state is column-major: byte r + 4c is row r of column c
+static void sub_shift_rows(uint8_t *state, const uint8_t *box, bool inverse) {
+    uint8_t shifted[16];
+    for (size_t c = 0; c < 4; c++) {
+        for (size_t r = 0; r < 4; r++) {
+            if (inverse) {
+                shifted[r + 4 * ((c + r) % 4)] = box[state[r + 4 * c]];
+            } else {
+                shifted[r + 4 * c] = box[state[r + 4 * ((c + r) % 4)]];
+            }
+        }
+    }
+    memcpy(state, shifted, 16);
+}
+
+static void mix_columns(uint8_t *state, const uint8_t *matrix) {
+    for (size_t c = 0; c < 4; c++) {
+        uint8_t a[4];
+        memcpy(a, &state[4 * c], 4);
+        for (size_t r = 0; r < 4; r++) {
+            state[4 * c + r] = (uint8_t)(gf_mul(a[0], matrix[(4 - r) % 4]) ^ gf_mul(a[1], matrix[(5 - r) % 4]) ^
+                                         gf_mul(a[2], matrix[(6 - r) % 4]) ^ gf_mul(a[3], matrix[(7 - r) % 4]));
+        }
+    }
+}
+
+static const uint8_t mix_forward[4] = { 0x02, 0x03, 0x01, 0x01 };
+static const uint8_t mix_inverse[4] = { 0x0E, 0x0B, 0x0D, 0x09 };
+
+static void aes128_crypt(const uint8_t *key, const uint8_t *input, uint8_t *output, bool decrypt) {
+    uint8_t round_keys[176];
+    uint8_t state[16];
+
+    if (!sbox_ready) {
+        sbox_init();
+    }
+    aes_expand_key(key, round_keys);
+    memcpy(state, input, 16);
+
+    if (!decrypt) {
+        add_round_key(state, &round_keys[0]);
+        for (size_t round = 1; round < 10; round++) {
+            sub_shift_rows(state, sbox, false);
+            mix_columns(state, mix_forward);
+            add_round_key(state, &round_keys[16 * round]);
+        }
+        sub_shift_rows(state, sbox, false);
+        add_round_key(state, &round_keys[160]);
+    } else {
+        add_round_key(state, &round_keys[160]);
+        for (size_t round = 9; round > 0; round--) {
+            sub_shift_rows(state, inv_sbox, true);
+            add_round_key(state, &round_keys[16 * round]);
+            mix_columns(state, mix_inverse);
+        }
+        sub_shift_rows(state, inv_sbox, true);
+        add_round_key(state, &round_keys[0]);
+    }
+
+    memcpy(output, state, 16);
+}
+
+// GCM multiplication in GF(2^128), bit-reflected as in NIST SP 800-38D
+static void gf128_mul(const uint8_t *x, const uint8_t *y, uint8_t *output) {
+    uint8_t z[16] = { 0 };
+    uint8_t v[16];
+    memcpy(v, y, 16);
+
+    for (size_t i = 0; i < 128; i++) {
+        if ((x[i / 8] >> (7 - i % 8)) & 1) {
+            for (size_t j = 0; j < 16; j++) {
+                z[j] ^= v[j];
+            }
+        }
+        bool lsb = v[15] & 1;
+        for (size_t j = 15; j > 0; j--) {
+            v[j] = (uint8_t)((v[j] >> 1) | (v[j - 1] << 7));
+        }
+        v[0] >>= 1;
+        if (lsb) {
+            v[0] ^= 0xE1;
+        }
+    }
+    memcpy(output, z, 16);
+}
+
+// ---------------------------------------------------------------------------
+// Command execution
+
+static bool config_locked(const atecc_sim_t *sim) {
+    return sim->config[ATECC_CFG_LOCK_CONFIG] != ATECC_LOCK_UNLOCKED;
+}
+
+static bool data_locked(const atecc_sim_t *sim) {
+    return sim->config[ATECC_CFG_LOCK_VALUE] != ATECC_LOCK_UNLOCKED;
+}
+
+static uint16_t slot_config(const atecc_sim_t *sim, uint8_t slot) {
+    return get_u16(&sim->config[ATECC_CFG_SLOT_CONFIG + 2u * slot]);
+}
+
+static uint16_t key_config(const atecc_sim_t *sim, uint8_t slot) {
+    return get_u16(&sim->config[ATECC_CFG_KEY_CONFIG + 2u * slot]);
+}
+
+// Drop everything the device forgets when it goes to sleep
+static void clear_volatile(atecc_sim_t *sim) {
+    memset(sim->tempkey, 0, sizeof(sim->tempkey));
+    sim->tempkey_valid = false;
+    sim->tempkey_gendig = false;
+    sim->sha_active = false;
+    sim->response_length = 0;
+}
+
+static void respond(atecc_sim_t *sim, const uint8_t *data, size_t length) {
+    sim->response[0] = (uint8_t)(length + 3);
+    memcpy(&sim->response[1], data, length);
+    calc_crc16_ccitt(length + 1, sim->response, &sim->response[length + 1]);
+    sim->response_length = length + 3;
+}
+
+static void respond_status(atecc_sim_t *sim, uint8_t status) {
+    respond(sim, &status, 1);
+}
+
+// 32 bytes of RNG output. With the config zone unlocked the device returns a fixed
+// FF FF 00 00 pattern instead.
+static void rng_generate(atecc_sim_t *sim, uint8_t *output) {
+    if (!config_locked(sim)) {
+        for (size_t i = 0; i < 32; i++) {
+            output[i] = (i % 4) < 2 ? 0xFF : 0x00;
+        }
+        return;
+    }
+
+    sw_sha256_ctx_t ctx;
+    uint8_t counter[8];
+    for (size_t i = 0; i < sizeof(counter); i++) {
+        counter[i] = (uint8_t)(sim->rng_counter >> (8 * i));
+    }
+    sim->rng_counter++;
+    sw_sha256_init(&ctx);
+    sw_sha256_update(&ctx, sim->rng_seed, sizeof(sim->rng_seed));
+    sw_sha256_update(&ctx, counter, sizeof(counter));
+    sw_sha256_final(&ctx, output);
+}
+
+static void exec_read(atecc_sim_t *sim, uint8_t param1, uint16_t param2, size_t data_len) {
+    uint8_t zone = param1 & 0x03;
+    size_t length = (param1 & ATCA_ZONE_READWRITE_32) ? ATCA_BLOCK_SIZE : ATCA_WORD_SIZE;
+    uint8_t block = (uint8_t)(param2 >> 3) & 0x1F;
+    uint8_t word = param2 & 0x07;
+    const uint8_t *source;
+    size_t size;
+    size_t offset;
+    bool encrypted = false;
+
+    if (data_len != 0) {
+        respond_status(sim, ATECC_SIM_STATUS_PARSE);
+        return;
+    }
+
+    switch (zone) {
+        case ATCA_ZONE_CONFIG:
+            source = sim->config;
+            size = sizeof(sim->config);
+            offset = block * ATCA_BLOCK_SIZE + word * ATCA_WORD_SIZE;
+            break;
+        case ATCA_ZONE_OTP:
+            source = sim->otp;
+            size = sizeof(sim->otp);
+            offset = block * ATCA_BLOCK_SIZE + word * ATCA_WORD_SIZE;
+            break;
+        case ATCA_ZONE_DATA: {
+            uint8_t slot = (uint8_t)(param2 >> 3) & 0x0F;
+            uint16_t sc = slot_config(sim, slot);
+            // Secret slots are only readable encrypted, in blocks, after a GenDig with ReadKey
+            if ((sc & 0x00C0u) == 0x00C0u && length == ATCA_BLOCK_SIZE && sim->tempkey_gendig &&
+                sim->gendig_slot == (sc & 0x0Fu)) {
+                encrypted = true;
+            } else if (sc & 0x00C0u) {
+                respond_status(sim, ATECC_SIM_STATUS_EXECUTION);
+                return;
+            }
+            source = sim->data[slot];
+            size = atecc_sim_slot_size(slot);
+            offset = (size_t)(param2 >> 8) * ATCA_BLOCK_SIZE + word * ATCA_WORD_SIZE;
+            break;
+        }
+        default:
+            respond_status(sim, ATECC_SIM_STATUS_PARSE);
+            return;
+    }
+
+    // Data and OTP can only be read once the data zone is locked
+    if ((zone != ATCA_ZONE_CONFIG && !data_locked(sim)) || offset + length > size) {
+        respond_status(sim, ATECC_SIM_STATUS_EXECUTION);
+        return;
+    }
+    if (encrypted) {
+        uint8_t output[ATCA_BLOCK_SIZE];
+        for (size_t i = 0; i < sizeof(output); i++) {
+            output[i] = source[offset + i] ^ sim->tempkey[i];
+        }
+        respond(sim, output, sizeof(output));
+        return;
+    }
+    respond(sim, &source[offset], length);
+}
+
+// Only the Revision mode: the four revision bytes of the config zone
+static void exec_info(atecc_sim_t *sim, uint8_t mode, size_t data_len) {
+    if (mode != 0x00 || data_len != 0) {
+        respond_status(sim, ATECC_SIM_STATUS_PARSE);
+        return;
+    }
+    respond(sim, &sim->config[4], 4);
+}
+
+static void exec_random(atecc_sim_t *sim, size_t data_len) {
+    uint8_t output[32];
+    if (data_len != 0) {
+        respond_status(sim, ATECC_SIM_STATUS_PARSE);
+        return;
+    }
+    rng_generate(sim, output);
+    respond(sim, output, sizeof(output));
+}
+
+static void exec_sha(atecc_sim_t *sim, uint8_t mode, uint16_t param2, const uint8_t *data, size_t data_len) {
+    switch (mode & 0x07) {
+        case 0x00:  // Start
+            sw_sha256_init(&sim->sha);
+            sim->sha_active = true;
+            respond_status(sim, ATECC_SIM_STATUS_SUCCESS);
+            return;
+        case 0x01:  // Update, exactly one block
+            if (data_len != 64) {
+                respond_status(sim, ATECC_SIM_STATUS_PARSE);
+                return;
+            }
+            if (!sim->sha_active) {
+                respond_status(sim, ATECC_SIM_STATUS_EXECUTION);
+                return;
+            }
+            sw_sha256_update(&sim->sha, data, data_len);
+            respond_status(sim, ATECC_SIM_STATUS_SUCCESS);
+            return;
+        case 0x02: {  // End, 0-63 trailing bytes; the digest also lands in TempKey
+            uint8_t digest[32];
+            if (data_len > 63 || param2 != data_len) {
+                respond_status(sim, ATECC_SIM_STATUS_PARSE);
+                return;
+            }
+            if (!sim->sha_active) {
+                respond_status(sim, ATECC_SIM_STATUS_EXECUTION);
+                return;
+            }
+            sw_sha256_update(&sim->sha, data, data_len);
+            sw_sha256_final(&sim->sha, digest);
+            sim->sha_active = false;
+            memcpy(sim->tempkey, digest, sizeof(digest));
+            sim->tempkey_valid = true;
+            respond(sim, digest, sizeof(digest));
+            return;
+        }
+        default:
+            respond_status(sim, ATECC_SIM_STATUS_PARSE);
+            return;
+    }
+}
+
+static void exec_aes(atecc_sim_t *sim, uint8_t mode, uint16_t param2, const uint8_t *data, size_t data_len) {
+    uint8_t operation = mode & 0x07;
+    uint8_t output[16];
+
+    if (operation == 0x03) {  // GFM: H followed by the second factor
+        if (data_len != 32) {
+            respond_status(sim, ATECC_SIM_STATUS_PARSE);
+            return;
+        }
+        gf128_mul(data, &data[16], output);
+        respond(sim, output, sizeof(output));
+        return;
+    }
+
+    if ((operation != 0x00 && operation != 0x01) || data_len != 16) {
+        respond_status(sim, ATECC_SIM_STATUS_PARSE);
+        return;
+    }
+
+    if (!(sim->config[ATECC_CFG_AES_ENABLE] & 0x01)) {
+        respond_status(sim, ATECC_SIM_STATUS_EXECUTION);
+        return;
+    }
+
+    // The key is one 16-byte block of a slot, or of TempKey for slot 0xFFFF
+    size_t key_block = mode >> 6;
+    const uint8_t *key;
+    if (param2 == 0xFFFF) {
+        if (!sim->tempkey_valid || key_block > 1) {
+            respond_status(sim, ATECC_SIM_STATUS_EXECUTION);
+            return;
+        }
+        key = &sim->tempkey[16 * key_block];
+    } else {
+        uint8_t slot = (uint8_t)param2;
+        if (param2 >= ATECC_SIM_NUM_SLOTS || ((key_config(sim, slot) >> 2) & 0x07) != ATECC_KEY_TYPE_AES ||
+            16 * (key_block + 1) > atecc_sim_slot_size(slot)) {
+            respond_status(sim, ATECC_SIM_STATUS_EXECUTION);
+            return;
+        }
+        key = &sim->data[slot][16 * key_block];
+    }
+
+    aes128_crypt(key, data, output, operation == 0x01);
+    respond(sim, output, sizeof(output));
+}
+
+static void exec_nonce(atecc_sim_t *sim, uint8_t mode, const uint8_t *data, size_t data_len) {
+    switch (mode & 0x03) {
+        case 0x00:  // Random, with and without a seed update
+        case 0x01: {
+            uint8_t rand_out[32];
+            uint8_t tail[3] = { ATCA_NONCE, mode, 0x00 };
+            sw_sha256_ctx_t ctx;
+
+            if (data_len != NONCE_NUMIN_SIZE) {
+                respond_status(sim, ATECC_SIM_STATUS_PARSE);
+                return;
+            }
+            rng_generate(sim, rand_out);
+            sw_sha256_init(&ctx);
+            sw_sha256_update(&ctx, rand_out, sizeof(rand_out));
+            sw_sha256_update(&ctx, data, data_len);
+            sw_sha256_update(&ctx, tail, sizeof(tail));
+            sw_sha256_final(&ctx, sim->tempkey);
+            sim->tempkey_valid = true;
+            respond(sim, rand_out, sizeof(rand_out));
+            return;
+        }
+        case 0x03:  // Pass-through
+            if (data_len != 32) {
+                respond_status(sim, ATECC_SIM_STATUS_PARSE);
+                return;
+            }
+            memcpy(sim->tempkey, data, 32);
+            sim->tempkey_valid = true;
+            respond_status(sim, ATECC_SIM_STATUS_SUCCESS);
+            return;
+        default:
+            respond_status(sim, ATECC_SIM_STATUS_PARSE);
+            return;
+    }
+}
+
+static bool is_p256_slot(const atecc_sim_t *sim, uint16_t slot, bool private_key) {
+    if (slot >= ATECC_SIM_NUM_SLOTS) {
+        return false;
+    }
+    uint16_t kc = key_config(sim, (uint8_t)slot);
+    return ((kc >> 2) & 0x07) == ATECC_KEY_TYPE_P256 && ((kc & 0x0001u) != 0) == private_key;
+}
+
+// A private key slot holds four pad bytes followed by the 32-byte scalar
+static uint8_t *private_key(atecc_sim_t *sim, uint8_t slot) {
+    return &sim->data[slot][ATECC_SIM_PRIVATE_KEY_OFFSET];
+}
+
+// Create a key (mode bit 2) or compute the public key of the stored one
+static void exec_genkey(atecc_sim_t *sim, uint8_t mode, uint16_t slot, size_t data_len) {
+    uint8_t public_key[64];
+
+    if ((mode & ~0x04u) != 0 || data_len != 0) {
+        respond_status(sim, ATECC_SIM_STATUS_PARSE);
+        return;
+    }
+    if (!is_p256_slot(sim, slot, true)) {
+        respond_status(sim, ATECC_SIM_STATUS_EXECUTION);
+        return;
+    }
+
+    if (mode & 0x04) {
+        // WriteConfig must allow GenKey, and a locked slot keeps its key
+        uint16_t locked = get_u16(&sim->config[ATECC_CFG_SLOT_LOCKED]);
+        if (!((slot_config(sim, (uint8_t)slot) >> 12) & 0x2) || !(locked & (1u << slot))) {
+            respond_status(sim, ATECC_SIM_STATUS_EXECUTION);
+            return;
+        }
+        do {
+            rng_generate(sim, private_key(sim, (uint8_t)slot));
+        } while (!sim_p256_valid_scalar(private_key(sim, (uint8_t)slot)));
+    }
+
+    if (!sim_p256_public_key(private_key(sim, (uint8_t)slot), public_key)) {
+        respond_status(sim, ATECC_SIM_STATUS_EXECUTION);
+        return;
+    }
+    respond(sim, public_key, sizeof(public_key));
+}
+
+// Only external mode: sign the digest in TempKey
+static void exec_sign(atecc_sim_t *sim, uint8_t mode, uint16_t slot, size_t data_len) {
+    uint8_t k[32];
+    uint8_t signature[64];
+
+    if (mode != 0x80 || data_len != 0) {
+        respond_status(sim, ATECC_SIM_STATUS_PARSE);
+        return;
+    }
+    if (!is_p256_slot(sim, slot, true) || !sim->tempkey_valid) {
+        respond_status(sim, ATECC_SIM_STATUS_EXECUTION);
+        return;
+    }
+
+    bool ok;
+    do {
+        rng_generate(sim, k);
+        ok = sim_p256_valid_scalar(k);
+    } while (!ok);
+    ok = sim_p256_sign(private_key(sim, (uint8_t)slot), sim->tempkey, k, signature);
+    memset(k, 0, sizeof(k));
+    if (!ok) {
+        respond_status(sim, ATECC_SIM_STATUS_EXECUTION);
+        return;
+    }
+    respond(sim, signature, sizeof(signature));
+}
+
+// Stored (public key in a slot) and external (public key after the signature) modes
+// over the digest in TempKey
+static void exec_verify(atecc_sim_t *sim, uint8_t mode, uint16_t param2, const uint8_t *data, size_t data_len) {
+    uint8_t public_key[64];
+
+    switch (mode & 0x07) {
+        case 0x00:
+            if (data_len != 64) {
+                respond_status(sim, ATECC_SIM_STATUS_PARSE);
+                return;
+            }
+            if (!is_p256_slot(sim, param2, false)) {
+                respond_status(sim, ATECC_SIM_STATUS_EXECUTION);
+                return;
+            }
+            // Stored as four pad bytes before each coordinate
+            memcpy(public_key, &sim->data[param2][4], 32);
+            memcpy(&public_key[32], &sim->data[param2][40], 32);
+            break;
+        case 0x02:
+            if (data_len != 128 || param2 != ATECC_KEY_TYPE_P256) {
+                respond_status(sim, ATECC_SIM_STATUS_PARSE);
+                return;
+            }
+            memcpy(public_key, &data[64], sizeof(public_key));
+            break;
+        default:
+            respond_status(sim, ATECC_SIM_STATUS_PARSE);
+            return;
+    }
+
+    if (!sim->tempkey_valid || !sim_p256_on_curve(public_key)) {
+        respond_status(sim, ATECC_SIM_STATUS_EXECUTION);
+        return;
+    }
+    respond_status(sim, sim_p256_verify(public_key, sim->tempkey, data) ? ATECC_SIM_STATUS_SUCCESS
+                                                                          : ATECC_SIM_STATUS_MISCOMPARE);
+}
+
+// The IO protection key, when ChipOptions enables one
+static const uint8_t *io_protection_key(const atecc_sim_t *sim) {
+    uint16_t options = get_u16(&sim->config[ATECC_CFG_CHIP_OPTIONS]);
+    if (!(options & ATECC_CHIP_OPT_IO_PROT_ENABLE)) {
+        return NULL;
+    }
+    return sim->data[options >> ATECC_CHIP_OPT_IO_PROT_KEY_SHIFT];
+}
+
+// Returns output encrypted with the IO protection key, followed by the 32-byte nonce:
+// each 32-byte block is XORed with SHA-256(IO key || 16 nonce bytes)
+static void respond_encrypted(atecc_sim_t *sim, const uint8_t *output, size_t length) {
+    const uint8_t *io_key = io_protection_key(sim);
+    uint8_t packet[64 + 32];
+    uint8_t mask[32];
+
+    if (io_key == NULL) {
+        respond_status(sim, ATECC_SIM_STATUS_EXECUTION);
+        return;
+    }
+    rng_generate(sim, &packet[length]);
+    for (size_t block = 0; block * 32 < length; block++) {
+        sw_sha256_ctx_t ctx;
+        sw_sha256_init(&ctx);
+        sw_sha256_update(&ctx, io_key, 32);
+        sw_sha256_update(&ctx, &packet[length + 16 * block], 16);
+        sw_sha256_final(&ctx, mask);
+        for (size_t i = 0; i < 32; i++) {
+            packet[32 * block + i] = output[32 * block + i] ^ mask[i];
+        }
+    }
+    respond(sim, packet, length + 32);
+}
+
+// Shared secret of the private key in a slot and the public key in the command, to
+// the next slot, TempKey or the response (bits 3:2), the latter possibly encrypted
+static void exec_ecdh(atecc_sim_t *sim, uint8_t mode, uint16_t slot, const uint8_t *data, size_t data_len) {
+    uint8_t secret[32];
+
+    if ((mode & ~0x0Eu) != 0 || (mode & 0x0C) == 0 || data_len != 64) {
+        respond_status(sim, ATECC_SIM_STATUS_PARSE);
+        return;
+    }
+    // ReadKey bit 2 permits ECDH with the key, bit 3 writing the secret to slot | 1
+    uint16_t permissions = is_p256_slot(sim, slot, true) ? slot_config(sim, (uint8_t)slot) & 0x0F : 0;
+    if (!(permissions & 0x4) || ((mode & 0x0C) == 0x04 && !(permissions & 0x8)) ||
+        !sim_p256_ecdh(private_key(sim, (uint8_t)slot), data, secret)) {
+        respond_status(sim, ATECC_SIM_STATUS_EXECUTION);
+        return;
+    }
+
+    switch (mode & 0x0C) {
+        case 0x04:
+            memcpy(sim->data[slot | 1u], secret, sizeof(secret));
+            respond_status(sim, ATECC_SIM_STATUS_SUCCESS);
+            break;
+        case 0x08:
+            memcpy(sim->tempkey, secret, sizeof(secret));
+            sim->tempkey_valid = true;
+            respond_status(sim, ATECC_SIM_STATUS_SUCCESS);
+            break;
+        default:
+            if (mode & 0x02) {
+                respond_encrypted(sim, secret, sizeof(secret));
+            } else {
+                respond(sim, secret, sizeof(secret));
+            }
+            break;
+    }
+    memset(secret, 0, sizeof(secret));
+}
+
+// TLS 1.2 P_SHA256 over one or two output blocks
+static void prf_sha256(const uint8_t *key, const uint8_t *seed, size_t seed_len, uint8_t *output, size_t length) {
+    uint8_t a[32];
+    uint8_t buffer[32 + 128];
+
+    sw_hmac_sha256(key, 32, seed, seed_len, a);
+    for (size_t offset = 0; offset < length; offset += 32) {
+        memcpy(buffer, a, sizeof(a));
+        memcpy(&buffer[32], seed, seed_len);
+        sw_hmac_sha256(key, 32, buffer, 32 + seed_len, &output[offset]);
+        sw_hmac_sha256(key, 32, a, sizeof(a), a);
+    }
+}
+
+// PRF and HKDF with a 32-byte key from TempKey or a slot. The details word and the
+// message follow in the data; key_id names the source slot (low byte) and target slot.
+static void exec_kdf(atecc_sim_t *sim, uint8_t mode, uint16_t key_id, const uint8_t *data, size_t data_len) {
+    static const uint8_t zero_key[32];
+    uint8_t source = mode & 0x03;
+    uint8_t target = mode & 0x1C;
+    uint8_t algorithm = mode & 0xE0;
+    uint8_t output[64];
+    size_t length = 32;
+
+    if (data_len < 4) {
+        respond_status(sim, ATECC_SIM_STATUS_PARSE);
+        return;
+    }
+    uint32_t details = (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) |
+                       ((uint32_t)data[3] << 24);
+    size_t message_len = details >> 24;
+    const uint8_t *message = &data[4];
+    // HKDF message location: 1 = TempKey, 2 = input; slot and IV are not modelled. The
+    // PRF message always follows the details.
+    uint8_t message_location = algorithm == 0x40 ? (uint8_t)(details & 0x3) : 0x2;
+    bool message_in_tempkey = message_location == 0x1;
+
+    if ((source != 0x00 && source != 0x02) || (algorithm != 0x00 && algorithm != 0x40) ||
+        (target != 0x00 && target != 0x08 && target != 0x10 && target != 0x14) ||
+        (message_location != 0x1 && message_location != 0x2) ||
+        message_len > 128 || data_len != 4 + (message_in_tempkey ? 0 : message_len)) {
+        respond_status(sim, ATECC_SIM_STATUS_PARSE);
+        return;
+    }
+
+    const uint8_t *key;
+    if (algorithm == 0x40 && (details & 0x4)) {
+        key = zero_key;
+    } else if (source == 0x02) {
+        uint8_t slot = (uint8_t)key_id;
+        if (slot >= ATECC_SIM_NUM_SLOTS || (key_config(sim, slot) & 0x0001u)) {
+            respond_status(sim, ATECC_SIM_STATUS_EXECUTION);
+            return;
+        }
+        key = sim->data[slot];
+    } else {
+        key = sim->tempkey;
+    }
+    if ((key == sim->tempkey || message_in_tempkey) && !sim->tempkey_valid) {
+        respond_status(sim, ATECC_SIM_STATUS_EXECUTION);
+        return;
+    }
+
+    if (algorithm == 0x40) {
+        uint8_t tempkey[32];
+        if (message_in_tempkey) {
+            memcpy(tempkey, sim->tempkey, sizeof(tempkey));
+            message = tempkey;
+            message_len = sizeof(tempkey);
+        }
+        sw_hmac_sha256(key, 32, message, message_len, output);
+    } else {
+        if (!(details & 0x1)) {    // Only 32-byte PRF keys
+            respond_status(sim, ATECC_SIM_STATUS_EXECUTION);
+            return;
+        }
+        length = (details & 0x100) ? 64 : 32;
+        prf_sha256(key, message, message_len, output, length);
+    }
+
+    switch (target) {
+        case 0x00:
+            if (length != 32) {
+                respond_status(sim, ATECC_SIM_STATUS_EXECUTION);
+                return;
+            }
+            memcpy(sim->tempkey, output, 32);
+            sim->tempkey_valid = true;
+            respond_status(sim, ATECC_SIM_STATUS_SUCCESS);
+            break;
+        case 0x08: {
+            uint8_t slot = (uint8_t)(key_id >> 8);
+            if (slot >= ATECC_SIM_NUM_SLOTS || length > atecc_sim_slot_size(slot) ||
+                (key_config(sim, slot) & 0x0001u)) {
+                respond_status(sim, ATECC_SIM_STATUS_EXECUTION);
+                return;
+            }
+            memcpy(sim->data[slot], output, length);
+            respond_status(sim, ATECC_SIM_STATUS_SUCCESS);
+            break;
+        }
+        case 0x10:
+            respond(sim, output, length);
+            break;
+        default:
+            respond_encrypted(sim, output, length);
+            break;
+    }
+    memset(output, 0, sizeof(output));
+}
+
+// Read (mode 0) or increment (mode 1) one of the two monotonic counters
+static void exec_counter(atecc_sim_t *sim, uint8_t mode, uint16_t counter_id, size_t data_len) {
+    uint8_t value[4];
+
+    if (mode > 0x01 || counter_id > 1 || data_len != 0) {
+        respond_status(sim, ATECC_SIM_STATUS_PARSE);
+        return;
+    }
+    if (mode == 0x01) {
+        if (sim->counters[counter_id] >= ATECC_SIM_COUNTER_MAX) {
+            respond_status(sim, ATECC_SIM_STATUS_EXECUTION);
+            return;
+        }
+        sim->counters[counter_id]++;
+    }
+    for (size_t i = 0; i < sizeof(value); i++) {
+        value[i] = (uint8_t)(sim->counters[counter_id] >> (8 * i));
+    }
+    respond(sim, value, sizeof(value));
+}
+
+// SN[8], SN[0:1] and 25 zero bytes, as GenDig and the Write MAC hash them
+static void hash_serial_tail(const atecc_sim_t *sim, sw_sha256_ctx_t *ctx) {
+    static const uint8_t zeros[25];
+    uint8_t sn[3] = { sim->config[12], sim->config[0], sim->config[1] };
+    sw_sha256_update(ctx, sn, sizeof(sn));
+    sw_sha256_update(ctx, zeros, sizeof(zeros));
+}
+
+// Only the data zone: hash the first 32 bytes of a slot into TempKey
+static void exec_gendig(atecc_sim_t *sim, uint8_t zone, uint16_t key_id, size_t data_len) {
+    uint8_t header[4] = { ATCA_GENDIG, zone, (uint8_t)key_id, (uint8_t)(key_id >> 8) };
+    sw_sha256_ctx_t ctx;
+
+    if (zone != ATCA_ZONE_DATA || data_len != 0) {
+        respond_status(sim, ATECC_SIM_STATUS_PARSE);
+        return;
+    }
+    if (key_id >= ATECC_SIM_NUM_SLOTS || !sim->tempkey_valid) {
+        respond_status(sim, ATECC_SIM_STATUS_EXECUTION);
+        return;
+    }
+    sw_sha256_init(&ctx);
+    sw_sha256_update(&ctx, sim->data[key_id], 32);
+    sw_sha256_update(&ctx, header, sizeof(header));
+    hash_serial_tail(sim, &ctx);
+    sw_sha256_update(&ctx, sim->tempkey, sizeof(sim->tempkey));
+    sw_sha256_final(&ctx, sim->tempkey);
+    sim->tempkey_gendig = true;
+    sim->gendig_slot = (uint8_t)key_id;
+    respond_status(sim, ATECC_SIM_STATUS_SUCCESS);
+}
+
+// Word or block writes. Config bytes past the first 16 while the config zone is
+// unlocked; OTP and data blocks before the data zone is locked; afterwards data slots
+// whose WriteConfig is Always, or Encrypt with the data XORed with a TempKey from
+// GenDig with WriteKey and followed by a MAC
+static void exec_write(atecc_sim_t *sim, uint8_t param1, uint16_t param2, const uint8_t *data, size_t data_len) {
+    uint8_t zone = param1 & 0x03;
+    bool block = (param1 & ATCA_ZONE_READWRITE_32) != 0;
+    bool encrypted = (param1 & ATCA_ZONE_ENCRYPTED) != 0;
+    size_t length = block ? ATCA_BLOCK_SIZE : ATCA_WORD_SIZE;
+    size_t word = param2 & 0x07;
+    uint8_t plain[ATCA_BLOCK_SIZE];
+    uint8_t *target;
+    size_t size;
+    size_t offset;
+
+    if (zone > ATCA_ZONE_DATA || (encrypted && (!block || zone != ATCA_ZONE_DATA)) ||
+        data_len != length + (encrypted ? 32u : 0u)) {
+        respond_status(sim, ATECC_SIM_STATUS_PARSE);
+        return;
+    }
+
+    bool allowed;
+    switch (zone) {
+        case ATCA_ZONE_CONFIG:
+            target = sim->config;
+            size = sizeof(sim->config);
+            offset = (size_t)((param2 >> 3) & 0x1F) * ATCA_BLOCK_SIZE + word * ATCA_WORD_SIZE;
+            allowed = !config_locked(sim) && offset >= 16;
+            break;
+        case ATCA_ZONE_OTP:
+            target = sim->otp;
+            size = sizeof(sim->otp);
+            offset = (size_t)((param2 >> 3) & 0x1F) * ATCA_BLOCK_SIZE + word * ATCA_WORD_SIZE;
+            allowed = !data_locked(sim) && block;
+            break;
+        default: {
+            uint8_t slot = (uint8_t)(param2 >> 3) & 0x0F;
+            uint16_t sc = slot_config(sim, slot);
+            uint8_t write_config = (uint8_t)(sc >> 12);
+            uint16_t locked = get_u16(&sim->config[ATECC_CFG_SLOT_LOCKED]);
+            target = sim->data[slot];
+            size = atecc_sim_slot_size(slot);
+            offset = (size_t)(param2 >> 8) * ATCA_BLOCK_SIZE + word * ATCA_WORD_SIZE;
+            if (!data_locked(sim)) {
+                allowed = block && !encrypted;
+            } else if (!(locked & (1u << slot))) {
+                allowed = false;
+            } else if (write_config & 0x4) {
+                allowed = encrypted && sim->tempkey_gendig && sim->gendig_slot == ((sc >> 8) & 0x0Fu);
+            } else {
+                allowed = write_config == 0x0 && !encrypted;
+            }
+            break;
+        }
+    }
+    if (!allowed || offset + length > size) {
+        respond_status(sim, ATECC_SIM_STATUS_EXECUTION);
+        return;
+    }
+
+    memcpy(plain, data, length);
+    if (encrypted) {
+        uint8_t header[4] = { ATCA_WRITE, param1, (uint8_t)param2, (uint8_t)(param2 >> 8) };
+        uint8_t mac[32];
+        sw_sha256_ctx_t ctx;
+
+        for (size_t i = 0; i < length; i++) {
+            plain[i] ^= sim->tempkey[i];
+        }
+        sw_sha256_init(&ctx);
+        sw_sha256_update(&ctx, sim->tempkey, sizeof(sim->tempkey));
+        sw_sha256_update(&ctx, header, sizeof(header));
+        hash_serial_tail(sim, &ctx);
+        sw_sha256_update(&ctx, plain, length);
+        sw_sha256_final(&ctx, mac);
+        if (memcmp(mac, &data[length], sizeof(mac)) != 0) {
+            respond_status(sim, ATECC_SIM_STATUS_EXECUTION);
+            return;
+        }
+    }
+    memcpy(&target[offset], plain, length);
+    respond_status(sim, ATECC_SIM_STATUS_SUCCESS);
+}
+
+static void exec_lock(atecc_sim_t *sim, uint8_t mode, uint16_t summary, size_t data_len) {
+    uint8_t zone = mode & 0x03;
+    bool check_summary = (mode & 0x80) == 0;
+    atecc_crc_ctx_t crc;
+    uint8_t crc_le[2];
+
+    if (data_len != 0) {
+        respond_status(sim, ATECC_SIM_STATUS_PARSE);
+        return;
+    }
+
+    atecc_crc_init(&crc);
+    switch (zone) {
+        case LOCK_ZONE_CONFIG:
+            if (config_locked(sim)) {
+                respond_status(sim, ATECC_SIM_STATUS_EXECUTION);
+                return;
+            }
+            atecc_crc_update(&crc, sim->config, sizeof(sim->config));
+            break;
+        case LOCK_ZONE_DATA:
+            if (!config_locked(sim) || data_locked(sim)) {
+                respond_status(sim, ATECC_SIM_STATUS_EXECUTION);
+                return;
+            }
+            for (uint8_t slot = 0; slot < ATECC_SIM_NUM_SLOTS; slot++) {
+                atecc_crc_update(&crc, sim->data[slot], atecc_sim_slot_size(slot));
+            }
+            atecc_crc_update(&crc, sim->otp, sizeof(sim->otp));
+            break;
+        case LOCK_ZONE_DATA_SLOT: {
+            uint8_t slot = (mode >> 2) & 0x0F;
+            uint16_t locked = get_u16(&sim->config[ATECC_CFG_SLOT_LOCKED]);
+            if (!data_locked(sim) || !(key_config(sim, slot) & 0x0020u) || !(locked & (1u << slot))) {
+                respond_status(sim, ATECC_SIM_STATUS_EXECUTION);
+                return;
+            }
+            atecc_crc_update(&crc, sim->data[slot], atecc_sim_slot_size(slot));
+            break;
+        }
+        default:
+            respond_status(sim, ATECC_SIM_STATUS_PARSE);
+            return;
+    }
+
+    atecc_crc_final(&crc, crc_le);
+    if (check_summary && get_u16(crc_le) != summary) {
+        respond_status(sim, ATECC_SIM_STATUS_EXECUTION);
+        return;
+    }
+
+    if (zone == LOCK_ZONE_CONFIG) {
+        sim->config[ATECC_CFG_LOCK_CONFIG] = ATECC_LOCK_LOCKED;
+    } else if (zone == LOCK_ZONE_DATA) {
+        sim->config[ATECC_CFG_LOCK_VALUE] = ATECC_LOCK_LOCKED;
+    } else {
+        uint8_t slot = (mode >> 2) & 0x0F;
+        put_u16(&sim->config[ATECC_CFG_SLOT_LOCKED],
+                (uint16_t)(get_u16(&sim->config[ATECC_CFG_SLOT_LOCKED]) & ~(1u << slot)));
+    }
+    respond_status(sim, ATECC_SIM_STATUS_SUCCESS);
+}
+
+/**
+ * @brief Checks and executes one command packet.
+ *
+ * @param sim    The model.
+ * @param packet The packet after the word address: count, op-code, params, data, CRC.
+ * @param length The number of bytes received.
+ */
+static void execute(atecc_sim_t *sim, const uint8_t *packet, size_t length) {
+    if (length < 7 || packet[0] != length || !crc_matches(packet, length)) {
+        sim->stats.crc_errors++;
+        respond_status(sim, ATECC_SIM_STATUS_CRC);
+        return;
+    }
+
+    uint8_t opcode = packet[1];
+    uint8_t param1 = packet[2];
+    uint16_t param2 = get_u16(&packet[3]);
+    const uint8_t *data = &packet[5];
+    size_t data_len = length - 7;
+
+    // A command that would outlast the watchdog is refused without running
+    uint32_t exec_us = atecc_sim_exec_us(opcode);
+    if (now_us + exec_us > sim->wake_us + ATECC_SIM_WATCHDOG_US) {
+        respond_status(sim, ATECC_SIM_STATUS_WATCHDOG);
+        return;
+    }
+
+    switch (opcode) {
+        case ATCA_READ:    exec_read(sim, param1, param2, data_len); break;
+        case ATCA_INFO:    exec_info(sim, param1, data_len); break;
+        case ATCA_RANDOM:  exec_random(sim, data_len); break;
+        case ATCA_SHA:     exec_sha(sim, param1, param2, data, data_len); break;
+        case ATCA_AES:     exec_aes(sim, param1, param2, data, data_len); break;
+        case ATCA_NONCE:   exec_nonce(sim, param1, data, data_len); break;
+        case ATCA_LOCK:    exec_lock(sim, param1, param2, data_len); break;
+        case ATCA_GENKEY:  exec_genkey(sim, param1, param2, data_len); break;
+        case ATCA_SIGN:    exec_sign(sim, param1, param2, data_len); break;
+        case ATCA_VERIFY:  exec_verify(sim, param1, param2, data, data_len); break;
+        case ATCA_ECDH:    exec_ecdh(sim, param1, param2, data, data_len); break;
+        case ATCA_KDF:     exec_kdf(sim, param1, param2, data, data_len); break;
+        case ATCA_COUNTER: exec_counter(sim, param1, param2, data_len); break;
+        case ATCA_GENDIG:  exec_gendig(sim, param1, param2, data_len); break;
+        case ATCA_WRITE:   exec_write(sim, param1, param2, data, data_len); break;
+        default:           respond_status(sim, ATECC_SIM_STATUS_PARSE); break;
+    }
+    // A TempKey from GenDig serves the one encrypted Read or Write that follows
+    if (opcode != ATCA_GENDIG) {
+        sim->tempkey_gendig = false;
+    }
+
+    sim->ready_us = now_us + exec_us;
+    sim->stats.commands++;
+    sim->stats.exec_us += exec_us;
+}
+
+// Put an awake device whose watchdog has expired to sleep
+static void check_watchdog(atecc_sim_t *sim) {
+    if (sim->power == ATECC_SIM_AWAKE && now_us - sim->wake_us >= ATECC_SIM_WATCHDOG_US) {
+        sim->power = ATECC_SIM_SLEEP;
+        clear_volatile(sim);
+    }
+}
+
+// Whether the wiring corrupts a transfer at the bus's current clock
+static bool clock_too_fast(const i2c_inst_t *bus, atecc_sim_t *sim) {
+    if (sim->max_clock_hz == 0 || bus->baudrate <= sim->max_clock_hz) {
+        return false;
+    }
+    sim->stats.corrupted++;
+    return true;
+}
+
+// A NACKed transfer still costs the address byte
+static int nack(i2c_inst_t *bus, atecc_sim_t *sim) {
+    uint64_t us = atecc_sim_bus_us(bus, 1);
+    now_us += us;
+    if (sim != NULL) {
+        sim->stats.nacks++;
+        sim->stats.bus_us += us;
+    }
+    return PICO_ERROR_GENERIC;
+}
+
+// Wake every sleeping or idle device on a bus; the pulse reaches all of them
+static void wake_bus(i2c_inst_t *bus) {
+    for (size_t i = 0; i < ATECC_SIM_MAX_DEVICES; i++) {
+        atecc_sim_t *sim = attached[i];
+        if (sim == NULL || sim->bus != bus) {
+            continue;
+        }
+        check_watchdog(sim);
+        if (sim->power == ATECC_SIM_AWAKE) {
+            continue;
+        }
+        sim->power = ATECC_SIM_AWAKE;
+        sim->wake_us = now_us;
+        sim->ready_us = now_us + ATECC_SIM_WAKE_DELAY_US;
+        sim->stats.wakes++;
+        respond_status(sim, ATECC_SIM_STATUS_WAKE);
+    }
+}
+
+/**
+ * @brief Delivers a write transfer to the device at an address.
+ *
+ * The first byte is the word address: 0x00 reset, 0x01 sleep, 0x02 idle, 0x03 command.
+ * A sleeping or idle device NACKs, but a 0x00 byte sent at a clock slow enough to
+ * hold SDA low for tWLO wakes every device on the bus. Above max_clock_hz the last
+ * bit of a command packet is misread.
+ *
+ * @param bus     The bus.
+ * @param address The 7-bit I2C address.
+ * @param data    The bytes written.
+ * @param length  The number of bytes.
+ * @return length if the device acknowledged, PICO_ERROR_GENERIC otherwise.
+ */
+int atecc_sim_i2c_write(i2c_inst_t *bus, uint8_t address, const uint8_t *data, size_t length) {
+    atecc_sim_t *sim = atecc_sim_find(bus, address);
+    if (sim == NULL || length == 0) {
+        return nack(bus, sim);
+    }
+    sim->stats.writes++;
+    check_watchdog(sim);
+
+    if (sim->power != ATECC_SIM_AWAKE) {
+        uint64_t hz = bus->baudrate ? bus->baudrate : ATECC_SIM_I2C_DEFAULT_HZ;
+        uint64_t low_us = 8u * 1000000u / hz;
+        if (data[0] == 0x00 && low_us >= ATECC_SIM_WAKE_LOW_US) {
+            wake_bus(bus);
+        }
+        return nack(bus, sim);
+    }
+
+    if (now_us < sim->ready_us) {
+        return nack(bus, sim);
+    }
+
+    uint64_t us = atecc_sim_bus_us(bus, 1 + length);
+    now_us += us;
+    sim->stats.bus_us += us;
+
+    switch (data[0]) {
+        case 0x00:
+            // Modelled as leaving the wake token behind, so a redundant wake of an
+            // already awake device (e.g. by another device's pulse) still succeeds
+            respond_status(sim, ATECC_SIM_STATUS_WAKE);
+            break;
+        case 0x01:
+            sim->power = ATECC_SIM_SLEEP;
+            clear_volatile(sim);
+            break;
+        case 0x02:
+            sim->power = ATECC_SIM_IDLE;
+            sim->response_length = 0;
+            break;
+        case 0x03:
+            if (length - 1 > ATECC_SIM_IO_BUFFER_SIZE) {
+                sim->stats.crc_errors++;
+                respond_status(sim, ATECC_SIM_STATUS_CRC);
+                break;
+            }
+            memcpy(sim->packet, &data[1], length - 1);
+            sim->packet_length = length - 1;
+            if (clock_too_fast(bus, sim)) {
+                // The last bit of the packet is misread, so the CRC check fails
+                uint8_t packet[ATECC_SIM_IO_BUFFER_SIZE];
+                memcpy(packet, &data[1], length - 1);
+                packet[length - 2] ^= 0x01;
+                execute(sim, packet, length - 1);
+            } else {
+                execute(sim, &data[1], length - 1);
+            }
+            break;
+        default:
+            break;
+    }
+    return (int)length;
+}
+
+/**
+ * @brief Delivers a read transfer from the device at an address.
+ *
+ * The device NACKs while asleep, idle or executing a command. Otherwise it returns
+ * its output buffer from the start; bytes past the end read as 0xFF. Above
+ * max_clock_hz the last bit read is flipped.
+ *
+ * @param bus     The bus.
+ * @param address The 7-bit I2C address.
+ * @param data    The buffer for the bytes read.
+ * @param length  The number of bytes.
+ * @return length if the device acknowledged, PICO_ERROR_GENERIC otherwise.
+ */
+int atecc_sim_i2c_read(i2c_inst_t *bus, uint8_t address, uint8_t *data, size_t length) {
+    atecc_sim_t *sim = atecc_sim_find(bus, address);
+    if (sim == NULL) {
+        return nack(bus, sim);
+    }
+    sim->stats.reads++;
+    check_watchdog(sim);
+
+    if (sim->power != ATECC_SIM_AWAKE || now_us < sim->ready_us || sim->response_length == 0 || length == 0) {
+        return nack(bus, sim);
+    }
+
+    uint64_t us = atecc_sim_bus_us(bus, 1 + length);
+    now_us += us;
+    sim->stats.bus_us += us;
+
+    size_t copied = length < sim->response_length ? length : sim->response_length;
+    memcpy(data, sim->response, copied);
+    memset(&data[copied], 0xFF, length - copied);
+    if (clock_too_fast(bus, sim)) {
+        data[length - 1] ^= 0x01;
+    }
+    return (int)length;
+}
@@ -0,0 +1,117 @@
+#ifndef ATECC_SIM_H
+#define ATECC_SIM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hardware/i2c.h"
+#include "sw_sha256.h"
+
+// Software model of an ATECC608 behind the host HAL. It parses real command packets,
+// checks their CRC and executes Read, Info, Random, SHA, AES, Nonce, Lock, GenKey,
+// Sign, Verify, ECDH, KDF, Counter, GenDig and Write against in-memory zones, while
+// accounting simulated bus and execution time.
+
+#define ATECC_SIM_MAX_DEVICES       (8u)    // Models attached at once
+#define ATECC_SIM_NUM_SLOTS         (16u)
+#define ATECC_SIM_SLOT_MAX_SIZE     (416u)  // Slot 8; slots 0-7 hold 36 bytes, 9-15 hold 72
+#define ATECC_SIM_OTP_SIZE          (64u)
+#define ATECC_SIM_CONFIG_SIZE       (128u)
+#define ATECC_SIM_IO_BUFFER_SIZE    (155u)  // Longest command packet the device accepts
+#define ATECC_SIM_PRIVATE_KEY_OFFSET (4u)   // Pad bytes before the scalar in a private key slot
+#define ATECC_SIM_PUBLIC_KEY_SLOT   (10u)   // Slot configured for a stored P-256 public key
+#define ATECC_SIM_IO_KEY_SLOT       (6u)    // Slot ChipOptions names as the IO protection key
+#define ATECC_SIM_DATA_KEY_SLOT     (4u)    // ReadKey and WriteKey of the encrypted slot
+#define ATECC_SIM_ENCRYPTED_SLOT    (9u)    // Slot read and written only encrypted
+#define ATECC_SIM_COUNTER_MAX       (2097151u)  // Increments beyond this fail
+
+#define ATECC_SIM_I2C_DEFAULT_HZ    (100000u)   // Bus clock before i2c_init()
+#define ATECC_SIM_WAKE_LOW_US       (60u)       // tWLO: SDA low time that wakes the device
+#define ATECC_SIM_WAKE_DELAY_US     (800u)      // tWHI: wake to first response (typical)
+#define ATECC_SIM_WATCHDOG_US       (1300000u)  // Awake time before the watchdog forces sleep
+
+// Status codes in a 4-byte response
+#define ATECC_SIM_STATUS_SUCCESS    ((uint8_t)0x00)
+#define ATECC_SIM_STATUS_MISCOMPARE ((uint8_t)0x01)
+#define ATECC_SIM_STATUS_PARSE      ((uint8_t)0x03)
+#define ATECC_SIM_STATUS_EXECUTION  ((uint8_t)0x0F)
+#define ATECC_SIM_STATUS_WAKE       ((uint8_t)0x11)
+#define ATECC_SIM_STATUS_WATCHDOG   ((uint8_t)0xEE)
+#define ATECC_SIM_STATUS_CRC        ((uint8_t)0xFF)
+
+// Power state of the modelled device
+typedef enum {
+    ATECC_SIM_SLEEP,
+    ATECC_SIM_IDLE,
+    ATECC_SIM_AWAKE,
+} atecc_sim_power_t;
+
+// What the model saw on the bus and how long it took
+typedef struct {
+    uint32_t writes;
+    uint32_t reads;
+    uint32_t nacks;         // Transfers NACKed: asleep or busy
+    uint32_t wakes;
+    uint32_t commands;      // Command packets executed
+    uint32_t crc_errors;    // Command packets rejected for a bad count or CRC
+    uint32_t corrupted;     // Transfers damaged by a clock above max_clock_hz
+    uint64_t bus_us;        // Time spent transferring, NACKs included
+    uint64_t exec_us;       // Time spent executing commands
+} atecc_sim_stats_t;
+
+// One modelled device
+typedef struct {
+    i2c_inst_t *bus;
+    uint8_t address;                // 7-bit I2C address
+    uint32_t max_clock_hz;          // Fastest clock the wiring carries cleanly, 0 for any
+    uint8_t config[ATECC_SIM_CONFIG_SIZE];
+    uint8_t otp[ATECC_SIM_OTP_SIZE];
+    uint8_t data[ATECC_SIM_NUM_SLOTS][ATECC_SIM_SLOT_MAX_SIZE];
+    uint32_t counters[2];           // Monotonic counters, starting at zero
+
+    // Volatile state, lost on sleep
+    uint8_t tempkey[32];
+    bool tempkey_valid;
+    bool tempkey_gendig;            // TempKey came from GenDig with gendig_slot
+    uint8_t gendig_slot;
+    sw_sha256_ctx_t sha;
+    bool sha_active;
+
+    uint8_t rng_seed[32];
+    uint64_t rng_counter;
+
+    atecc_sim_power_t power;
+    uint64_t wake_us;               // When the watchdog was last started
+    uint64_t ready_us;              // Reads are NACKed until this time
+    uint8_t response[ATECC_SIM_IO_BUFFER_SIZE];
+    size_t response_length;
+    uint8_t packet[ATECC_SIM_IO_BUFFER_SIZE];     // Last command packet, count byte to CRC
+    size_t packet_length;
+
+    atecc_sim_stats_t stats;
+} atecc_sim_t;
+
+void atecc_sim_init(atecc_sim_t *sim, i2c_inst_t *bus, uint8_t address);
+bool atecc_sim_attach(atecc_sim_t *sim);
+void atecc_sim_detach(atecc_sim_t *sim);
+atecc_sim_t *atecc_sim_default();
+atecc_sim_t *atecc_sim_find(i2c_inst_t *bus, uint8_t address);
+
+// Provisioning, bypassing the command interface
+size_t atecc_sim_slot_size(uint8_t slot);
+bool atecc_sim_write_slot(atecc_sim_t *sim, uint8_t slot, size_t offset, const uint8_t *data, size_t length);
+void atecc_sim_set_locks(atecc_sim_t *sim, bool config_locked, bool data_locked);
+
+// Timing model
+uint64_t atecc_sim_now_us();
+void atecc_sim_advance_us(uint64_t us);
+uint32_t atecc_sim_exec_us(uint8_t opcode);
+void atecc_sim_set_exec_us(uint8_t opcode, uint32_t us);
+uint64_t atecc_sim_bus_us(const i2c_inst_t *bus, size_t bytes);
+
+// Bus transfers as seen by the device at address; used by the host HAL
+int atecc_sim_i2c_write(i2c_inst_t *bus, uint8_t address, const uint8_t *data, size_t length);
+int atecc_sim_i2c_read(i2c_inst_t *bus, uint8_t address, uint8_t *data, size_t length);
+
+#endif // ATECC_SIM_H
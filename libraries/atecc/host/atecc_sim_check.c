@@ -0,0 +1,1712 @@
+#include "hal_pico_i2c.h"
+#include "atecc_aes.h"
+#include "atecc_bus.h"
+#include "atecc_channel.h"
+#include "atecc_cmd.h"
+#include "atecc_config.h"
+#include "atecc_counter.h"
+#include "atecc_data.h"
+#include "atecc_device.h"
+#include "atecc_ecc.h"
+#include "atecc_exec.h"
+#include "atecc_kdf.h"
+#include "atecc_log.h"
+#include "atecc_pool.h"
+#include "atecc_power.h"
+#include "atecc_random.h"
+#include "atecc_response.h"
+#include "atecc_rpc_client.h"
+#include "atecc_rpc_loopback.h"
+#include "atecc_sha.h"
+#include "atecc_sim.h"
+#include "atecc_stats.h"
+#include "sim_p256.h"
+#include "sw_aes.h"
+#include "sw_sha256.h"
+
+// Functional checks of the atecc library against the ATECC608 model, followed by
+// per-command latency and throughput at the common I2C clocks. Exits non-zero if
+// any check fails.
+
+static int failures;
+
+#define CHECK(cond) check((cond), #cond, __LINE__)
+
+static void check(bool ok, const char *what, int line) {
+    if (!ok) {
+        printf("❌ FAIL line %d: %s\n", line, what);
+        failures++;
+    }
+}
+
+// FIPS-197 appendix C.1, the key the model provisions into slot 3
+static const uint8_t fips_plaintext[16] = {
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF,
+};
+static const uint8_t fips_ciphertext[16] = {
+    0x69, 0xC4, 0xE0, 0xD8, 0x6A, 0x7B, 0x04, 0x30, 0xD8, 0xCD, 0xB7, 0x80, 0x70, 0xB4, 0xC5, 0x5A,
+};
+
+// GCM specification test case 2: zero key, zero IV, one zero block
+static const uint8_t gcm_ciphertext[16] = {
+    0x03, 0x88, 0xDA, 0xCE, 0x60, 0xB6, 0xA3, 0x92, 0xF3, 0x28, 0xC2, 0xB9, 0x71, 0xB2, 0xFE, 0x78,
+};
+static const uint8_t gcm_tag[16] = {
+    0xAB, 0x6E, 0x47, 0xD4, 0x2C, 0xEC, 0x13, 0xBD, 0xF5, 0x3A, 0x67, 0xB2, 0x12, 0x57, 0xBD, 0xDF,
+};
+
+// RFC 6979 appendix A.2.5: P-256 key and the SHA-256 signature of "sample"
+static const uint8_t rfc6979_private[32] = {
+    0xC9, 0xAF, 0xA9, 0xD8, 0x45, 0xBA, 0x75, 0x16, 0x6B, 0x5C, 0x21, 0x57, 0x67, 0xB1, 0xD6, 0x93,
+    0x4E, 0x50, 0xC3, 0xDB, 0x36, 0xE8, 0x9B, 0x12, 0x7B, 0x8A, 0x62, 0x2B, 0x12, 0x0F, 0x67, 0x21,
+};
+static const uint8_t rfc6979_public[64] = {
+    0x60, 0xFE, 0xD4, 0xBA, 0x25, 0x5A, 0x9D, 0x31, 0xC9, 0x61, 0xEB, 0x74, 0xC6, 0x35, 0x6D, 0x68,
+    0xC0, 0x49, 0xB8, 0x92, 0x3B, 0x61, 0xFA, 0x6C, 0xE6, 0x69, 0x62, 0x2E, 0x60, 0xF2, 0x9F, 0xB6,
+    0x79, 0x03, 0xFE, 0x10, 0x08, 0xB8, 0xBC, 0x99, 0xA4, 0x1A, 0xE9, 0xE9, 0x56, 0x28, 0xBC, 0x64,
+    0xF2, 0xF1, 0xB2, 0x0C, 0x2D, 0x7E, 0x9F, 0x51, 0x77, 0xA3, 0xC2, 0x94, 0xD4, 0x46, 0x22, 0x99,
+};
+static const uint8_t rfc6979_signature[64] = {
+    0xEF, 0xD4, 0x8B, 0x2A, 0xAC, 0xB6, 0xA8, 0xFD, 0x11, 0x40, 0xDD, 0x9C, 0xD4, 0x5E, 0x81, 0xD6,
+    0x9D, 0x2C, 0x87, 0x7B, 0x56, 0xAA, 0xF9, 0x91, 0xC3, 0x4D, 0x0E, 0xA8, 0x4E, 0xAF, 0x37, 0x16,
+    0xF7, 0xCB, 0x1C, 0x94, 0x2D, 0x65, 0x7C, 0x41, 0xD4, 0x36, 0xC7, 0xA1, 0xB6, 0xE2, 0x9F, 0x65,
+    0xF3, 0xE9, 0x00, 0xDB, 0xB9, 0xAF, 0xF4, 0x06, 0x4D, 0xC4, 0xAB, 0x2F, 0x84, 0x3A, 0xCD, 0xA8,
+};
+
+#define AES_KEY_SLOT    (3u)
+#define ECC_FIXED_SLOT  (0u)    // Provisioned with the RFC 6979 key
+#define ECC_GENKEY_SLOT (1u)
+#define ECC_BATCH_SIZE  (4u)
+#define POOL_ADDRESS    (0x61u) // Second device of the pool checks
+#define POOL_BLOCKS     (8u)
+#define ECC_RATE_COUNT  (16u)
+#define ECC_HOST_HASH_US (5000u) // Time the MCU takes to hash a message for signing
+#define CHANNEL_MESSAGE  (100u)
+#define COUNTER_BLOCK    (8u)
+#define COUNTER_RATE_COUNT (64u)
+#define COUNTER_RATE_BLOCK (32u)
+#define RPC_BURST_FRAMES (60u)  // Good frames after the one hiding a frame in its payload
+
+static void check_zones() {
+    atecc_sim_t *sim = atecc_sim_default();
+    uint8_t serial[ATCA_SERIAL_NUM_SIZE];
+    uint8_t config[CONFIG_ZONE_SIZE];
+
+    CHECK(read_atecc_serial_number(serial));
+    CHECK(memcmp(serial, sim->config, 4) == 0 && memcmp(&serial[4], &sim->config[8], 5) == 0);
+    CHECK(read_config_zone(config));
+    CHECK(memcmp(config, sim->config, sizeof(config)) == 0);
+    CHECK(atecc_config_is_locked() && atecc_data_is_locked());
+    CHECK(atecc_slot_is_aes_key(AES_KEY_SLOT));
+
+    // Unaligned range crossing a block boundary, served by word reads
+    uint8_t range[10];
+    CHECK(atecc_read_zone(ATCA_ZONE_CONFIG, 0, 27, range, sizeof(range)));
+    CHECK(memcmp(range, &sim->config[27], sizeof(range)) == 0);
+
+    uint8_t key[16];
+    CHECK(atecc_read_zone(ATCA_ZONE_DATA, AES_KEY_SLOT, 0, key, sizeof(key)));
+    CHECK(memcmp(key, sim->data[AES_KEY_SLOT], sizeof(key)) == 0);
+
+    // Secret slots are not readable
+    CHECK(!atecc_read_zone(ATCA_ZONE_DATA, 0, 0, key, sizeof(key)));
+}
+
+static void check_random() {
+    uint8_t a[48];
+    uint8_t b[48];
+    uint64_t value;
+
+    CHECK(random_pool_init(ATECC_RANDOM_BLOCK_SIZE, true));
+    CHECK(get_random_bytes(a, sizeof(a)));
+    CHECK(get_random_bytes(b, sizeof(b)));
+    CHECK(memcmp(a, b, sizeof(a)) != 0);
+
+    for (int i = 0; i < 32; i++) {
+        CHECK(random_uniform(100, 110, &value) && value >= 100 && value <= 110);
+    }
+}
+
+// FIPS 180-2 appendix B: one block, two blocks, and a million 'a's
+static const uint8_t sha256_abc[32] = {
+    0xBA, 0x78, 0x16, 0xBF, 0x8F, 0x01, 0xCF, 0xEA, 0x41, 0x41, 0x40, 0xDE, 0x5D, 0xAE, 0x22, 0x23,
+    0xB0, 0x03, 0x61, 0xA3, 0x96, 0x17, 0x7A, 0x9C, 0xB4, 0x10, 0xFF, 0x61, 0xF2, 0x00, 0x15, 0xAD,
+};
+static const uint8_t sha256_two_block[32] = {
+    0x24, 0x8D, 0x6A, 0x61, 0xD2, 0x06, 0x38, 0xB8, 0xE5, 0xC0, 0x26, 0x93, 0x0C, 0x3E, 0x60, 0x39,
+    0xA3, 0x3C, 0xE4, 0x59, 0x64, 0xFF, 0x21, 0x67, 0xF6, 0xEC, 0xED, 0xD4, 0x19, 0xDB, 0x06, 0xC1,
+};
+static const uint8_t sha256_million_a[32] = {
+    0xCD, 0xC7, 0x6E, 0x5C, 0x99, 0x14, 0xFB, 0x92, 0x81, 0xA1, 0xC7, 0xE2, 0x84, 0xD7, 0x3E, 0x67,
+    0xF1, 0x80, 0x9A, 0x48, 0xA4, 0x97, 0x20, 0x0E, 0x04, 0x6D, 0x39, 0xCC, 0xC7, 0x11, 0x2C, 0xD0,
+};
+
+// Hash message on one engine in a single update
+static bool engine_digest(sha256_engine_t engine, const uint8_t *message, size_t length, uint8_t *digest) {
+    sha256_ctx_t ctx;
+    return sha256_start(&ctx, engine, false) && sha256_update(&ctx, message, length) &&
+           sha256_final(&ctx, digest);
+}
+
+// Time one device SHA-256 of length bytes takes
+static uint64_t atecc_sha256_us(const uint8_t *message, size_t length) {
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    uint64_t start_us = atecc_sim_now_us();
+    CHECK(engine_digest(SHA256_ENGINE_ATECC, message, length, digest));
+    return atecc_sim_now_us() - start_us;
+}
+
+// Whether the dispatcher's pick for size and flags follows the calibrated cost model
+static bool follows_cost_model(size_t size, uint32_t flags) {
+    const sha256_calibration_t *calibration = sha256_get_calibration();
+    uint64_t blocks = ((uint64_t)size + 9u + SHA256_BLOCK_SIZE - 1u) / SHA256_BLOCK_SIZE;
+    const sha256_engine_cost_t *device = &calibration->engine[SHA256_ENGINE_ATECC];
+    const sha256_engine_cost_t *mcu = &calibration->engine[SHA256_ENGINE_SW];
+    uint64_t device_us = device->fixed_us + blocks * device->per_block_us;
+    uint64_t mcu_us = mcu->fixed_us + blocks * mcu->per_block_us;
+    bool bind = false;
+
+    if (flags & SHA256_FLAG_TEMPKEY) {
+        mcu_us += calibration->nonce_us;
+    }
+    sha256_engine_t engine = sha256_select_engine(size, flags, &bind);
+    if (device_us <= mcu_us) {
+        return engine == SHA256_ENGINE_ATECC && !bind;
+    }
+    return engine == SHA256_ENGINE_SW && bind == ((flags & SHA256_FLAG_TEMPKEY) != 0);
+}
+
+// The software engine against FIPS 180-2, the dispatcher against its cost model before
+// and after calibration, and digests that must land in TempKey
+static void check_sha256_dispatch() {
+    static const char two_block[] = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    static uint8_t message[2000];
+    uint8_t expected[SHA256_DIGEST_SIZE];
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    sha256_ctx_t ctx;
+
+    CHECK(engine_digest(SHA256_ENGINE_SW, (const uint8_t *)"abc", 3, digest));
+    CHECK(memcmp(digest, sha256_abc, sizeof(digest)) == 0);
+    CHECK(engine_digest(SHA256_ENGINE_SW, (const uint8_t *)two_block, sizeof(two_block) - 1, digest));
+    CHECK(memcmp(digest, sha256_two_block, sizeof(digest)) == 0);
+    CHECK(engine_digest(SHA256_ENGINE_ATECC, (const uint8_t *)two_block, sizeof(two_block) - 1, digest));
+    CHECK(memcmp(digest, sha256_two_block, sizeof(digest)) == 0);
+
+    // Pieces that never line up with a block
+    memset(message, 'a', 1000);
+    CHECK(sha256_start(&ctx, SHA256_ENGINE_SW, false));
+    for (int i = 0; i < 1000; i++) {
+        CHECK(sha256_update(&ctx, message, 1000));
+    }
+    CHECK(sha256_final(&ctx, digest));
+    CHECK(memcmp(digest, sha256_million_a, sizeof(digest)) == 0);
+
+    for (size_t i = 0; i < sizeof(message); i++) {
+        message[i] = (uint8_t)(i * 11u + 5u);
+    }
+
+    // The host has no accelerator; TempKey is bound only when hashing on the MCU
+    static const size_t sizes[] = { 0, 55, 64, 1000, SHA256_SIZE_UNKNOWN };
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        for (uint32_t flags = 0; flags <= SHA256_FLAG_TEMPKEY; flags++) {
+            CHECK(follows_cost_model(sizes[i] == SHA256_SIZE_UNKNOWN ? 1024u : sizes[i], flags));
+            bool bind = false;
+            sha256_engine_t engine = sha256_select_engine(sizes[i], flags, &bind);
+            CHECK(engine != SHA256_ENGINE_HW && (!bind || engine == SHA256_ENGINE_SW));
+        }
+    }
+
+    // Calibration fits the device's one- and sixteen-block times
+    CHECK(atecc_session_begin());
+    uint64_t short_us = atecc_sha256_us(message, 55);
+    uint64_t long_us = atecc_sha256_us(message, 55 + 15 * SHA256_BLOCK_SIZE);
+    atecc_session_end();
+    CHECK(sha256_calibrate());
+    const sha256_calibration_t *calibration = sha256_get_calibration();
+    const sha256_engine_cost_t *device = &calibration->engine[SHA256_ENGINE_ATECC];
+    CHECK(calibration->calibrated && device->per_block_us > 0 && calibration->nonce_us > 0);
+    CHECK(device->fixed_us + device->per_block_us + 15 >= short_us &&
+          device->fixed_us + device->per_block_us <= short_us + 15);
+    CHECK(device->fixed_us + 16 * device->per_block_us + 15 >= long_us &&
+          device->fixed_us + 16 * device->per_block_us <= long_us + 15);
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        CHECK(follows_cost_model(sizes[i] == SHA256_SIZE_UNKNOWN ? 1024u : sizes[i], 0));
+        CHECK(follows_cost_model(sizes[i] == SHA256_SIZE_UNKNOWN ? 1024u : sizes[i], SHA256_FLAG_TEMPKEY));
+    }
+
+    // The digest ends up in TempKey whichever engine hashes it
+    for (size_t length = 3; length <= sizeof(message); length += 1997) {
+        sw_sha256(message, length, expected);
+        memset(atecc_sim_default()->tempkey, 0, sizeof(atecc_sim_default()->tempkey));
+        CHECK(sha256_digest(message, length, SHA256_FLAG_TEMPKEY, digest));
+        CHECK(memcmp(digest, expected, sizeof(digest)) == 0);
+        CHECK(memcmp(atecc_sim_default()->tempkey, expected, sizeof(expected)) == 0);
+    }
+    memset(atecc_sim_default()->tempkey, 0, sizeof(atecc_sim_default()->tempkey));
+    CHECK(sha256_start(&ctx, SHA256_ENGINE_SW, true) && sha256_update(&ctx, message, 3) &&
+          sha256_final(&ctx, digest));
+    sw_sha256(message, 3, expected);
+    CHECK(memcmp(atecc_sim_default()->tempkey, expected, sizeof(expected)) == 0);
+}
+
+static void check_sha256() {
+    static uint8_t message[300];
+    uint8_t expected[SHA256_DIGEST_SIZE];
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    sha256_ctx_t ctx;
+
+    for (size_t i = 0; i < sizeof(message); i++) {
+        message[i] = (uint8_t)(i * 7u + 3u);
+    }
+    sw_sha256(message, sizeof(message), expected);
+
+    // Odd piece sizes complete buffered blocks from two fragments
+    CHECK(sha256_start(&ctx, SHA256_ENGINE_ATECC, false));
+    for (size_t offset = 0; offset < sizeof(message); offset += 23) {
+        size_t chunk = sizeof(message) - offset < 23 ? sizeof(message) - offset : 23;
+        CHECK(sha256_update(&ctx, &message[offset], chunk));
+    }
+    CHECK(sha256_final(&ctx, digest));
+    CHECK(memcmp(digest, expected, sizeof(digest)) == 0);
+    CHECK(memcmp(atecc_sim_default()->tempkey, expected, sizeof(expected)) == 0);
+
+    // Dispatcher result must not depend on the engine it picks
+    CHECK(sha256_digest(message, 64, 0, digest));
+    sw_sha256(message, 64, expected);
+    CHECK(memcmp(digest, expected, sizeof(digest)) == 0);
+
+    // A failed update closes the computation's session once: the final and the
+    // abort after it leave the caller's own session open
+    atecc_power_t *power = &atecc_device_current()->power;
+    CHECK(atecc_session_begin());
+    uint32_t depth = power->session_depth;
+    CHECK(sha256_start(&ctx, SHA256_ENGINE_ATECC, false));
+    CHECK(power->session_depth == depth + 1);
+    atecc_sim_default()->sha_active = false;
+    CHECK(!sha256_update(&ctx, message, SHA256_BLOCK_SIZE));
+    CHECK(power->session_depth == depth);
+    CHECK(!sha256_update(&ctx, message, SHA256_BLOCK_SIZE));
+    CHECK(!sha256_final(&ctx, digest));
+    sha256_abort(&ctx);
+    CHECK(power->session_depth == depth);
+
+    // Abandoned after a good update
+    CHECK(sha256_start(&ctx, SHA256_ENGINE_ATECC, false));
+    CHECK(sha256_update(&ctx, message, SHA256_BLOCK_SIZE));
+    sha256_abort(&ctx);
+    sha256_abort(&ctx);
+    CHECK(power->session_depth == depth);
+    atecc_session_end();
+}
+
+// Library errors go to the trace log instead of stdio
+static void check_log() {
+#if ATECC_LOG_LEVEL >= ATECC_LOG_LEVEL_WARN
+    atecc_log_record_t record;
+    uint8_t block[16];
+
+    atecc_log_drain(SIZE_MAX);
+    CHECK(!atecc_read_zone(ATCA_ZONE_DATA, 0, 0, block, sizeof(block)));
+    CHECK(atecc_log_pop(&record));
+    CHECK(record.event == ATECC_EV_COMMAND_FAILED && record.opcode == ATCA_READ &&
+          record.status == ATECC_SIM_STATUS_EXECUTION && record.args[1] == 1);
+    CHECK(atecc_log_pop(&record));
+    CHECK(record.event == ATECC_EV_READ_FAILED && record.args[0] == 0x0000);
+    CHECK(!aes_encrypt(fips_plaintext, block, 4));
+    CHECK(atecc_log_pop(&record));
+    CHECK(record.event == ATECC_EV_AES_SLOT_NOT_KEY && record.args[0] == 4);
+    CHECK(!atecc_log_pop(&record));
+
+    // A full log drops new records instead of blocking, and keeps the oldest
+    uint32_t dropped = atecc_log_dropped();
+    for (size_t i = 0; i < ATECC_LOG_ENTRIES + 3; i++) {
+        ATECC_LOG(AES_PADDING_INVALID, 0, 0, i, 0);
+    }
+    CHECK(atecc_log_dropped() == dropped + 3);
+
+    size_t count = 0;
+    bool ordered = true;
+    while (atecc_log_pop(&record)) {
+        ordered = ordered && record.args[0] == count;
+        count++;
+    }
+    CHECK(count == ATECC_LOG_ENTRIES && ordered);
+#endif
+}
+
+// NIST SP 800-38A appendix F: AES-128 key, the four-block plaintext, and the ECB,
+// CBC (IV 000102..0F) and CTR (counter F0F1..FF) ciphertexts
+static const uint8_t sp800_38a_key[16] = {
+    0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C,
+};
+static const uint8_t sp800_38a_plaintext[64] = {
+    0x6B, 0xC1, 0xBE, 0xE2, 0x2E, 0x40, 0x9F, 0x96, 0xE9, 0x3D, 0x7E, 0x11, 0x73, 0x93, 0x17, 0x2A,
+    0xAE, 0x2D, 0x8A, 0x57, 0x1E, 0x03, 0xAC, 0x9C, 0x9E, 0xB7, 0x6F, 0xAC, 0x45, 0xAF, 0x8E, 0x51,
+    0x30, 0xC8, 0x1C, 0x46, 0xA3, 0x5C, 0xE4, 0x11, 0xE5, 0xFB, 0xC1, 0x19, 0x1A, 0x0A, 0x52, 0xEF,
+    0xF6, 0x9F, 0x24, 0x45, 0xDF, 0x4F, 0x9B, 0x17, 0xAD, 0x2B, 0x41, 0x7B, 0xE6, 0x6C, 0x37, 0x10,
+};
+static const uint8_t sp800_38a_ecb[64] = {
+    0x3A, 0xD7, 0x7B, 0xB4, 0x0D, 0x7A, 0x36, 0x60, 0xA8, 0x9E, 0xCA, 0xF3, 0x24, 0x66, 0xEF, 0x97,
+    0xF5, 0xD3, 0xD5, 0x85, 0x03, 0xB9, 0x69, 0x9D, 0xE7, 0x85, 0x89, 0x5A, 0x96, 0xFD, 0xBA, 0xAF,
+    0x43, 0xB1, 0xCD, 0x7F, 0x59, 0x8E, 0xCE, 0x23, 0x88, 0x1B, 0x00, 0xE3, 0xED, 0x03, 0x06, 0x88,
+    0x7B, 0x0C, 0x78, 0x5E, 0x27, 0xE8, 0xAD, 0x3F, 0x82, 0x23, 0x20, 0x71, 0x04, 0x72, 0x5D, 0xD4,
+};
+static const uint8_t sp800_38a_cbc[64] = {
+    0x76, 0x49, 0xAB, 0xAC, 0x81, 0x19, 0xB2, 0x46, 0xCE, 0xE9, 0x8E, 0x9B, 0x12, 0xE9, 0x19, 0x7D,
+    0x50, 0x86, 0xCB, 0x9B, 0x50, 0x72, 0x19, 0xEE, 0x95, 0xDB, 0x11, 0x3A, 0x91, 0x76, 0x78, 0xB2,
+    0x73, 0xBE, 0xD6, 0xB8, 0xE3, 0xC1, 0x74, 0x3B, 0x71, 0x16, 0xE6, 0x9E, 0x22, 0x22, 0x95, 0x16,
+    0x3F, 0xF1, 0xCA, 0xA1, 0x68, 0x1F, 0xAC, 0x09, 0x12, 0x0E, 0xCA, 0x30, 0x75, 0x86, 0xE1, 0xA7,
+};
+static const uint8_t sp800_38a_ctr[64] = {
+    0x87, 0x4D, 0x61, 0x91, 0xB6, 0x20, 0xE3, 0x26, 0x1B, 0xEF, 0x68, 0x64, 0x99, 0x0D, 0xB6, 0xCE,
+    0x98, 0x06, 0xF6, 0x6B, 0x79, 0x70, 0xFD, 0xFF, 0x86, 0x17, 0x18, 0x7B, 0xB9, 0xFF, 0xFD, 0xFF,
+    0x5A, 0xE4, 0xDF, 0x3E, 0xDB, 0xD5, 0xD3, 0x5E, 0x5B, 0x4F, 0x09, 0x02, 0x0D, 0xB0, 0x3E, 0xAB,
+    0x1E, 0x03, 0x1D, 0xDA, 0x2F, 0xBE, 0x03, 0xD1, 0x79, 0x21, 0x70, 0xA0, 0xF3, 0x00, 0x9C, 0xEE,
+};
+// Keystream of the SP 800-38A key from counter 0001020304050607 FFFFFFFFFFFFFFFE,
+// whose third block carries out of the low 64 bits
+static const uint8_t ctr_carry_keystream[40] = {
+    0xEB, 0x18, 0x47, 0x2F, 0xF2, 0x2C, 0x12, 0xC6, 0x38, 0xC5, 0xB2, 0xE7, 0x28, 0x2D, 0x0D, 0x20,
+    0x3D, 0x88, 0xA6, 0x8D, 0xB0, 0xF3, 0xE3, 0xC6, 0x6E, 0x7F, 0xD8, 0xC1, 0xB1, 0xCB, 0x79, 0x7A,
+    0x2A, 0x88, 0x91, 0xD2, 0x39, 0x94, 0x9B, 0xEA,
+};
+
+// ECB, CBC and CTR against SP 800-38A, and a CTR counter carrying across 64 bits
+static void check_aes_modes() {
+    atecc_sim_t *sim = atecc_sim_default();
+    uint8_t saved_key[16];
+    uint8_t iv[16];
+    uint8_t counter[16] = { 0xF0, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7,
+                            0xF8, 0xF9, 0xFA, 0xFB, 0xFC, 0xFD, 0xFE, 0xFF };
+    uint8_t output[80];
+    uint8_t decrypted[80];
+    size_t length;
+
+    memcpy(saved_key, sim->data[AES_KEY_SLOT], sizeof(saved_key));
+    atecc_sim_write_slot(sim, AES_KEY_SLOT, 0, sp800_38a_key, sizeof(sp800_38a_key));
+
+    CHECK(aes_ecb_encrypt(AES_KEY_SLOT, sp800_38a_plaintext, output, sizeof(sp800_38a_plaintext)));
+    CHECK(memcmp(output, sp800_38a_ecb, sizeof(sp800_38a_ecb)) == 0);
+    CHECK(aes_ecb_decrypt(AES_KEY_SLOT, sp800_38a_ecb, output, sizeof(sp800_38a_ecb)));
+    CHECK(memcmp(output, sp800_38a_plaintext, sizeof(sp800_38a_plaintext)) == 0);
+
+    // PKCS#7 adds a whole padding block after the four vector blocks
+    for (size_t i = 0; i < sizeof(iv); i++) {
+        iv[i] = (uint8_t)i;
+    }
+    CHECK(aes_cbc_encrypt(AES_KEY_SLOT, iv, sp800_38a_plaintext, sizeof(sp800_38a_plaintext), output,
+                          sizeof(output), &length));
+    CHECK(length == sizeof(output) && memcmp(output, sp800_38a_cbc, sizeof(sp800_38a_cbc)) == 0);
+    CHECK(aes_cbc_decrypt(AES_KEY_SLOT, iv, output, length, decrypted, &length));
+    CHECK(length == sizeof(sp800_38a_plaintext) && memcmp(decrypted, sp800_38a_plaintext, length) == 0);
+
+    // In two calls, the counter left by the first feeding the second
+    CHECK(aes_ctr_crypt(AES_KEY_SLOT, counter, sp800_38a_plaintext, output, 32));
+    CHECK(aes_ctr_crypt(AES_KEY_SLOT, counter, &sp800_38a_plaintext[32], &output[32], 32));
+    CHECK(memcmp(output, sp800_38a_ctr, sizeof(sp800_38a_ctr)) == 0);
+    CHECK(counter[13] == 0xFD && counter[14] == 0xFF && counter[15] == 0x03);
+
+    uint8_t carry[16] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                          0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE };
+    uint8_t zero[sizeof(ctr_carry_keystream)] = { 0 };
+    static const uint8_t carried[16] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x08,
+                                         0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01 };
+    CHECK(aes_ctr_crypt(AES_KEY_SLOT, carry, zero, output, sizeof(zero)));
+    CHECK(memcmp(output, ctr_carry_keystream, sizeof(ctr_carry_keystream)) == 0);
+    CHECK(memcmp(carry, carried, sizeof(carried)) == 0);
+
+    atecc_sim_write_slot(sim, AES_KEY_SLOT, 0, saved_key, sizeof(saved_key));
+}
+
+// GCM test cases 3, 4 and 6 of the GCM specification (McGrew and Viega): one key
+// and plaintext; case 3 has no AAD, case 4 drops the last 4 bytes and adds AAD,
+// case 6 is case 4 with a 60-byte IV. Case 4's ciphertext is case 3's, truncated.
+static const uint8_t gcm_key[16] = {
+    0xFE, 0xFF, 0xE9, 0x92, 0x86, 0x65, 0x73, 0x1C, 0x6D, 0x6A, 0x8F, 0x94, 0x67, 0x30, 0x83, 0x08,
+};
+static const uint8_t gcm_plaintext[64] = {
+    0xD9, 0x31, 0x32, 0x25, 0xF8, 0x84, 0x06, 0xE5, 0xA5, 0x59, 0x09, 0xC5, 0xAF, 0xF5, 0x26, 0x9A,
+    0x86, 0xA7, 0xA9, 0x53, 0x15, 0x34, 0xF7, 0xDA, 0x2E, 0x4C, 0x30, 0x3D, 0x8A, 0x31, 0x8A, 0x72,
+    0x1C, 0x3C, 0x0C, 0x95, 0x95, 0x68, 0x09, 0x53, 0x2F, 0xCF, 0x0E, 0x24, 0x49, 0xA6, 0xB5, 0x25,
+    0xB1, 0x6A, 0xED, 0xF5, 0xAA, 0x0D, 0xE6, 0x57, 0xBA, 0x63, 0x7B, 0x39, 0x1A, 0xAF, 0xD2, 0x55,
+};
+static const uint8_t gcm_iv[12] = {
+    0xCA, 0xFE, 0xBA, 0xBE, 0xFA, 0xCE, 0xDB, 0xAD, 0xDE, 0xCA, 0xF8, 0x88,
+};
+static const uint8_t gcm_aad[20] = {
+    0xFE, 0xED, 0xFA, 0xCE, 0xDE, 0xAD, 0xBE, 0xEF, 0xFE, 0xED, 0xFA, 0xCE, 0xDE, 0xAD, 0xBE, 0xEF,
+    0xAB, 0xAD, 0xDA, 0xD2,
+};
+static const uint8_t gcm_case3_ciphertext[64] = {
+    0x42, 0x83, 0x1E, 0xC2, 0x21, 0x77, 0x74, 0x24, 0x4B, 0x72, 0x21, 0xB7, 0x84, 0xD0, 0xD4, 0x9C,
+    0xE3, 0xAA, 0x21, 0x2F, 0x2C, 0x02, 0xA4, 0xE0, 0x35, 0xC1, 0x7E, 0x23, 0x29, 0xAC, 0xA1, 0x2E,
+    0x21, 0xD5, 0x14, 0xB2, 0x54, 0x66, 0x93, 0x1C, 0x7D, 0x8F, 0x6A, 0x5A, 0xAC, 0x84, 0xAA, 0x05,
+    0x1B, 0xA3, 0x0B, 0x39, 0x6A, 0x0A, 0xAC, 0x97, 0x3D, 0x58, 0xE0, 0x91, 0x47, 0x3F, 0x59, 0x85,
+};
+static const uint8_t gcm_case3_tag[16] = {
+    0x4D, 0x5C, 0x2A, 0xF3, 0x27, 0xCD, 0x64, 0xA6, 0x2C, 0xF3, 0x5A, 0xBD, 0x2B, 0xA6, 0xFA, 0xB4,
+};
+static const uint8_t gcm_case4_tag[16] = {
+    0x5B, 0xC9, 0x4F, 0xBC, 0x32, 0x21, 0xA5, 0xDB, 0x94, 0xFA, 0xE9, 0x5A, 0xE7, 0x12, 0x1A, 0x47,
+};
+static const uint8_t gcm_case6_iv[60] = {
+    0x93, 0x13, 0x22, 0x5D, 0xF8, 0x84, 0x06, 0xE5, 0x55, 0x90, 0x9C, 0x5A, 0xFF, 0x52, 0x69, 0xAA,
+    0x6A, 0x7A, 0x95, 0x38, 0x53, 0x4F, 0x7D, 0xA1, 0xE4, 0xC3, 0x03, 0xD2, 0xA3, 0x18, 0xA7, 0x28,
+    0xC3, 0xC0, 0xC9, 0x51, 0x56, 0x80, 0x95, 0x39, 0xFC, 0xF0, 0xE2, 0x42, 0x9A, 0x6B, 0x52, 0x54,
+    0x16, 0xAE, 0xDB, 0xF5, 0xA0, 0xDE, 0x6A, 0x57, 0xA6, 0x37, 0xB3, 0x9B,
+};
+static const uint8_t gcm_case6_ciphertext[60] = {
+    0x8C, 0xE2, 0x49, 0x98, 0x62, 0x56, 0x15, 0xB6, 0x03, 0xA0, 0x33, 0xAC, 0xA1, 0x3F, 0xB8, 0x94,
+    0xBE, 0x91, 0x12, 0xA5, 0xC3, 0xA2, 0x11, 0xA8, 0xBA, 0x26, 0x2A, 0x3C, 0xCA, 0x7E, 0x2C, 0xA7,
+    0x01, 0xE4, 0xA9, 0xA4, 0xFB, 0xA4, 0x3C, 0x90, 0xCC, 0xDC, 0xB2, 0x81, 0xD4, 0x8C, 0x7C, 0x6F,
+    0xD6, 0x28, 0x75, 0xD2, 0xAC, 0xA4, 0x17, 0x03, 0x4C, 0x34, 0xAE, 0xE5,
+};
+static const uint8_t gcm_case6_tag[16] = {
+    0x61, 0x9C, 0xC5, 0xAE, 0xFF, 0xFE, 0x0B, 0xFA, 0x46, 0x2A, 0xF4, 0x3C, 0x16, 0x99, 0xD0, 0x50,
+};
+
+// Device GCM: several blocks, AAD, a partial final block, a 60-byte IV, and input
+// split unevenly across update calls
+static void check_aes_gcm() {
+    atecc_sim_t *sim = atecc_sim_default();
+    uint8_t saved_key[16];
+    uint8_t output[64];
+    uint8_t tag[AES_GCM_TAG_SIZE];
+    aes_gcm_ctx_t gcm;
+
+    memcpy(saved_key, sim->data[AES_KEY_SLOT], sizeof(saved_key));
+    atecc_sim_write_slot(sim, AES_KEY_SLOT, 0, gcm_key, sizeof(gcm_key));
+
+    // Case 3 in one call each way
+    CHECK(aes_gcm_init(&gcm, AES_KEY_SLOT, gcm_iv, sizeof(gcm_iv)));
+    CHECK(aes_gcm_encrypt_update(&gcm, gcm_plaintext, output, sizeof(gcm_plaintext)));
+    CHECK(aes_gcm_encrypt_finish(&gcm, tag, sizeof(tag)));
+    CHECK(memcmp(output, gcm_case3_ciphertext, sizeof(gcm_case3_ciphertext)) == 0);
+    CHECK(memcmp(tag, gcm_case3_tag, sizeof(tag)) == 0);
+    CHECK(aes_gcm_init(&gcm, AES_KEY_SLOT, gcm_iv, sizeof(gcm_iv)));
+    CHECK(aes_gcm_decrypt_update(&gcm, gcm_case3_ciphertext, output, sizeof(gcm_case3_ciphertext)));
+    CHECK(aes_gcm_decrypt_finish(&gcm, gcm_case3_tag, sizeof(gcm_case3_tag)));
+    CHECK(memcmp(output, gcm_plaintext, sizeof(gcm_plaintext)) == 0);
+
+    // Tags shorter than 12 bytes are refused before the tag is computed; a 12-byte one
+    // is checked against the leading bytes
+    CHECK(aes_gcm_init(&gcm, AES_KEY_SLOT, gcm_iv, sizeof(gcm_iv)));
+    CHECK(aes_gcm_encrypt_update(&gcm, gcm_plaintext, output, sizeof(gcm_plaintext)));
+    CHECK(!aes_gcm_encrypt_finish(&gcm, tag, 1));
+    CHECK(!aes_gcm_encrypt_finish(&gcm, tag, AES_GCM_MIN_TAG_SIZE - 1));
+    CHECK(!aes_gcm_encrypt_finish(&gcm, tag, AES_GCM_TAG_SIZE + 1));
+    CHECK(aes_gcm_encrypt_finish(&gcm, tag, AES_GCM_MIN_TAG_SIZE));
+    CHECK(memcmp(tag, gcm_case3_tag, AES_GCM_MIN_TAG_SIZE) == 0);
+    CHECK(aes_gcm_init(&gcm, AES_KEY_SLOT, gcm_iv, sizeof(gcm_iv)));
+    CHECK(aes_gcm_decrypt_update(&gcm, gcm_case3_ciphertext, output, sizeof(gcm_case3_ciphertext)));
+    CHECK(!aes_gcm_decrypt_finish(&gcm, gcm_case3_tag, 8));
+    CHECK(aes_gcm_decrypt_finish(&gcm, gcm_case3_tag, AES_GCM_MIN_TAG_SIZE));
+
+    // Case 4 with the AAD in two pieces and the data in three, none block-aligned
+    static const size_t pieces[] = { 7, 25, 28 };
+    size_t offset = 0;
+    CHECK(aes_gcm_init(&gcm, AES_KEY_SLOT, gcm_iv, sizeof(gcm_iv)));
+    CHECK(aes_gcm_update_aad(&gcm, gcm_aad, 5));
+    CHECK(aes_gcm_update_aad(&gcm, &gcm_aad[5], sizeof(gcm_aad) - 5));
+    for (size_t i = 0; i < sizeof(pieces) / sizeof(pieces[0]); i++) {
+        CHECK(aes_gcm_encrypt_update(&gcm, &gcm_plaintext[offset], &output[offset], pieces[i]));
+        offset += pieces[i];
+    }
+    CHECK(aes_gcm_encrypt_finish(&gcm, tag, sizeof(tag)));
+    CHECK(offset == 60 && memcmp(output, gcm_case3_ciphertext, offset) == 0);
+    CHECK(memcmp(tag, gcm_case4_tag, sizeof(tag)) == 0);
+
+    // Case 6 decrypted, then rejected with one AAD bit flipped
+    uint8_t aad[sizeof(gcm_aad)];
+    memcpy(aad, gcm_aad, sizeof(aad));
+    CHECK(aes_gcm_init(&gcm, AES_KEY_SLOT, gcm_case6_iv, sizeof(gcm_case6_iv)));
+    CHECK(aes_gcm_update_aad(&gcm, aad, sizeof(aad)));
+    CHECK(aes_gcm_decrypt_update(&gcm, gcm_case6_ciphertext, output, sizeof(gcm_case6_ciphertext)));
+    CHECK(aes_gcm_decrypt_finish(&gcm, gcm_case6_tag, sizeof(gcm_case6_tag)));
+    CHECK(memcmp(output, gcm_plaintext, sizeof(gcm_case6_ciphertext)) == 0);
+    aad[19] ^= 0x01;
+    CHECK(aes_gcm_init(&gcm, AES_KEY_SLOT, gcm_case6_iv, sizeof(gcm_case6_iv)));
+    CHECK(aes_gcm_update_aad(&gcm, aad, sizeof(aad)));
+    CHECK(aes_gcm_decrypt_update(&gcm, gcm_case6_ciphertext, output, sizeof(gcm_case6_ciphertext)));
+    CHECK(!aes_gcm_decrypt_finish(&gcm, gcm_case6_tag, sizeof(gcm_case6_tag)));
+
+    atecc_sim_write_slot(sim, AES_KEY_SLOT, 0, saved_key, sizeof(saved_key));
+}
+
+static void check_aes() {
+    atecc_sim_t *sim = atecc_sim_default();
+    uint8_t block[16];
+    uint8_t iv[16] = { 0 };
+    uint8_t record[80];
+    uint8_t encrypted[96];
+    uint8_t decrypted[96];
+    size_t length;
+
+    CHECK(aes_encrypt(fips_plaintext, block, AES_KEY_SLOT));
+    CHECK(memcmp(block, fips_ciphertext, sizeof(block)) == 0);
+    CHECK(aes_decrypt(fips_ciphertext, block, AES_KEY_SLOT));
+    CHECK(memcmp(block, fips_plaintext, sizeof(block)) == 0);
+
+    // Slot 4 is not an AES key; rejected from the config shadow
+    CHECK(!aes_encrypt(fips_plaintext, block, 4));
+
+    for (size_t i = 0; i < sizeof(record); i++) {
+        record[i] = (uint8_t)i;
+    }
+    CHECK(aes_cbc_encrypt(AES_KEY_SLOT, iv, record, sizeof(record), encrypted, sizeof(encrypted), &length));
+    CHECK(length == 96);
+    CHECK(aes_cbc_decrypt(AES_KEY_SLOT, iv, encrypted, length, decrypted, &length));
+    CHECK(length == sizeof(record) && memcmp(decrypted, record, sizeof(record)) == 0);
+
+    // GCM test case 2 needs the zero key; restore the FIPS key afterwards
+    uint8_t saved_key[16];
+    uint8_t zero[16] = { 0 };
+    uint8_t tag[AES_GCM_TAG_SIZE];
+    aes_gcm_ctx_t gcm;
+    memcpy(saved_key, sim->data[AES_KEY_SLOT], sizeof(saved_key));
+    atecc_sim_write_slot(sim, AES_KEY_SLOT, 0, zero, sizeof(zero));
+
+    CHECK(aes_gcm_init(&gcm, AES_KEY_SLOT, zero, 12));
+    CHECK(aes_gcm_encrypt_update(&gcm, zero, block, sizeof(block)));
+    CHECK(aes_gcm_encrypt_finish(&gcm, tag, sizeof(tag)));
+    CHECK(memcmp(block, gcm_ciphertext, sizeof(block)) == 0);
+    CHECK(memcmp(tag, gcm_tag, sizeof(tag)) == 0);
+
+    CHECK(aes_gcm_init(&gcm, AES_KEY_SLOT, zero, 12));
+    CHECK(aes_gcm_decrypt_update(&gcm, gcm_ciphertext, block, sizeof(block)));
+    tag[0] ^= 0x01;
+    CHECK(!aes_gcm_decrypt_finish(&gcm, tag, sizeof(tag)));
+
+    // The software GCM used by channels agrees with the device
+    sw_aes_ctx_t sw;
+    sw_aes_init(&sw, zero);
+    sw_aes_gcm_encrypt(&sw, zero, NULL, 0, zero, block, sizeof(block), tag);
+    CHECK(memcmp(block, gcm_ciphertext, sizeof(block)) == 0);
+    CHECK(memcmp(tag, gcm_tag, sizeof(tag)) == 0);
+    CHECK(sw_aes_gcm_decrypt(&sw, zero, NULL, 0, gcm_ciphertext, block, sizeof(block), gcm_tag));
+    CHECK(memcmp(block, zero, sizeof(block)) == 0);
+    tag[15] ^= 0x80;
+    CHECK(!sw_aes_gcm_decrypt(&sw, zero, NULL, 0, gcm_ciphertext, block, sizeof(block), tag));
+
+    atecc_sim_write_slot(sim, AES_KEY_SLOT, 0, saved_key, sizeof(saved_key));
+}
+
+static void check_nonce() {
+    uint8_t value[32];
+    uint8_t nonce[32];
+
+    for (size_t i = 0; i < sizeof(value); i++) {
+        value[i] = (uint8_t)(0xC0u + i);
+    }
+    CHECK(nonce_load_tempkey(value));
+    CHECK(memcmp(atecc_sim_default()->tempkey, value, sizeof(value)) == 0);
+    CHECK(send_nonce_command(nonce));
+    CHECK(memcmp(atecc_sim_default()->tempkey, value, sizeof(value)) != 0);
+}
+
+static void check_corrupt_packet() {
+    uint8_t packet[] = { 0x03, 0x07, ATCA_RANDOM, 0x00, 0x00, 0x00, 0x24, 0xCD };
+    uint8_t response[4];
+
+    CHECK(atecc_session_begin());
+    packet[7] ^= 0x01;
+    CHECK(hal_i2c_send(packet, sizeof(packet)) == (int)sizeof(packet));
+    atecc_exec_begin(ATCA_RANDOM);
+    CHECK(atecc_wait_response(response, sizeof(response)));
+    CHECK(response[0] == 4 && response[1] == ATECC_SIM_STATUS_CRC);
+    atecc_session_end();
+}
+
+// A second, unprovisioned device on the same bus: lock its config zone
+static void check_lock() {
+    static atecc_sim_t blank;
+    atecc_device_t device;
+    uint8_t response[4];
+    uint8_t crc[2];
+
+    atecc_sim_init(&blank, I2C_PORT, I2C_ADDR + 1);
+    atecc_sim_set_locks(&blank, false, false);
+    CHECK(atecc_sim_attach(&blank));
+
+    atecc_device_init(&device, I2C_PORT, I2C_ADDR + 1);
+    atecc_device_t *previous = atecc_device_select(&device);
+    CHECK(atecc_session_begin());
+
+    // Random returns the fixed pattern until the config zone is locked
+    uint8_t random[ATECC_RANDOM_BLOCK_SIZE + 3];
+    CHECK(send_atecc_command(ATCA_RANDOM, RANDOM_SEED_UPDATE, 0x0000, NULL, 0));
+    CHECK(atecc_wait_response(random, sizeof(random)));
+    CHECK(random[1] == 0xFF && random[2] == 0xFF && random[3] == 0x00 && random[4] == 0x00);
+
+    calc_crc16_ccitt(CONFIG_ZONE_SIZE, blank.config, crc);
+    uint16_t summary = (uint16_t)(crc[0] | (crc[1] << 8));
+    CHECK(send_atecc_command(ATCA_LOCK, LOCK_ZONE_CONFIG, (uint16_t)(summary ^ 1u), NULL, 0));
+    CHECK(atecc_wait_response(response, sizeof(response)) && response[1] == ATECC_SIM_STATUS_EXECUTION);
+    CHECK(send_atecc_command(ATCA_LOCK, LOCK_ZONE_CONFIG, summary, NULL, 0));
+    CHECK(atecc_wait_response(response, sizeof(response)) && response[1] == ATECC_SIM_STATUS_SUCCESS);
+    CHECK(atecc_config_is_locked() && !atecc_data_is_locked());
+
+    atecc_session_end();
+    atecc_device_select(previous);
+    atecc_sim_detach(&blank);
+}
+
+// The library re-wakes the device once its watchdog has expired
+static void check_watchdog() {
+    uint8_t block[16];
+    uint32_t wakes = atecc_sim_default()->stats.wakes;
+
+    CHECK(aes_encrypt(fips_plaintext, block, AES_KEY_SLOT));
+    atecc_sim_advance_us(ATECC_SIM_WATCHDOG_US + 1000u);
+    CHECK(atecc_sim_default()->power != ATECC_SIM_AWAKE || atecc_power_watchdog_remaining_us() == 0);
+    CHECK(aes_encrypt(fips_plaintext, block, AES_KEY_SLOT));
+    CHECK(memcmp(block, fips_ciphertext, sizeof(block)) == 0);
+    CHECK(atecc_sim_default()->stats.wakes > wakes);
+}
+
+// Negotiation against wiring limits, a wake above 100 kHz, and the runtime downgrade
+static void check_bus() {
+    atecc_sim_t *sim = atecc_sim_default();
+    const atecc_bus_state_t *state = atecc_bus_state(I2C_PORT);
+    uint8_t block[ATCA_BLOCK_SIZE];
+
+    CHECK(atecc_bus_negotiate() == 1000000u && state->negotiated_hz == 1000000u);
+    atecc_sim_advance_us(ATECC_SIM_WATCHDOG_US + 1000u);
+    CHECK(atecc_read_zone(ATCA_ZONE_CONFIG, 0, 0, block, sizeof(block)));
+    CHECK(sim->stats.corrupted == 0);
+
+    sim->max_clock_hz = 400000u;
+    CHECK(atecc_bus_negotiate() == 400000u && atecc_bus_rate(I2C_PORT) == 400000u);
+
+    // Wiring degrades at 1 MHz: the device rejects damaged packets until the bus drops
+    // a step, and the retry engine carries the read through
+    atecc_bus_set_rate(I2C_PORT, 1000000u);
+    uint32_t downgrades = state->downgrades;
+    uint32_t crc_errors = state->crc_errors;
+    CHECK(atecc_read_zone(ATCA_ZONE_CONFIG, 0, 0, block, sizeof(block)));
+    CHECK(state->crc_errors == crc_errors + ATECC_BUS_ERROR_LIMIT);
+    CHECK(state->downgrades == downgrades + 1 && atecc_bus_rate(I2C_PORT) == 400000u);
+
+    sim->max_clock_hz = 0;
+    atecc_bus_set_rate(I2C_PORT, 100000u);
+    atecc_log_drain(SIZE_MAX);
+}
+
+// Status packets and response damage as decoded by the response layer
+static void check_decode() {
+    static const uint8_t codes[] = { 0x01, 0x03, 0x05, 0x07, 0x08, 0x0F, 0x11, 0xEE, 0xFF };
+    uint8_t status[4] = { 0x04, 0x00 };
+    uint8_t response[ATCA_BLOCK_SIZE + 3] = { sizeof(response) };
+
+    compute_crc(2, status, &status[2]);
+    CHECK(atecc_response_decode(status, sizeof(status)) == ATECC_OK);
+    CHECK(atecc_response_decode(status, sizeof(response)) == ATECC_ERR_RESPONSE_LENGTH);
+    for (size_t i = 0; i < sizeof(codes); i++) {
+        status[1] = codes[i];
+        compute_crc(2, status, &status[2]);
+        CHECK(atecc_response_decode(status, sizeof(response)) == (atecc_result_t)codes[i]);
+    }
+    status[1] = 0x42;
+    compute_crc(2, status, &status[2]);
+    CHECK(atecc_response_decode(status, sizeof(response)) == ATECC_ERR_STATUS);
+    status[3] ^= 0x01;
+    CHECK(atecc_response_decode(status, sizeof(response)) == ATECC_ERR_RESPONSE_CRC);
+
+    compute_crc(sizeof(response) - 2, response, &response[sizeof(response) - 2]);
+    CHECK(atecc_response_decode(response, sizeof(response)) == ATECC_OK);
+    CHECK(atecc_response_decode(response, ATCA_WORD_SIZE + 3) == ATECC_ERR_RESPONSE_LENGTH);
+    response[5] ^= 0x01;
+    CHECK(atecc_response_decode(response, sizeof(response)) == ATECC_ERR_RESPONSE_CRC);
+
+    CHECK(atecc_result_is_transient(ATECC_ERR_RESPONSE_CRC, ATECC_EXEC_REPLAYABLE));
+    CHECK(!atecc_result_is_transient(ATECC_ERR_RESPONSE_CRC, 0));
+    CHECK(atecc_result_is_transient(ATECC_ERR_BAD_CRC, 0));
+    CHECK(!atecc_result_is_transient(ATECC_ERR_EXECUTION, ATECC_EXEC_REPLAYABLE));
+}
+
+// Info with the model's execution time set to exec_us: how many reads were NACKed
+// and how long after the send the wait returned
+static bool timed_info(uint32_t exec_us, uint32_t *nacks, uint64_t *elapsed_us) {
+    atecc_sim_t *sim = atecc_sim_default();
+    uint8_t response[ATCA_WORD_SIZE + 3];
+    uint32_t saved = atecc_sim_exec_us(ATCA_INFO);
+
+    atecc_sim_set_exec_us(ATCA_INFO, exec_us);
+    bool sent = atecc_command_send(ATCA_INFO, INFO_MODE_REVISION, 0x0000, NULL, 0) == ATECC_OK;
+    uint64_t start_us = atecc_device_current()->exec.start_us;
+    uint32_t before = sim->stats.nacks;
+    bool received = sent && atecc_wait_response(response, sizeof(response));
+
+    *nacks = sim->stats.nacks - before;
+    *elapsed_us = atecc_sim_now_us() - start_us;
+    atecc_sim_set_exec_us(ATCA_INFO, saved);
+    return received;
+}
+
+// The response wait: first read at the typical time, then one read per poll
+// interval while the device NACKs, and failure once the maximum time has passed
+static void check_exec_wait() {
+    const atecc_exec_time_t *timing = atecc_exec_lookup(ATCA_INFO);
+    uint64_t nack_us = atecc_sim_bus_us(I2C_PORT, 1);
+    uint64_t read_us = atecc_sim_bus_us(I2C_PORT, 1 + ATCA_WORD_SIZE + 3);
+    uint64_t poll_us = ATECC_POLL_INTERVAL_US + nack_us;    // A NACKed read, then the interval
+    uint32_t nacks;
+    uint64_t elapsed_us;
+
+    CHECK(atecc_session_begin());
+
+    // Ready before the typical time: one read, right at it
+    CHECK(timed_info(timing->typical_us / 2, &nacks, &elapsed_us));
+    CHECK(nacks == 0 && elapsed_us == timing->typical_us + read_us);
+
+    // Still busy at the first one to three reads
+    for (uint32_t busy = 1; busy <= 3; busy++) {
+        CHECK(timed_info(timing->typical_us + busy * (uint32_t)poll_us - 1, &nacks, &elapsed_us));
+        CHECK(nacks == busy && elapsed_us == timing->typical_us + busy * poll_us + read_us);
+    }
+
+    // Never ready in time: the last read is at or after the maximum time
+    uint64_t polls = (timing->max_us - timing->typical_us + poll_us - 1) / poll_us + 1;
+    CHECK(!timed_info(timing->max_us + 1000u, &nacks, &elapsed_us));
+    CHECK(nacks == polls && elapsed_us == timing->typical_us + polls * poll_us - ATECC_POLL_INTERVAL_US);
+    CHECK(elapsed_us >= timing->max_us);
+    atecc_sim_advance_us(1000u);
+
+    atecc_session_end();
+}
+
+static void count_completion(atecc_async_t *op, void *user_data) {
+    (void)op;
+    (*(int *)user_data)++;
+}
+
+// Asynchronous commands: completion, busy polling, timeout, and blocking transfers
+// issued while one is in flight
+static void check_async() {
+    atecc_sim_t *sim = atecc_sim_default();
+    const atecc_exec_time_t *timing = atecc_exec_lookup(ATCA_RANDOM);
+    uint32_t saved = atecc_sim_exec_us(ATCA_RANDOM);
+    uint8_t response[ATECC_RANDOM_BLOCK_SIZE + 3];
+    uint8_t other[ATECC_RANDOM_BLOCK_SIZE + 3];
+    uint8_t revision[ATCA_WORD_SIZE + 3];
+    atecc_async_t op = { 0 };
+    int completions = 0;
+
+    CHECK(!atecc_async_busy());
+
+    // Submitting returns at once; the response is read once the device is done
+    uint64_t start_us = atecc_sim_now_us();
+    CHECK(atecc_command_async(&op, ATCA_RANDOM, RANDOM_SEED_UPDATE, 0x0000, NULL, 0, response, sizeof(response),
+                              count_completion, &completions));
+    CHECK(atecc_sim_now_us() - start_us < timing->typical_us);
+    CHECK(atecc_async_busy() && atecc_async_poll(&op) == ATECC_ASYNC_BUSY);
+    CHECK(!atecc_command_async(&op, ATCA_RANDOM, RANDOM_SEED_UPDATE, 0x0000, NULL, 0, other, sizeof(other),
+                               NULL, NULL));
+    CHECK(atecc_async_wait(&op) == ATECC_ASYNC_DONE);
+    CHECK(completions == 1 && response[0] == sizeof(response) && crc_matches(response, sizeof(response)));
+    CHECK(atecc_async_poll(&op) == ATECC_ASYNC_IDLE && completions == 1);
+    CHECK(atecc_device_current()->power.session_depth == 0);
+
+    // Busy past the typical time: NACKed reads until the device is done
+    uint32_t nacks = sim->stats.nacks;
+    atecc_sim_set_exec_us(ATCA_RANDOM, timing->typical_us + 3 * ATECC_POLL_INTERVAL_US);
+    CHECK(atecc_command_async(&op, ATCA_RANDOM, RANDOM_SEED_UPDATE, 0x0000, NULL, 0, response, sizeof(response),
+                              NULL, NULL));
+    CHECK(atecc_async_wait(&op) == ATECC_ASYNC_DONE);
+    CHECK(sim->stats.nacks > nacks && crc_matches(response, sizeof(response)));
+
+    // Never done in time
+    atecc_sim_set_exec_us(ATCA_RANDOM, timing->max_us + 1000u);
+    CHECK(atecc_command_async(&op, ATCA_RANDOM, RANDOM_SEED_UPDATE, 0x0000, NULL, 0, response, sizeof(response),
+                              NULL, NULL));
+    CHECK(atecc_async_wait(&op) == ATECC_ASYNC_FAILED);
+    CHECK(atecc_sim_now_us() - op.start_us >= timing->max_us);
+    atecc_sim_advance_us(1000u);
+    atecc_sim_set_exec_us(ATCA_RANDOM, saved);
+
+    // A device error comes back as a status packet: the command fails, but the bus
+    // counts no CRC error for it
+    const atecc_bus_state_t *bus = atecc_bus_state(atecc_device_current()->bus);
+    uint32_t crc_errors = bus->crc_errors;
+    uint8_t signature[ECC_P256_SIG_SIZE + 3];
+    CHECK(atecc_command_async(&op, ATCA_SIGN, ATCA_SIGN_MODE_EXTERNAL, AES_KEY_SLOT, NULL, 0, signature,
+                              sizeof(signature), NULL, NULL));
+    CHECK(atecc_async_wait(&op) == ATECC_ASYNC_FAILED);
+    CHECK(signature[0] == 4 && signature[1] != ATECC_OK && bus->crc_errors == crc_errors);
+
+    // A blocking read issued once the device has finished must not take the
+    // response of the command in flight
+    CHECK(atecc_session_begin());
+    CHECK(atecc_command_async(&op, ATCA_RANDOM, RANDOM_SEED_UPDATE, 0x0000, NULL, 0, response, sizeof(response),
+                              NULL, NULL));
+    atecc_sim_advance_us(saved);
+    hal_i2c_receive(other, sizeof(other));
+    CHECK(op.state == ATECC_ASYNC_DONE && crc_matches(response, sizeof(response)));
+    CHECK(atecc_async_poll(&op) == ATECC_ASYNC_DONE);
+
+    // A blocking command waits for the one in flight
+    CHECK(atecc_command_async(&op, ATCA_RANDOM, RANDOM_SEED_UPDATE, 0x0000, NULL, 0, response, sizeof(response),
+                              NULL, NULL));
+    CHECK(atecc_execute(ATCA_INFO, INFO_MODE_REVISION, 0x0000, NULL, 0, revision, sizeof(revision),
+                        ATECC_EXEC_REPLAYABLE) == ATECC_OK && revision[3] == 0x60);
+    CHECK(op.state == ATECC_ASYNC_DONE && crc_matches(response, sizeof(response)));
+    CHECK(atecc_async_poll(&op) == ATECC_ASYNC_DONE);
+    atecc_session_end();
+
+    // The pool refills in the background without waiting for the device
+    uint8_t drain[ATECC_RANDOM_POOL_SIZE];
+    CHECK(random_pool_init(ATECC_RANDOM_BLOCK_SIZE, false));
+    CHECK(get_random_bytes(drain, random_pool_available()) && random_pool_available() == 0);
+    start_us = atecc_sim_now_us();
+    CHECK(random_pool_service() && atecc_async_busy());
+    CHECK(atecc_sim_now_us() - start_us < timing->typical_us && random_pool_available() == 0);
+    hal_i2c_wait_idle();
+    CHECK(random_pool_service() && random_pool_available() == ATECC_RANDOM_BLOCK_SIZE);
+    hal_i2c_wait_idle();
+    CHECK(random_pool_service() && random_pool_available() == 2 * ATECC_RANDOM_BLOCK_SIZE);
+    CHECK(!atecc_async_busy());
+}
+
+// Whether the log holds a retry of opcode after result
+static bool retry_logged(uint8_t opcode, atecc_result_t result) {
+    atecc_log_record_t record;
+    bool found = false;
+    while (atecc_log_pop(&record)) {
+        found = found || (record.event == ATECC_EV_COMMAND_RETRY && record.opcode == opcode &&
+                          record.args[0] == (uint32_t)result);
+    }
+    return found;
+}
+
+// Recovery from a device whose watchdog runs out early and one that fell asleep
+static void check_retry() {
+    atecc_sim_t *sim = atecc_sim_default();
+    uint8_t response[ATECC_RANDOM_BLOCK_SIZE + 3];
+    uint8_t block[ATCA_BLOCK_SIZE];
+
+    atecc_log_drain(SIZE_MAX);
+    CHECK(atecc_session_begin());
+
+    // Left with less watchdog time than Random needs, but enough to read the status
+    uint32_t wakes = sim->stats.wakes;
+    sim->wake_us = atecc_sim_now_us() + 2100u - ATECC_SIM_WATCHDOG_US;
+    CHECK(atecc_execute(ATCA_RANDOM, RANDOM_SEED_UPDATE, 0x0000, NULL, 0, response, sizeof(response),
+                        ATECC_EXEC_REPLAYABLE) == ATECC_OK);
+    CHECK(sim->stats.wakes == wakes + 1);
+#if ATECC_LOG_LEVEL >= ATECC_LOG_LEVEL_WARN
+    CHECK(retry_logged(ATCA_RANDOM, ATECC_ERR_WATCHDOG));
+#endif
+
+    // Asleep although the host still counts it awake: the packet is NACKed
+    sim->power = ATECC_SIM_SLEEP;
+    CHECK(atecc_read_zone(ATCA_ZONE_CONFIG, 0, 0, block, sizeof(block)));
+    CHECK(sim->stats.wakes == wakes + 2);
+#if ATECC_LOG_LEVEL >= ATECC_LOG_LEVEL_WARN
+    CHECK(retry_logged(ATCA_READ, ATECC_ERR_NACK));
+#endif
+
+    atecc_session_end();
+}
+
+// Two devices in a pool: the pick policies, batches spread over both, a batch one
+// device fails, and the power policy applied to every device
+static void check_pool() {
+    static atecc_sim_t second_sim;
+    static atecc_device_t second;
+    atecc_sim_t *sim = atecc_sim_default();
+    atecc_device_t *first = atecc_device_default();
+    uint8_t input[POOL_BLOCKS * AES_BLOCK_SIZE];
+    uint8_t output[POOL_BLOCKS * AES_BLOCK_SIZE];
+    uint8_t random[3 * ATECC_RANDOM_BLOCK_SIZE + 5];
+    uint8_t response[ATECC_RANDOM_BLOCK_SIZE + 3];
+    atecc_pool_t pool;
+
+    atecc_sim_init(&second_sim, I2C_PORT, POOL_ADDRESS);
+    CHECK(atecc_sim_attach(&second_sim));
+    atecc_device_init(&second, I2C_PORT, POOL_ADDRESS);
+    for (size_t i = 0; i < POOL_BLOCKS; i++) {
+        memcpy(&input[i * AES_BLOCK_SIZE], fips_plaintext, AES_BLOCK_SIZE);
+    }
+
+    // Round robin takes turns
+    atecc_pool_init(&pool, ATECC_POOL_ROUND_ROBIN);
+    CHECK(atecc_pool_pick(&pool) == NULL);
+    CHECK(atecc_pool_add(&pool, first) && atecc_pool_add(&pool, &second));
+    CHECK(atecc_pool_pick(&pool) == first);
+    CHECK(atecc_pool_pick(&pool) == &second);
+    CHECK(atecc_pool_pick(&pool) == first);
+
+    // Batches reach both devices, which execute at the same time; on a shared bus only
+    // the execution times overlap
+    uint32_t first_commands = sim->stats.commands;
+    uint32_t second_commands = second_sim.stats.commands;
+    CHECK(atecc_pool_random(&pool, random, sizeof(random)));
+    CHECK(sim->stats.commands - first_commands == 2 && second_sim.stats.commands - second_commands == 2);
+
+    uint64_t start_us = atecc_sim_now_us();
+    CHECK(aes_ecb_encrypt(AES_KEY_SLOT, input, output, sizeof(output)));
+    uint64_t single_us = atecc_sim_now_us() - start_us;
+    memset(output, 0, sizeof(output));
+    start_us = atecc_sim_now_us();
+    CHECK(atecc_pool_aes_ecb_encrypt(&pool, AES_KEY_SLOT, input, output, sizeof(output)));
+    CHECK(atecc_sim_now_us() - start_us < single_us);
+    for (size_t i = 0; i < POOL_BLOCKS; i++) {
+        CHECK(memcmp(&output[i * AES_BLOCK_SIZE], fips_ciphertext, AES_BLOCK_SIZE) == 0);
+    }
+    CHECK(atecc_pool_aes_ecb_decrypt(&pool, AES_KEY_SLOT, output, output, sizeof(output)));
+    CHECK(memcmp(output, input, sizeof(output)) == 0);
+    CHECK(atecc_device_current() == first);
+
+    // Only the selected device idles on its own; the pool idles both
+    atecc_sim_advance_us(first->power.policy.idle_after_us);
+    atecc_power_poll();
+    CHECK(sim->power == ATECC_SIM_IDLE && second_sim.power == ATECC_SIM_AWAKE);
+    atecc_pool_power_poll(&pool);
+    CHECK(second_sim.power == ATECC_SIM_IDLE && atecc_device_current() == first);
+
+    // Least busy skips a device still executing a command
+    atecc_pool_init(&pool, ATECC_POOL_LEAST_BUSY);
+    CHECK(atecc_pool_add(&pool, first) && atecc_pool_add(&pool, &second));
+    CHECK(atecc_session_begin());
+    CHECK(send_atecc_command(ATCA_RANDOM, RANDOM_SEED_UPDATE, 0x0000, NULL, 0));
+    CHECK(atecc_pool_pick(&pool) == &second);
+    CHECK(atecc_pool_pick(&pool) == &second);
+    CHECK(atecc_wait_response(response, sizeof(response)) && crc_matches(response, sizeof(response)));
+    atecc_session_end();
+    CHECK(atecc_pool_pick(&pool) == first);
+    CHECK(atecc_pool_pick(&pool) == &second);
+
+    // AES disabled on the device that goes first in each round: the batch fails, the
+    // other device's response is collected, and both are left without a session
+    second_sim.config[ATECC_CFG_AES_ENABLE] = 0x00;
+    atecc_pool_init(&pool, ATECC_POOL_ROUND_ROBIN);
+    CHECK(atecc_pool_add(&pool, &second) && atecc_pool_add(&pool, first));
+    first_commands = sim->stats.commands;
+    CHECK(!atecc_pool_aes_ecb_encrypt(&pool, AES_KEY_SLOT, input, output, sizeof(output)));
+    CHECK(sim->stats.commands - first_commands == 1);
+    CHECK(first->power.session_depth == 0 && second.power.session_depth == 0);
+    CHECK(!first->exec.outstanding && atecc_device_current() == first);
+    CHECK(aes_ecb_encrypt(AES_KEY_SLOT, input, output, AES_BLOCK_SIZE));
+    CHECK(memcmp(output, fips_ciphertext, AES_BLOCK_SIZE) == 0);
+
+    atecc_sim_detach(&second_sim);
+}
+
+// Digest source for the batch checks: SHA-256 of the index, stopping at *user_data
+static bool index_digest(size_t index, uint8_t *digest, void *user_data) {
+    uint8_t message[4] = { (uint8_t)index, 0x5A, 0xA5, 0x00 };
+    sw_sha256_ctx_t ctx;
+
+    if (index >= *(const size_t *)user_data) {
+        return false;
+    }
+    sw_sha256_init(&ctx);
+    sw_sha256_update(&ctx, message, sizeof(message));
+    sw_sha256_final(&ctx, digest);
+    return true;
+}
+
+// GenKey, Sign and Verify against RFC 6979 and the software curve
+static void check_ecc() {
+    atecc_sim_t *sim = atecc_sim_default();
+    uint8_t digest[ECC_DIGEST_SIZE];
+    uint8_t public_key[ECC_P256_KEY_SIZE];
+    uint8_t signature[ECC_P256_SIG_SIZE];
+    uint8_t stored[72] = { 0 };
+    sw_sha256_ctx_t ctx;
+    bool valid = false;
+
+    sw_sha256_init(&ctx);
+    sw_sha256_update(&ctx, (const uint8_t *)"sample", 6);
+    sw_sha256_final(&ctx, digest);
+
+    // Known key: public key mode, external and stored Verify
+    atecc_sim_write_slot(sim, ECC_FIXED_SLOT, ATECC_SIM_PRIVATE_KEY_OFFSET, rfc6979_private, sizeof(rfc6979_private));
+    CHECK(ecc_get_public_key(ECC_FIXED_SLOT, public_key));
+    CHECK(memcmp(public_key, rfc6979_public, sizeof(public_key)) == 0);
+    CHECK(ecc_verify_extern(digest, rfc6979_signature, rfc6979_public, &valid) && valid);
+    memcpy(signature, rfc6979_signature, sizeof(signature));
+    signature[40] ^= 0x01;
+    CHECK(ecc_verify_extern(digest, signature, rfc6979_public, &valid) && !valid);
+
+    memcpy(&stored[4], rfc6979_public, 32);
+    memcpy(&stored[40], &rfc6979_public[32], 32);
+    atecc_sim_write_slot(sim, ATECC_SIM_PUBLIC_KEY_SLOT, 0, stored, sizeof(stored));
+    CHECK(ecc_verify_stored(digest, rfc6979_signature, ATECC_SIM_PUBLIC_KEY_SLOT, &valid) && valid);
+    CHECK(!ecc_verify_stored(digest, rfc6979_signature, ECC_FIXED_SLOT, &valid));
+
+    // A fresh key signs what the software curve and the device both accept
+    CHECK(ecc_genkey(ECC_GENKEY_SLOT, public_key));
+    CHECK(ecc_sign_digest(ECC_GENKEY_SLOT, digest, signature));
+    CHECK(sim_p256_verify(public_key, digest, signature));
+    CHECK(ecc_verify_extern(digest, signature, public_key, &valid) && valid);
+    CHECK(!ecc_sign_digest(AES_KEY_SLOT, digest, signature));
+
+    // Batch signing, in full and stopped early by the source
+    uint8_t digests[ECC_BATCH_SIZE][ECC_DIGEST_SIZE];
+    uint8_t signatures[ECC_BATCH_SIZE][ECC_P256_SIG_SIZE];
+    size_t limit = ECC_BATCH_SIZE;
+    for (size_t i = 0; i < ECC_BATCH_SIZE; i++) {
+        index_digest(i, digests[i], &limit);
+    }
+    CHECK(ecc_sign_digests(ECC_GENKEY_SLOT, &digests[0][0], ECC_BATCH_SIZE, &signatures[0][0]) == ECC_BATCH_SIZE);
+    for (size_t i = 0; i < ECC_BATCH_SIZE; i++) {
+        CHECK(sim_p256_verify(public_key, digests[i], signatures[i]));
+    }
+    limit = 2;
+    memset(signatures, 0, sizeof(signatures));
+    CHECK(ecc_sign_batch(ECC_GENKEY_SLOT, ECC_BATCH_SIZE, index_digest, &limit, &signatures[0][0]) == 2);
+    CHECK(sim_p256_verify(public_key, digests[1], signatures[1]));
+
+    // A device asleep mid-batch loses TempKey; the signature is redone
+    limit = ECC_BATCH_SIZE;
+    uint32_t wakes = sim->stats.wakes;
+    sim->power = ATECC_SIM_SLEEP;
+    CHECK(ecc_sign_batch(ECC_GENKEY_SLOT, ECC_BATCH_SIZE, index_digest, &limit, &signatures[0][0]) == ECC_BATCH_SIZE);
+    CHECK(sim->stats.wakes > wakes);
+    for (size_t i = 0; i < ECC_BATCH_SIZE; i++) {
+        CHECK(sim_p256_verify(public_key, digests[i], signatures[i]));
+    }
+    atecc_log_drain(SIZE_MAX);
+}
+
+// Print the simulated time of count runs of op and the resulting rate
+// The peer of the checks: a software key pair and the secret it shares with slot 0
+static const uint8_t peer_private[32] = {
+    0x51, 0x9B, 0x42, 0x3D, 0x71, 0x5F, 0x8B, 0x58, 0x1F, 0x4F, 0xA8, 0xEE, 0x59, 0xF4, 0x77, 0x1A,
+    0x5B, 0x44, 0xC8, 0x13, 0x0B, 0x4E, 0x3E, 0xAC, 0xCA, 0x54, 0xA5, 0x6D, 0xDA, 0x72, 0xB4, 0x64,
+};
+static const uint8_t io_key[ATECC_IO_KEY_SIZE] = {
+    0x10, 0x32, 0x54, 0x76, 0x98, 0xBA, 0xDC, 0xFE, 0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF,
+    0xF0, 0xE1, 0xD2, 0xC3, 0xB4, 0xA5, 0x96, 0x87, 0x78, 0x69, 0x5A, 0x4B, 0x3C, 0x2D, 0x1E, 0x0F,
+};
+static const uint8_t channel_info[] = "pico_atecc channel v1";
+
+// What the peer derives in software for an epoch: HKDF-Extract, then one Expand block
+static void peer_keys(const uint8_t *shared, uint32_t epoch, uint8_t *okm) {
+    static const uint8_t zero_salt[32];
+    uint8_t prk[32];
+    uint8_t info[sizeof(channel_info) + 5];
+
+    sw_hmac_sha256(zero_salt, sizeof(zero_salt), shared, 32, prk);
+    memcpy(info, channel_info, sizeof(channel_info));
+    for (int i = 0; i < 4; i++) {
+        info[sizeof(channel_info) + i] = (uint8_t)(epoch >> (24 - 8 * i));
+    }
+    info[sizeof(channel_info) + 4] = 0x01;
+    sw_hmac_sha256(prk, sizeof(prk), info, sizeof(info), okm);
+}
+
+// Opens a message sealed by the channel with the peer's copy of the keys
+static bool peer_open(const uint8_t *shared, const uint8_t *header, const uint8_t *sealed, size_t length,
+                      const uint8_t *tag, uint8_t *plaintext) {
+    uint32_t epoch = ((uint32_t)header[0] << 24) | ((uint32_t)header[1] << 16) | ((uint32_t)header[2] << 8) | header[3];
+    uint8_t okm[32];
+    uint8_t iv[SW_AES_GCM_IV_SIZE];
+    sw_aes_ctx_t aes;
+
+    peer_keys(shared, epoch, okm);
+    sw_aes_init(&aes, okm);
+    memcpy(iv, &okm[16], 4);
+    memcpy(&iv[4], &header[4], 8);
+    return sw_aes_gcm_decrypt(&aes, iv, header, ATECC_CHANNEL_HEADER_SIZE, sealed, plaintext, length, tag);
+}
+
+// Seals a message for the channel as the responder would at an epoch
+static void peer_seal(const uint8_t *shared, uint32_t epoch, uint64_t sequence, const uint8_t *plaintext,
+                      uint8_t *sealed, size_t length, uint8_t *header, uint8_t *tag) {
+    uint8_t okm[32];
+    uint8_t iv[SW_AES_GCM_IV_SIZE];
+    sw_aes_ctx_t aes;
+
+    for (int i = 0; i < 4; i++) {
+        header[i] = (uint8_t)(epoch >> (24 - 8 * i));
+    }
+    for (int i = 0; i < 8; i++) {
+        header[4 + i] = (uint8_t)(sequence >> (56 - 8 * i));
+    }
+    peer_keys(shared, epoch, okm);
+    sw_aes_init(&aes, okm);
+    memcpy(iv, &okm[20], 4);
+    memcpy(&iv[4], &header[4], 8);
+    sw_aes_gcm_encrypt(&aes, iv, header, ATECC_CHANNEL_HEADER_SIZE, plaintext, sealed, length, tag);
+}
+
+// KDF packets as CryptoAuthLib encodes them, count byte to details: op-code 0x56,
+// mode HKDF (0x40) from TempKey, key id 0, then the details word little-endian.
+// Extract writes TempKey, with the message in TempKey (KDF_DETAILS_HKDF_MSG_LOC_TEMPKEY,
+// 0x1), a zero key (0x4) and 32 message bytes.
+static const uint8_t hkdf_extract_packet[] = { 0x0B, 0x56, 0x40, 0x00, 0x00, 0x05, 0x00, 0x00, 0x20 };
+
+static void check_kdf() {
+    atecc_sim_t *sim = atecc_sim_default();
+    static const uint8_t zero_salt[32];
+    uint8_t peer_public[ECC_P256_KEY_SIZE];
+    uint8_t expected[ECC_SHARED_SECRET_SIZE];
+    uint8_t secret[ECC_SHARED_SECRET_SIZE];
+    uint8_t prk[32];
+    uint8_t okm[KDF_OUTPUT_MAX];
+    uint8_t reference[KDF_OUTPUT_MAX];
+
+    // Slot 0 holds the RFC 6979 key since check_ecc()
+    CHECK(sim_p256_public_key(peer_private, peer_public));
+    CHECK(sim_p256_ecdh(peer_private, rfc6979_public, expected));
+    atecc_sim_write_slot(sim, ATECC_SIM_IO_KEY_SLOT, 0, io_key, sizeof(io_key));
+
+    CHECK(ecc_ecdh(ECC_FIXED_SLOT, peer_public, secret));
+    CHECK(memcmp(secret, expected, sizeof(secret)) == 0);
+    memset(secret, 0, sizeof(secret));
+    CHECK(ecc_ecdh_encrypted(ECC_FIXED_SLOT, peer_public, io_key, secret));
+    CHECK(memcmp(secret, expected, sizeof(secret)) == 0);
+    CHECK(!ecc_ecdh(AES_KEY_SLOT, peer_public, secret));
+    CHECK(!ecc_ecdh_to_slot(ECC_FIXED_SLOT, peer_public));     // SlotConfig does not allow it
+
+    // ECDH into TempKey, HKDF-Extract in place, then Expand and PRF from the result
+    CHECK(atecc_session_begin());
+    CHECK(ecc_ecdh_to_tempkey(ECC_FIXED_SLOT, peer_public));
+    CHECK(sim->tempkey_valid && memcmp(sim->tempkey, expected, sizeof(expected)) == 0);
+    CHECK(kdf_hkdf_extract_tempkey());
+    sw_hmac_sha256(zero_salt, sizeof(zero_salt), expected, sizeof(expected), prk);
+    CHECK(memcmp(sim->tempkey, prk, sizeof(prk)) == 0);
+    CHECK(sim->packet_length == sizeof(hkdf_extract_packet) + 2 &&
+          memcmp(sim->packet, hkdf_extract_packet, sizeof(hkdf_extract_packet)) == 0 &&
+          crc_matches(sim->packet, sim->packet_length));
+
+    uint8_t info[sizeof(channel_info) + 1];
+    memcpy(info, channel_info, sizeof(channel_info));
+    info[sizeof(channel_info)] = 0x01;
+    sw_hmac_sha256(prk, sizeof(prk), info, sizeof(info), reference);
+    CHECK(kdf_hkdf_expand(channel_info, sizeof(channel_info), NULL, okm));
+    CHECK(memcmp(okm, reference, 32) == 0);
+    // Expand returns its output in clear (mode 0x50); the message follows the details
+    // (KDF_DETAILS_HKDF_MSG_LOC_INPUT, 0x2)
+    const uint8_t expand_head[] = {
+        (uint8_t)(sizeof(hkdf_extract_packet) + sizeof(info) + 2), 0x56, 0x50, 0x00, 0x00,
+        0x02, 0x00, 0x00, (uint8_t)sizeof(info),
+    };
+    CHECK(sim->packet_length == sizeof(expand_head) + sizeof(info) + 2 &&
+          memcmp(sim->packet, expand_head, sizeof(expand_head)) == 0 &&
+          memcmp(&sim->packet[sizeof(expand_head)], info, sizeof(info)) == 0);
+    memset(okm, 0, sizeof(okm));
+    CHECK(kdf_hkdf_expand(channel_info, sizeof(channel_info), io_key, okm));
+    CHECK(memcmp(okm, reference, 32) == 0);
+
+    // TLS 1.2 P_SHA256 over two blocks
+    static const uint8_t label_seed[] = "master secret client random server random";
+    uint8_t a[32];
+    uint8_t buffer[32 + sizeof(label_seed)];
+    sw_hmac_sha256(prk, sizeof(prk), label_seed, sizeof(label_seed), a);
+    for (size_t offset = 0; offset < 64; offset += 32) {
+        memcpy(buffer, a, sizeof(a));
+        memcpy(&buffer[32], label_seed, sizeof(label_seed));
+        sw_hmac_sha256(prk, sizeof(prk), buffer, sizeof(buffer), &reference[offset]);
+        sw_hmac_sha256(prk, sizeof(prk), a, sizeof(a), a);
+    }
+    CHECK(kdf_prf(label_seed, sizeof(label_seed), okm, 64));
+    CHECK(memcmp(okm, reference, 64) == 0);
+    CHECK(!kdf_prf(label_seed, sizeof(label_seed), okm, 48));
+    atecc_session_end();
+    atecc_log_drain(SIZE_MAX);
+}
+
+static void check_channel() {
+    uint8_t peer_public[ECC_P256_KEY_SIZE];
+    uint8_t shared[ECC_SHARED_SECRET_SIZE];
+    uint8_t message[CHANNEL_MESSAGE];
+    uint8_t sealed[CHANNEL_MESSAGE];
+    uint8_t opened[CHANNEL_MESSAGE];
+    uint8_t header[ATECC_CHANNEL_HEADER_SIZE];
+    uint8_t tag[ATECC_CHANNEL_TAG_SIZE];
+    atecc_rekey_policy_t policy = { .max_bytes = 2 * CHANNEL_MESSAGE, .max_age_us = 2000000u };
+    atecc_channel_t channel;
+
+    CHECK(sim_p256_public_key(peer_private, peer_public));
+    CHECK(sim_p256_ecdh(peer_private, rfc6979_public, shared));
+    for (size_t i = 0; i < sizeof(message); i++) {
+        message[i] = (uint8_t)(i * 7);
+    }
+
+    // Two messages fit the byte budget, the third goes out under the next key
+    CHECK(atecc_channel_open(&channel, ECC_FIXED_SLOT, peer_public, channel_info, sizeof(channel_info), true,
+                             &policy, io_key));
+    for (uint32_t i = 0; i < 3; i++) {
+        CHECK(atecc_channel_seal(&channel, NULL, 0, message, sealed, sizeof(message), header, tag));
+        CHECK(peer_open(shared, header, sealed, sizeof(sealed), tag, opened));
+        CHECK(memcmp(opened, message, sizeof(message)) == 0);
+    }
+    CHECK(channel.epoch == 1 && channel.sequence == 1 && header[3] == 1 && header[11] == 0);
+    sealed[0] ^= 0x01;
+    CHECK(!peer_open(shared, header, sealed, sizeof(sealed), tag, opened));
+
+    // An old key is replaced after max_age_us
+    atecc_sim_advance_us(policy.max_age_us);
+    CHECK(atecc_channel_needs_rekey(&channel, 1));
+    CHECK(atecc_channel_seal(&channel, NULL, 0, message, sealed, 16, header, tag));
+    CHECK(channel.epoch == 2 && channel.rekeys == 2);
+    CHECK(peer_open(shared, header, sealed, 16, tag, opened));
+
+    // The responder's messages open; a later epoch is followed, an earlier one refused
+    peer_seal(shared, 2, 0, message, sealed, sizeof(message), header, tag);
+    CHECK(atecc_channel_unseal(&channel, header, NULL, 0, sealed, opened, sizeof(opened), tag));
+    CHECK(memcmp(opened, message, sizeof(message)) == 0);
+    peer_seal(shared, 4, 0, message, sealed, sizeof(message), header, tag);
+    CHECK(atecc_channel_unseal(&channel, header, NULL, 0, sealed, opened, sizeof(opened), tag));
+    CHECK(channel.epoch == 4);
+    peer_seal(shared, 3, 1, message, sealed, sizeof(message), header, tag);
+    CHECK(!atecc_channel_unseal(&channel, header, NULL, 0, sealed, opened, sizeof(opened), tag));
+
+    // Within an epoch a sequence number opens once, and only after the last one opened
+    peer_seal(shared, 4, 0, message, sealed, sizeof(message), header, tag);
+    CHECK(!atecc_channel_unseal(&channel, header, NULL, 0, sealed, opened, sizeof(opened), tag));
+    peer_seal(shared, 4, 5, message, sealed, sizeof(message), header, tag);
+    CHECK(atecc_channel_unseal(&channel, header, NULL, 0, sealed, opened, sizeof(opened), tag));
+    CHECK(!atecc_channel_unseal(&channel, header, NULL, 0, sealed, opened, sizeof(opened), tag));
+    peer_seal(shared, 4, 3, message, sealed, sizeof(message), header, tag);
+    CHECK(!atecc_channel_unseal(&channel, header, NULL, 0, sealed, opened, sizeof(opened), tag));
+
+    // A later epoch whose message does not authenticate leaves the key alone
+    CHECK(atecc_channel_seal(&channel, NULL, 0, message, sealed, 16, header, tag));
+    uint64_t sequence = channel.sequence;
+    peer_seal(shared, 5, 0, message, sealed, sizeof(message), header, tag);
+    tag[0] ^= 0x01;
+    CHECK(!atecc_channel_unseal(&channel, header, NULL, 0, sealed, opened, sizeof(opened), tag));
+    CHECK(channel.epoch == 4 && channel.sequence == sequence && channel.rekeys == 3);
+    peer_seal(shared, 4, 6, message, sealed, sizeof(message), header, tag);
+    CHECK(atecc_channel_unseal(&channel, header, NULL, 0, sealed, opened, sizeof(opened), tag));
+
+    // The peer may run at most ATECC_CHANNEL_EPOCH_SKIP_MAX epochs ahead
+    peer_seal(shared, 4 + ATECC_CHANNEL_EPOCH_SKIP_MAX + 1, 0, message, sealed, sizeof(message), header, tag);
+    CHECK(!atecc_channel_unseal(&channel, header, NULL, 0, sealed, opened, sizeof(opened), tag));
+    CHECK(channel.epoch == 4);
+    peer_seal(shared, 4 + ATECC_CHANNEL_EPOCH_SKIP_MAX, 7, message, sealed, sizeof(message), header, tag);
+    CHECK(atecc_channel_unseal(&channel, header, NULL, 0, sealed, opened, sizeof(opened), tag));
+    CHECK(channel.epoch == 4 + ATECC_CHANNEL_EPOCH_SKIP_MAX && channel.sequence == 0);
+    CHECK(!atecc_channel_unseal(&channel, header, NULL, 0, sealed, opened, sizeof(opened), tag));
+    atecc_channel_close(&channel);
+    CHECK(!atecc_channel_seal(&channel, NULL, 0, message, sealed, sizeof(message), header, tag));
+    atecc_log_drain(SIZE_MAX);
+}
+
+static void check_counter() {
+    atecc_sim_t *sim = atecc_sim_default();
+    counter_reservation_t reservation;
+    uint64_t sequence = 0;
+    uint64_t last = 0;
+    uint32_t value = 0;
+
+    CHECK(counter_read(0, &value) && value == 0);
+    CHECK(counter_increment(0, &value) && value == 1);
+    CHECK(counter_read(0, &value) && value == 1);
+    CHECK(counter_read(1, &value) && value == 0);
+    CHECK(!counter_read(ATECC_COUNTER_COUNT, &value));
+
+    // One increment per block; the numbers of a block come from RAM
+    uint32_t commands = sim->stats.commands;
+    CHECK(counter_reserve_init(&reservation, 0, COUNTER_BLOCK));
+    for (size_t i = 0; i < COUNTER_BLOCK + 1; i++) {
+        CHECK(counter_reserve_next(&reservation, &sequence));
+        CHECK(i == 0 || sequence > last);
+        last = sequence;
+    }
+    CHECK(reservation.blocks == 2 && sim->stats.commands - commands == 2);
+    CHECK(sequence == 3 * COUNTER_BLOCK);
+
+    // After a reset the rest of the block is skipped, not reused
+    CHECK(counter_reserve_init(&reservation, 0, COUNTER_BLOCK));
+    CHECK(counter_reserve_next(&reservation, &sequence) && sequence > last);
+
+    // A counter at its limit refuses to move
+    sim->counters[1] = ATECC_COUNTER_MAX;
+    CHECK(!counter_increment(1, &value));
+    CHECK(counter_read(1, &value) && value == ATECC_COUNTER_MAX);
+    sim->counters[1] = 0;
+    atecc_log_drain(SIZE_MAX);
+}
+
+static void check_data() {
+    atecc_sim_t *sim = atecc_sim_default();
+    static uint8_t blob[416];
+    static uint8_t readback[416];
+    uint8_t key[ATECC_DATA_KEY_SIZE];
+    uint8_t block[64];
+
+    for (size_t i = 0; i < sizeof(blob); i++) {
+        blob[i] = (uint8_t)(i * 31u + 7u);
+    }
+    CHECK(data_slot_size(0) == 36 && data_slot_size(8) == 416 && data_slot_size(15) == 72);
+
+    // Slot 8 in whole blocks: one command per 32 bytes each way
+    uint32_t commands = sim->stats.commands;
+    CHECK(data_write(8, 0, blob, sizeof(blob)));
+    CHECK(sim->stats.commands - commands == 13);
+    CHECK(memcmp(sim->data[8], blob, sizeof(blob)) == 0);
+    commands = sim->stats.commands;
+    CHECK(data_read(8, 0, readback, sizeof(readback)));
+    CHECK(sim->stats.commands - commands == 13);
+    CHECK(memcmp(readback, blob, sizeof(blob)) == 0);
+
+    // Words around the blocks; unaligned reads, aligned writes only
+    CHECK(data_write(8, 20, &blob[100], 48));
+    CHECK(memcmp(&sim->data[8][20], &blob[100], 48) == 0);
+    CHECK(data_read(8, 5, readback, 50));
+    CHECK(memcmp(readback, &sim->data[8][5], 50) == 0);
+    CHECK(!data_write(8, 2, blob, 4));
+    CHECK(!data_read(8, 400, readback, 32));
+    CHECK(!data_write(ECC_FIXED_SLOT, 0, blob, 4));     // GenKey only
+    CHECK(data_read(15, 64, readback, 8) && memcmp(readback, &sim->data[15][64], 8) == 0);
+
+    // The OTP zone reads back; with the data zone locked it no longer takes writes
+    CHECK(otp_read(0, readback, OTP_ZONE_SIZE) && memcmp(readback, sim->otp, OTP_ZONE_SIZE) == 0);
+    CHECK(!otp_write(0, blob, ATCA_BLOCK_SIZE));
+
+    // Encrypted slot: refused in clear, readable and writable with its key
+    for (size_t i = 0; i < sizeof(key); i++) {
+        key[i] = (uint8_t)(0xC0u + i);
+    }
+    atecc_sim_write_slot(sim, ATECC_SIM_DATA_KEY_SLOT, 0, key, sizeof(key));
+    atecc_sim_write_slot(sim, ATECC_SIM_ENCRYPTED_SLOT, 0, &blob[200], sizeof(block));
+    CHECK(!data_read(ATECC_SIM_ENCRYPTED_SLOT, 0, block, 4));
+    CHECK(!data_write(ATECC_SIM_ENCRYPTED_SLOT, 0, blob, 4));
+    CHECK(data_read_encrypted(ATECC_SIM_ENCRYPTED_SLOT, 0, key, block, sizeof(block)));
+    CHECK(memcmp(block, &blob[200], sizeof(block)) == 0);
+    CHECK(data_write_encrypted(ATECC_SIM_ENCRYPTED_SLOT, 32, key, blob, 32));
+    CHECK(memcmp(&sim->data[ATECC_SIM_ENCRYPTED_SLOT][32], blob, 32) == 0);
+    CHECK(!data_read_encrypted(ATECC_SIM_ENCRYPTED_SLOT, 4, key, block, 32));
+
+    // A wrong key fails the MAC check and decrypts to noise
+    key[0] ^= 0x01;
+    CHECK(!data_write_encrypted(ATECC_SIM_ENCRYPTED_SLOT, 0, key, blob, 32));
+    CHECK(memcmp(sim->data[ATECC_SIM_ENCRYPTED_SLOT], &blob[200], 32) == 0);
+    CHECK(data_read_encrypted(ATECC_SIM_ENCRYPTED_SLOT, 0, key, block, 32));
+    CHECK(memcmp(block, &blob[200], 32) != 0);
+    atecc_log_drain(SIZE_MAX);
+}
+
+static void check_rpc() {
+    static const uint8_t message[] = "pipelined";
+    static uint8_t stream[2 * ATECC_RPC_MAX_FRAME];
+    static uint8_t burst[4 * ATECC_RPC_MAX_FRAME];
+    static uint8_t digests[16][SHA256_DIGEST_SIZE];
+    static atecc_rpc_frame_t frame;
+    atecc_rpc_transport_t transport;
+    atecc_rpc_client_t client;
+    atecc_rpc_parser_t parser;
+    atecc_rpc_call_t calls[20];
+    uint8_t inputs[16];
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    uint8_t expected[SHA256_DIGEST_SIZE];
+    uint8_t public_key[ECC_P256_KEY_SIZE];
+    uint8_t signature[ECC_P256_SIG_SIZE];
+    uint8_t block[16];
+    uint8_t random[600];
+    uint8_t echo[sizeof(message)];
+    sw_sha256_ctx_t ctx;
+    bool complete;
+    bool valid = false;
+
+    // Noise and a stray sync byte, a frame with a bad CRC, then a good frame in two feeds
+    size_t length = 0;
+    stream[length++] = 0x00;
+    stream[length++] = ATECC_RPC_SYNC;
+    size_t corrupted = length;
+    length += atecc_rpc_encode(ATECC_RPC_PING, 0, ATECC_RPC_OK, 7, message, sizeof(message), &stream[length]);
+    stream[corrupted + ATECC_RPC_HEADER_SIZE] ^= 0x01;
+    length += atecc_rpc_encode(ATECC_RPC_SHA256, 3, ATECC_RPC_OK, 8, message, sizeof(message), &stream[length]);
+    atecc_rpc_parser_init(&parser);
+    size_t consumed = atecc_rpc_parse(&parser, stream, 5, &frame, &complete);
+    CHECK(consumed == 5 && !complete);
+    consumed += atecc_rpc_parse(&parser, &stream[5], length - 5, &frame, &complete);
+    CHECK(complete && consumed == length);
+    CHECK(frame.opcode == ATECC_RPC_SHA256 && frame.param == 3 && frame.id == 8);
+    CHECK(frame.length == sizeof(message) && memcmp(frame.payload, message, sizeof(message)) == 0);
+    CHECK(parser.crc_errors == 1 && parser.dropped_bytes == corrupted + (length - corrupted) / 2);
+    CHECK(atecc_rpc_encode(ATECC_RPC_PING, 0, ATECC_RPC_OK, 0, stream, ATECC_RPC_MAX_PAYLOAD + 1, stream) == 0);
+
+    // A corrupted frame whose payload holds a whole shorter frame: after the resync the
+    // buffer holds more than that frame, which still decodes, and so do the frames after
+    // it. Fed in small pieces, then drained without new bytes.
+    uint8_t payload[100];
+    memset(payload, 0x11, sizeof(payload));
+    atecc_rpc_encode(ATECC_RPC_PING, 0, ATECC_RPC_OK, 9, NULL, 0, payload);
+    length = atecc_rpc_encode(ATECC_RPC_PING, 0, ATECC_RPC_OK, 7, payload, sizeof(payload), burst);
+    burst[length - ATECC_RPC_CRC_SIZE - 1] ^= 0x01;
+    for (uint16_t id = 0; id < RPC_BURST_FRAMES; id++) {
+        length += atecc_rpc_encode(ATECC_RPC_PING, 0, ATECC_RPC_OK, (uint16_t)(100 + id), message, sizeof(message),
+                                   &burst[length]);
+    }
+    atecc_rpc_parser_init(&parser);
+    uint16_t frames = 0;
+    bool in_order = true;
+    complete = false;
+    for (size_t offset = 0; offset < length || complete;) {
+        size_t piece = length - offset < 7 ? length - offset : 7;
+        offset += atecc_rpc_parse(&parser, &burst[offset], piece, &frame, &complete);
+        if (complete) {
+            in_order &= frame.id == (frames == 0 ? 9 : 99 + frames) &&
+                        frame.length == (frames == 0 ? 0 : sizeof(message));
+            frames++;
+        }
+    }
+    CHECK(frames == RPC_BURST_FRAMES + 1 && in_order);
+    CHECK(parser.crc_errors == 1 && parser.filled == 0);
+
+    atecc_rpc_loopback_init(&transport);
+    atecc_rpc_client_init(&client, &transport);
+
+    // One request at a time
+    sw_sha256_init(&ctx);
+    sw_sha256_update(&ctx, message, sizeof(message));
+    sw_sha256_final(&ctx, expected);
+    CHECK(atecc_rpc_random(&client, random, sizeof(random)));
+    CHECK(atecc_rpc_sha256(&client, message, sizeof(message), digest));
+    CHECK(memcmp(digest, expected, sizeof(digest)) == 0);
+    CHECK(atecc_rpc_aes_encrypt(&client, AES_KEY_SLOT, fips_plaintext, block, sizeof(block)));
+    CHECK(memcmp(block, fips_ciphertext, sizeof(block)) == 0);
+    CHECK(atecc_rpc_aes_decrypt(&client, AES_KEY_SLOT, fips_ciphertext, block, sizeof(block)));
+    CHECK(memcmp(block, fips_plaintext, sizeof(block)) == 0);
+    CHECK(ecc_get_public_key(ECC_FIXED_SLOT, public_key));
+    CHECK(atecc_rpc_sign(&client, ECC_FIXED_SLOT, digest, signature));
+    CHECK(ecc_verify_extern(digest, signature, public_key, &valid) && valid);
+    CHECK(!atecc_rpc_sign(&client, AES_KEY_SLOT, digest, signature));
+
+    // Line noise between requests is skipped; the stray sync byte makes a header that
+    // fails its CRC before the parser finds the real one
+    CHECK(transport.write((const uint8_t *)"\x5A\xA5\x00", 3, NULL) == 3);
+    CHECK(atecc_rpc_sha256(&client, message, sizeof(message), digest));
+
+    // A batch with twice as many outstanding as the device takes: it stops reading
+    // until responses go out, and every request is still answered once
+    for (size_t i = 0; i < 16; i++) {
+        inputs[i] = (uint8_t)i;
+        calls[i] = (atecc_rpc_call_t){ ATECC_RPC_SHA256, 0, &inputs[i], 1, digests[i], SHA256_DIGEST_SIZE, 0, false };
+    }
+    calls[16] = (atecc_rpc_call_t){ ATECC_RPC_PING, 0, message, sizeof(message), echo, sizeof(echo), 0, false };
+    calls[17] = (atecc_rpc_call_t){ 0x7F, 0, NULL, 0, NULL, 0, 0, false };
+    calls[18] = (atecc_rpc_call_t){ ATECC_RPC_AES_ENCRYPT, AES_KEY_SLOT, fips_plaintext, 15, block, sizeof(block), 0, false };
+    calls[19] = (atecc_rpc_call_t){ ATECC_RPC_SIGN, AES_KEY_SLOT, expected, 32, signature, sizeof(signature), 0, false };
+    CHECK(atecc_rpc_client_run(&client, calls, 20, 2 * ATECC_RPC_MAX_IN_FLIGHT) == 20);
+    for (size_t i = 0; i < 16; i++) {
+        sw_sha256_init(&ctx);
+        sw_sha256_update(&ctx, &inputs[i], 1);
+        sw_sha256_final(&ctx, expected);
+        CHECK(calls[i].status == ATECC_RPC_OK && memcmp(digests[i], expected, sizeof(expected)) == 0);
+    }
+    CHECK(calls[16].status == ATECC_RPC_OK && memcmp(echo, message, sizeof(message)) == 0);
+    CHECK(calls[17].status == ATECC_RPC_ERR_OPCODE);
+    CHECK(calls[18].status == ATECC_RPC_ERR_LENGTH);
+    CHECK(calls[19].status == ATECC_RPC_ERR_FAILED);
+
+    const atecc_rpc_server_t *server = atecc_rpc_loopback_server();
+    CHECK(server->requests == 28 && server->errors == 4 && server->busy == 0);
+    CHECK(server->parser.crc_errors == 1 && server->parser.dropped_bytes == 3);
+    atecc_log_drain(SIZE_MAX);
+}
+
+static void measure(const char *name, size_t count, size_t bytes_per_op, bool (*op)()) {
+    bool ok = true;
+    uint64_t start = time_us_64();
+    for (size_t i = 0; ok && i < count; i++) {
+        ok = op();
+    }
+    uint64_t elapsed = time_us_64() - start;
+    CHECK(ok);
+
+    double per_op = (double)elapsed / (double)count;
+    printf("⏱️ %-14s %8.1f µs/op %9.1f ops/s", name, per_op, per_op > 0 ? 1e6 / per_op : 0.0);
+    if (bytes_per_op > 0) {
+        printf(" %9.1f bytes/s", per_op > 0 ? bytes_per_op * 1e6 / per_op : 0.0);
+    }
+    printf("\n");
+}
+
+static bool op_read_block() {
+    uint8_t block[ATCA_BLOCK_SIZE];
+    return atecc_read_zone(ATCA_ZONE_CONFIG, 0, 0, block, sizeof(block));
+}
+
+static bool op_random() {
+    uint8_t response[ATECC_RANDOM_BLOCK_SIZE + 3];
+    return send_atecc_command(ATCA_RANDOM, RANDOM_SEED_UPDATE, 0x0000, NULL, 0) &&
+           atecc_wait_response(response, sizeof(response));
+}
+
+static bool op_aes_block() {
+    uint8_t block[16];
+    return aes_encrypt(fips_plaintext, block, AES_KEY_SLOT);
+}
+
+static bool op_sha_1k() {
+    static uint8_t message[1024];
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    sha256_ctx_t ctx;
+    return sha256_start(&ctx, SHA256_ENGINE_ATECC, false) && sha256_update(&ctx, message, sizeof(message)) &&
+           sha256_final(&ctx, digest);
+}
+
+// Digest source that spends host time on each message, as hashing it on the MCU would
+static bool timed_digest(size_t index, uint8_t *digest, void *user_data) {
+    (void)user_data;
+    atecc_sim_advance_us(ECC_HOST_HASH_US);
+    memset(digest, (int)index + 1, ECC_DIGEST_SIZE);
+    return true;
+}
+
+// Signatures per second, one at a time after hashing each message and batched with
+// the hashing overlapped
+static void report_sign_rate() {
+    static uint8_t signatures[ECC_RATE_COUNT][ECC_P256_SIG_SIZE];
+    uint8_t digest[ECC_DIGEST_SIZE];
+    bool ok = true;
+
+    uint64_t start = time_us_64();
+    for (size_t i = 0; ok && i < ECC_RATE_COUNT; i++) {
+        timed_digest(i, digest, NULL);
+        ok = ecc_sign_digest(ECC_GENKEY_SLOT, digest, signatures[i]);
+    }
+    uint64_t single_us = time_us_64() - start;
+    CHECK(ok);
+
+    start = time_us_64();
+    CHECK(ecc_sign_batch(ECC_GENKEY_SLOT, ECC_RATE_COUNT, timed_digest, NULL, &signatures[0][0]) == ECC_RATE_COUNT);
+    uint64_t batch_us = time_us_64() - start;
+
+    printf("⏱️ ECDSA sign (%u µs host hash each): %.2f sig/s one at a time, %.2f sig/s batched\n",
+           ECC_HOST_HASH_US, ECC_RATE_COUNT * 1e6 / (double)single_us, ECC_RATE_COUNT * 1e6 / (double)batch_us);
+}
+
+// Sequence numbers per second from an increment each and from reserved blocks
+static void report_counter_rate() {
+    counter_reservation_t reservation;
+    uint64_t sequence;
+    uint32_t value;
+    bool ok = true;
+
+    CHECK(atecc_session_begin());
+    uint64_t start = time_us_64();
+    for (size_t i = 0; ok && i < COUNTER_RATE_COUNT; i++) {
+        ok = counter_increment(1, &value);
+    }
+    uint64_t single_us = time_us_64() - start;
+    CHECK(ok);
+
+    start = time_us_64();
+    ok = counter_reserve_init(&reservation, 1, COUNTER_RATE_BLOCK);
+    for (size_t i = 0; ok && i < COUNTER_RATE_COUNT; i++) {
+        ok = counter_reserve_next(&reservation, &sequence);
+    }
+    uint64_t reserved_us = time_us_64() - start;
+    CHECK(ok);
+    atecc_session_end();
+
+    printf("⏱️ Counter: %.1f numbers/s incrementing, %.1f numbers/s in blocks of %u (%lu increments)\n",
+           COUNTER_RATE_COUNT * 1e6 / (double)single_us, COUNTER_RATE_COUNT * 1e6 / (double)reserved_us,
+           COUNTER_RATE_BLOCK, (unsigned long)reservation.blocks);
+}
+
+// Switch to the clock under test and restart the watchdog, so a whole measurement
+// fits in one watchdog window
+static void restart_watchdog_at(uint32_t clock) {
+    atecc_bus_set_rate(I2C_PORT, clock);
+    CHECK(atecc_power_ensure_awake(ATECC_WATCHDOG_US - ATECC_WATCHDOG_MARGIN_US));
+}
+
+static void report_latency() {
+    static const uint32_t clocks[] = { 100000u, 400000u, 1000000u };
+
+    atecc_stats_reset();
+    CHECK(atecc_session_begin());
+    for (size_t i = 0; i < sizeof(clocks) / sizeof(clocks[0]); i++) {
+        printf("📈 I2C at %lu kHz\n", (unsigned long)(clocks[i] / 1000u));
+
+        restart_watchdog_at(clocks[i]);
+        measure("Read 32 bytes", 64, ATCA_BLOCK_SIZE, op_read_block);
+        restart_watchdog_at(clocks[i]);
+        measure("Random", 64, ATECC_RANDOM_BLOCK_SIZE, op_random);
+        restart_watchdog_at(clocks[i]);
+        measure("AES block", 64, AES_BLOCK_SIZE, op_aes_block);
+        restart_watchdog_at(clocks[i]);
+        measure("SHA-256 1 KiB", 4, 1024, op_sha_1k);
+    }
+    atecc_session_end();
+    report_sign_rate();
+    report_counter_rate();
+    atecc_bus_set_rate(I2C_PORT, 100000u);
+
+    const atecc_sim_stats_t *stats = &atecc_sim_default()->stats;
+    printf("📊 %lu commands, %lu NACKs, %lu wakes, %lu CRC errors, %llu µs on the bus, %llu µs executing\n",
+           (unsigned long)stats->commands, (unsigned long)stats->nacks, (unsigned long)stats->wakes,
+           (unsigned long)stats->crc_errors, (unsigned long long)stats->bus_us,
+           (unsigned long long)stats->exec_us);
+}
+
+// Library counters against what the latency run issued, and CRC error attribution
+static void check_stats() {
+#if ATECC_STATS
+    const size_t reads = 3 * 64;
+    const atecc_opcode_stats_t *read = atecc_stats_opcode(ATCA_READ);
+    CHECK(read != NULL);
+    if (read == NULL) {
+        return;
+    }
+
+    uint32_t histogram = 0;
+    for (size_t b = 0; b < ATECC_STATS_HIST_BUCKETS; b++) {
+        histogram += read->latency_hist[b];
+    }
+    CHECK(read->calls == reads && read->failures == 0 && histogram == reads);
+    CHECK(read->bytes_sent == reads * ATECC_PACKET_OVERHEAD);
+    CHECK(read->bytes_received == reads * (ATCA_BLOCK_SIZE + 3));
+    CHECK(read->bus_us > 0 && read->busy_us > 0 && read->wait_us > 0);
+    CHECK(atecc_stats_opcode(ATCA_AES) != NULL && atecc_stats_opcode(ATCA_AES)->calls == 3 * 64);
+    CHECK(atecc_stats_opcode(ATCA_CHECKMAC) == NULL);
+
+    uint8_t response[ATECC_RANDOM_BLOCK_SIZE + 3];
+    CHECK(send_atecc_command(ATCA_RANDOM, RANDOM_SEED_UPDATE, 0x0000, NULL, 0));
+    CHECK(atecc_wait_response(response, sizeof(response)));
+    uint32_t crc_errors = atecc_stats_opcode(ATCA_RANDOM)->crc_errors;
+    response[1] ^= 0x01;
+    CHECK(!validate_crc(response, sizeof(response)));
+    CHECK(atecc_stats_opcode(ATCA_RANDOM)->crc_errors == crc_errors + 1);
+
+    atecc_stats_dump();
+#endif
+}
+
+int main() {
+    i2c_init(I2C_PORT, 100 * 1000);
+
+    check_zones();
+    check_log();
+    check_random();
+    check_sha256();
+    check_sha256_dispatch();
+    check_aes();
+    check_aes_modes();
+    check_aes_gcm();
+    check_nonce();
+    check_corrupt_packet();
+    check_lock();
+    check_watchdog();
+    check_bus();
+    check_decode();
+    check_exec_wait();
+    check_async();
+    check_retry();
+    check_pool();
+    check_ecc();
+    check_kdf();
+    check_channel();
+    check_counter();
+    check_data();
+    check_rpc();
+    report_latency();
+    check_stats();
+    atecc_log_drain(SIZE_MAX);
+
+    if (failures) {
+        printf("❌ %d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("🎉 All simulator checks passed\n");
+    return 0;
+}
@@ -0,0 +1,247 @@
+#include "hal_pico_i2c.h"
+#include "atecc_bus.h"
+#include "atecc_cmd.h"
+#include "atecc_config.h"
+#include "atecc_device.h"
+#include "atecc_exec.h"
+#include "atecc_power.h"
+#include "atecc_response.h"
+#include "atecc_sim.h"
+
+// Host transport: transfers go straight to the ATECC608 model addressed by the
+// selected device, and take simulated bus time instead of DMA. Without interrupts,
+// an asynchronous command makes progress whenever it is polled or waited on.
+
+// Asynchronous command currently owning the device
+static atecc_async_t *active;
+
+/**
+ * @brief Accepted for API compatibility; the host has no transfer interrupt.
+ *
+ * @param[in] enabled Ignored.
+ */
+void hal_i2c_irq_enable(bool enabled) {
+    (void)enabled;
+}
+
+/**
+ * @brief Sends data over the simulated I2C bus.
+ *
+ * Completes any asynchronous command first, as the Pico transport does.
+ *
+ * @param[in] txdata   The bytes to send.
+ * @param[in] txlength The number of bytes to send.
+ *
+ * @return the number of bytes written, or PICO_ERROR_GENERIC on a NACK.
+ */
+int hal_i2c_send(uint8_t *txdata, size_t txlength) {
+    atecc_device_t *device = atecc_device_current();
+    hal_i2c_wait_idle();
+    return atecc_sim_i2c_write(device->bus, device->address, txdata, txlength);
+}
+
+/**
+ * @brief Receives data over the simulated I2C bus.
+ *
+ * Completes any asynchronous command first, as the Pico transport does. A busy
+ * or sleeping device NACKs, so failures are expected while polling.
+ *
+ * @param[out] rxdata   Pointer to the buffer where received data will be stored.
+ * @param[in]  rxlength The length of the data to be received.
+ *
+ * @return the number of bytes read, or -1 on failure.
+ */
+int hal_i2c_receive(uint8_t *rxdata, size_t rxlength) {
+    atecc_device_t *device = atecc_device_current();
+    hal_i2c_wait_idle();
+    return atecc_sim_i2c_read(device->bus, device->address, rxdata, rxlength) < 0 ? -1 : (int)rxlength;
+}
+
+static void async_finish(atecc_async_state_t state) {
+    atecc_async_t *op = active;
+    active = NULL;
+    op->state = state;
+    if (op->callback) {
+        op->callback(op, op->user_data);
+    }
+}
+
+// Poll the active command once if its typical execution time has passed
+static void async_step() {
+    atecc_async_t *op = active;
+    if (op == NULL || time_us_64() - op->start_us < op->timing->typical_us) {
+        return;
+    }
+
+    ATECC_STATS_POLL_BEGIN(&op->stats);
+    bool received = atecc_sim_i2c_read(op->device->bus, op->device->address, op->response, op->response_length) >= 0;
+    ATECC_STATS_POLL_END(&op->stats);
+    if (!received) {
+        if (time_us_64() - op->start_us >= op->timing->max_us) {
+            atecc_bus_note_timeout(op->device->bus);
+            ATECC_STATS_DONE(&op->stats, op->opcode, op->start_us, op->response_length, false);
+            async_finish(ATECC_ASYNC_FAILED);
+        }
+        return;
+    }
+
+    atecc_bus_note_response(op->device->bus, op->response, op->response_length);
+    ATECC_STATS_DONE(&op->stats, op->opcode, op->start_us, op->response_length, true);
+    // A status packet is checked over its own 4 bytes, so a device error is not
+    // taken for a bus CRC error
+    atecc_result_t result = atecc_response_decode(op->response, op->response_length);
+    if (result == ATECC_ERR_RESPONSE_CRC) {
+        atecc_bus_note_crc_error(op->device->bus);
+        ATECC_STATS_CRC_ERROR(op->opcode);
+    }
+    async_finish(result == ATECC_OK ? ATECC_ASYNC_DONE : ATECC_ASYNC_FAILED);
+}
+
+// Let simulated time pass until the next poll of the active command is due
+static void async_sleep() {
+    uint64_t due = active->start_us + active->timing->typical_us;
+    uint64_t now = time_us_64();
+    uint64_t delay = now < due ? due - now : ATECC_POLL_INTERVAL_US;
+    sleep_us(delay);
+    ATECC_STATS_WAIT(&active->stats, delay);
+}
+
+/**
+ * @brief Runs the active asynchronous command to completion.
+ */
+void hal_i2c_wait_idle() {
+    while (active != NULL) {
+        async_step();
+        if (active != NULL) {
+            async_sleep();
+        }
+    }
+}
+
+/**
+ * @brief Submits a command without waiting for it to execute.
+ *
+ * Same contract as the Pico transport. The packet is delivered immediately; the
+ * response is read by atecc_async_poll() or atecc_async_wait() once the device
+ * has finished, and the callback runs from there.
+ *
+ * @param[out] op              Caller-owned command state, zero-initialised before first use.
+ * @param[in]  opcode          The command op-code.
+ * @param[in]  param1          The first parameter.
+ * @param[in]  param2          The second parameter.
+ * @param[in]  data            The command data.
+ * @param[in]  data_len        The length of the data.
+ * @param[out] response        Buffer for the raw response, count byte and CRC included.
+ * @param[in]  response_length The expected response length.
+ * @param[in]  callback        Called on completion, or NULL.
+ * @param[in]  user_data       Passed to the callback.
+ *
+ * @return true if the command was submitted, false if another command is in flight or the device did not wake.
+ */
+bool atecc_command_async(atecc_async_t *op, uint8_t opcode, uint8_t param1, uint16_t param2,
+                         const uint8_t *data, size_t data_len, uint8_t *response, size_t response_length,
+                         atecc_async_callback_t callback, void *user_data) {
+    if (active != NULL || ATECC_PACKET_OVERHEAD + data_len > ATECC_I2C_MAX_TRANSFER ||
+        response_length < 4 || response_length > ATECC_I2C_MAX_TRANSFER) {
+        return false;
+    }
+
+    // A finished but unretired command still holds its power session
+    atecc_async_poll(op);
+
+    op->device = atecc_device_current();
+    atecc_bus_service(op->device->bus);
+    op->timing = atecc_exec_lookup(opcode);
+    op->opcode = opcode;
+    if (!atecc_session_begin()) {
+        return false;
+    }
+    if (!atecc_power_ensure_awake(op->timing->max_us)) {
+        atecc_session_end();
+        return false;
+    }
+
+    atecc_fragment_t fragment = { data, data_len };
+    size_t length = atecc_packet_build(op->device->packet, sizeof(op->device->packet), opcode, param1, param2,
+                                       &fragment, data_len > 0 ? 1 : 0);
+
+    ATECC_STATS_SUBMIT(&op->stats);
+    if (length == 0) {
+        atecc_session_end();
+        return false;
+    }
+    if (hal_i2c_send(op->device->packet, length) < 0) {
+        atecc_bus_note_timeout(op->device->bus);
+        ATECC_STATS_SEND_FAILED(opcode);
+        atecc_session_end();
+        return false;
+    }
+
+    op->response = response;
+    op->response_length = response_length;
+    op->callback = callback;
+    op->user_data = user_data;
+    op->in_session = true;
+    op->start_us = time_us_64();
+    ATECC_STATS_SENT(&op->stats, opcode, length, op->start_us);
+    op->state = ATECC_ASYNC_BUSY;
+    active = op;
+
+    atecc_config_note_command(opcode, param1);
+    return true;
+}
+
+/**
+ * @brief Checks an asynchronous command and retires it once it has finished.
+ *
+ * Returns ATECC_ASYNC_DONE or ATECC_ASYNC_FAILED exactly once; later calls return
+ * ATECC_ASYNC_IDLE.
+ *
+ * @param[in,out] op The command state.
+ *
+ * @return the command state.
+ */
+atecc_async_state_t atecc_async_poll(atecc_async_t *op) {
+    if (op == active) {
+        async_step();
+    }
+
+    atecc_async_state_t state = op->state;
+    if (state == ATECC_ASYNC_DONE || state == ATECC_ASYNC_FAILED) {
+        op->state = ATECC_ASYNC_IDLE;
+        if (op->in_session) {
+            atecc_device_t *previous = atecc_device_select(op->device);
+            op->in_session = false;
+            atecc_session_end();
+            atecc_device_select(previous);
+        }
+    }
+    return state;
+}
+
+/**
+ * @brief Lets simulated time pass until an asynchronous command has finished, then retires it.
+ *
+ * @param[in,out] op The command state.
+ *
+ * @return ATECC_ASYNC_DONE, ATECC_ASYNC_FAILED, or ATECC_ASYNC_IDLE if nothing was pending.
+ */
+atecc_async_state_t atecc_async_wait(atecc_async_t *op) {
+    while (op == active) {
+        async_step();
+        if (op == active) {
+            async_sleep();
+        }
+    }
+    return atecc_async_poll(op);
+}
+
+/**
+ * @brief Reports whether an asynchronous command is in flight.
+ *
+ * @return true while a command is executing on the device.
+ */
+bool atecc_async_busy() {
+    async_step();
+    return active != NULL;
+}
@@ -0,0 +1,25 @@
+#ifndef ATECC_HOST_HARDWARE_I2C_H
+#define ATECC_HOST_HARDWARE_I2C_H
+
+// Host stand-in for the Pico SDK's hardware/i2c.h. A bus only carries the clock
+// the simulator uses to account for transfer time.
+
+#include "pico/stdlib.h"
+
+typedef struct i2c_inst {
+    uint8_t index;
+    uint32_t baudrate;      // SCL frequency in Hz, 0 until i2c_init()
+} i2c_inst_t;
+
+extern i2c_inst_t i2c0_inst;
+extern i2c_inst_t i2c1_inst;
+
+#define i2c0 (&i2c0_inst)
+#define i2c1 (&i2c1_inst)
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+uint i2c_set_baudrate(i2c_inst_t *i2c, uint baudrate);
+
+static inline uint i2c_hw_index(i2c_inst_t *i2c) { return i2c->index; }
+
+#endif // ATECC_HOST_HARDWARE_I2C_H
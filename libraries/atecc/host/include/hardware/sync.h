@@ -0,0 +1,18 @@
+#ifndef ATECC_HOST_HARDWARE_SYNC_H
+#define ATECC_HOST_HARDWARE_SYNC_H
+
+// Host stand-in for the Pico SDK's hardware/sync.h. The host has no interrupts. The
+// barrier is a full fence, as atecc_service_check runs core1 as a thread (see
+// pico/multicore.h); waiting for an event yields to it.
+
+#include <sched.h>
+#include <stdint.h>
+
+static inline void __dmb() { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __sev() {}
+static inline void __wfe() { sched_yield(); }
+
+static inline uint32_t save_and_disable_interrupts() { return 0; }
+static inline void restore_interrupts(uint32_t status) { (void)status; }
+
+#endif // ATECC_HOST_HARDWARE_SYNC_H
@@ -0,0 +1,27 @@
+#ifndef ATECC_HOST_PICO_MULTICORE_H
+#define ATECC_HOST_PICO_MULTICORE_H
+
+// Host stand-in for the Pico SDK's pico/multicore.h: core1 is a thread. Only
+// atecc_service_check launches it; once it runs, core0 must leave the library and
+// the model to it, as on the device.
+
+#include <pthread.h>
+#include <stddef.h>
+
+static void (*multicore_core1_entry)();
+
+static void *multicore_core1_main(void *arg) {
+    (void)arg;
+    multicore_core1_entry();
+    return NULL;
+}
+
+static inline void multicore_launch_core1(void (*entry)()) {
+    pthread_t thread;
+
+    multicore_core1_entry = entry;
+    pthread_create(&thread, NULL, multicore_core1_main, NULL);
+    pthread_detach(thread);
+}
+
+#endif // ATECC_HOST_PICO_MULTICORE_H
@@ -0,0 +1,29 @@
+#ifndef ATECC_HOST_PICO_STDLIB_H
+#define ATECC_HOST_PICO_STDLIB_H
+
+// Host stand-in for the Pico SDK's pico/stdlib.h. Time is the simulated clock of
+// the ATECC608 model (see atecc_sim.h), so sleeping costs no wall-clock time.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+typedef unsigned int uint;
+
+#define PICO_OK             0
+#define PICO_ERROR_GENERIC  (-1)
+
+typedef uint64_t absolute_time_t;
+
+uint64_t time_us_64();
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+bool best_effort_wfe_or_timeout(absolute_time_t timeout);
+
+static inline absolute_time_t make_timeout_time_us(uint64_t us) { return time_us_64() + us; }
+
+// The host runs everything on one "core"
+static inline uint get_core_num() { return 0; }
+
+#endif // ATECC_HOST_PICO_STDLIB_H
@@ -0,0 +1,543 @@
+#include "sim_p256.h"
+
+#include <string.h>
+
+// 256-bit unsigned integer, least significant word first
+typedef struct {
+    uint32_t v[8];
+} u256_t;
+
+// Montgomery arithmetic modulo m, with R = 2^256
+typedef struct {
+    u256_t m;
+    u256_t r2;          // R^2 mod m, to enter the Montgomery domain
+    u256_t one;         // R mod m
+    uint32_t m0inv;     // -m^-1 mod 2^32
+} mont_t;
+
+// Jacobian point with Montgomery coordinates; Z = 0 is the point at infinity
+typedef struct {
+    u256_t x;
+    u256_t y;
+    u256_t z;
+} point_t;
+
+static const uint8_t p_bytes[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+static const uint8_t n_bytes[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xBC, 0xE6, 0xFA, 0xAD, 0xA7, 0x17, 0x9E, 0x84, 0xF3, 0xB9, 0xCA, 0xC2, 0xFC, 0x63, 0x25, 0x51,
+};
+static const uint8_t b_bytes[32] = {
+    0x5A, 0xC6, 0x35, 0xD8, 0xAA, 0x3A, 0x93, 0xE7, 0xB3, 0xEB, 0xBD, 0x55, 0x76, 0x98, 0x86, 0xBC,
+    0x65, 0x1D, 0x06, 0xB0, 0xCC, 0x53, 0xB0, 0xF6, 0x3B, 0xCE, 0x3C, 0x3E, 0x27, 0xD2, 0x60, 0x4B,
+};
+static const uint8_t gx_bytes[32] = {
+    0x6B, 0x17, 0xD1, 0xF2, 0xE1, 0x2C, 0x42, 0x47, 0xF8, 0xBC, 0xE6, 0xE5, 0x63, 0xA4, 0x40, 0xF2,
+    0x77, 0x03, 0x7D, 0x81, 0x2D, 0xEB, 0x33, 0xA0, 0xF4, 0xA1, 0x39, 0x45, 0xD8, 0x98, 0xC2, 0x96,
+};
+static const uint8_t gy_bytes[32] = {
+    0x4F, 0xE3, 0x42, 0xE2, 0xFE, 0x1A, 0x7F, 0x9B, 0x8E, 0xE7, 0xEB, 0x4A, 0x7C, 0x0F, 0x9E, 0x16,
+    0x2B, 0xCE, 0x33, 0x57, 0x6B, 0x31, 0x5E, 0xCE, 0xCB, 0xB6, 0x40, 0x68, 0x37, 0xBF, 0x51, 0xF5,
+};
+
+static bool initialized;
+static mont_t fp;       // Field arithmetic
+static mont_t fn;       // Scalar arithmetic, modulo the group order
+static u256_t curve_b;  // Montgomery form
+static point_t base;
+
+static void u256_from_be(u256_t *r, const uint8_t *bytes) {
+    for (size_t i = 0; i < 8; i++) {
+        const uint8_t *w = &bytes[28 - 4 * i];
+        r->v[i] = ((uint32_t)w[0] << 24) | ((uint32_t)w[1] << 16) | ((uint32_t)w[2] << 8) | w[3];
+    }
+}
+
+static void u256_to_be(uint8_t *bytes, const u256_t *a) {
+    for (size_t i = 0; i < 8; i++) {
+        uint8_t *w = &bytes[28 - 4 * i];
+        w[0] = (uint8_t)(a->v[i] >> 24);
+        w[1] = (uint8_t)(a->v[i] >> 16);
+        w[2] = (uint8_t)(a->v[i] >> 8);
+        w[3] = (uint8_t)a->v[i];
+    }
+}
+
+static void u256_set_word(u256_t *r, uint32_t value) {
+    memset(r, 0, sizeof(*r));
+    r->v[0] = value;
+}
+
+static int u256_cmp(const u256_t *a, const u256_t *b) {
+    for (int i = 7; i >= 0; i--) {
+        if (a->v[i] != b->v[i]) {
+            return a->v[i] < b->v[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+static bool u256_is_zero(const u256_t *a) {
+    uint32_t any = 0;
+    for (size_t i = 0; i < 8; i++) {
+        any |= a->v[i];
+    }
+    return any == 0;
+}
+
+static bool u256_bit(const u256_t *a, size_t bit) {
+    return (a->v[bit / 32] >> (bit % 32)) & 1u;
+}
+
+static uint32_t u256_add(u256_t *r, const u256_t *a, const u256_t *b) {
+    uint64_t carry = 0;
+    for (size_t i = 0; i < 8; i++) {
+        carry += (uint64_t)a->v[i] + b->v[i];
+        r->v[i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+    return (uint32_t)carry;
+}
+
+static uint32_t u256_sub(u256_t *r, const u256_t *a, const u256_t *b) {
+    int64_t borrow = 0;
+    for (size_t i = 0; i < 8; i++) {
+        borrow += (int64_t)a->v[i] - b->v[i];
+        r->v[i] = (uint32_t)borrow;
+        borrow >>= 32;
+    }
+    return (uint32_t)(borrow & 1);
+}
+
+// a and b below m
+static void mod_add(u256_t *r, const u256_t *a, const u256_t *b, const mont_t *ctx) {
+    if (u256_add(r, a, b) || u256_cmp(r, &ctx->m) >= 0) {
+        u256_sub(r, r, &ctx->m);
+    }
+}
+
+static void mod_sub(u256_t *r, const u256_t *a, const u256_t *b, const mont_t *ctx) {
+    if (u256_sub(r, a, b)) {
+        u256_add(r, r, &ctx->m);
+    }
+}
+
+// r = a * b / R mod m (CIOS)
+static void mont_mul(u256_t *r, const u256_t *a, const u256_t *b, const mont_t *ctx) {
+    uint32_t t[10] = { 0 };
+
+    for (size_t i = 0; i < 8; i++) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < 8; j++) {
+            uint64_t sum = (uint64_t)a->v[j] * b->v[i] + t[j] + carry;
+            t[j] = (uint32_t)sum;
+            carry = sum >> 32;
+        }
+        uint64_t sum = (uint64_t)t[8] + carry;
+        t[8] = (uint32_t)sum;
+        t[9] = (uint32_t)(sum >> 32);
+
+        uint32_t q = t[0] * ctx->m0inv;
+        sum = (uint64_t)q * ctx->m.v[0] + t[0];
+        carry = sum >> 32;
+        for (size_t j = 1; j < 8; j++) {
+            sum = (uint64_t)q * ctx->m.v[j] + t[j] + carry;
+            t[j - 1] = (uint32_t)sum;
+            carry = sum >> 32;
+        }
+        sum = (uint64_t)t[8] + carry;
+        t[7] = (uint32_t)sum;
+        t[8] = t[9] + (uint32_t)(sum >> 32);
+    }
+
+    memcpy(r->v, t, sizeof(r->v));
+    if (t[8] != 0 || u256_cmp(r, &ctx->m) >= 0) {
+        u256_sub(r, r, &ctx->m);
+    }
+}
+
+static void mont_init(mont_t *ctx, const uint8_t *modulus) {
+    u256_from_be(&ctx->m, modulus);
+
+    uint32_t inv = 1;
+    for (int i = 0; i < 5; i++) {
+        inv *= 2u - ctx->m.v[0] * inv;
+    }
+    ctx->m0inv = (uint32_t)0 - inv;
+
+    // 2^256 and 2^512 mod m by doubling
+    u256_t x;
+    u256_set_word(&x, 1);
+    for (int i = 0; i < 512; i++) {
+        mod_add(&x, &x, &x, ctx);
+        if (i == 255) {
+            ctx->one = x;
+        }
+    }
+    ctx->r2 = x;
+}
+
+static void to_mont(u256_t *r, const u256_t *a, const mont_t *ctx) {
+    mont_mul(r, a, &ctx->r2, ctx);
+}
+
+static void from_mont(u256_t *r, const u256_t *a, const mont_t *ctx) {
+    u256_t one;
+    u256_set_word(&one, 1);
+    mont_mul(r, a, &one, ctx);
+}
+
+// r = a^(m - 2), the inverse of a non-zero a (Montgomery in and out)
+static void mont_inv(u256_t *r, const u256_t *a, const mont_t *ctx) {
+    u256_t exponent;
+    u256_t two;
+    u256_set_word(&two, 2);
+    u256_sub(&exponent, &ctx->m, &two);
+
+    u256_t result = ctx->one;
+    for (int bit = 255; bit >= 0; bit--) {
+        mont_mul(&result, &result, &result, ctx);
+        if (u256_bit(&exponent, (size_t)bit)) {
+            mont_mul(&result, &result, a, ctx);
+        }
+    }
+    *r = result;
+}
+
+static void init() {
+    if (initialized) {
+        return;
+    }
+    mont_init(&fp, p_bytes);
+    mont_init(&fn, n_bytes);
+
+    u256_t value;
+    u256_from_be(&value, b_bytes);
+    to_mont(&curve_b, &value, &fp);
+    u256_from_be(&value, gx_bytes);
+    to_mont(&base.x, &value, &fp);
+    u256_from_be(&value, gy_bytes);
+    to_mont(&base.y, &value, &fp);
+    base.z = fp.one;
+    initialized = true;
+}
+
+static void point_double(point_t *r, const point_t *p) {
+    u256_t delta, gamma, beta, alpha, t1, t2;
+
+    if (u256_is_zero(&p->z)) {
+        *r = *p;
+        return;
+    }
+
+    // dbl-2001-b for a = -3
+    mont_mul(&delta, &p->z, &p->z, &fp);
+    mont_mul(&gamma, &p->y, &p->y, &fp);
+    mont_mul(&beta, &p->x, &gamma, &fp);
+    mod_sub(&t1, &p->x, &delta, &fp);
+    mod_add(&t2, &p->x, &delta, &fp);
+    mont_mul(&alpha, &t1, &t2, &fp);
+    mod_add(&t1, &alpha, &alpha, &fp);
+    mod_add(&alpha, &t1, &alpha, &fp);
+
+    point_t out;
+    mod_add(&t1, &beta, &beta, &fp);
+    mod_add(&t1, &t1, &t1, &fp);                // 4 beta
+    mod_add(&t2, &t1, &t1, &fp);                // 8 beta
+    mont_mul(&out.x, &alpha, &alpha, &fp);
+    mod_sub(&out.x, &out.x, &t2, &fp);
+
+    mod_add(&out.z, &p->y, &p->z, &fp);
+    mont_mul(&out.z, &out.z, &out.z, &fp);
+    mod_sub(&out.z, &out.z, &gamma, &fp);
+    mod_sub(&out.z, &out.z, &delta, &fp);
+
+    mod_sub(&t1, &t1, &out.x, &fp);
+    mont_mul(&out.y, &alpha, &t1, &fp);
+    mont_mul(&t2, &gamma, &gamma, &fp);
+    mod_add(&t2, &t2, &t2, &fp);
+    mod_add(&t2, &t2, &t2, &fp);
+    mod_add(&t2, &t2, &t2, &fp);                // 8 gamma^2
+    mod_sub(&out.y, &out.y, &t2, &fp);
+    *r = out;
+}
+
+static void point_add(point_t *r, const point_t *p, const point_t *q) {
+    u256_t z1z1, z2z2, u1, u2, s1, s2, h, rr, hh, hhh, v, t;
+
+    if (u256_is_zero(&p->z)) {
+        *r = *q;
+        return;
+    }
+    if (u256_is_zero(&q->z)) {
+        *r = *p;
+        return;
+    }
+
+    mont_mul(&z1z1, &p->z, &p->z, &fp);
+    mont_mul(&z2z2, &q->z, &q->z, &fp);
+    mont_mul(&u1, &p->x, &z2z2, &fp);
+    mont_mul(&u2, &q->x, &z1z1, &fp);
+    mont_mul(&s1, &p->y, &q->z, &fp);
+    mont_mul(&s1, &s1, &z2z2, &fp);
+    mont_mul(&s2, &q->y, &p->z, &fp);
+    mont_mul(&s2, &s2, &z1z1, &fp);
+    mod_sub(&h, &u2, &u1, &fp);
+    mod_sub(&rr, &s2, &s1, &fp);
+
+    if (u256_is_zero(&h)) {
+        if (u256_is_zero(&rr)) {
+            point_double(r, p);
+        } else {
+            memset(r, 0, sizeof(*r));
+        }
+        return;
+    }
+
+    point_t out;
+    mont_mul(&hh, &h, &h, &fp);
+    mont_mul(&hhh, &h, &hh, &fp);
+    mont_mul(&v, &u1, &hh, &fp);
+
+    mont_mul(&out.x, &rr, &rr, &fp);
+    mod_sub(&out.x, &out.x, &hhh, &fp);
+    mod_sub(&out.x, &out.x, &v, &fp);
+    mod_sub(&out.x, &out.x, &v, &fp);
+
+    mod_sub(&t, &v, &out.x, &fp);
+    mont_mul(&out.y, &rr, &t, &fp);
+    mont_mul(&t, &s1, &hhh, &fp);
+    mod_sub(&out.y, &out.y, &t, &fp);
+
+    mont_mul(&out.z, &p->z, &q->z, &fp);
+    mont_mul(&out.z, &out.z, &h, &fp);
+    *r = out;
+}
+
+static void point_mul(point_t *r, const u256_t *k, const point_t *p) {
+    point_t acc;
+    memset(&acc, 0, sizeof(acc));
+    for (int bit = 255; bit >= 0; bit--) {
+        point_double(&acc, &acc);
+        if (u256_bit(k, (size_t)bit)) {
+            point_add(&acc, &acc, p);
+        }
+    }
+    *r = acc;
+}
+
+// Affine coordinates, out of the Montgomery domain; false for the point at infinity
+static bool point_affine(const point_t *p, u256_t *x, u256_t *y) {
+    if (u256_is_zero(&p->z)) {
+        return false;
+    }
+    u256_t zinv, zinv2, t;
+    mont_inv(&zinv, &p->z, &fp);
+    mont_mul(&zinv2, &zinv, &zinv, &fp);
+    mont_mul(&t, &p->x, &zinv2, &fp);
+    from_mont(x, &t, &fp);
+    if (y != NULL) {
+        mont_mul(&zinv2, &zinv2, &zinv, &fp);
+        mont_mul(&t, &p->y, &zinv2, &fp);
+        from_mont(y, &t, &fp);
+    }
+    return true;
+}
+
+// Parse X || Y into a Jacobian point, checking that it lies on the curve
+static bool point_load(point_t *r, const uint8_t *public_key) {
+    u256_t x, y, lhs, rhs, t;
+
+    u256_from_be(&x, public_key);
+    u256_from_be(&y, &public_key[32]);
+    if (u256_cmp(&x, &fp.m) >= 0 || u256_cmp(&y, &fp.m) >= 0) {
+        return false;
+    }
+    to_mont(&r->x, &x, &fp);
+    to_mont(&r->y, &y, &fp);
+    r->z = fp.one;
+
+    // y^2 = x^3 - 3x + b
+    mont_mul(&lhs, &r->y, &r->y, &fp);
+    mont_mul(&rhs, &r->x, &r->x, &fp);
+    mont_mul(&rhs, &rhs, &r->x, &fp);
+    mod_add(&t, &r->x, &r->x, &fp);
+    mod_add(&t, &t, &r->x, &fp);
+    mod_sub(&rhs, &rhs, &t, &fp);
+    mod_add(&rhs, &rhs, &curve_b, &fp);
+    return u256_cmp(&lhs, &rhs) == 0;
+}
+
+// A scalar in [1, n - 1]
+static bool scalar_load(u256_t *r, const uint8_t *bytes) {
+    u256_from_be(r, bytes);
+    return !u256_is_zero(r) && u256_cmp(r, &fn.m) < 0;
+}
+
+// The digest as an integer modulo n
+static void digest_load(u256_t *r, const uint8_t *digest) {
+    u256_from_be(r, digest);
+    if (u256_cmp(r, &fn.m) >= 0) {
+        u256_sub(r, r, &fn.m);
+    }
+}
+
+/**
+ * @brief Checks that 32 bytes form a valid private key or nonce.
+ *
+ * @param scalar The big-endian scalar.
+ * @return true if it lies in [1, n - 1].
+ */
+bool sim_p256_valid_scalar(const uint8_t *scalar) {
+    init();
+    u256_t k;
+    return scalar_load(&k, scalar);
+}
+
+/**
+ * @brief Computes the public key of a private key.
+ *
+ * @param private_key The 32-byte private key.
+ * @param public_key  Receives X || Y.
+ * @return true on success, false if the private key is out of range.
+ */
+bool sim_p256_public_key(const uint8_t *private_key, uint8_t *public_key) {
+    init();
+    u256_t d, x, y;
+    point_t q;
+    if (!scalar_load(&d, private_key)) {
+        return false;
+    }
+    point_mul(&q, &d, &base);
+    point_affine(&q, &x, &y);
+    u256_to_be(public_key, &x);
+    u256_to_be(&public_key[32], &y);
+    return true;
+}
+
+/**
+ * @brief Checks that X || Y is a point on the curve.
+ *
+ * @param public_key The 64-byte point.
+ * @return true if the point is valid.
+ */
+bool sim_p256_on_curve(const uint8_t *public_key) {
+    init();
+    point_t q;
+    return point_load(&q, public_key);
+}
+
+/**
+ * @brief Signs a digest with ECDSA.
+ *
+ * @param private_key The 32-byte private key.
+ * @param digest      The 32-byte message digest.
+ * @param k           The 32-byte per-signature nonce; must be secret and unique.
+ * @param signature   Receives R || S.
+ * @return true on success, false if a scalar is out of range or k is unusable.
+ */
+bool sim_p256_sign(const uint8_t *private_key, const uint8_t *digest, const uint8_t *k, uint8_t *signature) {
+    init();
+    u256_t d, e, kk, x, r, s, t, u;
+    point_t kg;
+
+    if (!scalar_load(&d, private_key) || !scalar_load(&kk, k)) {
+        return false;
+    }
+    digest_load(&e, digest);
+
+    point_mul(&kg, &kk, &base);
+    point_affine(&kg, &x, NULL);
+    r = x;
+    if (u256_cmp(&r, &fn.m) >= 0) {
+        u256_sub(&r, &r, &fn.m);
+    }
+    if (u256_is_zero(&r)) {
+        return false;
+    }
+
+    // s = k^-1 (e + r d) mod n
+    to_mont(&t, &r, &fn);
+    to_mont(&u, &d, &fn);
+    mont_mul(&t, &t, &u, &fn);
+    to_mont(&u, &e, &fn);
+    mod_add(&t, &t, &u, &fn);
+    to_mont(&u, &kk, &fn);
+    mont_inv(&u, &u, &fn);
+    mont_mul(&t, &t, &u, &fn);
+    from_mont(&s, &t, &fn);
+    if (u256_is_zero(&s)) {
+        return false;
+    }
+
+    u256_to_be(signature, &r);
+    u256_to_be(&signature[32], &s);
+    return true;
+}
+
+/**
+ * @brief Verifies an ECDSA signature.
+ *
+ * @param public_key The signer's X || Y.
+ * @param digest     The 32-byte message digest.
+ * @param signature  R || S.
+ * @return true if the signature is valid.
+ */
+bool sim_p256_verify(const uint8_t *public_key, const uint8_t *digest, const uint8_t *signature) {
+    init();
+    u256_t r, s, e, w, u1, u2, t, x;
+    point_t q, p1, p2;
+
+    if (!point_load(&q, public_key) || !scalar_load(&r, signature) || !scalar_load(&s, &signature[32])) {
+        return false;
+    }
+    digest_load(&e, digest);
+
+    // u1 = e / s, u2 = r / s
+    to_mont(&w, &s, &fn);
+    mont_inv(&w, &w, &fn);
+    to_mont(&t, &e, &fn);
+    mont_mul(&t, &t, &w, &fn);
+    from_mont(&u1, &t, &fn);
+    to_mont(&t, &r, &fn);
+    mont_mul(&t, &t, &w, &fn);
+    from_mont(&u2, &t, &fn);
+
+    point_mul(&p1, &u1, &base);
+    point_mul(&p2, &u2, &q);
+    point_add(&p1, &p1, &p2);
+    if (!point_affine(&p1, &x, NULL)) {
+        return false;
+    }
+    if (u256_cmp(&x, &fn.m) >= 0) {
+        u256_sub(&x, &x, &fn.m);
+    }
+    return u256_cmp(&x, &r) == 0;
+}
+
+/**
+ * @brief Computes the ECDH shared secret, the X coordinate of d * Q.
+ *
+ * @param private_key The 32-byte private key.
+ * @param public_key  The peer's X || Y.
+ * @param shared_x    Receives the 32-byte shared X coordinate.
+ * @return true on success, false if either key is invalid.
+ */
+bool sim_p256_ecdh(const uint8_t *private_key, const uint8_t *public_key, uint8_t *shared_x) {
+    init();
+    u256_t d, x;
+    point_t q;
+
+    if (!scalar_load(&d, private_key) || !point_load(&q, public_key)) {
+        return false;
+    }
+    point_mul(&q, &d, &q);
+    if (!point_affine(&q, &x, NULL)) {
+        return false;
+    }
+    u256_to_be(shared_x, &x);
+    return true;
+}
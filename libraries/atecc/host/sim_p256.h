@@ -0,0 +1,20 @@
+#ifndef SIM_P256_H
+#define SIM_P256_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// NIST P-256 arithmetic for the ATECC608 model: key generation, ECDSA and ECDH.
+// Written for clarity, not speed or side-channel resistance; host use only.
+// Scalars and coordinates are 32-byte big-endian, points are X || Y.
+
+#define SIM_P256_SIZE   (32u)
+
+bool sim_p256_valid_scalar(const uint8_t *scalar);
+bool sim_p256_public_key(const uint8_t *private_key, uint8_t *public_key);
+bool sim_p256_on_curve(const uint8_t *public_key);
+bool sim_p256_sign(const uint8_t *private_key, const uint8_t *digest, const uint8_t *k, uint8_t *signature);
+bool sim_p256_verify(const uint8_t *public_key, const uint8_t *digest, const uint8_t *signature);
+bool sim_p256_ecdh(const uint8_t *private_key, const uint8_t *public_key, uint8_t *shared_x);
+
+#endif // SIM_P256_H
@@ -0,0 +1,577 @@
+#include "atecc_aes.h"
+#include "atecc_cmd.h"
+#include "atecc_config.h"
+#include "atecc_log.h"
+#include "atecc_power.h"
+#include "atecc_response.h"
+
+// A multi-block AES operation. load() produces the device input for a block from the
+// device output of the previous block, store() consumes the device output. store() for
+// block N runs while block N+1 executes on the device, so chaining and XOR work overlaps
+// the device execution time.
+typedef struct aes_job {
+    uint8_t mode;
+    uint8_t key_slot;
+    size_t blocks;
+    const uint8_t *input;
+    uint8_t *output;
+    size_t length;                      // Bytes of input/output (CTR may end mid-block)
+    uint8_t chain[AES_BLOCK_SIZE];      // IV or CTR counter
+    uint8_t last[AES_BLOCK_SIZE];       // Padded final block for CBC encrypt
+    void (*load)(struct aes_job *job, size_t index, const uint8_t *previous, uint8_t *block);
+    void (*store)(struct aes_job *job, size_t index, const uint8_t *block);
+} aes_job_t;
+
+static inline void xor_block(uint8_t *dest, const uint8_t *a, const uint8_t *b, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        dest[i] = a[i] ^ b[i];
+    }
+}
+
+// Increment a 128-bit big-endian counter block
+static inline void increment_counter(uint8_t *counter) {
+    for (int i = AES_BLOCK_SIZE - 1; i >= 0; i--) {
+        if (++counter[i] != 0) {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Runs a multi-block AES job within a single power session.
+ *
+ * The command for block N+1 is written to the bus before block N's output is
+ * processed, so the host-side work for block N runs while the device computes.
+ * A block whose command or response is lost is run again with aes_execute_block().
+ *
+ * @param job The job to run.
+ * @return true if all blocks were processed, false otherwise.
+ */
+static bool aes_run_job(aes_job_t *job) {
+    uint8_t in_block[AES_BLOCK_SIZE];
+    uint8_t out_block[AES_BLOCK_SIZE];
+
+    if (job->blocks == 0) {
+        return true;
+    }
+
+    if (!atecc_slot_is_aes_key(job->key_slot)) {
+        ATECC_LOG(AES_SLOT_NOT_KEY, ATCA_AES, 0, job->key_slot, 0);
+        return false;
+    }
+
+    if (!atecc_session_begin()) {
+        ATECC_LOG(AES_WAKE_FAILED, ATCA_AES, 0, 0, 0);
+        return false;
+    }
+
+    bool ok = true;
+    job->load(job, 0, job->chain, in_block);
+    bool sent = send_aes_command(job->mode, job->key_slot, in_block);
+
+    for (size_t i = 0; i < job->blocks; i++) {
+        // A block lost in the pipeline is run again on its own, with retries
+        if (!(sent && receive_aes_response(out_block)) &&
+            !aes_execute_block(job->mode, job->key_slot, in_block, out_block)) {
+            ok = false;
+            break;
+        }
+
+        if (i + 1 < job->blocks) {
+            job->load(job, i + 1, out_block, in_block);
+            sent = send_aes_command(job->mode, job->key_slot, in_block);
+        }
+
+        job->store(job, i, out_block);
+    }
+
+    atecc_session_end();
+    if (!ok) {
+        ATECC_LOG(AES_BLOCKS_FAILED, ATCA_AES, 0, job->blocks, 0);
+    }
+    return ok;
+}
+
+static void ecb_load(aes_job_t *job, size_t index, const uint8_t *previous, uint8_t *block) {
+    (void)previous;
+    memcpy(block, &job->input[index * AES_BLOCK_SIZE], AES_BLOCK_SIZE);
+}
+
+static void ecb_store(aes_job_t *job, size_t index, const uint8_t *block) {
+    memcpy(&job->output[index * AES_BLOCK_SIZE], block, AES_BLOCK_SIZE);
+}
+
+// CBC encrypt: the chaining value is the previous ciphertext block (the IV for block 0)
+static void cbc_encrypt_load(aes_job_t *job, size_t index, const uint8_t *previous, uint8_t *block) {
+    const uint8_t *plain = (index + 1 == job->blocks) ? job->last : &job->input[index * AES_BLOCK_SIZE];
+    xor_block(block, plain, previous, AES_BLOCK_SIZE);
+}
+
+// CBC decrypt: plaintext is the decrypted block XOR the previous ciphertext block
+static void cbc_decrypt_store(aes_job_t *job, size_t index, const uint8_t *block) {
+    const uint8_t *previous = (index == 0) ? job->chain : &job->input[(index - 1) * AES_BLOCK_SIZE];
+    xor_block(&job->output[index * AES_BLOCK_SIZE], block, previous, AES_BLOCK_SIZE);
+}
+
+// CTR: the device encrypts successive counter blocks into a keystream
+static void ctr_load(aes_job_t *job, size_t index, const uint8_t *previous, uint8_t *block) {
+    (void)index;
+    (void)previous;
+    memcpy(block, job->chain, AES_BLOCK_SIZE);
+    increment_counter(job->chain);
+}
+
+static void ctr_store(aes_job_t *job, size_t index, const uint8_t *block) {
+    size_t offset = index * AES_BLOCK_SIZE;
+    size_t chunk = job->length - offset < AES_BLOCK_SIZE ? job->length - offset : AES_BLOCK_SIZE;
+    xor_block(&job->output[offset], &job->input[offset], block, chunk);
+}
+
+/**
+ * @brief Encrypts whole blocks in ECB mode.
+ *
+ * @param key_slot The key slot where the AES 128-bit key is stored.
+ * @param input    The plaintext.
+ * @param output   The buffer to store the ciphertext (may equal input).
+ * @param length   The number of bytes, a multiple of AES_BLOCK_SIZE.
+ * @return true if all blocks were encrypted, false otherwise.
+ */
+bool aes_ecb_encrypt(uint8_t key_slot, const uint8_t *input, uint8_t *output, size_t length) {
+    if (length % AES_BLOCK_SIZE != 0) {
+        return false;
+    }
+    aes_job_t job = {
+        .mode = ATCA_AES_MODE_ENCRYPT, .key_slot = key_slot, .blocks = length / AES_BLOCK_SIZE,
+        .input = input, .output = output, .length = length, .load = ecb_load, .store = ecb_store,
+    };
+    return aes_run_job(&job);
+}
+
+/**
+ * @brief Decrypts whole blocks in ECB mode.
+ *
+ * @param key_slot The key slot where the AES 128-bit key is stored.
+ * @param input    The ciphertext.
+ * @param output   The buffer to store the plaintext (may equal input).
+ * @param length   The number of bytes, a multiple of AES_BLOCK_SIZE.
+ * @return true if all blocks were decrypted, false otherwise.
+ */
+bool aes_ecb_decrypt(uint8_t key_slot, const uint8_t *input, uint8_t *output, size_t length) {
+    if (length % AES_BLOCK_SIZE != 0) {
+        return false;
+    }
+    aes_job_t job = {
+        .mode = ATCA_AES_MODE_DECRYPT, .key_slot = key_slot, .blocks = length / AES_BLOCK_SIZE,
+        .input = input, .output = output, .length = length, .load = ecb_load, .store = ecb_store,
+    };
+    return aes_run_job(&job);
+}
+
+/**
+ * @brief Encrypts a buffer of any size in CBC mode with PKCS#7 padding.
+ *
+ * The output is always 1 to 16 bytes longer than the input.
+ *
+ * @param key_slot      The key slot where the AES 128-bit key is stored.
+ * @param iv            The 16-byte initialization vector.
+ * @param input         The plaintext.
+ * @param length        The plaintext length in bytes.
+ * @param output        The buffer to store the ciphertext (must not overlap input).
+ * @param output_size   The size of the output buffer.
+ * @param output_length Set to the ciphertext length.
+ * @return true if the buffer was encrypted, false on error or if output is too small.
+ */
+bool aes_cbc_encrypt(uint8_t key_slot, const uint8_t *iv, const uint8_t *input, size_t length,
+                     uint8_t *output, size_t output_size, size_t *output_length) {
+    size_t blocks = length / AES_BLOCK_SIZE + 1;
+    if (output_size < blocks * AES_BLOCK_SIZE) {
+        return false;
+    }
+
+    aes_job_t job = {
+        .mode = ATCA_AES_MODE_ENCRYPT, .key_slot = key_slot, .blocks = blocks,
+        .input = input, .output = output, .length = length,
+        .load = cbc_encrypt_load, .store = ecb_store,
+    };
+    memcpy(job.chain, iv, AES_BLOCK_SIZE);
+
+    // PKCS#7: pad the final block with the number of padding bytes
+    size_t tail = length % AES_BLOCK_SIZE;
+    uint8_t pad = (uint8_t)(AES_BLOCK_SIZE - tail);
+    memcpy(job.last, &input[length - tail], tail);
+    memset(&job.last[tail], pad, pad);
+
+    if (!aes_run_job(&job)) {
+        return false;
+    }
+    *output_length = blocks * AES_BLOCK_SIZE;
+    return true;
+}
+
+/**
+ * @brief Decrypts a CBC ciphertext and removes its PKCS#7 padding.
+ *
+ * @param key_slot      The key slot where the AES 128-bit key is stored.
+ * @param iv            The 16-byte initialization vector.
+ * @param input         The ciphertext.
+ * @param length        The ciphertext length, a non-zero multiple of AES_BLOCK_SIZE.
+ * @param output        The buffer of at least length bytes to store the plaintext (must not overlap input).
+ * @param output_length Set to the plaintext length without padding.
+ * @return true if the buffer was decrypted and the padding is valid, false otherwise.
+ */
+bool aes_cbc_decrypt(uint8_t key_slot, const uint8_t *iv, const uint8_t *input, size_t length,
+                     uint8_t *output, size_t *output_length) {
+    if (length == 0 || length % AES_BLOCK_SIZE != 0) {
+        return false;
+    }
+
+    aes_job_t job = {
+        .mode = ATCA_AES_MODE_DECRYPT, .key_slot = key_slot, .blocks = length / AES_BLOCK_SIZE,
+        .input = input, .output = output, .length = length,
+        .load = ecb_load, .store = cbc_decrypt_store,
+    };
+    memcpy(job.chain, iv, AES_BLOCK_SIZE);
+
+    if (!aes_run_job(&job)) {
+        return false;
+    }
+
+    uint8_t pad = output[length - 1];
+    if (pad == 0 || pad > AES_BLOCK_SIZE) {
+        ATECC_LOG(AES_PADDING_INVALID, 0, 0, 0, 0);
+        return false;
+    }
+    for (size_t i = length - pad; i < length; i++) {
+        if (output[i] != pad) {
+            ATECC_LOG(AES_PADDING_INVALID, 0, 0, 0, 0);
+            return false;
+        }
+    }
+    *output_length = length - pad;
+    return true;
+}
+
+/**
+ * @brief Encrypts or decrypts a buffer of any size in CTR mode.
+ *
+ * The counter block is incremented as a 128-bit big-endian integer and is left
+ * pointing at the next unused block, so a stream can be processed in pieces as long
+ * as every piece but the last is a multiple of AES_BLOCK_SIZE.
+ *
+ * @param key_slot The key slot where the AES 128-bit key is stored.
+ * @param counter  The 16-byte initial counter block, updated on return.
+ * @param input    The input data.
+ * @param output   The buffer to store the output (may equal input).
+ * @param length   The number of bytes.
+ * @return true if the buffer was processed, false otherwise.
+ */
+bool aes_ctr_crypt(uint8_t key_slot, uint8_t *counter, const uint8_t *input, uint8_t *output, size_t length) {
+    aes_job_t job = {
+        .mode = ATCA_AES_MODE_ENCRYPT, .key_slot = key_slot,
+        .blocks = (length + AES_BLOCK_SIZE - 1) / AES_BLOCK_SIZE,
+        .input = input, .output = output, .length = length,
+        .load = ctr_load, .store = ctr_store,
+    };
+    memcpy(job.chain, counter, AES_BLOCK_SIZE);
+
+    if (!aes_run_job(&job)) {
+        return false;
+    }
+    memcpy(counter, job.chain, AES_BLOCK_SIZE);
+    return true;
+}
+
+/**
+ * @brief Multiplies two blocks in GF(2^128) on the device (AES GFM mode).
+ *
+ * @param h      The first factor (the GHASH subkey).
+ * @param input  The second factor.
+ * @param output The buffer to store the 16-byte product.
+ * @return true if the product was computed, false otherwise.
+ */
+static bool aes_gfm(const uint8_t *h, const uint8_t *input, uint8_t *output) {
+    const atecc_fragment_t data[] = {
+        { h, AES_BLOCK_SIZE },
+        { input, AES_BLOCK_SIZE },
+    };
+
+    uint8_t response[AES_BLOCK_SIZE + 3];
+
+    if (atecc_execute_sg(ATCA_AES, ATCA_AES_MODE_GFM, 0x0000, data, 2, response, sizeof(response),
+                         ATECC_EXEC_REPLAYABLE) != ATECC_OK) {
+        return false;
+    }
+    memcpy(output, &response[1], AES_BLOCK_SIZE);
+    return true;
+}
+
+// Increment the rightmost 32 bits of a GCM counter block
+static inline void increment_counter32(uint8_t *counter) {
+    for (size_t i = AES_BLOCK_SIZE; i > AES_BLOCK_SIZE - 4; i--) {
+        if (++counter[i - 1] != 0) {
+            break;
+        }
+    }
+}
+
+// Store a 64-bit value big-endian
+static inline void put_be64(uint8_t *dest, uint64_t value) {
+    for (int i = 7; i >= 0; i--) {
+        dest[i] = (uint8_t)value;
+        value >>= 8;
+    }
+}
+
+// GHASH step: X = (X ^ block) * H
+static bool gcm_ghash_block(aes_gcm_ctx_t *ctx, uint8_t *ghash, const uint8_t *block) {
+    uint8_t x[AES_BLOCK_SIZE];
+    xor_block(x, ghash, block, AES_BLOCK_SIZE);
+    return aes_gfm(ctx->h, x, ghash);
+}
+
+// Hash a buffered partial block (zero padded) and start a new one
+static bool gcm_flush_partial(aes_gcm_ctx_t *ctx) {
+    if (ctx->partial_length == 0) {
+        return true;
+    }
+    memset(&ctx->partial[ctx->partial_length], 0, AES_BLOCK_SIZE - ctx->partial_length);
+    ctx->partial_length = 0;
+    return gcm_ghash_block(ctx, ctx->ghash, ctx->partial);
+}
+
+/**
+ * @brief Starts an AES-GCM operation.
+ *
+ * Derives the hash subkey H = E(K, 0^128) on the device and the pre-counter block
+ * J0 from the IV. 12-byte IVs are used directly; other lengths are hashed with GHASH.
+ *
+ * @param ctx       The GCM state to initialize.
+ * @param key_slot  The key slot where the AES 128-bit key is stored.
+ * @param iv        The initialization vector.
+ * @param iv_length The IV length in bytes (12 recommended).
+ * @return true if the state was initialized, false otherwise.
+ */
+bool aes_gcm_init(aes_gcm_ctx_t *ctx, uint8_t key_slot, const uint8_t *iv, size_t iv_length) {
+    uint8_t zero[AES_BLOCK_SIZE] = {0};
+
+    if (iv_length == 0) {
+        return false;
+    }
+
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->key_slot = key_slot;
+
+    if (!atecc_session_begin()) {
+        return false;
+    }
+
+    bool ok = aes_encrypt(zero, ctx->h, key_slot);
+    if (ok && iv_length == 12) {
+        memcpy(ctx->j0, iv, 12);
+        ctx->j0[AES_BLOCK_SIZE - 1] = 0x01;
+    } else if (ok) {
+        // J0 = GHASH(IV || 0-pad || 0^64 || [len(IV) in bits]64)
+        uint8_t block[AES_BLOCK_SIZE];
+        for (size_t offset = 0; ok && offset < iv_length; offset += AES_BLOCK_SIZE) {
+            size_t chunk = iv_length - offset < AES_BLOCK_SIZE ? iv_length - offset : AES_BLOCK_SIZE;
+            memset(block, 0, sizeof(block));
+            memcpy(block, &iv[offset], chunk);
+            ok = gcm_ghash_block(ctx, ctx->j0, block);
+        }
+        memset(block, 0, sizeof(block));
+        put_be64(&block[8], (uint64_t)iv_length * 8u);
+        ok = ok && gcm_ghash_block(ctx, ctx->j0, block);
+    }
+
+    atecc_session_end();
+    memcpy(ctx->counter, ctx->j0, AES_BLOCK_SIZE);
+    return ok;
+}
+
+/**
+ * @brief Adds additional authenticated data; must precede all data updates.
+ *
+ * @param ctx    The GCM state.
+ * @param aad    The additional authenticated data.
+ * @param length The AAD length in bytes.
+ * @return true if the AAD was absorbed, false on error or if data was already processed.
+ */
+bool aes_gcm_update_aad(aes_gcm_ctx_t *ctx, const uint8_t *aad, size_t length) {
+    if (ctx->aad_done) {
+        return false;
+    }
+
+    if (!atecc_session_begin()) {
+        return false;
+    }
+
+    bool ok = true;
+    for (size_t i = 0; ok && i < length; i++) {
+        ctx->partial[ctx->partial_length++] = aad[i];
+        if (ctx->partial_length == AES_BLOCK_SIZE) {
+            ctx->partial_length = 0;
+            ok = gcm_ghash_block(ctx, ctx->ghash, ctx->partial);
+        }
+    }
+    ctx->aad_length += length;
+
+    atecc_session_end();
+    return ok;
+}
+
+/**
+ * @brief Runs the CTR keystream over data and absorbs the ciphertext into GHASH.
+ *
+ * @param ctx     The GCM state.
+ * @param input   The input data.
+ * @param output  The buffer to store the output (may equal input).
+ * @param length  The number of bytes.
+ * @param encrypt true if input is plaintext, false if it is ciphertext.
+ * @return true if the data was processed, false otherwise.
+ */
+static bool gcm_crypt(aes_gcm_ctx_t *ctx, const uint8_t *input, uint8_t *output, size_t length, bool encrypt) {
+    if (!atecc_session_begin()) {
+        return false;
+    }
+
+    bool ok = true;
+    if (!ctx->aad_done) {
+        ok = gcm_flush_partial(ctx);
+        ctx->aad_done = true;
+    }
+
+    for (size_t i = 0; ok && i < length; i++) {
+        // The keystream position always matches the buffered ciphertext position
+        if (ctx->partial_length == 0) {
+            increment_counter32(ctx->counter);
+            ok = aes_encrypt(ctx->counter, ctx->keystream, ctx->key_slot);
+            if (!ok) {
+                break;
+            }
+        }
+
+        uint8_t in = input[i];
+        uint8_t out = in ^ ctx->keystream[ctx->partial_length];
+        output[i] = out;
+        ctx->partial[ctx->partial_length++] = encrypt ? out : in;
+
+        if (ctx->partial_length == AES_BLOCK_SIZE) {
+            ctx->partial_length = 0;
+            ok = gcm_ghash_block(ctx, ctx->ghash, ctx->partial);
+        }
+    }
+    ctx->data_length += length;
+
+    atecc_session_end();
+    return ok;
+}
+
+/**
+ * @brief Encrypts the next piece of plaintext.
+ *
+ * @param ctx        The GCM state.
+ * @param plaintext  The plaintext.
+ * @param ciphertext The buffer to store the ciphertext (may equal plaintext).
+ * @param length     The number of bytes.
+ * @return true if the data was encrypted, false otherwise.
+ */
+bool aes_gcm_encrypt_update(aes_gcm_ctx_t *ctx, const uint8_t *plaintext, uint8_t *ciphertext, size_t length) {
+    return gcm_crypt(ctx, plaintext, ciphertext, length, true);
+}
+
+/**
+ * @brief Decrypts the next piece of ciphertext.
+ *
+ * The plaintext must not be used before aes_gcm_decrypt_finish() has verified the tag.
+ *
+ * @param ctx        The GCM state.
+ * @param ciphertext The ciphertext.
+ * @param plaintext  The buffer to store the plaintext (may equal ciphertext).
+ * @param length     The number of bytes.
+ * @return true if the data was decrypted, false otherwise.
+ */
+bool aes_gcm_decrypt_update(aes_gcm_ctx_t *ctx, const uint8_t *ciphertext, uint8_t *plaintext, size_t length) {
+    return gcm_crypt(ctx, ciphertext, plaintext, length, false);
+}
+
+/**
+ * @brief Completes GHASH and computes the full 16-byte tag.
+ *
+ * @param ctx The GCM state.
+ * @param tag The buffer to store the tag.
+ * @return true if the tag was computed, false otherwise.
+ */
+static bool gcm_compute_tag(aes_gcm_ctx_t *ctx, uint8_t *tag) {
+    uint8_t lengths[AES_BLOCK_SIZE];
+    uint8_t mask[AES_BLOCK_SIZE];
+
+    if (!atecc_session_begin()) {
+        return false;
+    }
+
+    bool ok = gcm_flush_partial(ctx);
+    ctx->aad_done = true;
+
+    put_be64(&lengths[0], ctx->aad_length * 8u);
+    put_be64(&lengths[8], ctx->data_length * 8u);
+    ok = ok && gcm_ghash_block(ctx, ctx->ghash, lengths);
+    ok = ok && aes_encrypt(ctx->j0, mask, ctx->key_slot);
+
+    atecc_session_end();
+    if (ok) {
+        xor_block(tag, ctx->ghash, mask, AES_BLOCK_SIZE);
+    }
+    return ok;
+}
+
+// Tags shorter than 96 bits (the 64- and 32-bit lengths SP 800-38D allows only
+// with limits on message and key use) are refused, as is anything over 128
+static bool gcm_tag_length_valid(size_t tag_length) {
+    return tag_length >= AES_GCM_MIN_TAG_SIZE && tag_length <= AES_GCM_TAG_SIZE;
+}
+
+/**
+ * @brief Finishes an encryption and returns the authentication tag.
+ *
+ * @param ctx        The GCM state.
+ * @param tag        The buffer to store the tag.
+ * @param tag_length The tag length in bytes (AES_GCM_MIN_TAG_SIZE to AES_GCM_TAG_SIZE,
+ *                   16 recommended).
+ * @return true if the tag was produced, false otherwise.
+ */
+bool aes_gcm_encrypt_finish(aes_gcm_ctx_t *ctx, uint8_t *tag, size_t tag_length) {
+    uint8_t full_tag[AES_GCM_TAG_SIZE];
+
+    if (!gcm_tag_length_valid(tag_length) || !gcm_compute_tag(ctx, full_tag)) {
+        return false;
+    }
+    memcpy(tag, full_tag, tag_length);
+    return true;
+}
+
+/**
+ * @brief Finishes a decryption and verifies the authentication tag.
+ *
+ * @param ctx        The GCM state.
+ * @param tag        The received tag.
+ * @param tag_length The tag length in bytes (AES_GCM_MIN_TAG_SIZE to AES_GCM_TAG_SIZE).
+ * @return true if the tag matches, false otherwise.
+ */
+bool aes_gcm_decrypt_finish(aes_gcm_ctx_t *ctx, const uint8_t *tag, size_t tag_length) {
+    uint8_t full_tag[AES_GCM_TAG_SIZE];
+    uint8_t diff = 0;
+
+    if (!gcm_tag_length_valid(tag_length) || !gcm_compute_tag(ctx, full_tag)) {
+        return false;
+    }
+
+    // Compare in constant time
+    for (size_t i = 0; i < tag_length; i++) {
+        diff |= full_tag[i] ^ tag[i];
+    }
+    if (diff != 0) {
+        ATECC_LOG(AES_GCM_TAG_MISMATCH, 0, 0, 0, 0);
+        return false;
+    }
+    return true;
+}
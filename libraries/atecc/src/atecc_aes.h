@@ -0,0 +1,55 @@
+#ifndef ATECC_AES_H
+#define ATECC_AES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AES_BLOCK_SIZE          (16u)           // AES block size in bytes
+#define ATCA_AES_MODE_ENCRYPT   ((uint8_t)0x00) // AES mode: encrypt one block
+#define ATCA_AES_MODE_DECRYPT   ((uint8_t)0x01) // AES mode: decrypt one block
+#define ATCA_AES_MODE_GFM       ((uint8_t)0x03) // AES mode: Galois field multiply
+#define AES_GCM_TAG_SIZE        (16u)           // Full-length GCM authentication tag
+#define AES_GCM_MIN_TAG_SIZE    (12u)           // Shortest tag accepted (SP 800-38D, 5.2.1.2)
+
+// AES-GCM state kept on the host between calls
+typedef struct {
+    uint8_t  key_slot;
+    uint8_t  h[AES_BLOCK_SIZE];         // Hash subkey E(K, 0^128)
+    uint8_t  j0[AES_BLOCK_SIZE];        // Pre-counter block, encrypted into the tag mask
+    uint8_t  counter[AES_BLOCK_SIZE];   // Last counter block used for the keystream
+    uint8_t  keystream[AES_BLOCK_SIZE]; // Keystream block for the current data block
+    uint8_t  ghash[AES_BLOCK_SIZE];     // Running GHASH value
+    uint8_t  partial[AES_BLOCK_SIZE];   // Buffered AAD or ciphertext not yet hashed
+    size_t   partial_length;
+    uint64_t aad_length;
+    uint64_t data_length;
+    bool     aad_done;
+} aes_gcm_ctx_t;
+
+// Bulk AES-128 with the key in a device slot. All blocks of a call share one wake.
+bool aes_ecb_encrypt(uint8_t key_slot, const uint8_t *input, uint8_t *output, size_t length);
+bool aes_ecb_decrypt(uint8_t key_slot, const uint8_t *input, uint8_t *output, size_t length);
+bool aes_cbc_encrypt(uint8_t key_slot, const uint8_t *iv, const uint8_t *input, size_t length,
+                     uint8_t *output, size_t output_size, size_t *output_length);
+bool aes_cbc_decrypt(uint8_t key_slot, const uint8_t *iv, const uint8_t *input, size_t length,
+                     uint8_t *output, size_t *output_length);
+bool aes_ctr_crypt(uint8_t key_slot, uint8_t *counter, const uint8_t *input, uint8_t *output, size_t length);
+
+// AES-GCM with device AES for the counter blocks and device GFM for GHASH
+bool aes_gcm_init(aes_gcm_ctx_t *ctx, uint8_t key_slot, const uint8_t *iv, size_t iv_length);
+bool aes_gcm_update_aad(aes_gcm_ctx_t *ctx, const uint8_t *aad, size_t length);
+bool aes_gcm_encrypt_update(aes_gcm_ctx_t *ctx, const uint8_t *plaintext, uint8_t *ciphertext, size_t length);
+bool aes_gcm_decrypt_update(aes_gcm_ctx_t *ctx, const uint8_t *ciphertext, uint8_t *plaintext, size_t length);
+bool aes_gcm_encrypt_finish(aes_gcm_ctx_t *ctx, uint8_t *tag, size_t tag_length);
+bool aes_gcm_decrypt_finish(aes_gcm_ctx_t *ctx, const uint8_t *tag, size_t tag_length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ATECC_AES_H
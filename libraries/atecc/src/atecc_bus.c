@@ -0,0 +1,203 @@
+#include "atecc_bus.h"
+#include "atecc_cmd.h"
+#include "atecc_device.h"
+#include "atecc_exec.h"
+#include "atecc_power.h"
+#include "hal_pico_i2c.h"
+
+// Clock steps tried by the negotiator, slowest first
+static const uint32_t rates[] = { 100000u, 400000u, 1000000u };
+
+static atecc_bus_state_t states[ATECC_BUS_COUNT];
+
+static atecc_bus_state_t *state_of(i2c_inst_t *bus) {
+    return &states[i2c_hw_index(bus)];
+}
+
+static void window_reset(atecc_bus_state_t *state) {
+    state->window_responses = 0;
+    state->window_errors = 0;
+    state->downgrade_pending = false;
+}
+
+static void window_error(atecc_bus_state_t *state) {
+    if (++state->window_errors >= ATECC_BUS_ERROR_LIMIT && state->rate_hz > rates[0]) {
+        state->downgrade_pending = true;
+    }
+}
+
+/**
+ * @brief Sets the clock of a bus and records it.
+ *
+ * Waits for any asynchronous command first, so no transfer sees the change.
+ *
+ * @param[in] bus     The bus.
+ * @param[in] rate_hz The SCL frequency in Hz.
+ * @return the frequency the hardware actually runs at.
+ */
+uint32_t atecc_bus_set_rate(i2c_inst_t *bus, uint32_t rate_hz) {
+    hal_i2c_wait_idle();
+    state_of(bus)->rate_hz = rate_hz;
+    return i2c_set_baudrate(bus, rate_hz);
+}
+
+/**
+ * @brief Returns the clock last set with atecc_bus_set_rate().
+ *
+ * @param[in] bus The bus.
+ * @return the frequency in Hz, or 0 if the clock is not managed by this module.
+ */
+uint32_t atecc_bus_rate(i2c_inst_t *bus) {
+    return state_of(bus)->rate_hz;
+}
+
+/**
+ * @brief Returns the clock and error counters of a bus.
+ *
+ * @param[in] bus The bus.
+ * @return Pointer to the live counters.
+ */
+const atecc_bus_state_t *atecc_bus_state(i2c_inst_t *bus) {
+    return state_of(bus);
+}
+
+// Read config block 0, checking count and CRC without recording errors
+static bool read_block(uint8_t *block) {
+    uint8_t response[ATCA_BLOCK_SIZE + 3];
+
+    if (!send_atecc_command(ATCA_READ, ATCA_ZONE_CONFIG | ATCA_ZONE_READWRITE_32, 0x0000, NULL, 0) ||
+        !atecc_wait_response(response, sizeof(response)) ||
+        response[0] != sizeof(response) || !crc_matches(response, sizeof(response))) {
+        return false;
+    }
+    memcpy(block, &response[1], ATCA_BLOCK_SIZE);
+    return true;
+}
+
+static bool read_revision() {
+    uint8_t response[4 + 3];
+
+    return send_atecc_command(ATCA_INFO, INFO_MODE_REVISION, 0x0000, NULL, 0) &&
+           atecc_wait_response(response, sizeof(response)) &&
+           response[0] == sizeof(response) && crc_matches(response, sizeof(response));
+}
+
+// Round trips at the current clock; every read must reproduce the reference block
+static bool validate(const uint8_t *reference) {
+    uint8_t block[ATCA_BLOCK_SIZE];
+
+    for (size_t i = 0; i < ATECC_BUS_VALIDATE_ROUNDS; i++) {
+        if (!read_block(block) || memcmp(block, reference, sizeof(block)) != 0 || !read_revision()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Finds the fastest reliable clock for the selected device's bus.
+ *
+ * Starts at 100 kHz, then steps up to 400 kHz and 1 MHz (capped at ATECC_BUS_MAX_HZ)
+ * as long as ATECC_BUS_VALIDATE_ROUNDS Read and Info round trips pass at each step.
+ * The bus is left at the last rate that passed. Other devices on the same bus must
+ * be able to run at that rate too.
+ *
+ * @return the chosen rate in Hz, or 0 if the device does not answer at 100 kHz.
+ */
+uint32_t atecc_bus_negotiate() {
+    i2c_inst_t *bus = atecc_device_current()->bus;
+    atecc_bus_state_t *state = state_of(bus);
+    uint8_t reference[ATCA_BLOCK_SIZE];
+    uint32_t chosen = 0;
+
+    atecc_bus_set_rate(bus, rates[0]);
+    window_reset(state);
+    if (!atecc_session_begin()) {
+        return 0;
+    }
+
+    if (read_block(reference)) {
+        for (size_t i = 0; i < sizeof(rates) / sizeof(rates[0]) && rates[i] <= ATECC_BUS_MAX_HZ; i++) {
+            atecc_bus_set_rate(bus, rates[i]);
+            if (!validate(reference)) {
+                break;
+            }
+            chosen = rates[i];
+        }
+    }
+
+    atecc_bus_set_rate(bus, chosen != 0 ? chosen : rates[0]);
+    atecc_session_end();
+
+    state->negotiated_hz = chosen;
+    window_reset(state);
+    return chosen;
+}
+
+/**
+ * @brief Applies a pending clock downgrade.
+ *
+ * Called before each command from thread context; the error counters may run in
+ * interrupt context, so they only flag the downgrade.
+ *
+ * @param[in] bus The bus.
+ */
+void atecc_bus_service(i2c_inst_t *bus) {
+    atecc_bus_state_t *state = state_of(bus);
+    if (!state->downgrade_pending) {
+        return;
+    }
+
+    uint32_t lower = rates[0];
+    for (size_t i = 0; i < sizeof(rates) / sizeof(rates[0]) && rates[i] < state->rate_hz; i++) {
+        lower = rates[i];
+    }
+    atecc_bus_set_rate(bus, lower);
+    state->downgrades++;
+    window_reset(state);
+}
+
+/**
+ * @brief Counts a response read from a device on a bus.
+ *
+ * A CRC error status means the command packet was damaged on the way to the
+ * device, which counts against the bus like a damaged response.
+ *
+ * @param[in] bus      The bus.
+ * @param[in] response The raw response, count byte first.
+ * @param[in] length   The number of bytes read.
+ */
+void atecc_bus_note_response(i2c_inst_t *bus, const uint8_t *response, size_t length) {
+    atecc_bus_state_t *state = state_of(bus);
+    state->responses++;
+    if (++state->window_responses >= ATECC_BUS_WINDOW) {
+        state->window_responses = 0;
+        state->window_errors = 0;
+    }
+    if (length >= 4 && response[0] == 4 && response[1] == ATCA_STATUS_CRC_ERROR) {
+        state->crc_errors++;
+        window_error(state);
+    }
+}
+
+/**
+ * @brief Counts a response rejected for its CRC.
+ *
+ * @param[in] bus The bus.
+ */
+void atecc_bus_note_crc_error(i2c_inst_t *bus) {
+    atecc_bus_state_t *state = state_of(bus);
+    state->crc_errors++;
+    window_error(state);
+}
+
+/**
+ * @brief Counts a NACKed command packet or a command that was never answered.
+ *
+ * @param[in] bus The bus.
+ */
+void atecc_bus_note_timeout(i2c_inst_t *bus) {
+    atecc_bus_state_t *state = state_of(bus);
+    state->timeouts++;
+    window_error(state);
+}
@@ -0,0 +1,47 @@
+#ifndef ATECC_BUS_H
+#define ATECC_BUS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hardware/i2c.h"
+
+// I2C clock negotiation and error-rate monitoring, per bus. atecc_bus_negotiate()
+// steps the clock up through the standard rates while CRC-checked round trips keep
+// passing; afterwards, a bus that collects too many errors drops one step.
+
+#define ATECC_BUS_COUNT             (2u)        // i2c0 and i2c1
+#define ATECC_BUS_WAKE_HZ           (100000u)   // Fastest clock whose 0x00 byte still holds SDA low for tWLO
+#ifndef ATECC_BUS_MAX_HZ
+#define ATECC_BUS_MAX_HZ            (1000000u)  // Fast-mode Plus; lower it for weak pull-ups or long wires
+#endif
+#define ATECC_BUS_VALIDATE_ROUNDS   (8u)        // Read and Info round trips that must all pass at a new rate
+#define ATECC_BUS_WINDOW            (64u)       // Responses per error-rate window
+#define ATECC_BUS_ERROR_LIMIT       (3u)        // Errors within one window that drop the clock a step
+
+// Clock and error counters of one bus
+typedef struct {
+    uint32_t rate_hz;           // Current clock; 0 until set through this module
+    uint32_t negotiated_hz;     // Fastest clock that passed validation, 0 if never negotiated
+    uint32_t responses;         // Responses read
+    uint32_t crc_errors;        // Responses rejected for their CRC
+    uint32_t timeouts;          // Packets NACKed, or commands never answered
+    uint32_t downgrades;        // Steps dropped because of the error rate
+    uint32_t window_responses;
+    uint32_t window_errors;
+    volatile bool downgrade_pending;    // Applied before the next command
+} atecc_bus_state_t;
+
+uint32_t atecc_bus_set_rate(i2c_inst_t *bus, uint32_t rate_hz);
+uint32_t atecc_bus_rate(i2c_inst_t *bus);
+uint32_t atecc_bus_negotiate();
+const atecc_bus_state_t *atecc_bus_state(i2c_inst_t *bus);
+void atecc_bus_service(i2c_inst_t *bus);
+
+// Error accounting, called by the command layer and the transports
+void atecc_bus_note_response(i2c_inst_t *bus, const uint8_t *response, size_t length);
+void atecc_bus_note_crc_error(i2c_inst_t *bus);
+void atecc_bus_note_timeout(i2c_inst_t *bus);
+
+#endif // ATECC_BUS_H
@@ -0,0 +1,309 @@
+#include "atecc_channel.h"
+#include "atecc_cmd.h"
+#include "atecc_log.h"
+#include "atecc_power.h"
+#include "atecc_response.h"
+#include "hal_pico_i2c.h"
+
+static void put_be32(uint8_t *out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out[i] = (uint8_t)(value >> (24 - 8 * i));
+    }
+}
+
+static void put_be64(uint8_t *out, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        out[i] = (uint8_t)(value >> (56 - 8 * i));
+    }
+}
+
+static uint32_t get_be32(const uint8_t *in) {
+    return ((uint32_t)in[0] << 24) | ((uint32_t)in[1] << 16) | ((uint32_t)in[2] << 8) | in[3];
+}
+
+static uint64_t get_be64(const uint8_t *in) {
+    return ((uint64_t)get_be32(in) << 32) | get_be32(&in[4]);
+}
+
+// The header is authenticated ahead of the caller's AAD
+static size_t associated_data(const uint8_t *header, const uint8_t *aad, size_t aad_length, uint8_t *ad) {
+    memcpy(ad, header, ATECC_CHANNEL_HEADER_SIZE);
+    if (aad_length > 0) {
+        memcpy(&ad[ATECC_CHANNEL_HEADER_SIZE], aad, aad_length);
+    }
+    return ATECC_CHANNEL_HEADER_SIZE + aad_length;
+}
+
+/**
+ * @brief Derives the 32 bytes of keying material of an epoch on the device.
+ *
+ * ECDH leaves the shared secret in TempKey, HKDF-Extract turns it into a
+ * pseudorandom key in place, and one block of HKDF-Expand over info || epoch
+ * returns the material. Only the last step crosses the bus. The Extract step
+ * consumes TempKey, so a failure anywhere restarts the chain from ECDH.
+ *
+ * @param[in]  channel The channel, with its key slot, peer and info.
+ * @param[in]  epoch   The epoch the material is for.
+ * @param[out] okm     Receives the 32-byte output keying material.
+ * @return true on success, false otherwise.
+ */
+static bool derive(const atecc_channel_t *channel, uint32_t epoch, uint8_t *okm) {
+    uint8_t info[ATECC_CHANNEL_INFO_MAX + 4];
+    bool ok = false;
+
+    memcpy(info, channel->info, channel->info_length);
+    put_be32(&info[channel->info_length], epoch);
+
+    if (!atecc_session_begin()) {
+        ATECC_LOG(ECC_WAKE_FAILED, ATCA_ECDH, 0, 0, 0);
+        return false;
+    }
+    for (uint32_t attempt = 0; !ok && attempt <= ATECC_RETRY_LIMIT; attempt++) {
+        ok = ecc_ecdh_to_tempkey(channel->key_slot, channel->peer_public) &&
+             kdf_hkdf_extract_tempkey() &&
+             kdf_hkdf_expand(info, channel->info_length + 4, channel->io_protected ? channel->io_key : NULL, okm);
+    }
+    atecc_session_end();
+    return ok;
+}
+
+// Keys of one epoch: the AES key, then an IV prefix per direction
+typedef struct {
+    sw_aes_ctx_t aes;
+    uint8_t iv_seal[4];
+    uint8_t iv_open[4];
+} epoch_keys_t;
+
+static bool derive_keys(const atecc_channel_t *channel, uint32_t epoch, epoch_keys_t *keys) {
+    uint8_t okm[32];
+
+    if (!derive(channel, epoch, okm)) {
+        ATECC_LOG(CHANNEL_REKEY_FAILED, ATCA_KDF, 0, epoch, 0);
+        return false;
+    }
+
+    sw_aes_init(&keys->aes, okm);
+    memcpy(keys->iv_seal, &okm[channel->initiator ? 16 : 20], sizeof(keys->iv_seal));
+    memcpy(keys->iv_open, &okm[channel->initiator ? 20 : 16], sizeof(keys->iv_open));
+    memset(okm, 0, sizeof(okm));
+    return true;
+}
+
+// Makes derived keys the channel's current ones and wipes the source
+static void install(atecc_channel_t *channel, uint32_t epoch, epoch_keys_t *keys) {
+    channel->aes = keys->aes;
+    memcpy(channel->iv_seal, keys->iv_seal, sizeof(channel->iv_seal));
+    memcpy(channel->iv_open, keys->iv_open, sizeof(channel->iv_open));
+    sw_aes_wipe(&keys->aes);
+
+    if (channel->keyed) {
+        ATECC_LOG(CHANNEL_REKEY, ATCA_KDF, 0, epoch, (uint32_t)channel->bytes);
+        channel->rekeys++;
+    }
+    channel->keyed = true;
+    channel->epoch = epoch;
+    channel->sequence = 0;
+    channel->bytes = 0;
+    channel->open_next = 0;
+    channel->keyed_us = time_us_64();
+}
+
+// Derives and installs the keys of an epoch
+static bool rekey(atecc_channel_t *channel, uint32_t epoch) {
+    epoch_keys_t keys;
+
+    if (!derive_keys(channel, epoch, &keys)) {
+        return false;
+    }
+    install(channel, epoch, &keys);
+    return true;
+}
+
+/**
+ * @brief Opens one end of a channel with the peer's public key and derives epoch 0.
+ *
+ * Both ends must use the same info; one of them is the initiator.
+ *
+ * @param[out] channel     The channel state.
+ * @param[in]  key_slot    A slot holding our P-256 private key, with ECDH enabled.
+ * @param[in]  peer_public The peer's public key, X || Y.
+ * @param[in]  info        Application info bound into every key.
+ * @param[in]  info_length The info length, at most ATECC_CHANNEL_INFO_MAX.
+ * @param[in]  initiator   true on the end that opened the channel.
+ * @param[in]  policy      When to rekey, or NULL to keep one key.
+ * @param[in]  io_key      The IO protection key, to receive keys encrypted, or NULL.
+ * @return true if the first key was derived, false otherwise.
+ */
+bool atecc_channel_open(atecc_channel_t *channel, uint8_t key_slot, const uint8_t *peer_public,
+                        const uint8_t *info, size_t info_length, bool initiator,
+                        const atecc_rekey_policy_t *policy, const uint8_t *io_key) {
+    memset(channel, 0, sizeof(*channel));
+
+    if (info_length > ATECC_CHANNEL_INFO_MAX) {
+        ATECC_LOG(KDF_LENGTH_INVALID, ATCA_KDF, 0, info_length, 32);
+        return false;
+    }
+    channel->key_slot = key_slot;
+    memcpy(channel->peer_public, peer_public, ECC_P256_KEY_SIZE);
+    memcpy(channel->info, info, info_length);
+    channel->info_length = info_length;
+    channel->initiator = initiator;
+    if (policy != NULL) {
+        channel->policy = *policy;
+    }
+    if (io_key != NULL) {
+        memcpy(channel->io_key, io_key, ATECC_IO_KEY_SIZE);
+        channel->io_protected = true;
+    }
+    return rekey(channel, 0);
+}
+
+/**
+ * @brief Replaces the channel key with the one of the next epoch.
+ *
+ * @param[in,out] channel An open channel.
+ * @return true on success; on failure the current key stays in use.
+ */
+bool atecc_channel_rekey(atecc_channel_t *channel) {
+    return rekey(channel, channel->epoch + 1);
+}
+
+/**
+ * @brief Tells whether sealing another message would exceed the rekey policy.
+ *
+ * @param[in] channel An open channel.
+ * @param[in] length  The length of the next message.
+ * @return true if the key should be replaced first.
+ */
+bool atecc_channel_needs_rekey(const atecc_channel_t *channel, size_t length) {
+    const atecc_rekey_policy_t *policy = &channel->policy;
+
+    // A message longer than the limit still goes out under a fresh key
+    if (policy->max_bytes != 0 && channel->bytes > 0 && channel->bytes + length > policy->max_bytes) {
+        return true;
+    }
+    return policy->max_age_us != 0 && time_us_64() - channel->keyed_us >= policy->max_age_us;
+}
+
+/**
+ * @brief Encrypts and authenticates a message with AES-128-GCM.
+ *
+ * Rekeys first when the policy requires it. The header names the epoch and the
+ * sequence number; it forms the IV with our prefix and is authenticated with the
+ * AAD, so it travels in clear with the ciphertext and the tag.
+ *
+ * @param[in,out] channel    An open channel.
+ * @param[in]     aad        Additional authenticated data, or NULL.
+ * @param[in]     aad_length The AAD length, at most ATECC_CHANNEL_AAD_MAX.
+ * @param[in]     plaintext  The message.
+ * @param[out]    ciphertext Receives length bytes; may be the plaintext buffer.
+ * @param[in]     length     The message length.
+ * @param[out]    header     Receives ATECC_CHANNEL_HEADER_SIZE bytes.
+ * @param[out]    tag        Receives ATECC_CHANNEL_TAG_SIZE bytes.
+ * @return true on success, false if a required rekey failed.
+ */
+bool atecc_channel_seal(atecc_channel_t *channel, const uint8_t *aad, size_t aad_length,
+                        const uint8_t *plaintext, uint8_t *ciphertext, size_t length,
+                        uint8_t *header, uint8_t *tag) {
+    uint8_t iv[SW_AES_GCM_IV_SIZE];
+
+    if (aad_length > ATECC_CHANNEL_AAD_MAX) {
+        return false;
+    }
+    if (!channel->keyed || (atecc_channel_needs_rekey(channel, length) && !atecc_channel_rekey(channel))) {
+        return false;
+    }
+
+    put_be32(header, channel->epoch);
+    put_be64(&header[4], channel->sequence);
+    memcpy(iv, channel->iv_seal, 4);
+    memcpy(&iv[4], &header[4], 8);
+
+    uint8_t ad[ATECC_CHANNEL_HEADER_SIZE + ATECC_CHANNEL_AAD_MAX];
+    size_t ad_length = associated_data(header, aad, aad_length, ad);
+    sw_aes_gcm_encrypt(&channel->aes, iv, ad, ad_length, plaintext, ciphertext, length, tag);
+
+    channel->sequence++;
+    channel->bytes += length;
+    return true;
+}
+
+/**
+ * @brief Authenticates and decrypts a message sealed by the other end.
+ *
+ * A message from a later epoch means the peer has rekeyed. Its key is derived
+ * aside and the channel follows only once the message has authenticated, so a
+ * forged header cannot move the channel to another epoch. The peer may run at most
+ * ATECC_CHANNEL_EPOCH_SKIP_MAX epochs ahead. Messages from an earlier epoch are
+ * refused, since that key is gone. Within an epoch sequence numbers must increase:
+ * a replayed or reordered message is refused.
+ *
+ * @param[in,out] channel    An open channel.
+ * @param[in]     header     The header sealed with the message.
+ * @param[in]     aad        Additional authenticated data, or NULL.
+ * @param[in]     aad_length The AAD length, at most ATECC_CHANNEL_AAD_MAX.
+ * @param[in]     ciphertext The encrypted message.
+ * @param[out]    plaintext  Receives length bytes; left zeroed if authentication fails.
+ * @param[in]     length     The message length.
+ * @param[in]     tag        The tag sealed with the message.
+ * @return true if the message is authentic and new, false otherwise.
+ */
+bool atecc_channel_unseal(atecc_channel_t *channel, const uint8_t *header, const uint8_t *aad, size_t aad_length,
+                          const uint8_t *ciphertext, uint8_t *plaintext, size_t length, const uint8_t *tag) {
+    uint32_t epoch = get_be32(header);
+    uint64_t sequence = get_be64(&header[4]);
+    uint8_t iv[SW_AES_GCM_IV_SIZE];
+
+    if (!channel->keyed || aad_length > ATECC_CHANNEL_AAD_MAX) {
+        return false;
+    }
+    if (epoch < channel->epoch || epoch - channel->epoch > ATECC_CHANNEL_EPOCH_SKIP_MAX) {
+        ATECC_LOG(CHANNEL_EPOCH_INVALID, ATCA_KDF, 0, epoch, channel->epoch);
+        return false;
+    }
+    if (epoch == channel->epoch && sequence < channel->open_next) {
+        ATECC_LOG(CHANNEL_REPLAY, ATCA_KDF, 0, (uint32_t)sequence, (uint32_t)channel->open_next);
+        return false;
+    }
+
+    epoch_keys_t next;
+    const sw_aes_ctx_t *aes = &channel->aes;
+    const uint8_t *iv_open = channel->iv_open;
+    if (epoch > channel->epoch) {
+        if (!derive_keys(channel, epoch, &next)) {
+            return false;
+        }
+        aes = &next.aes;
+        iv_open = next.iv_open;
+    }
+
+    memcpy(iv, iv_open, 4);
+    memcpy(&iv[4], &header[4], 8);
+
+    uint8_t ad[ATECC_CHANNEL_HEADER_SIZE + ATECC_CHANNEL_AAD_MAX];
+    size_t ad_length = associated_data(header, aad, aad_length, ad);
+    bool authentic = sw_aes_gcm_decrypt(aes, iv, ad, ad_length, ciphertext, plaintext, length, tag);
+
+    if (epoch > channel->epoch) {
+        if (!authentic) {
+            sw_aes_wipe(&next.aes);
+            return false;
+        }
+        install(channel, epoch, &next);
+    }
+    if (!authentic) {
+        return false;
+    }
+    channel->open_next = sequence + 1;
+    return true;
+}
+
+/**
+ * @brief Wipes the keys and state of a channel.
+ *
+ * @param[out] channel The channel to close.
+ */
+void atecc_channel_close(atecc_channel_t *channel) {
+    sw_aes_wipe(&channel->aes);
+    memset(channel, 0, sizeof(*channel));
+}
@@ -0,0 +1,70 @@
+#ifndef ATECC_CHANNEL_H
+#define ATECC_CHANNEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "atecc_ecc.h"
+#include "atecc_kdf.h"
+#include "sw_aes.h"
+
+// Bulk encryption with a session key agreed on the device. ECDH with a private key
+// slot puts the shared secret in TempKey, KDF runs HKDF-Extract on it and one block
+// of HKDF-Expand over the channel info and the key epoch; only that output reaches the
+// MCU, which then encrypts with software AES-128-GCM at memory speed. A rekey repeats
+// the derivation for the next epoch when the rekey policy says the key is worn out.
+
+#define ATECC_CHANNEL_INFO_MAX      (64u)   // Application info mixed into every key
+#define ATECC_CHANNEL_AAD_MAX       (64u)   // Additional authenticated data per message
+#define ATECC_CHANNEL_HEADER_SIZE   (12u)   // Epoch (4) and sequence number (8), big-endian
+#define ATECC_CHANNEL_TAG_SIZE      SW_AES_GCM_TAG_SIZE
+
+// Epochs a received message may run ahead of ours; each one costs a derivation
+#ifndef ATECC_CHANNEL_EPOCH_SKIP_MAX
+#define ATECC_CHANNEL_EPOCH_SKIP_MAX (4u)
+#endif
+
+// When a channel key is replaced; zero fields do not limit
+typedef struct {
+    uint64_t max_bytes;         // Bytes sealed under one key
+    uint64_t max_age_us;        // Time since the key was derived
+} atecc_rekey_policy_t;
+
+// One end of a channel. Both ends derive the same keys; the initiator and responder
+// seal with different IV prefixes so their sequence numbers never collide.
+typedef struct {
+    uint8_t  key_slot;                          // Our P-256 private key
+    uint8_t  peer_public[ECC_P256_KEY_SIZE];
+    uint8_t  info[ATECC_CHANNEL_INFO_MAX];
+    size_t   info_length;
+    bool     initiator;
+    bool     io_protected;                      // The key crosses the bus encrypted
+    uint8_t  io_key[ATECC_IO_KEY_SIZE];
+    atecc_rekey_policy_t policy;
+
+    bool     keyed;
+    uint32_t epoch;                             // Keys derived before the current one
+    sw_aes_ctx_t aes;
+    uint8_t  iv_seal[4];                        // IV prefix of the messages we send
+    uint8_t  iv_open[4];                        // IV prefix of the messages we receive
+    uint64_t sequence;                          // Messages sealed under the current key
+    uint64_t open_next;                         // Lowest sequence number still accepted from the peer
+    uint64_t bytes;                             // Bytes sealed under the current key
+    uint64_t keyed_us;                          // When the current key was derived
+    uint32_t rekeys;
+} atecc_channel_t;
+
+bool atecc_channel_open(atecc_channel_t *channel, uint8_t key_slot, const uint8_t *peer_public,
+                        const uint8_t *info, size_t info_length, bool initiator,
+                        const atecc_rekey_policy_t *policy, const uint8_t *io_key);
+bool atecc_channel_rekey(atecc_channel_t *channel);
+bool atecc_channel_needs_rekey(const atecc_channel_t *channel, size_t length);
+bool atecc_channel_seal(atecc_channel_t *channel, const uint8_t *aad, size_t aad_length,
+                        const uint8_t *plaintext, uint8_t *ciphertext, size_t length,
+                        uint8_t *header, uint8_t *tag);
+bool atecc_channel_unseal(atecc_channel_t *channel, const uint8_t *header, const uint8_t *aad, size_t aad_length,
+                          const uint8_t *ciphertext, uint8_t *plaintext, size_t length, const uint8_t *tag);
+void atecc_channel_close(atecc_channel_t *channel);
+
+#endif // ATECC_CHANNEL_H
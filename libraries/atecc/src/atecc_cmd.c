@@ -1,183 +1,196 @@
 #include "atecc_cmd.h"
+#include "atecc_aes.h"
+#include "atecc_bus.h"
+#include "atecc_device.h"
 #include "hal_pico_i2c.h"
+#include "atecc_exec.h"
+#include "atecc_log.h"
+#include "atecc_config.h"
+#include "atecc_power.h"
+#include "atecc_random.h"
+#include "atecc_response.h"
+#include "atecc_sha.h"
 
 /**
- * @brief Reads the serial number from an ATECC device.
- *
- * This function reads the serial number from an ATECC device by sending read commands
- * and receiving responses in parts. It then prints the serial number in hexadecimal format.
+ * @brief Computes the Read/Write address word for a zone location.
  *
- * @return true if the serial number is successfully read, false otherwise.
+ * @param zone  The zone (ATCA_ZONE_CONFIG, ATCA_ZONE_OTP or ATCA_ZONE_DATA).
+ * @param slot  The slot number (data zone only).
+ * @param block The 32-byte block within the zone or slot.
+ * @param word  The 4-byte word within the block.
+ * @return The value for param2 of the Read/Write command.
  */
-bool read_atecc_serial_number()
-{
-    uint8_t serial[ATCA_SERIAL_NUM_SIZE];
-    uint8_t last_response[2];
+uint16_t atecc_zone_address(uint8_t zone, uint8_t slot, uint8_t block, uint8_t word) {
+    if (zone == ATCA_ZONE_DATA) {
+        return (uint16_t)(((uint16_t)block << 8) | ((uint16_t)(slot & 0x0F) << 3) | (word & 0x07));
+    }
+    return (uint16_t)(((block & 0x1F) << 3) | (word & 0x07));
+}
 
-    send_atecc_command(ATCA_READ, 0x00, 0x0000, NULL, 0);
-    sleep_ms(5);
-    if (!receive_atecc_response(&serial[0], 4, true))
+/**
+ * @brief Reads one 4-byte word or one 32-byte block from a zone.
+ *
+ * @param zone    The zone to read from.
+ * @param address The Read address word (see atecc_zone_address).
+ * @param data    The buffer to store the bytes read.
+ * @param block   true to read a 32-byte block, false to read a 4-byte word.
+ * @return true if the read succeeded, possibly after retries, false otherwise.
+ */
+static bool read_zone_unit(uint8_t zone, uint16_t address, uint8_t *data, bool block) {
+    uint8_t response[ATCA_BLOCK_SIZE + 3];
+    size_t length = block ? ATCA_BLOCK_SIZE : ATCA_WORD_SIZE;
+    uint8_t param1 = block ? (uint8_t)(zone | ATCA_ZONE_READWRITE_32) : zone;
+
+    atecc_result_t result = atecc_execute(ATCA_READ, param1, address, NULL, 0, response, length + 3,
+                                          ATECC_EXEC_REPLAYABLE);
+    if (result != ATECC_OK) {
+        ATECC_LOG(READ_FAILED, ATCA_READ, atecc_result_status(result), address, 0);
         return false;
+    }
 
-    send_atecc_command(ATCA_READ, 0x00, 0x0002, NULL, 0);
-    sleep_ms(5);
-    if (!receive_atecc_response(&serial[4], 5, true))
-        return false;
+    memcpy(data, &response[1], length);
+    return true;
+}
 
-    send_atecc_command(ATCA_READ, 0x00, 0x0003, NULL, 0);
-    sleep_ms(5);
-    if (!receive_atecc_response(last_response, 2, false))
-        return false;
-    serial[8] = last_response[0];
+/**
+ * @brief Reads a byte range from the config, OTP or data zone.
+ *
+ * Whenever the current offset is 32-byte aligned and at least 32 bytes remain, a whole
+ * block is fetched with a single 32-byte Read; leftover ranges fall back to 4-byte word
+ * reads. Offsets and lengths need not be word-aligned.
+ *
+ * @param zone   The zone (ATCA_ZONE_CONFIG, ATCA_ZONE_OTP or ATCA_ZONE_DATA).
+ * @param slot   The slot number for the data zone, ignored otherwise.
+ * @param offset The byte offset within the zone or slot.
+ * @param data   The buffer to store the bytes read.
+ * @param length The number of bytes to read.
+ * @return true if all bytes were read, false otherwise.
+ */
+bool atecc_read_zone(uint8_t zone, uint8_t slot, uint16_t offset, uint8_t *data, size_t length) {
+    while (length > 0) {
+        uint8_t block = (uint8_t)(offset / ATCA_BLOCK_SIZE);
+        uint8_t word = (uint8_t)((offset % ATCA_BLOCK_SIZE) / ATCA_WORD_SIZE);
+        uint16_t address = atecc_zone_address(zone, slot, block, word);
+
+        if (offset % ATCA_BLOCK_SIZE == 0 && length >= ATCA_BLOCK_SIZE) {
+            if (!read_zone_unit(zone, address, data, true)) {
+                return false;
+            }
+            offset += ATCA_BLOCK_SIZE;
+            data += ATCA_BLOCK_SIZE;
+            length -= ATCA_BLOCK_SIZE;
+            continue;
+        }
 
-    printf("🆔 Serial Number: ");
-    for (int i = 0; i < ATCA_SERIAL_NUM_SIZE; i++)
-    {
-        printf("%02X", serial[i]);
-    }
-    printf("\n");
+        uint8_t word_data[ATCA_WORD_SIZE];
+        if (!read_zone_unit(zone, address, word_data, false)) {
+            return false;
+        }
 
+        size_t skip = offset % ATCA_WORD_SIZE;
+        size_t chunk = ATCA_WORD_SIZE - skip;
+        if (chunk > length) {
+            chunk = length;
+        }
+        memcpy(data, &word_data[skip], chunk);
+        offset += chunk;
+        data += chunk;
+        length -= chunk;
+    }
     return true;
 }
 
 /**
- * @brief Maps an array of 8 random bytes to a specified range.
+ * @brief Reads the serial number from an ATECC device.
  *
- * This function takes an array of 8 random bytes and maps the resulting
- * 64-bit random value to a specified range between min and max (inclusive).
+ * The serial number is spread over config bytes 0-3 and 8-12, so the first
+ * 32-byte config block is read in one transaction and the bytes are picked from it.
  *
- * @param random_bytes An array of 8 random bytes.
- * @param min The minimum value of the desired range.
- * @param max The maximum value of the desired range.
- * @return A 64-bit random value mapped to the specified range.
+ * @param serial The buffer to store the ATCA_SERIAL_NUM_SIZE serial number bytes.
+ * @return true if the serial number is successfully read, false otherwise.
  */
-uint64_t map_random_to_range(uint8_t *random_bytes, uint64_t min, uint64_t max) {
-    uint64_t random_value = 0;
-    for (int i = 0; i < 8; i++) {
-        random_value = (random_value << 8) | random_bytes[i];
+bool read_atecc_serial_number(uint8_t *serial)
+{
+    uint8_t block[ATCA_BLOCK_SIZE];
+
+    if (!atecc_read_zone(ATCA_ZONE_CONFIG, 0, 0, block, sizeof(block))) {
+        return false;
     }
-    return min + (random_value % (max - min + 1));
+
+    memcpy(&serial[0], &block[0], 4);
+    memcpy(&serial[4], &block[8], 5);
+    return true;
 }
 
 /**
  * @brief Generates a random number within a specified range using the ATECC608A cryptographic co-processor.
  *
- * This function utilizes the ATECC608A cryptographic co-processor to generate a random number.
- * It then maps the generated random value to the given range [min, max] and prints the result.
+ * This function draws an unbiased random number in the range [min, max] from the
+ * entropy pool (see random_uniform) and prints the result.
  *
  * @param min The minimum value of the range.
  * @param max The maximum value of the range.
  */
 void generate_random_number_in_range(uint64_t min, uint64_t max) {
-    uint8_t response[35];
-
-    send_atecc_command(ATCA_RANDOM, 0x00, 0x0000, NULL, 0);
-    sleep_ms(23);
-
-    if (hal_i2c_receive(response, sizeof(response)) != (int)sizeof(response)) {
-        printf("❌ ERROR: Failed to read random number response\n");
-        return;
-    }
+    uint64_t value;
 
-    if (response[0] != 0x23) {
-        printf("❌ ERROR: Invalid response length byte!\n");
+    if (!random_uniform(min, max, &value)) {
+        printf("❌ ERROR: Failed to generate random number\n");
         return;
     }
 
-    // Map random value to range
-    uint64_t mapped_value = map_random_to_range(&response[1], min, max);
-    printf("🎲 Random Number (Mapped to Range %llu-%llu): %llu\n", min, max, mapped_value);
+    printf("🎲 Random Number (Mapped to Range %llu-%llu): %llu\n",
+           (unsigned long long)min, (unsigned long long)max, (unsigned long long)value);
 }
 
 /**
  * @brief Generates a random value of a specified length using the ATECC608A cryptographic co-processor.
  *
- * This function utilizes the ATECC608A cryptographic co-processor to generate a random value of a specified length.
- * It then prints the generated random value in hexadecimal format.
+ * This function draws the requested number of bytes from the entropy pool
+ * and prints the generated random value in hexadecimal format.
  *
  * @param length The length of the random value to generate.
  * @return true if the random value is successfully generated, false otherwise.
  */
 bool generate_random_value(uint8_t length) {
-    uint8_t response[35];
-
-    // Use the RANDOM_SEED_UPDATE command to generate random bytes
-    send_atecc_command(ATCA_RANDOM, RANDOM_SEED_UPDATE, 0x0000, NULL, 0);
-    sleep_ms(23);
+    uint8_t value[UINT8_MAX];
 
-    if (hal_i2c_receive(response, sizeof(response)) != (int)sizeof(response)) {
-        printf("❌ ERROR: Failed to read random number response\n");
-        return false;
-    }
-
-    if (response[0] != 0x23) {
-        printf("❌ ERROR: Invalid response length byte!\n");
+    if (!get_random_bytes(value, length)) {
+        printf("❌ ERROR: Failed to read random value\n");
         return false;
     }
 
     printf("🎲 Random Value (HEX): ");
-    for (int i = 4; i < length; i++) {
-        printf("%02X ", response[i]);
+    for (int i = 0; i < length; i++) {
+        printf("%02X ", value[i]);
         if ((i + 1) % 16 == 0) printf("\n");
     }
+    if (length % 16 != 0) printf("\n");
     return true;
 }
 
 /**
  * @brief Computes the SHA-256 hash of a given message using the ATECC608A cryptographic co-processor.
  *
- * This function computes the SHA-256 hash of a given message using the ATECC608A cryptographic co-processor.
- * It sends the message in blocks of 64 bytes to the device and reads the resulting hash value.
+ * This function hashes a NUL-terminated message with the streaming SHA-256 API
+ * and prints the resulting hash value.
  *
  * @param message The message for which to compute the SHA-256 hash.
  * @return true if the SHA-256 hash is successfully computed, false otherwise.
  */
 bool compute_sha256_hash(const char *message) {
-    size_t message_len = strlen(message);
-    size_t offset = 0;
-    uint8_t response[35];
-
-    // Step 1: Start SHA computation
-    if (!send_atecc_command(ATCA_SHA, 0x00, 0x0000, NULL, 0)) {
-        printf("❌ ERROR: SHA Start command failed!\n");
-        return false;
-    }
-    sleep_ms(5);
-
-    // Step 2: Process full 64-byte blocks (SHA Update)
-    while (message_len - offset >= 64) {
-        if (!send_atecc_command(ATCA_SHA, 0x01, 0x0000, (const uint8_t *)&message[offset], 64)) {
-            printf("❌ ERROR: SHA Update command failed!\n");
-            return false;
-        }
-        offset += 64;
-        sleep_ms(5);
-    }
-
-    // Step 3: Process the final block (SHA End)
-    if (!send_atecc_command(ATCA_SHA, 0x02, message_len - offset, (const uint8_t *)&message[offset], message_len - offset)) {
-        printf("❌ ERROR: SHA End command failed!\n");
-        return false;
-    }
-    sleep_ms(5);
-
-    // Step 4: Read the response
-    int res = hal_i2c_receive(response, sizeof(response));
-    if (res < 0 || response[0] != 0x23) {
-        printf("❌ ERROR: Failed to retrieve SHA-256 digest!\n");
-        return false;
-    }
+    sha256_ctx_t ctx;
+    uint8_t digest[SHA256_DIGEST_SIZE];
 
-    // Step 5: Validate CRC
-    if (!validate_crc(response, sizeof(response))) {
-        printf("❌ ERROR: CRC check failed for response!\n");
+    if (!sha256_init(&ctx) ||
+        !sha256_update(&ctx, (const uint8_t *)message, strlen(message)) ||
+        !sha256_final(&ctx, digest)) {
         return false;
     }
 
-    // Step 6: Print Hash
     printf("🔢 SHA-256: ");
-    for (int i = 1; i <= 32; i++) {
-        printf("%02X", response[i]);
+    for (size_t i = 0; i < SHA256_DIGEST_SIZE; i++) {
+        printf("%02X", digest[i]);
     }
     printf("\n");
 
@@ -185,127 +198,77 @@ bool compute_sha256_hash(const char *message) {
 }
 
 /**
- * @brief Reads the configuration of a specific slot from the ATECC608A device over I2C bus.
+ * @brief Prints the configuration of a specific slot of the ATECC608A device.
  *
- * This function reads the configuration of a specific slot from the ATECC608A device by sending read commands
- * and receiving responses. It then prints the configuration data in hexadecimal format.
+ * This function looks up the SlotConfig and KeyConfig of a specific slot in the
+ * configuration zone shadow and prints the raw and decoded values.
  *
  * @param slot The slot number for which to read the configuration.
  * @return true if the slot configuration is successfully read, false otherwise.
  */
 bool read_slot_config(uint8_t slot) {
-    uint8_t response[4];
     printf("🔎 Checking Slot %d Configuration...\n", slot);
 
-    if (!send_atecc_command(ATCA_READ, 0x00, slot, NULL, 0)) {
-        printf("❌ ERROR: Failed to send slot config read command!\n");
-        return false;
-    }
-    sleep_ms(20);
-
-    if (hal_i2c_receive(response, 4) != 4) {
+    const atecc_config_t *config = atecc_config_get();
+    if (config == NULL || slot >= ATECC_NUM_SLOTS) {
         printf("❌ ERROR: Failed to read slot configuration!\n");
         return false;
     }
 
-    printf("🔎 Slot %d Config Data: %02X %02X %02X %02X\n", slot, response[0], response[1], response[2], response[3]);
+    const uint8_t *raw = &config->raw[ATECC_CFG_SLOT_CONFIG + 2 * slot];
+    const atecc_key_config_t *key_config = &config->key_config[slot];
+    printf("🔎 Slot %d Config Data: %02X %02X\n", slot, raw[0], raw[1]);
+    printf("🔎 Slot %d Key Type: %d%s%s\n", slot, key_config->key_type,
+           key_config->private_key ? " (private)" : "",
+           atecc_slot_is_locked(slot) ? " (locked)" : "");
     return true;
 }
 
 /**
- * @brief Reads the configuration data of all slots from the ATECC608A device over I2C bus.
+ * @brief Reads the full configuration zone from the ATECC608A device over I2C bus.
  *
- * This function reads the configuration data of all slots from the ATECC608A device by sending read commands
- * and receiving responses. It then prints the configuration data in hexadecimal format.
+ * The 128-byte zone is fetched as four 32-byte block reads.
  *
+ * @param config_data The buffer to store the CONFIG_ZONE_SIZE configuration bytes.
  * @return true if the configuration data is successfully read, false otherwise.
  */
-bool read_config_zone() {
-    uint8_t config_data[128] = {0};  // Full 128-byte config zone
-    uint8_t response[5];  // Read buffer (5 bytes to include index byte)
-    int config_index = 0;  // Tracks where to store valid bytes
-
-    printf("🔎 Reading Configuration Data...\n");
-
-    for (uint8_t i = 0; i < TOTAL_READS; i++) {
-        if (!send_atecc_command(ATCA_READ, 0x00, i, NULL, 0)) {
-            printf("❌ ERROR: Failed to send read command for index %d!\n", i);
-            return false;
-        }
-        sleep_ms(20);
-
-        if (hal_i2c_receive(response, 5) != 5) {  // Read 5 bytes
-            printf("❌ ERROR: Failed to read configuration for index %d!\n", i);
-            return false;
-        }
-
-        // Store only the last 4 bytes, skipping the index byte (0x07)
-        if (config_index + 4 <= 128) {
-            config_data[config_index]     = response[1];
-            config_data[config_index + 1] = response[2];
-            config_data[config_index + 2] = response[3];
-            config_data[config_index + 3] = response[4];
-            config_index += 4;  // Move forward by exactly 4 bytes
-        }
-    }
-
-    // Print formatted config data (16 bytes per row)
-    for (int i = 0; i < 128; i++) {
-        printf("%02X ", config_data[i]);
-        if ((i + 1) % 16 == 0) {
-            printf("\n");
-        }
-    }
-    return true;
+bool read_config_zone(uint8_t *config_data) {
+    return atecc_read_zone(ATCA_ZONE_CONFIG, 0, 0, config_data, CONFIG_ZONE_SIZE);
 }
 
 /**
  * @brief Checks the lock status of the ATECC608A device.
  *
- * This function checks the lock status of the ATECC608A device by sending read commands
- * and receiving responses. It then prints the lock status of the device.
+ * This function checks the lock status of the ATECC608A device using the configuration
+ * zone shadow (loaded from the device on first use). It then prints the lock status of the device.
  *
  * @return true if the lock status is successfully checked, false otherwise.
  */
 bool check_lock_status() {
     printf("🔍 Checking ATECC608A Lock Status...\n");
 
-    uint8_t response[5];  // Read 5 bytes to ensure full data capture
-    uint8_t expected_address = 0x15;  // Correct address for lock bytes
-
-    // 🔹 Send read command for lock status at word address 0x15
-    if (!send_atecc_command(ATCA_READ, 0x00, expected_address, NULL, 0)) {
-        printf("❌ ERROR: Failed to send lock status read command!\n");
+    const atecc_config_t *config = atecc_config_get();
+    if (config == NULL) {
+        printf("❌ ERROR: Failed to read lock status!\n");
         return false;
     }
 
-    sleep_ms(23);
-    if (hal_i2c_receive(response, sizeof(response)) != 5) { 
-        printf("❌ ERROR: Failed to read lock status response!\n");
-        return false;
-    }
-
-   // Print raw lock status response (5 bytes) for debugging purposes
-    printf("🔐 Raw Lock Status Response: %02X %02X %02X %02X %02X\n",
-           response[0], response[1], response[2], response[3], response[4]);
-
-    // Extract correct lock bytes from response[3] and response[4]
-    uint8_t lock_config = response[3];  // Byte 0x15 (Config Lock)
-    uint8_t lock_value = response[4];   // Byte 0x16 (Data Lock)
+    uint8_t lock_config = config->lock_config;  // Byte 87 (Config Lock)
+    uint8_t lock_value = config->lock_value;    // Byte 86 (Data Lock)
 
     printf("🔒 Config Lock Status: %02X\n", lock_config);
     printf("🔒 Data Lock Status: %02X\n", lock_value);
 
     // 🔐 Determine Lock Status
-    if (lock_config == 0x00 && lock_value == 0x00) {
+    if (lock_config == ATECC_LOCK_LOCKED && lock_value == ATECC_LOCK_LOCKED) {
         printf("🔒 Chip is **FULLY LOCKED** (Config & Data).\n");
         return true;
     } 
-    else if (lock_config == 0x55 && lock_value == 0x55) {
+    else if (lock_config == ATECC_LOCK_UNLOCKED && lock_value == ATECC_LOCK_UNLOCKED) {
         printf("🔓 Chip is **UNLOCKED**.\n");
         return true;
     } 
-    else if (lock_config == 0x00 && lock_value == 0x55) {
+    else if (lock_config == ATECC_LOCK_LOCKED && lock_value == ATECC_LOCK_UNLOCKED) {
         printf("⚠️ Chip is **PARTIALLY LOCKED** (Config Locked, Data Open).\n");
         return true;
     } 
@@ -318,58 +281,55 @@ bool check_lock_status() {
 /**
  * @brief Sends a Nonce command to the ATECC608A device to generate a random nonce.
  *
- * This function sends a Nonce command to the ATECC608A device to generate a random nonce.
+ * This function sends a random-mode Nonce command with an all-zero 20-byte NumIn.
  * It then reads the 32-byte response and stores the random nonce in the provided buffer.
  *
  * @param random_out The buffer to store the generated random nonce.
  * @return true if the Nonce command is successfully sent and the random nonce is generated, false otherwise.
  */
 bool send_nonce_command(uint8_t *random_out) {
-    uint8_t command[8];
-    uint8_t response[32];  // Nonce response
-
-    printf("🔹 Sending Nonce Command...\n");
-
-    command[0] = 0x03;  // Packet header
-    command[1] = 0x07;  // Length (7 bytes)
-    command[2] = 0x16;  // Nonce Opcode
-    command[3] = 0x00;  // Mode (random nonce)
-    command[4] = 0x00;  // Zero (reserved)
-    command[5] = 0x00;  // Zero (reserved)
-
-    uint8_t computed_crc[2];
-    compute_crc(6, command, computed_crc);
-    command[6] = computed_crc[0];
-    command[7] = computed_crc[1];
-
-    int res = hal_i2c_send((uint8_t*)&command, sizeof(command));
-    if (res != sizeof(command)) {
-        printf("❌ ERROR: I2C write failed for Nonce Command.\n");
-        return false;
-    }
+    static const uint8_t num_in[NONCE_NUMIN_SIZE] = { 0 };
+    uint8_t response[32 + 3];  // Count, nonce, CRC
 
-    sleep_ms(5);
+    ATECC_LOG(NONCE_SEND, ATCA_NONCE, 0, 0, 0);
 
-    // Read 32-byte response
-    res = hal_i2c_receive(response, sizeof(response));
-    if (res != sizeof(response)) {
-        printf("❌ ERROR: Failed to read Nonce response.\n");
+    if (atecc_execute(ATCA_NONCE, NONCE_MODE_RANDOM, 0x0000, num_in, sizeof(num_in), response, sizeof(response),
+                      ATECC_EXEC_REPLAYABLE) != ATECC_OK) {
         return false;
     }
 
-    int actual_len = sizeof(response) - 1;  // Subtract first byte
-    if (actual_len > 32) actual_len = 32;   // Limit to 32 bytes
-    memcpy(random_out, response + 1, actual_len);
-    printf("🔹 Nonce Generated.\n");
+    memcpy(random_out, response + 1, 32);
+    ATECC_LOG(NONCE_DONE, ATCA_NONCE, 0, 0, 0);
+
+    return true;
+}
+
+/**
+ * @brief Loads a 32-byte value into TempKey with a pass-through Nonce command.
+ *
+ * Used to bind an externally computed digest to device state, e.g. before a Sign
+ * or Verify of an external message.
+ *
+ * @param value The 32 bytes to place in TempKey.
+ * @return true if TempKey was loaded, false otherwise.
+ */
+bool nonce_load_tempkey(const uint8_t *value) {
+    uint8_t response[4];
 
+    atecc_result_t result = atecc_execute(ATCA_NONCE, NONCE_MODE_PASSTHROUGH, 0x0000, value, 32, response,
+                                          sizeof(response), ATECC_EXEC_REPLAYABLE);
+    if (result != ATECC_OK) {
+        ATECC_LOG(NONCE_LOAD_FAILED, ATCA_NONCE, atecc_result_status(result), 0, 0);
+        return false;
+    }
     return true;
 }
 
 /**
  * @brief Sends an AES command to the ATECC608A device over I2C bus.
  *
- * This function constructs an AES command packet and sends it to the ATECC608A device
- * over the I2C bus. It computes the CRC for the command packet and sends it to the device.
+ * This function sends an AES command with one 16-byte block to the ATECC608A device
+ * over the I2C bus. The packet is built by the shared command packet builder.
  *
  * @param mode The AES mode (0x00 for encrypt, 0x01 for decrypt).
  * @param key_slot The key slot to use for encryption/decryption.
@@ -377,25 +337,8 @@ bool send_nonce_command(uint8_t *random_out) {
  * @return true if the AES command is successfully sent, false otherwise.
  */
 bool send_aes_command(uint8_t mode, uint8_t key_slot, const uint8_t *input_data) {
-    uint8_t command[24];
-    command[0] = 0x03;  // Packet header
-    command[1] = 0x17;  // Length (23 bytes)
-    command[2] = 0x51;  // AES Opcode
-    command[3] = mode;  // AES Mode
-    command[4] = key_slot & 0xFF;  // Key Slot LSB
-    command[5] = 0x00;  // Key Slot MSB
-    memcpy(&command[6], input_data, 16); // AES Plaintext
-
-    // **Compute CRC for first 21 bytes**
-    uint8_t computed_crc[2];
-    compute_crc(21, command + 1, computed_crc);
-    command[22] = computed_crc[0];
-    command[23] = computed_crc[1];
-
-    // **Send the AES command over I2C**
-    int res = hal_i2c_send((uint8_t*)&command, sizeof(command));
-    if (res != sizeof(command)) {
-        printf("❌ ERROR: I2C write failed (expected %zu bytes, got %d)\n", sizeof(command), res);
+    if (!send_atecc_command(ATCA_AES, mode, key_slot, input_data, AES_BLOCK_SIZE)) {
+        ATECC_LOG(AES_SEND_FAILED, ATCA_AES, 0, 0, 0);
         return false;
     }
     return true;
@@ -411,23 +354,50 @@ bool send_aes_command(uint8_t mode, uint8_t key_slot, const uint8_t *input_data)
  * @return true if the AES response is successfully received, false otherwise.
  */
 bool receive_aes_response(uint8_t *output_data) {
-    uint8_t response[19];
+    uint8_t response[AES_BLOCK_SIZE + 3];
+    const size_t crc_offset = sizeof(response) - 2;
 
-    int res = hal_i2c_receive(response, sizeof(response));
-    if (res != sizeof(response)) {
-        printf("❌ ERROR: I2C Read failed (Expected %d bytes, got %d)\n", (int)sizeof(response), res);
+    if (!atecc_wait_response(response, sizeof(response))) {
+        ATECC_LOG(AES_RESPONSE_FAILED, ATCA_AES, 0, sizeof(response), 0);
         return false;
     }
 
     uint8_t crc[2];
-    compute_crc(17, response, crc);
-    if (crc[0] != response[17] || crc[1] != response[18]) {
-        printf("❌ ERROR: CRC mismatch! Expected: %02X %02X, Got: %02X %02X\n",
-               crc[0], crc[1], response[17], response[18]);
+    compute_crc(crc_offset, response, crc);
+    if (crc[0] != response[crc_offset] || crc[1] != response[crc_offset + 1]) {
+        ATECC_LOG(AES_CRC_MISMATCH, ATCA_AES, 0, (crc[0] << 8) | crc[1],
+                  (response[crc_offset] << 8) | response[crc_offset + 1]);
+        atecc_bus_note_crc_error(atecc_device_current()->bus);
+        ATECC_STATS_CRC_ERROR(ATCA_AES);
+        return false;
+    }
+
+    memcpy(output_data, &response[1], AES_BLOCK_SIZE);
+    return true;
+}
+
+/**
+ * @brief Runs one AES block through the device and reads the result.
+ *
+ * Unlike send_aes_command() and receive_aes_response(), which leave a command in
+ * flight for pipelining, this goes through atecc_execute() and so retries
+ * transient failures.
+ *
+ * @param mode The AES mode (0x00 for encrypt, 0x01 for decrypt).
+ * @param key_slot The key slot to use for encryption/decryption.
+ * @param input_data The 16-byte input block.
+ * @param output_data The buffer to store the 16-byte output block.
+ * @return true if the block was processed, false otherwise.
+ */
+bool aes_execute_block(uint8_t mode, uint8_t key_slot, const uint8_t *input_data, uint8_t *output_data) {
+    uint8_t response[AES_BLOCK_SIZE + 3];
+
+    if (atecc_execute(ATCA_AES, mode, key_slot, input_data, AES_BLOCK_SIZE, response, sizeof(response),
+                      ATECC_EXEC_REPLAYABLE) != ATECC_OK) {
         return false;
     }
 
-    memcpy(output_data, &response[1], 16);
+    memcpy(output_data, &response[1], AES_BLOCK_SIZE);
     return true;
 }
 
@@ -436,7 +406,11 @@ bool receive_aes_response(uint8_t *output_data) {
  *
  * This function encrypts a plaintext message using AES 128-bit encryption
  * with the specified key slot on the ATECC608A device. It sends the AES command
- * to the device and receives the encrypted ciphertext in response.
+ * to the device and receives the encrypted ciphertext in response; transient failures
+ * are retried (see atecc_execute()). The device is
+ * only woken if the power manager does not already hold it awake.
+ * The slot's KeyType is checked against the configuration zone shadow first,
+ * so a misconfigured slot fails without a bus round trip.
  *
  * @param plaintext The plaintext message to encrypt.
  * @param ciphertext The buffer to store the encrypted ciphertext.
@@ -444,27 +418,20 @@ bool receive_aes_response(uint8_t *output_data) {
  * @return true if the plaintext message is successfully encrypted, false otherwise.
  */
 bool aes_encrypt(const uint8_t *plaintext, uint8_t *ciphertext, uint8_t key_slot) {
-    send_idle_command();
-    if (!wake_atecc_device()) {
-        printf("❌ Failed to wake device.\n");
+    if (!atecc_slot_is_aes_key(key_slot)) {
+        ATECC_LOG(AES_SLOT_NOT_KEY, ATCA_AES, 0, key_slot, 0);
         return false;
     }
 
-    sleep_ms(5);
-
-    if (!send_aes_command(0x00, key_slot, plaintext)) {
-        printf("❌ Failed to send AES encrypt command.\n");
+    if (!atecc_session_begin()) {
+        ATECC_LOG(AES_WAKE_FAILED, ATCA_AES, 0, 0, 0);
         return false;
     }
 
-    sleep_ms(5);
-
-    if (!receive_aes_response(ciphertext)) {
-        printf("❌ Failed to receive AES encrypt response.\n");
-        return false;
-    }
+    bool ok = aes_execute_block(0x00, key_slot, plaintext, ciphertext);
 
-    return true;
+    atecc_session_end();
+    return ok;
 }
 
 /**
@@ -472,7 +439,11 @@ bool aes_encrypt(const uint8_t *plaintext, uint8_t *ciphertext, uint8_t key_slot
  *
  * This function decrypts a ciphertext message using AES 128-bit decryption
  * with the specified key slot on the ATECC608A device. It sends the AES command
- * to the device and receives the decrypted plaintext in response.
+ * to the device and receives the decrypted plaintext in response; transient failures
+ * are retried (see atecc_execute()). The device is
+ * only woken if the power manager does not already hold it awake.
+ * The slot's KeyType is checked against the configuration zone shadow first,
+ * so a misconfigured slot fails without a bus round trip.
  *
  * @param ciphertext The ciphertext message to decrypt.
  * @param plaintext The buffer to store the decrypted plaintext.
@@ -480,25 +451,18 @@ bool aes_encrypt(const uint8_t *plaintext, uint8_t *ciphertext, uint8_t key_slot
  * @return true if the ciphertext message is successfully decrypted, false otherwise.
  */
 bool aes_decrypt(const uint8_t *ciphertext, uint8_t *plaintext, uint8_t key_slot) {
-    send_idle_command();
-    if (!wake_atecc_device()) {
-        printf("❌ Failed to wake device.\n");
+    if (!atecc_slot_is_aes_key(key_slot)) {
+        ATECC_LOG(AES_SLOT_NOT_KEY, ATCA_AES, 0, key_slot, 0);
         return false;
     }
 
-    sleep_ms(5);  // Ensure device is awake
-
-    if (!send_aes_command(0x01, key_slot, ciphertext)) {
-        printf("❌ Failed to send AES decrypt command.\n");
+    if (!atecc_session_begin()) {
+        ATECC_LOG(AES_WAKE_FAILED, ATCA_AES, 0, 0, 0);
         return false;
     }
 
-    sleep_ms(5);  // Ensure enough time for AES processing
+    bool ok = aes_execute_block(0x01, key_slot, ciphertext, plaintext);
 
-    if (!receive_aes_response(plaintext)) {
-        printf("❌ Failed to receive AES decrypt response.\n");
-        return false;
-    }
-
-    return true;
+    atecc_session_end();
+    return ok;
 }
@@ -17,7 +17,10 @@ extern "C" {
 #define SLOT_CONFIG_SIZE      (32u)         // 16 slots * 2 bytes each
 #define CONFIG_ZONE_SIZE      (128u)       // Size of the configuration zone
 #define ATCA_SERIAL_NUM_SIZE  (9u)         // Serial number size
-#define TOTAL_READS           (32u)        // 128 bytes total, 4 bytes per read
+#define OTP_ZONE_SIZE         (64u)        // Size of the OTP zone
+#define ATCA_BLOCK_SIZE       (32u)        // Bytes per 32-byte block read/write
+#define ATCA_WORD_SIZE        (4u)         // Bytes per 4-byte word read/write
+#define NONCE_NUMIN_SIZE      (20u)        // NumIn size for a random-mode Nonce
 
 // Opcodes for ATECC608A command set
 #define ATCA_CHECKMAC           ((uint8_t)0x28)  // CheckMac command op-code
@@ -43,22 +46,36 @@ extern "C" {
 #define ATCA_AES                ((uint8_t)0x51)  // AES command op-code
 #define ATCA_KDF                ((uint8_t)0x56)  // KDF command op-code
 #define ATCA_IDLE               ((uint8_t)0x02)  // Idle command op-code
+#define ATCA_SLEEP              ((uint8_t)0x01)  // Sleep command op-code
 #define RANDOM_SEED_UPDATE      ((uint8_t)0x00) // Random mode for automatic seed update
-#define SLOT_CONFIG_START       ((uint8_t)0x20) // SlotConfig starts at byte offset 32 (0x20)
+#define ATCA_STATUS_CRC_ERROR   ((uint8_t)0xFF) // Status: the device received a packet with a bad CRC
+#define INFO_MODE_REVISION      ((uint8_t)0x00) // Info mode: device revision
+#define NONCE_MODE_RANDOM       ((uint8_t)0x00) // Nonce mode: combine 20-byte NumIn with an RNG output
+#define NONCE_MODE_PASSTHROUGH  ((uint8_t)0x03) // Nonce mode: load 32 input bytes into TempKey
+#define SLOT_CONFIG_START       ((uint8_t)0x14) // SlotConfig starts at byte offset 20 (0x14)
 #define LOCK_ZONE_CONFIG        ((uint8_t)0x00) // Lock Config Zone
 #define LOCK_ZONE_DATA          ((uint8_t)0x01) // Lock Data Zone
 #define LOCK_ZONE_DATA_SLOT     ((uint8_t)0x02) // Lock Data Slot
+#define ATCA_ZONE_CONFIG        ((uint8_t)0x00) // Read/Write zone: Config
+#define ATCA_ZONE_OTP           ((uint8_t)0x01) // Read/Write zone: OTP
+#define ATCA_ZONE_DATA          ((uint8_t)0x02) // Read/Write zone: Data
+#define ATCA_ZONE_READWRITE_32  ((uint8_t)0x80) // Read/Write 32 bytes instead of 4
+#define ATCA_ZONE_ENCRYPTED     ((uint8_t)0x40) // Write: data is encrypted with TempKey and followed by a MAC
 
-bool read_atecc_serial_number();
+uint16_t atecc_zone_address(uint8_t zone, uint8_t slot, uint8_t block, uint8_t word);
+bool atecc_read_zone(uint8_t zone, uint8_t slot, uint16_t offset, uint8_t *data, size_t length);
+bool read_atecc_serial_number(uint8_t *serial);
 void generate_random_number_in_range(uint64_t min, uint64_t max);
 bool compute_sha256_hash(const char *message);
 bool read_slot_config(uint8_t slot);
 bool generate_random_value(uint8_t length);
-bool read_config_zone();
+bool read_config_zone(uint8_t *config_data);
 bool check_lock_status();
 bool send_aes_command(uint8_t mode, uint8_t key_slot, const uint8_t *input_data);
 bool send_nonce_command(uint8_t *random_out);
+bool nonce_load_tempkey(const uint8_t *value);
 bool receive_aes_response(uint8_t *output_data);
+bool aes_execute_block(uint8_t mode, uint8_t key_slot, const uint8_t *input_data, uint8_t *output_data);
 bool aes_encrypt(const uint8_t *plaintext, uint8_t *ciphertext, uint8_t key_slot);
 bool aes_decrypt(const uint8_t *ciphertext, uint8_t *plaintext, uint8_t key_slot);
 
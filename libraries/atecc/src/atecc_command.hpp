@@ -0,0 +1,205 @@
+#ifndef ATECC_COMMAND_HPP
+#define ATECC_COMMAND_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "atecc_aes.h"
+#include "atecc_cmd.h"
+#include "atecc_counter.h"
+#include "atecc_ecc.h"
+#include "atecc_exec.h"
+#include "atecc_packet.h"
+#include "atecc_response.h"
+#include "atecc_sha.h"
+
+// Compile-time command descriptors for C++ callers (C++17). Each descriptor fixes a
+// command's op-code, mode, payload size, response size and execution time bounds, so
+// its packet is a std::array of exactly the right size, a payload or output of the
+// wrong size fails to compile, and the response wait uses the descriptor's bounds
+// instead of the table in atecc_exec.c. Packets go through atecc_execute_packet(), so
+// they share the retry, resync and logging of the C commands.
+
+namespace atecc {
+
+// Device CRC16 (0x8005, data shifted in LSB first), usable in constant expressions
+constexpr uint16_t crc16(const uint8_t *data, size_t length) {
+    uint16_t crc_register = 0;
+
+    for (size_t i = 0; i < length; i++) {
+        for (uint8_t bit = 0x01; bit != 0; bit = (uint8_t)(bit << 1)) {
+            uint8_t data_bit = (data[i] & bit) ? 1u : 0u;
+            uint8_t crc_bit = (uint8_t)(crc_register >> 15);
+            crc_register = (uint16_t)(crc_register << 1);
+            if (data_bit != crc_bit) {
+                crc_register ^= 0x8005u;
+            }
+        }
+    }
+    return crc_register;
+}
+
+/**
+ * @brief One ATECC608A command with everything about it fixed at compile time.
+ *
+ * @tparam Opcode       The command op-code.
+ * @tparam Mode         Param1, the mode bits.
+ * @tparam DataSize     The payload length.
+ * @tparam ResponseSize The data bytes of the response, 0 for a status-only response.
+ * @tparam TypicalUs    Time after which the first response poll is issued.
+ * @tparam MaxUs        Time after which the command is considered failed.
+ * @tparam Flags        ATECC_EXEC_* flags for the retry loop.
+ */
+template <uint8_t Opcode, uint8_t Mode, size_t DataSize, size_t ResponseSize,
+          uint32_t TypicalUs, uint32_t MaxUs, uint8_t Flags = 0>
+struct command {
+    static constexpr uint8_t opcode = Opcode;
+    static constexpr uint8_t mode = Mode;
+    static constexpr uint8_t flags = Flags;
+    static constexpr size_t data_size = DataSize;
+    static constexpr size_t packet_size = ATECC_PACKET_OVERHEAD + DataSize;
+    static constexpr size_t response_size = ResponseSize;
+    // A status-only response is count, status and CRC
+    static constexpr size_t response_length = ResponseSize == 0 ? 4 : ResponseSize + 3;
+    static constexpr atecc_exec_time_t timing = { Opcode, TypicalUs, MaxUs };
+
+    using data_t = std::array<uint8_t, DataSize>;
+    using packet_t = std::array<uint8_t, packet_size>;
+    using response_t = std::array<uint8_t, response_length>;
+
+    static_assert(packet_size <= ATECC_I2C_MAX_TRANSFER, "packet exceeds the I2C transfer limit");
+    static_assert(packet_size - 1 <= 0xFF, "packet count does not fit its count byte");
+    static_assert(response_length <= 0xFF, "response count does not fit its count byte");
+    static_assert(TypicalUs <= MaxUs, "typical execution time exceeds the maximum");
+};
+
+/**
+ * @brief Builds the packet of a command.
+ *
+ * @tparam Cmd The command descriptor.
+ * @param[in] param2 The command's param2.
+ * @param[in] data   The payload, exactly Cmd::data_size bytes.
+ * @return The packet, word address first and CRC last.
+ */
+template <typename Cmd>
+constexpr typename Cmd::packet_t build_packet(uint16_t param2, const typename Cmd::data_t &data) {
+    typename Cmd::packet_t packet{};
+
+    packet[0] = ATECC_WORD_ADDRESS_COMMAND;
+    packet[1] = (uint8_t)(Cmd::packet_size - 1);
+    packet[2] = Cmd::opcode;
+    packet[3] = Cmd::mode;
+    packet[4] = (uint8_t)(param2 & 0xFFu);
+    packet[5] = (uint8_t)(param2 >> 8);
+    for (size_t i = 0; i < Cmd::data_size; i++) {
+        packet[6 + i] = data[i];
+    }
+
+    // CRC over count to the end of the payload
+    uint16_t crc = crc16(&packet[1], Cmd::packet_size - 3);
+    packet[Cmd::packet_size - 2] = (uint8_t)(crc & 0xFFu);
+    packet[Cmd::packet_size - 1] = (uint8_t)(crc >> 8);
+    return packet;
+}
+
+/**
+ * @brief Runs a built packet and reads its response.
+ *
+ * @tparam Cmd The command descriptor.
+ * @param[in]  packet   The packet from build_packet().
+ * @param[out] response Receives the raw response, count byte first.
+ * @return ATECC_OK with the response in place, or the result of the last attempt.
+ */
+template <typename Cmd>
+atecc_result_t execute(const typename Cmd::packet_t &packet, typename Cmd::response_t &response) {
+    return atecc_execute_packet(packet.data(), packet.size(), &Cmd::timing, response.data(), response.size(),
+                                Cmd::flags);
+}
+
+/**
+ * @brief Builds and runs a command that returns data.
+ *
+ * @tparam Cmd The command descriptor.
+ * @param[in]  param2 The command's param2.
+ * @param[in]  data   The payload.
+ * @param[out] output Receives the response data, exactly Cmd::response_size bytes.
+ * @return ATECC_OK on success, or the result of the last attempt.
+ */
+template <typename Cmd>
+atecc_result_t run(uint16_t param2, const typename Cmd::data_t &data,
+                   std::array<uint8_t, Cmd::response_size> &output) {
+    static_assert(Cmd::response_size > 0, "command returns only a status");
+    typename Cmd::response_t response;
+
+    atecc_result_t result = execute<Cmd>(build_packet<Cmd>(param2, data), response);
+    if (result == ATECC_OK) {
+        for (size_t i = 0; i < Cmd::response_size; i++) {
+            output[i] = response[1 + i];
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Builds and runs a command that returns only a status.
+ *
+ * @tparam Cmd The command descriptor.
+ * @param[in] param2 The command's param2.
+ * @param[in] data   The payload.
+ * @return ATECC_OK on success, or the result of the last attempt.
+ */
+template <typename Cmd>
+atecc_result_t run(uint16_t param2, const typename Cmd::data_t &data) {
+    static_assert(Cmd::response_size == 0, "command returns data; pass an output");
+    typename Cmd::response_t response;
+
+    return execute<Cmd>(build_packet<Cmd>(param2, data), response);
+}
+
+// Descriptors; bounds as in the atecc_exec.c table
+namespace cmd {
+
+using info_revision = command<ATCA_INFO, INFO_MODE_REVISION, 0, 4, 100u, 5000u, ATECC_EXEC_REPLAYABLE>;
+using random = command<ATCA_RANDOM, RANDOM_SEED_UPDATE, 0, 32, 1000u, 23000u, ATECC_EXEC_REPLAYABLE>;
+using nonce_random = command<ATCA_NONCE, NONCE_MODE_RANDOM, NONCE_NUMIN_SIZE, 32, 100u, 20000u, ATECC_EXEC_REPLAYABLE>;
+using nonce_passthrough = command<ATCA_NONCE, NONCE_MODE_PASSTHROUGH, 32, 0, 100u, 20000u, ATECC_EXEC_REPLAYABLE>;
+
+// Param2 is the zone address
+template <uint8_t Zone>
+using read_word = command<ATCA_READ, Zone, 0, ATCA_WORD_SIZE, 100u, 5000u, ATECC_EXEC_REPLAYABLE>;
+template <uint8_t Zone>
+using read_block = command<ATCA_READ, Zone | ATCA_ZONE_READWRITE_32, 0, ATCA_BLOCK_SIZE, 100u, 5000u,
+                           ATECC_EXEC_REPLAYABLE>;
+
+// SHA keeps a context on the device, so none of its steps is replayable; param2 of
+// sha_end is the tail length
+using sha_start = command<ATCA_SHA, ATCA_SHA_MODE_START, 0, 0, 200u, 36000u>;
+using sha_update = command<ATCA_SHA, ATCA_SHA_MODE_UPDATE, SHA256_BLOCK_SIZE, 0, 200u, 36000u>;
+template <size_t TailSize>
+using sha_end = command<ATCA_SHA, ATCA_SHA_MODE_END, TailSize, SHA256_DIGEST_SIZE, 200u, 36000u>;
+
+// Param2 is the key slot
+using aes_encrypt = command<ATCA_AES, ATCA_AES_MODE_ENCRYPT, AES_BLOCK_SIZE, AES_BLOCK_SIZE, 1000u, 27000u,
+                            ATECC_EXEC_REPLAYABLE>;
+using aes_decrypt = command<ATCA_AES, ATCA_AES_MODE_DECRYPT, AES_BLOCK_SIZE, AES_BLOCK_SIZE, 1000u, 27000u,
+                            ATECC_EXEC_REPLAYABLE>;
+
+// Sign takes its digest from TempKey (nonce_passthrough first); param2 is the key slot
+using sign_external = command<ATCA_SIGN, ATCA_SIGN_MODE_EXTERNAL, 0, ECC_P256_SIG_SIZE, 42000u, 115000u>;
+using genkey_private = command<ATCA_GENKEY, ATCA_GENKEY_MODE_PRIVATE, 0, ECC_P256_KEY_SIZE, 59000u, 115000u>;
+using genkey_public = command<ATCA_GENKEY, ATCA_GENKEY_MODE_PUBLIC, 0, ECC_P256_KEY_SIZE, 59000u, 115000u,
+                              ATECC_EXEC_REPLAYABLE>;
+// Signature then public key; param2 is ATCA_VERIFY_KEY_P256
+using verify_external = command<ATCA_VERIFY, ATCA_VERIFY_MODE_EXTERNAL, ECC_P256_SIG_SIZE + ECC_P256_KEY_SIZE, 0,
+                                38000u, 105000u>;
+
+// Param2 is the counter id
+using counter_read = command<ATCA_COUNTER, COUNTER_MODE_READ, 0, 4, 1000u, 25000u, ATECC_EXEC_REPLAYABLE>;
+using counter_increment = command<ATCA_COUNTER, COUNTER_MODE_INCREMENT, 0, 4, 1000u, 25000u>;
+
+} // namespace cmd
+
+} // namespace atecc
+
+#endif // ATECC_COMMAND_HPP
@@ -0,0 +1,190 @@
+#include "atecc_config.h"
+#include "atecc_device.h"
+#include "atecc_log.h"
+#include "hal_pico_i2c.h"
+
+// Each device keeps its config zone shadow, loaded on first use and dropped by
+// Write/Lock commands
+
+// Read a little-endian 16-bit field from the raw config zone
+static inline uint16_t config_u16(const uint8_t *raw, size_t offset) {
+    return (uint16_t)(raw[offset] | ((uint16_t)raw[offset + 1] << 8));
+}
+
+/**
+ * @brief Parses the raw configuration zone into the typed fields of the shadow.
+ *
+ * @param config The shadow whose raw bytes have been filled in.
+ */
+static void parse_config(atecc_config_t *config) {
+    const uint8_t *raw = config->raw;
+
+    memcpy(&config->serial[0], &raw[0], 4);
+    memcpy(&config->serial[4], &raw[8], 5);
+    config->aes_enable = (raw[ATECC_CFG_AES_ENABLE] & 0x01u) != 0;
+    config->i2c_address = raw[ATECC_CFG_I2C_ADDRESS];
+    config->count_match = raw[ATECC_CFG_COUNT_MATCH];
+    config->chip_mode = raw[ATECC_CFG_CHIP_MODE];
+    memcpy(config->counter0, &raw[ATECC_CFG_COUNTER0], sizeof(config->counter0));
+    memcpy(config->counter1, &raw[ATECC_CFG_COUNTER1], sizeof(config->counter1));
+    config->lock_value = raw[ATECC_CFG_LOCK_VALUE];
+    config->lock_config = raw[ATECC_CFG_LOCK_CONFIG];
+    config->slot_locked = config_u16(raw, ATECC_CFG_SLOT_LOCKED);
+    config->chip_options = config_u16(raw, ATECC_CFG_CHIP_OPTIONS);
+
+    for (uint8_t slot = 0; slot < ATECC_NUM_SLOTS; slot++) {
+        uint16_t sc = config_u16(raw, ATECC_CFG_SLOT_CONFIG + 2u * slot);
+        atecc_slot_config_t *slot_config = &config->slot_config[slot];
+        slot_config->read_key = sc & 0x0Fu;
+        slot_config->no_mac = (sc & 0x0010u) != 0;
+        slot_config->limited_use = (sc & 0x0020u) != 0;
+        slot_config->encrypt_read = (sc & 0x0040u) != 0;
+        slot_config->is_secret = (sc & 0x0080u) != 0;
+        slot_config->write_key = (sc >> 8) & 0x0Fu;
+        slot_config->write_config = (sc >> 12) & 0x0Fu;
+
+        uint16_t kc = config_u16(raw, ATECC_CFG_KEY_CONFIG + 2u * slot);
+        atecc_key_config_t *key_config = &config->key_config[slot];
+        key_config->private_key = (kc & 0x0001u) != 0;
+        key_config->pub_info = (kc & 0x0002u) != 0;
+        key_config->key_type = (kc >> 2) & 0x07u;
+        key_config->lockable = (kc & 0x0020u) != 0;
+        key_config->req_random = (kc & 0x0040u) != 0;
+        key_config->req_auth = (kc & 0x0080u) != 0;
+        key_config->auth_key = (kc >> 8) & 0x0Fu;
+        key_config->persistent_disable = (kc & 0x1000u) != 0;
+        key_config->x509_id = (kc >> 14) & 0x03u;
+    }
+}
+
+/**
+ * @brief Drops the shadow when a command that may modify the config zone was sent.
+ *
+ * Writes to the data and OTP zones leave it alone, so that slot writes do not cost
+ * a config reload on the next access check.
+ *
+ * @param opcode The op-code of the command that was sent.
+ * @param param1 Its first parameter, the zone of a Write.
+ */
+void atecc_config_note_command(uint8_t opcode, uint8_t param1) {
+    if ((opcode == ATCA_WRITE && (param1 & 0x03) == ATCA_ZONE_CONFIG) || opcode == ATCA_LOCK ||
+        opcode == ATCA_UPDATE_EXTRA) {
+        atecc_config_invalidate();
+    }
+}
+
+/**
+ * @brief Loads the configuration zone into the RAM shadow.
+ *
+ * Reads the full 128-byte zone from the device and parses it. Called implicitly by
+ * the accessors the first time the shadow is needed; an explicit call refreshes it.
+ *
+ * @return true if the zone was read and parsed, false otherwise.
+ */
+bool atecc_config_load() {
+    atecc_config_t *config = &atecc_device_current()->config;
+
+    config->valid = false;
+    if (!read_config_zone(config->raw)) {
+        ATECC_LOG(CONFIG_LOAD_FAILED, 0, 0, 0, 0);
+        return false;
+    }
+
+    parse_config(config);
+    config->valid = true;
+    return true;
+}
+
+/**
+ * @brief Drops the configuration zone shadow.
+ *
+ * Called whenever a command that can modify the configuration zone (Write, Lock,
+ * UpdateExtra) is sent, so the next accessor reloads it from the device.
+ */
+void atecc_config_invalidate() {
+    atecc_device_current()->config.valid = false;
+}
+
+/**
+ * @brief Returns the configuration zone shadow, loading it if necessary.
+ *
+ * Counter fields reflect the device state at load time.
+ *
+ * @return Pointer to the parsed shadow, or NULL if it could not be loaded.
+ */
+const atecc_config_t *atecc_config_get() {
+    atecc_config_t *config = &atecc_device_current()->config;
+    if (!config->valid && !atecc_config_load()) {
+        return NULL;
+    }
+    return config;
+}
+
+/**
+ * @brief Checks whether the configuration zone is locked.
+ *
+ * @return true if LockConfig indicates a locked zone, false if unlocked or unknown.
+ */
+bool atecc_config_is_locked() {
+    const atecc_config_t *config = atecc_config_get();
+    return config != NULL && config->lock_config == ATECC_LOCK_LOCKED;
+}
+
+/**
+ * @brief Checks whether the data and OTP zones are locked.
+ *
+ * @return true if LockValue indicates locked zones, false if unlocked or unknown.
+ */
+bool atecc_data_is_locked() {
+    const atecc_config_t *config = atecc_config_get();
+    return config != NULL && config->lock_value == ATECC_LOCK_LOCKED;
+}
+
+/**
+ * @brief Checks whether an individual slot has been locked.
+ *
+ * @param slot The slot number.
+ * @return true if the slot's SlotLocked bit is cleared, false otherwise.
+ */
+bool atecc_slot_is_locked(uint8_t slot) {
+    const atecc_config_t *config = atecc_config_get();
+    return config != NULL && slot < ATECC_NUM_SLOTS && (config->slot_locked & (1u << slot)) == 0;
+}
+
+/**
+ * @brief Checks whether a slot holds an AES key usable by the AES command.
+ *
+ * @param slot The slot number.
+ * @return true if AES is enabled and the slot's KeyType is AES, false otherwise.
+ */
+bool atecc_slot_is_aes_key(uint8_t slot) {
+    const atecc_config_t *config = atecc_config_get();
+    return config != NULL && slot < ATECC_NUM_SLOTS && config->aes_enable &&
+           config->key_config[slot].key_type == ATECC_KEY_TYPE_AES;
+}
+
+/**
+ * @brief Checks whether a slot holds a P-256 private key usable for signing.
+ *
+ * @param slot The slot number.
+ * @return true if the slot's KeyType is P256 and it is marked private, false otherwise.
+ */
+bool atecc_slot_is_p256_key(uint8_t slot) {
+    const atecc_config_t *config = atecc_config_get();
+    return config != NULL && slot < ATECC_NUM_SLOTS &&
+           config->key_config[slot].key_type == ATECC_KEY_TYPE_P256 &&
+           config->key_config[slot].private_key;
+}
+
+/**
+ * @brief Checks whether a slot holds a P-256 public key usable by Verify.
+ *
+ * @param slot The slot number.
+ * @return true if the slot's KeyType is P256 and it is not marked private, false otherwise.
+ */
+bool atecc_slot_is_p256_public(uint8_t slot) {
+    const atecc_config_t *config = atecc_config_get();
+    return config != NULL && slot < ATECC_NUM_SLOTS &&
+           config->key_config[slot].key_type == ATECC_KEY_TYPE_P256 &&
+           !config->key_config[slot].private_key;
+}
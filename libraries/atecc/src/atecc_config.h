@@ -0,0 +1,101 @@
+#ifndef ATECC_CONFIG_H
+#define ATECC_CONFIG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "atecc_cmd.h"
+
+#define ATECC_NUM_SLOTS             (16u)
+
+// Byte offsets of the ATECC608A configuration zone fields
+#define ATECC_CFG_AES_ENABLE        (13u)
+#define ATECC_CFG_I2C_ADDRESS       (16u)
+#define ATECC_CFG_COUNT_MATCH       (18u)
+#define ATECC_CFG_CHIP_MODE         (19u)
+#define ATECC_CFG_SLOT_CONFIG       (20u)
+#define ATECC_CFG_COUNTER0          (52u)
+#define ATECC_CFG_COUNTER1          (60u)
+#define ATECC_CFG_USER_EXTRA        (84u)
+#define ATECC_CFG_USER_EXTRA_ADD    (85u)
+#define ATECC_CFG_LOCK_VALUE        (86u)
+#define ATECC_CFG_LOCK_CONFIG       (87u)
+#define ATECC_CFG_SLOT_LOCKED       (88u)
+#define ATECC_CFG_CHIP_OPTIONS      (90u)
+#define ATECC_CFG_KEY_CONFIG        (96u)
+
+// Lock byte values
+#define ATECC_LOCK_UNLOCKED         ((uint8_t)0x55)
+#define ATECC_LOCK_LOCKED           ((uint8_t)0x00)
+
+// KeyConfig KeyType values
+#define ATECC_KEY_TYPE_P256         ((uint8_t)0x04)
+#define ATECC_KEY_TYPE_AES          ((uint8_t)0x06)
+#define ATECC_KEY_TYPE_SHA          ((uint8_t)0x07)
+
+// ChipMode bits
+#define ATECC_CHIP_MODE_USER_EXTRA_ADD  ((uint8_t)0x01)
+#define ATECC_CHIP_MODE_TTL_ENABLE      ((uint8_t)0x02)
+#define ATECC_CHIP_MODE_WATCHDOG_10S    ((uint8_t)0x04)
+#define ATECC_CHIP_MODE_CLOCK_DIV_SHIFT (3u)
+
+// ChipOptions bits (16-bit little-endian word)
+#define ATECC_CHIP_OPT_IO_PROT_ENABLE   ((uint16_t)0x0002)  // IO protection key enabled
+#define ATECC_CHIP_OPT_IO_PROT_KEY_SHIFT (12u)              // Bits 15:12 - IO protection key slot
+
+// Parsed SlotConfig (2 bytes per slot)
+typedef struct {
+    uint8_t read_key;           // Bits 3:0  - key used for encrypted reads
+    bool    no_mac;             // Bit 4     - key cannot be used by MAC
+    bool    limited_use;        // Bit 5     - key use limited by Counter0
+    bool    encrypt_read;       // Bit 6     - reads must be encrypted
+    bool    is_secret;          // Bit 7     - contents are never readable in clear
+    uint8_t write_key;          // Bits 11:8 - key used for encrypted writes
+    uint8_t write_config;       // Bits 15:12 - write permissions
+} atecc_slot_config_t;
+
+// Parsed KeyConfig (2 bytes per slot)
+typedef struct {
+    bool    private_key;        // Bit 0     - slot holds an ECC private key
+    bool    pub_info;           // Bit 1     - public key can be generated/read
+    uint8_t key_type;           // Bits 4:2  - ATECC_KEY_TYPE_*
+    bool    lockable;           // Bit 5     - slot can be individually locked
+    bool    req_random;         // Bit 6     - random nonce required
+    bool    req_auth;           // Bit 7     - prior authorization required
+    uint8_t auth_key;           // Bits 11:8 - authorizing key
+    bool    persistent_disable; // Bit 12    - use requires persistent latch
+    uint8_t x509_id;            // Bits 15:14 - X509format entry
+} atecc_key_config_t;
+
+// RAM shadow of the configuration zone
+typedef struct {
+    bool                valid;
+    uint8_t             raw[CONFIG_ZONE_SIZE];
+    uint8_t             serial[ATCA_SERIAL_NUM_SIZE];
+    bool                aes_enable;
+    uint8_t             i2c_address;
+    uint8_t             count_match;
+    uint8_t             chip_mode;
+    atecc_slot_config_t slot_config[ATECC_NUM_SLOTS];
+    uint8_t             counter0[8];
+    uint8_t             counter1[8];
+    uint8_t             lock_value;
+    uint8_t             lock_config;
+    uint16_t            slot_locked;    // Bit n clear = slot n locked
+    uint16_t            chip_options;
+    atecc_key_config_t  key_config[ATECC_NUM_SLOTS];
+} atecc_config_t;
+
+bool atecc_config_load();
+void atecc_config_invalidate();
+void atecc_config_note_command(uint8_t opcode, uint8_t param1);
+const atecc_config_t *atecc_config_get();
+
+bool atecc_config_is_locked();
+bool atecc_data_is_locked();
+bool atecc_slot_is_locked(uint8_t slot);
+bool atecc_slot_is_aes_key(uint8_t slot);
+bool atecc_slot_is_p256_key(uint8_t slot);
+bool atecc_slot_is_p256_public(uint8_t slot);
+
+#endif // ATECC_CONFIG_H
@@ -0,0 +1,98 @@
+#include "atecc_counter.h"
+#include "atecc_cmd.h"
+#include "atecc_log.h"
+#include "atecc_response.h"
+#include "hal_pico_i2c.h"
+
+// Counter in either mode; both return the 32-bit value, little-endian
+static bool counter(uint8_t mode, uint8_t counter_id, uint32_t *value) {
+    uint8_t response[4 + 3];
+
+    if (counter_id >= ATECC_COUNTER_COUNT) {
+        ATECC_LOG(COUNTER_INVALID, ATCA_COUNTER, 0, counter_id, 0);
+        return false;
+    }
+
+    // A replayed increment would skip a value; an increment whose response was lost
+    // is reported as failed rather than repeated
+    uint8_t flags = mode == COUNTER_MODE_READ ? ATECC_EXEC_REPLAYABLE : 0;
+    if (atecc_execute(ATCA_COUNTER, mode, counter_id, NULL, 0, response, sizeof(response), flags) != ATECC_OK) {
+        return false;
+    }
+
+    *value = (uint32_t)response[1] | ((uint32_t)response[2] << 8) | ((uint32_t)response[3] << 16) |
+             ((uint32_t)response[4] << 24);
+    return true;
+}
+
+/**
+ * @brief Reads a monotonic counter.
+ *
+ * @param[in]  counter_id 0 or 1.
+ * @param[out] value      Receives the counter value.
+ * @return true on success, false otherwise.
+ */
+bool counter_read(uint8_t counter_id, uint32_t *value) {
+    return counter(COUNTER_MODE_READ, counter_id, value);
+}
+
+/**
+ * @brief Increments a monotonic counter.
+ *
+ * The device refuses to go past ATECC_COUNTER_MAX. If the response is lost the
+ * counter may still have moved; the next value read is then larger by two.
+ *
+ * @param[in]  counter_id 0 or 1.
+ * @param[out] value      Receives the new counter value.
+ * @return true on success, false otherwise.
+ */
+bool counter_increment(uint8_t counter_id, uint32_t *value) {
+    return counter(COUNTER_MODE_INCREMENT, counter_id, value);
+}
+
+// Claims the next block of sequence numbers with one increment
+static bool reserve_block(counter_reservation_t *reservation) {
+    uint32_t value;
+
+    if (!counter_increment(reservation->counter_id, &value)) {
+        return false;
+    }
+    reservation->next = (uint64_t)value * reservation->block_size;
+    reservation->end = reservation->next + reservation->block_size;
+    reservation->blocks++;
+    ATECC_LOG(COUNTER_BLOCK_RESERVED, ATCA_COUNTER, 0, reservation->counter_id, value);
+    return true;
+}
+
+/**
+ * @brief Starts handing out sequence numbers from blocks of a counter.
+ *
+ * Reserves the first block at once, so every number handed out after a reset is
+ * larger than any handed out before it.
+ *
+ * @param[out] reservation The reservation state.
+ * @param[in]  counter_id  0 or 1.
+ * @param[in]  block_size  Sequence numbers per increment; must not change for a counter.
+ * @return true if the first block was reserved, false otherwise.
+ */
+bool counter_reserve_init(counter_reservation_t *reservation, uint8_t counter_id, uint32_t block_size) {
+    memset(reservation, 0, sizeof(*reservation));
+    reservation->counter_id = counter_id;
+    reservation->block_size = block_size > 0 ? block_size : 1;
+    return reserve_block(reservation);
+}
+
+/**
+ * @brief Returns the next sequence number, reserving a new block when one runs out.
+ *
+ * @param[in,out] reservation A reservation started with counter_reserve_init().
+ * @param[out]    sequence    Receives the sequence number.
+ * @return true on success, false if a new block could not be reserved.
+ */
+bool counter_reserve_next(counter_reservation_t *reservation, uint64_t *sequence) {
+    if (reservation->next == reservation->end && !reserve_block(reservation)) {
+        return false;
+    }
+    *sequence = reservation->next++;
+    return true;
+}
@@ -0,0 +1,39 @@
+#ifndef ATECC_COUNTER_H
+#define ATECC_COUNTER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ATECC_COUNTER_COUNT         (2u)            // Counter0 and Counter1
+#define ATECC_COUNTER_MAX           (2097151u)      // Largest value a counter reaches
+#define COUNTER_MODE_READ           ((uint8_t)0x00) // Counter mode: return the value
+#define COUNTER_MODE_INCREMENT      ((uint8_t)0x01) // Counter mode: add one, return the new value
+
+// Sequence numbers handed out from RAM. Each block of block_size numbers is paid for
+// with one Counter increment: block v of the chip counter covers [v * block_size,
+// (v + 1) * block_size). Numbers left in a block at reset are skipped, never reused,
+// as long as a counter is always reserved with the same block size.
+typedef struct {
+    uint8_t  counter_id;
+    uint32_t block_size;
+    uint64_t next;              // Next sequence number handed out
+    uint64_t end;               // First number past the reserved block
+    uint32_t blocks;            // Counter increments made
+} counter_reservation_t;
+
+bool counter_read(uint8_t counter_id, uint32_t *value);
+bool counter_increment(uint8_t counter_id, uint32_t *value);
+
+bool counter_reserve_init(counter_reservation_t *reservation, uint8_t counter_id, uint32_t block_size);
+bool counter_reserve_next(counter_reservation_t *reservation, uint64_t *sequence);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ATECC_COUNTER_H
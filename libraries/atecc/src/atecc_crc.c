@@ -1,14 +1,101 @@
 #include "hal_pico_i2c.h"
+#include "atecc_bus.h"
+#include "atecc_device.h"
 
-// Calculate CRC16-CCITT (0x8005) checksum (little-endian) taken from CryptoAuthLib
-void calc_crc16_ccitt(size_t length, const uint8_t *data, uint8_t *crc_le) {
-    size_t counter;
-    uint16_t crc_register = 0;
+#if ATECC_CRC_IMPL == ATECC_CRC_TABLE
+// CRC16 (0x8005) table in bit-reflected form (0xA001), one entry per input byte
+static const uint16_t crc16_table[256] = {
+    0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
+    0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
+    0xCC01, 0x0CC0, 0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40,
+    0x0A00, 0xCAC1, 0xCB81, 0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841,
+    0xD801, 0x18C0, 0x1980, 0xD941, 0x1B00, 0xDBC1, 0xDA81, 0x1A40,
+    0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01, 0x1DC0, 0x1C80, 0xDC41,
+    0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0, 0x1680, 0xD641,
+    0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081, 0x1040,
+    0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
+    0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441,
+    0x3C00, 0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41,
+    0xFA01, 0x3AC0, 0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840,
+    0x2800, 0xE8C1, 0xE981, 0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41,
+    0xEE01, 0x2EC0, 0x2F80, 0xEF41, 0x2D00, 0xEDC1, 0xEC81, 0x2C40,
+    0xE401, 0x24C0, 0x2580, 0xE541, 0x2700, 0xE7C1, 0xE681, 0x2640,
+    0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0, 0x2080, 0xE041,
+    0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281, 0x6240,
+    0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
+    0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41,
+    0xAA01, 0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840,
+    0x7800, 0xB8C1, 0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41,
+    0xBE01, 0x7EC0, 0x7F80, 0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40,
+    0xB401, 0x74C0, 0x7580, 0xB541, 0x7700, 0xB7C1, 0xB681, 0x7640,
+    0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101, 0x71C0, 0x7080, 0xB041,
+    0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0, 0x5280, 0x9241,
+    0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481, 0x5440,
+    0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
+    0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841,
+    0x8801, 0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40,
+    0x4E00, 0x8EC1, 0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41,
+    0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
+    0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040,
+};
+#elif ATECC_CRC_IMPL == ATECC_CRC_NIBBLE
+// CRC16 (0x8005) table in bit-reflected form (0xA001), one entry per input nibble
+static const uint16_t crc16_nibble_table[16] = {
+    0x0000, 0xCC01, 0xD801, 0x1400, 0xF001, 0x3C00, 0x2800, 0xE401,
+    0xA001, 0x6C00, 0x7800, 0xB401, 0x5000, 0x9C01, 0x8801, 0x4400,
+};
+#endif
+
+#if ATECC_CRC_IMPL != ATECC_CRC_BITWISE
+// Reverse the bit order of a 16-bit value
+static inline uint16_t reflect16(uint16_t value) {
+    value = (uint16_t)(((value & 0x5555u) << 1) | ((value >> 1) & 0x5555u));
+    value = (uint16_t)(((value & 0x3333u) << 2) | ((value >> 2) & 0x3333u));
+    value = (uint16_t)(((value & 0x0F0Fu) << 4) | ((value >> 4) & 0x0F0Fu));
+    return (uint16_t)((value << 8) | (value >> 8));
+}
+#endif
+
+/**
+ * @brief Starts an incremental CRC16 calculation.
+ *
+ * @param[out] ctx The CRC state to initialize.
+ */
+void atecc_crc_init(atecc_crc_ctx_t *ctx) {
+    ctx->reg = 0;
+}
+
+/**
+ * @brief Feeds data into an incremental CRC16 calculation.
+ *
+ * The device shifts data in least-significant bit first into a register that is
+ * shifted towards the MSB. The table variants keep the register bit-reflected so a
+ * whole byte (or nibble) can be processed per lookup; atecc_crc_final() undoes the
+ * reflection.
+ *
+ * @param[in,out] ctx    The running CRC state.
+ * @param[in]     data   The bytes to add.
+ * @param[in]     length The number of bytes to add.
+ */
+void atecc_crc_update(atecc_crc_ctx_t *ctx, const uint8_t *data, size_t length) {
+    uint16_t crc_register = ctx->reg;
+
+#if ATECC_CRC_IMPL == ATECC_CRC_TABLE
+    for (size_t counter = 0; counter < length; counter++) {
+        crc_register = (uint16_t)((crc_register >> 8) ^ crc16_table[(crc_register ^ data[counter]) & 0xFFu]);
+    }
+#elif ATECC_CRC_IMPL == ATECC_CRC_NIBBLE
+    for (size_t counter = 0; counter < length; counter++) {
+        crc_register = (uint16_t)((crc_register >> 4) ^ crc16_nibble_table[(crc_register ^ data[counter]) & 0x0Fu]);
+        crc_register = (uint16_t)((crc_register >> 4) ^ crc16_nibble_table[(crc_register ^ (data[counter] >> 4)) & 0x0Fu]);
+    }
+#else
+    // Bitwise calculation taken from CryptoAuthLib
     uint16_t polynom = 0x8005;
     uint8_t shift_register;
     uint8_t data_bit, crc_bit;
 
-    for (counter = 0; counter < length; counter++) {
+    for (size_t counter = 0; counter < length; counter++) {
         for (shift_register = 0x01; shift_register > 0x00u; shift_register <<= 1) {
             data_bit = ((data[counter] & shift_register) != 0u) ? 1u : 0u;
             crc_bit = (uint8_t)(crc_register >> 15);
@@ -18,21 +105,57 @@ void calc_crc16_ccitt(size_t length, const uint8_t *data, uint8_t *crc_le) {
             }
         }
     }
+#endif
+
+    ctx->reg = crc_register;
+}
+
+/**
+ * @brief Finishes an incremental CRC16 calculation.
+ *
+ * @param[in]  ctx    The running CRC state.
+ * @param[out] crc_le The 2-byte CRC in little-endian order, as sent on the wire.
+ */
+void atecc_crc_final(const atecc_crc_ctx_t *ctx, uint8_t *crc_le) {
+#if ATECC_CRC_IMPL == ATECC_CRC_BITWISE
+    uint16_t crc_register = ctx->reg;
+#else
+    uint16_t crc_register = reflect16(ctx->reg);
+#endif
     crc_le[0] = (uint8_t)(crc_register & 0x00FFu);
     crc_le[1] = (uint8_t)(crc_register >> 8u);
 }
 
+// Calculate CRC16-CCITT (0x8005) checksum (little-endian) of a contiguous buffer
+void calc_crc16_ccitt(size_t length, const uint8_t *data, uint8_t *crc_le) {
+    atecc_crc_ctx_t ctx;
+    atecc_crc_init(&ctx);
+    atecc_crc_update(&ctx, data, length);
+    atecc_crc_final(&ctx, crc_le);
+}
+
 // Compute CRC of the data bytes (excluding the CRC bytes)
 void compute_crc(uint8_t length, uint8_t *data, uint8_t *crc) {
     calc_crc16_ccitt(length, data, crc);
 }
 
-// Validate the CRC of the response data 
-bool validate_crc(uint8_t *response, size_t length) {
+// Check the trailing CRC of a packet or response without recording anything
+bool crc_matches(const uint8_t *data, size_t length) {
     if (length < 3) return false; // Not enough bytes for CRC
     uint8_t computed_crc[2];
-    compute_crc(length - 2, response, computed_crc);
-    return (computed_crc[0] == response[length - 2] && computed_crc[1] == response[length - 1]);
+    calc_crc16_ccitt(length - 2, data, computed_crc);
+    return (computed_crc[0] == data[length - 2] && computed_crc[1] == data[length - 1]);
+}
+
+// Validate the CRC of the response data; a mismatch counts against the command sent last
+bool validate_crc(uint8_t *response, size_t length) {
+    if (!crc_matches(response, length)) {
+        atecc_device_t *device = atecc_device_current();
+        atecc_bus_note_crc_error(device->bus);
+        ATECC_STATS_CRC_ERROR(device->exec.opcode);
+        return false;
+    }
+    return true;
 }
 
 // Debug function to print CRC mismatch details
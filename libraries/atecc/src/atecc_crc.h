@@ -1,14 +1,34 @@
 #ifndef ATECC_CRC_H
 #define ATECC_CRC_H
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
+// CRC16 implementations, selected at compile time with ATECC_CRC_IMPL
+#define ATECC_CRC_BITWISE   0   // 8 iterations per byte, no table
+#define ATECC_CRC_NIBBLE    1   // 2 lookups per byte, 32-byte table (flash-constrained builds)
+#define ATECC_CRC_TABLE     2   // 1 lookup per byte, 512-byte table
+
+#ifndef ATECC_CRC_IMPL
+#define ATECC_CRC_IMPL      ATECC_CRC_TABLE
+#endif
+
+// Running CRC state for the incremental API
+typedef struct {
+    uint16_t reg;
+} atecc_crc_ctx_t;
+
+// Incremental CRC16 calculation
+void atecc_crc_init(atecc_crc_ctx_t *ctx);
+void atecc_crc_update(atecc_crc_ctx_t *ctx, const uint8_t *data, size_t length);
+void atecc_crc_final(const atecc_crc_ctx_t *ctx, uint8_t *crc_le);
 
 // Function to calculate CRC16
 void calc_crc16_ccitt(size_t length, const uint8_t *data, uint8_t *crc_le);
 void compute_crc(uint8_t length, uint8_t *data, uint8_t *crc);
+bool crc_matches(const uint8_t *data, size_t length);
 bool validate_crc(uint8_t *response, size_t length);
 void debug_crc_mismatch(uint8_t *data, size_t length, uint8_t *expected_crc);
 
-#endif // ATECC_CRC_H
\ No newline at end of file
+#endif // ATECC_CRC_H
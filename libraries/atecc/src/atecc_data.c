@@ -0,0 +1,367 @@
+#include "atecc_data.h"
+#include "atecc_cmd.h"
+#include "atecc_config.h"
+#include "atecc_log.h"
+#include "atecc_power.h"
+#include "atecc_random.h"
+#include "atecc_response.h"
+#include "atecc_stats.h"
+#include "hal_pico_i2c.h"
+#include "sw_sha256.h"
+
+/**
+ * @brief Returns the size of a data zone slot.
+ *
+ * @param slot The slot number.
+ * @return 36 bytes for slots 0-7, 416 for slot 8, 72 for slots 9-15, 0 otherwise.
+ */
+size_t data_slot_size(uint8_t slot) {
+    if (slot < 8) {
+        return 36u;
+    }
+    if (slot == 8) {
+        return 416u;
+    }
+    return slot < ATECC_NUM_SLOTS ? 72u : 0u;
+}
+
+// A range must fit the zone and start and end on multiples of align
+static bool range_valid(uint8_t opcode, size_t offset, size_t length, size_t size, size_t align) {
+    if (size == 0 || offset > size || length > size - offset || offset % align != 0 || length % align != 0) {
+        ATECC_LOG(DATA_RANGE_INVALID, opcode, 0, offset, length);
+        return false;
+    }
+    return true;
+}
+
+// Transfers of several commands run in one awake session
+static bool transfer_begin(uint8_t opcode) {
+    if (!atecc_session_begin()) {
+        ATECC_LOG(DATA_WAKE_FAILED, opcode, 0, 0, 0);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Writes one 4-byte word or one 32-byte block in clear.
+ *
+ * Writing the same bytes twice is harmless, so the command is retried.
+ *
+ * @param zone    The zone to write to.
+ * @param address The Write address word (see atecc_zone_address).
+ * @param data    The bytes to write.
+ * @param block   true to write a 32-byte block, false to write a 4-byte word.
+ * @return true if the write succeeded, false otherwise.
+ */
+static bool write_zone_unit(uint8_t zone, uint16_t address, const uint8_t *data, bool block) {
+    uint8_t response[4];
+    uint8_t param1 = block ? (uint8_t)(zone | ATCA_ZONE_READWRITE_32) : zone;
+
+    atecc_result_t result = atecc_execute(ATCA_WRITE, param1, address, data,
+                                          block ? ATCA_BLOCK_SIZE : ATCA_WORD_SIZE, response, sizeof(response),
+                                          ATECC_EXEC_REPLAYABLE);
+    if (result != ATECC_OK) {
+        ATECC_LOG(WRITE_FAILED, ATCA_WRITE, atecc_result_status(result), address, 0);
+        return false;
+    }
+    return true;
+}
+
+// Word-aligned range in blocks where they fit and words elsewhere
+static bool write_zone(uint8_t zone, uint8_t slot, size_t offset, const uint8_t *data, size_t length) {
+    while (length > 0) {
+        uint16_t address = atecc_zone_address(zone, slot, (uint8_t)(offset / ATCA_BLOCK_SIZE),
+                                              (uint8_t)((offset % ATCA_BLOCK_SIZE) / ATCA_WORD_SIZE));
+        bool block = offset % ATCA_BLOCK_SIZE == 0 && length >= ATCA_BLOCK_SIZE;
+        size_t chunk = block ? ATCA_BLOCK_SIZE : ATCA_WORD_SIZE;
+
+        if (!write_zone_unit(zone, address, data, block)) {
+            return false;
+        }
+        offset += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+    return true;
+}
+
+/**
+ * @brief Reads a byte range of a data slot in clear.
+ *
+ * @param[in]  slot   The slot number.
+ * @param[in]  offset The byte offset within the slot.
+ * @param[out] data   Receives length bytes.
+ * @param[in]  length The number of bytes, up to the end of the slot.
+ * @return true if all bytes were read, false otherwise.
+ */
+bool data_read(uint8_t slot, size_t offset, uint8_t *data, size_t length) {
+    if (!range_valid(ATCA_READ, offset, length, data_slot_size(slot), 1) || !transfer_begin(ATCA_READ)) {
+        return false;
+    }
+    bool ok = atecc_read_zone(ATCA_ZONE_DATA, slot, (uint16_t)offset, data, length);
+    atecc_session_end();
+    return ok;
+}
+
+/**
+ * @brief Writes a byte range of a data slot in clear.
+ *
+ * The slot's WriteConfig must allow clear writes once the data zone is locked; before
+ * that, the device only accepts whole 32-byte blocks.
+ *
+ * @param[in] slot   The slot number.
+ * @param[in] offset The byte offset within the slot, a multiple of 4.
+ * @param[in] data   The bytes to write.
+ * @param[in] length The number of bytes, a multiple of 4, up to the end of the slot.
+ * @return true if all bytes were written, false otherwise.
+ */
+bool data_write(uint8_t slot, size_t offset, const uint8_t *data, size_t length) {
+    if (!range_valid(ATCA_WRITE, offset, length, data_slot_size(slot), ATCA_WORD_SIZE) ||
+        !transfer_begin(ATCA_WRITE)) {
+        return false;
+    }
+    bool ok = write_zone(ATCA_ZONE_DATA, slot, offset, data, length);
+    atecc_session_end();
+    return ok;
+}
+
+/**
+ * @brief Reads a byte range of the OTP zone.
+ *
+ * @param[in]  offset The byte offset within the zone.
+ * @param[out] data   Receives length bytes.
+ * @param[in]  length The number of bytes, up to OTP_ZONE_SIZE - offset.
+ * @return true if all bytes were read, false otherwise.
+ */
+bool otp_read(size_t offset, uint8_t *data, size_t length) {
+    if (!range_valid(ATCA_READ, offset, length, OTP_ZONE_SIZE, 1) || !transfer_begin(ATCA_READ)) {
+        return false;
+    }
+    bool ok = atecc_read_zone(ATCA_ZONE_OTP, 0, (uint16_t)offset, data, length);
+    atecc_session_end();
+    return ok;
+}
+
+/**
+ * @brief Writes a byte range of the OTP zone, which is only possible before the data
+ *        zone is locked, and then only in whole blocks.
+ *
+ * @param[in] offset The byte offset within the zone, a multiple of 4.
+ * @param[in] data   The bytes to write.
+ * @param[in] length The number of bytes, a multiple of 4.
+ * @return true if all bytes were written, false otherwise.
+ */
+bool otp_write(size_t offset, const uint8_t *data, size_t length) {
+    if (!range_valid(ATCA_WRITE, offset, length, OTP_ZONE_SIZE, ATCA_WORD_SIZE) || !transfer_begin(ATCA_WRITE)) {
+        return false;
+    }
+    bool ok = write_zone(ATCA_ZONE_OTP, 0, offset, data, length);
+    atecc_session_end();
+    return ok;
+}
+
+// The fields after the opcode and parameters that GenDig and the Write MAC hash:
+// SN[8], SN[0:1] and 25 zero bytes
+static void hash_serial_tail(sw_sha256_ctx_t *ctx, const uint8_t *serial) {
+    static const uint8_t zeros[25];
+    uint8_t sn[3] = { serial[8], serial[0], serial[1] };
+
+    sw_sha256_update(ctx, sn, sizeof(sn));
+    sw_sha256_update(ctx, zeros, sizeof(zeros));
+}
+
+/**
+ * @brief Runs Nonce and GenDig and computes the TempKey the device now holds.
+ *
+ * The random Nonce mixes host randomness (NumIn) with the device RNG, then GenDig
+ * hashes the slot key into it: TempKey = SHA-256(key || 0x15 || zone || key_id ||
+ * SN[8] || SN[0:1] || 0^25 || TempKey).
+ *
+ * @param[in]  num_in   The 20-byte host input to the Nonce.
+ * @param[in]  key_slot The slot holding the read or write key.
+ * @param[in]  key      The 32-byte key in that slot.
+ * @param[in]  serial   The device serial number.
+ * @param[out] tempkey  Receives the 32-byte TempKey.
+ * @return ATECC_OK, or the result of the failed command.
+ */
+static atecc_result_t gendig_tempkey(const uint8_t *num_in, uint8_t key_slot, const uint8_t *key,
+                                     const uint8_t *serial, uint8_t *tempkey) {
+    uint8_t response[32 + 3];
+    uint8_t header[4];
+    sw_sha256_ctx_t ctx;
+
+    atecc_result_t result = atecc_execute(ATCA_NONCE, NONCE_MODE_RANDOM, 0x0000, num_in, NONCE_NUMIN_SIZE,
+                                          response, sizeof(response), ATECC_EXEC_REPLAYABLE);
+    if (result != ATECC_OK) {
+        return result;
+    }
+    header[0] = ATCA_NONCE;
+    header[1] = NONCE_MODE_RANDOM;
+    header[2] = 0x00;
+    sw_sha256_init(&ctx);
+    sw_sha256_update(&ctx, &response[1], 32);
+    sw_sha256_update(&ctx, num_in, NONCE_NUMIN_SIZE);
+    sw_sha256_update(&ctx, header, 3);
+    sw_sha256_final(&ctx, tempkey);
+
+    // A repeated GenDig would hash the key in twice
+    result = atecc_execute(ATCA_GENDIG, GENDIG_ZONE_DATA, key_slot, NULL, 0, response, 4, ATECC_EXEC_NO_RETRY);
+    if (result != ATECC_OK) {
+        return result;
+    }
+    header[0] = ATCA_GENDIG;
+    header[1] = GENDIG_ZONE_DATA;
+    header[2] = key_slot;
+    header[3] = 0x00;
+    sw_sha256_init(&ctx);
+    sw_sha256_update(&ctx, key, ATECC_DATA_KEY_SIZE);
+    sw_sha256_update(&ctx, header, sizeof(header));
+    hash_serial_tail(&ctx, serial);
+    sw_sha256_update(&ctx, tempkey, 32);
+    sw_sha256_final(&ctx, tempkey);
+    return ATECC_OK;
+}
+
+/**
+ * @brief Reads or writes one 32-byte block encrypted with a fresh TempKey.
+ *
+ * Nonce, GenDig and the transfer are retried as a whole: TempKey does not survive
+ * sleep, and a repeated GenDig changes it.
+ *
+ * @param[in]     write    true to write, false to read.
+ * @param[in]     key_slot The ReadKey or WriteKey slot.
+ * @param[in]     key      The 32-byte key in that slot.
+ * @param[in]     address  The data zone address of the block.
+ * @param[in,out] block    The 32 bytes to write, or receives the 32 bytes read.
+ * @return true on success, false otherwise.
+ */
+static bool encrypted_block(bool write, uint8_t key_slot, const uint8_t *key, uint16_t address, uint8_t *block) {
+    const atecc_config_t *config = atecc_config_get();
+    uint8_t opcode = write ? ATCA_WRITE : ATCA_READ;
+    uint32_t backoff_us = ATECC_RETRY_BACKOFF_US;
+    uint8_t num_in[NONCE_NUMIN_SIZE];
+    uint8_t tempkey[32];
+    uint8_t packet[2 * ATCA_BLOCK_SIZE];
+    uint8_t response[ATCA_BLOCK_SIZE + 3];
+    atecc_result_t result;
+    uint32_t retries = 0;
+
+    // NumIn comes from the random pool, which may itself need a Random command
+    if (config == NULL || !get_random_bytes(num_in, sizeof(num_in))) {
+        return false;
+    }
+    for (;;) {
+        result = gendig_tempkey(num_in, key_slot, key, config->serial, tempkey);
+        if (result == ATECC_OK && write) {
+            // Ciphertext, then SHA-256(TempKey || 0x12 || param1 || address || SN || plaintext)
+            uint8_t header[4] = {
+                ATCA_WRITE, ATCA_ZONE_DATA | ATCA_ZONE_READWRITE_32 | ATCA_ZONE_ENCRYPTED,
+                (uint8_t)address, (uint8_t)(address >> 8),
+            };
+            sw_sha256_ctx_t ctx;
+            sw_sha256_init(&ctx);
+            sw_sha256_update(&ctx, tempkey, sizeof(tempkey));
+            sw_sha256_update(&ctx, header, sizeof(header));
+            hash_serial_tail(&ctx, config->serial);
+            sw_sha256_update(&ctx, block, ATCA_BLOCK_SIZE);
+            sw_sha256_final(&ctx, &packet[ATCA_BLOCK_SIZE]);
+            for (size_t i = 0; i < ATCA_BLOCK_SIZE; i++) {
+                packet[i] = block[i] ^ tempkey[i];
+            }
+            result = atecc_execute(ATCA_WRITE, header[1], address, packet, sizeof(packet), response, 4,
+                                   ATECC_EXEC_NO_RETRY);
+        } else if (result == ATECC_OK) {
+            result = atecc_execute(ATCA_READ, ATCA_ZONE_DATA | ATCA_ZONE_READWRITE_32, address, NULL, 0,
+                                   response, sizeof(response), ATECC_EXEC_NO_RETRY);
+        }
+        if (result == ATECC_OK) {
+            break;
+        }
+
+        if (retries == ATECC_RETRY_LIMIT || !atecc_result_is_transient(result, ATECC_EXEC_REPLAYABLE)) {
+            ATECC_LOG(COMMAND_FAILED, opcode, atecc_result_status(result), result, retries + 1);
+            break;
+        }
+        retries++;
+        ATECC_LOG(COMMAND_RETRY, opcode, atecc_result_status(result), result, retries);
+        ATECC_STATS_RETRY(opcode);
+        sleep_us(backoff_us);
+        backoff_us = backoff_us * 2 < ATECC_RETRY_BACKOFF_MAX_US ? backoff_us * 2 : ATECC_RETRY_BACKOFF_MAX_US;
+    }
+
+    if (result == ATECC_OK && !write) {
+        for (size_t i = 0; i < ATCA_BLOCK_SIZE; i++) {
+            block[i] = response[1 + i] ^ tempkey[i];
+        }
+    }
+    memset(tempkey, 0, sizeof(tempkey));
+    memset(packet, 0, sizeof(packet));
+    memset(response, 0, sizeof(response));
+    return result == ATECC_OK;
+}
+
+// Whole blocks of a slot, each with its own Nonce and GenDig; input is NULL for reads
+// and output is NULL for writes
+static bool encrypted_range(bool write, uint8_t slot, size_t offset, const uint8_t *key, const uint8_t *input,
+                            uint8_t *output, size_t length) {
+    uint8_t opcode = write ? ATCA_WRITE : ATCA_READ;
+    const atecc_config_t *config = atecc_config_get();
+    uint8_t block[ATCA_BLOCK_SIZE];
+    bool ok = true;
+
+    if (config == NULL || !range_valid(opcode, offset, length, data_slot_size(slot), ATCA_BLOCK_SIZE) ||
+        !transfer_begin(opcode)) {
+        return false;
+    }
+    uint8_t key_slot = write ? config->slot_config[slot].write_key : config->slot_config[slot].read_key;
+
+    for (size_t done = 0; ok && done < length; done += ATCA_BLOCK_SIZE) {
+        uint16_t address = atecc_zone_address(ATCA_ZONE_DATA, slot, (uint8_t)((offset + done) / ATCA_BLOCK_SIZE), 0);
+        if (write) {
+            memcpy(block, &input[done], sizeof(block));
+        }
+        ok = encrypted_block(write, key_slot, key, address, block);
+        if (ok && !write) {
+            memcpy(&output[done], block, sizeof(block));
+        }
+    }
+    atecc_session_end();
+    memset(block, 0, sizeof(block));
+    return ok;
+}
+
+/**
+ * @brief Reads whole blocks of a slot configured for encrypted reads.
+ *
+ * Each block arrives XORed with a TempKey derived from the slot's ReadKey, which the
+ * host computes alongside the device.
+ *
+ * @param[in]  slot     The slot number.
+ * @param[in]  offset   The byte offset within the slot, a multiple of 32.
+ * @param[in]  read_key The 32-byte value of the slot's ReadKey.
+ * @param[out] data     Receives length bytes.
+ * @param[in]  length   The number of bytes, a multiple of 32.
+ * @return true if all blocks were read, false otherwise.
+ */
+bool data_read_encrypted(uint8_t slot, size_t offset, const uint8_t *read_key, uint8_t *data, size_t length) {
+    return encrypted_range(false, slot, offset, read_key, NULL, data, length);
+}
+
+/**
+ * @brief Writes whole blocks of a slot whose WriteConfig requires encryption.
+ *
+ * Each block is XORed with a TempKey derived from the slot's WriteKey and followed
+ * by a MAC over the plaintext, which the device checks before writing.
+ *
+ * @param[in] slot      The slot number.
+ * @param[in] offset    The byte offset within the slot, a multiple of 32.
+ * @param[in] write_key The 32-byte value of the slot's WriteKey.
+ * @param[in] data      The bytes to write.
+ * @param[in] length    The number of bytes, a multiple of 32.
+ * @return true if all blocks were written, false otherwise.
+ */
+bool data_write_encrypted(uint8_t slot, size_t offset, const uint8_t *write_key, const uint8_t *data,
+                          size_t length) {
+    return encrypted_range(true, slot, offset, write_key, data, NULL, length);
+}
@@ -0,0 +1,24 @@
+#ifndef ATECC_DATA_H
+#define ATECC_DATA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define ATECC_DATA_KEY_SIZE         (32u)           // Read and write keys used for encrypted transfers
+#define GENDIG_ZONE_DATA            ((uint8_t)0x02) // GenDig zone: mix a data slot key into TempKey
+
+// Slot and OTP access by byte range. Clear transfers use a 32-byte block wherever the
+// range covers one and 4-byte words elsewhere, within one awake session. Encrypted
+// transfers move whole blocks, each after its own Nonce and GenDig.
+size_t data_slot_size(uint8_t slot);
+bool data_read(uint8_t slot, size_t offset, uint8_t *data, size_t length);
+bool data_write(uint8_t slot, size_t offset, const uint8_t *data, size_t length);
+bool otp_read(size_t offset, uint8_t *data, size_t length);
+bool otp_write(size_t offset, const uint8_t *data, size_t length);
+
+bool data_read_encrypted(uint8_t slot, size_t offset, const uint8_t *read_key, uint8_t *data, size_t length);
+bool data_write_encrypted(uint8_t slot, size_t offset, const uint8_t *write_key, const uint8_t *data,
+                          size_t length);
+
+#endif // ATECC_DATA_H
@@ -0,0 +1,65 @@
+#include "atecc_device.h"
+
+// The device at I2C_PORT/I2C_ADDR, used until another one is selected
+static atecc_device_t default_device;
+
+// Device all commands are sent to
+static atecc_device_t *current;
+
+/**
+ * @brief Initializes a device context.
+ *
+ * The device starts out assumed asleep, with the default power policy and no
+ * config zone shadow.
+ *
+ * @param device  The context to initialize.
+ * @param bus     The I2C block the device is on, already set up with i2c_init().
+ * @param address The 7-bit I2C address of the device.
+ */
+void atecc_device_init(atecc_device_t *device, i2c_inst_t *bus, uint8_t address) {
+    memset(device, 0, sizeof(*device));
+    device->bus = bus;
+    device->address = address;
+    device->power.state = ATECC_POWER_SLEEP;
+    device->power.policy = (atecc_power_policy_t)ATECC_POWER_POLICY_DEFAULT;
+    device->exec.timing = atecc_exec_lookup(0x00);
+}
+
+/**
+ * @brief Returns the device configured by I2C_PORT and I2C_ADDR.
+ *
+ * @return Pointer to the default device context.
+ */
+atecc_device_t *atecc_device_default() {
+    if (default_device.bus == NULL) {
+        atecc_device_init(&default_device, I2C_PORT, I2C_ADDR);
+    }
+    return &default_device;
+}
+
+/**
+ * @brief Returns the device the library currently talks to.
+ *
+ * @return Pointer to the selected device context.
+ */
+atecc_device_t *atecc_device_current() {
+    if (current == NULL) {
+        current = atecc_device_default();
+    }
+    return current;
+}
+
+/**
+ * @brief Directs all following library calls to a device.
+ *
+ * The wake pulse reaches every device on a bus, but each context only tracks the
+ * power state of its own device.
+ *
+ * @param device The device to select, or NULL for the default device.
+ * @return The previously selected device, to restore it afterwards.
+ */
+atecc_device_t *atecc_device_select(atecc_device_t *device) {
+    atecc_device_t *previous = atecc_device_current();
+    current = device != NULL ? device : atecc_device_default();
+    return previous;
+}
@@ -0,0 +1,27 @@
+#ifndef ATECC_DEVICE_H
+#define ATECC_DEVICE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hal_pico_i2c.h"
+#include "atecc_config.h"
+#include "atecc_exec.h"
+#include "atecc_power.h"
+
+// One ATECC608 on an I2C bus and the host-side state kept for it
+struct atecc_device {
+    i2c_inst_t *bus;
+    uint8_t address;                // 7-bit I2C address
+    atecc_power_t power;
+    atecc_exec_pending_t exec;
+    atecc_config_t config;          // Config zone shadow
+    uint8_t packet[ATECC_I2C_MAX_TRANSFER];    // Command packets are built here
+};
+
+void atecc_device_init(atecc_device_t *device, i2c_inst_t *bus, uint8_t address);
+atecc_device_t *atecc_device_default();
+atecc_device_t *atecc_device_current();
+atecc_device_t *atecc_device_select(atecc_device_t *device);
+
+#endif // ATECC_DEVICE_H
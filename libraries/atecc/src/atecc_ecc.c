@@ -0,0 +1,358 @@
+#include "atecc_ecc.h"
+#include "atecc_cmd.h"
+#include "atecc_config.h"
+#include "atecc_kdf.h"
+#include "atecc_log.h"
+#include "atecc_power.h"
+#include "atecc_response.h"
+#include "hal_pico_i2c.h"
+
+/**
+ * @brief Loads a digest into TempKey and runs a command that consumes it.
+ *
+ * The pair is retried as a whole: if the device went to sleep between the two
+ * commands, TempKey is gone and the command alone would be refused. Must be called
+ * within a power session so that the watchdog is restarted through idle, which keeps
+ * TempKey, rather than expiring.
+ *
+ * @param[in]  digest    The 32-byte digest for TempKey.
+ * @param[in]  opcode    The command op-code (Sign or Verify).
+ * @param[in]  mode      The command mode.
+ * @param[in]  param2    The key slot or key type.
+ * @param[in]  fragments The command payload fragments.
+ * @param[in]  count     The number of fragments.
+ * @param[out] response  Buffer receiving the raw response.
+ * @param[in]  length    The expected response length.
+ * @return ATECC_OK, or the result of the last attempt.
+ */
+static atecc_result_t run_with_digest(const uint8_t *digest, uint8_t opcode, uint8_t mode, uint16_t param2,
+                                      const atecc_fragment_t *fragments, size_t count,
+                                      uint8_t *response, size_t length) {
+    uint32_t backoff_us = ATECC_RETRY_BACKOFF_US;
+    atecc_result_t result;
+    uint32_t retries = 0;
+
+    for (;;) {
+        uint8_t status[4];
+        result = atecc_execute(ATCA_NONCE, NONCE_MODE_PASSTHROUGH, 0x0000, digest, ECC_DIGEST_SIZE,
+                               status, sizeof(status), ATECC_EXEC_REPLAYABLE);
+        if (result == ATECC_OK) {
+            result = atecc_execute_sg(opcode, mode, param2, fragments, count, response, length,
+                                      ATECC_EXEC_REPLAYABLE | ATECC_EXEC_NO_RETRY);
+        }
+        if (result == ATECC_OK) {
+            return ATECC_OK;
+        }
+
+        if (retries == ATECC_RETRY_LIMIT || !atecc_result_is_transient(result, ATECC_EXEC_REPLAYABLE)) {
+            break;
+        }
+
+        retries++;
+        ATECC_LOG(COMMAND_RETRY, opcode, atecc_result_status(result), result, retries);
+        ATECC_STATS_RETRY(opcode);
+        sleep_us(backoff_us);
+        backoff_us = backoff_us * 2 < ATECC_RETRY_BACKOFF_MAX_US ? backoff_us * 2 : ATECC_RETRY_BACKOFF_MAX_US;
+    }
+
+    if (result != ATECC_ERR_MISCOMPARE) {
+        ATECC_LOG(COMMAND_FAILED, opcode, atecc_result_status(result), result, retries + 1);
+    }
+    return result;
+}
+
+// GenKey in either mode; both return the 64-byte public key
+static bool genkey(uint8_t mode, uint8_t key_slot, uint8_t *public_key) {
+    uint8_t response[ECC_P256_KEY_SIZE + 3];
+
+    if (!atecc_slot_is_p256_key(key_slot)) {
+        ATECC_LOG(ECC_SLOT_NOT_KEY, ATCA_GENKEY, 0, key_slot, 0);
+        return false;
+    }
+
+    // Creating a key twice leaves the second one, whose public key is what comes back
+    if (atecc_execute(ATCA_GENKEY, mode, key_slot, NULL, 0, response, sizeof(response),
+                      ATECC_EXEC_REPLAYABLE) != ATECC_OK) {
+        return false;
+    }
+    memcpy(public_key, &response[1], ECC_P256_KEY_SIZE);
+    return true;
+}
+
+/**
+ * @brief Creates a new P-256 private key in a slot.
+ *
+ * The private key never leaves the device; the previous key in the slot is lost.
+ *
+ * @param[in]  key_slot   A slot configured for P-256 private keys, writable by GenKey.
+ * @param[out] public_key Receives the new public key, X || Y.
+ * @return true if the key was created, false otherwise.
+ */
+bool ecc_genkey(uint8_t key_slot, uint8_t *public_key) {
+    return genkey(ATCA_GENKEY_MODE_PRIVATE, key_slot, public_key);
+}
+
+/**
+ * @brief Computes the public key of the private key stored in a slot.
+ *
+ * @param[in]  key_slot   A slot holding a P-256 private key.
+ * @param[out] public_key Receives the public key, X || Y.
+ * @return true on success, false otherwise.
+ */
+bool ecc_get_public_key(uint8_t key_slot, uint8_t *public_key) {
+    return genkey(ATCA_GENKEY_MODE_PUBLIC, key_slot, public_key);
+}
+
+/**
+ * @brief Signs an external 32-byte digest with the private key in a slot.
+ *
+ * The digest is loaded into TempKey with a pass-through Nonce, then signed with
+ * Sign in external mode.
+ *
+ * @param[in]  key_slot  A slot holding a P-256 private key.
+ * @param[in]  digest    The 32-byte message digest.
+ * @param[out] signature Receives the signature, R || S.
+ * @return true if the digest was signed, false otherwise.
+ */
+bool ecc_sign_digest(uint8_t key_slot, const uint8_t *digest, uint8_t *signature) {
+    uint8_t response[ECC_P256_SIG_SIZE + 3];
+
+    if (!atecc_slot_is_p256_key(key_slot)) {
+        ATECC_LOG(ECC_SLOT_NOT_KEY, ATCA_SIGN, 0, key_slot, 0);
+        return false;
+    }
+    if (!atecc_session_begin()) {
+        ATECC_LOG(ECC_WAKE_FAILED, ATCA_SIGN, 0, 0, 0);
+        return false;
+    }
+
+    bool ok = run_with_digest(digest, ATCA_SIGN, ATCA_SIGN_MODE_EXTERNAL, key_slot, NULL, 0,
+                              response, sizeof(response)) == ATECC_OK;
+    atecc_session_end();
+
+    if (ok) {
+        memcpy(signature, &response[1], ECC_P256_SIG_SIZE);
+    }
+    return ok;
+}
+
+// Verify in either mode; a miscompare is a valid answer
+static bool verify(uint8_t mode, uint16_t param2, const uint8_t *digest, const atecc_fragment_t *fragments,
+                   size_t count, bool *valid) {
+    uint8_t response[4];
+
+    if (!atecc_session_begin()) {
+        ATECC_LOG(ECC_WAKE_FAILED, ATCA_VERIFY, 0, 0, 0);
+        return false;
+    }
+    atecc_result_t result = run_with_digest(digest, ATCA_VERIFY, mode, param2, fragments, count,
+                                            response, sizeof(response));
+    atecc_session_end();
+
+    if (result != ATECC_OK && result != ATECC_ERR_MISCOMPARE) {
+        return false;
+    }
+    *valid = result == ATECC_OK;
+    return true;
+}
+
+/**
+ * @brief Verifies a signature over a digest against a public key supplied by the host.
+ *
+ * @param[in]  digest     The 32-byte message digest.
+ * @param[in]  signature  The signature, R || S.
+ * @param[in]  public_key The signer's public key, X || Y.
+ * @param[out] valid      Set to whether the signature is valid.
+ * @return true if the device gave an answer, false if the command failed.
+ */
+bool ecc_verify_extern(const uint8_t *digest, const uint8_t *signature, const uint8_t *public_key, bool *valid) {
+    atecc_fragment_t fragments[2] = {
+        { signature, ECC_P256_SIG_SIZE },
+        { public_key, ECC_P256_KEY_SIZE },
+    };
+    return verify(ATCA_VERIFY_MODE_EXTERNAL, ATCA_VERIFY_KEY_P256, digest, fragments, 2, valid);
+}
+
+/**
+ * @brief Verifies a signature over a digest against a public key stored in a slot.
+ *
+ * @param[in]  digest    The 32-byte message digest.
+ * @param[in]  signature The signature, R || S.
+ * @param[in]  key_slot  A slot holding a P-256 public key.
+ * @param[out] valid     Set to whether the signature is valid.
+ * @return true if the device gave an answer, false if the command failed.
+ */
+bool ecc_verify_stored(const uint8_t *digest, const uint8_t *signature, uint8_t key_slot, bool *valid) {
+    atecc_fragment_t fragment = { signature, ECC_P256_SIG_SIZE };
+
+    if (!atecc_slot_is_p256_public(key_slot)) {
+        ATECC_LOG(ECC_SLOT_NOT_PUBLIC, ATCA_VERIFY, 0, key_slot, 0);
+        return false;
+    }
+    return verify(ATCA_VERIFY_MODE_STORED, key_slot, digest, &fragment, 1, valid);
+}
+
+// ECDH in any mode; response_length is 4 when the secret stays on the device
+static bool ecdh(uint8_t mode, uint8_t key_slot, const uint8_t *public_key, uint8_t *response,
+                 size_t response_length) {
+    if (!atecc_slot_is_p256_key(key_slot)) {
+        ATECC_LOG(ECC_SLOT_NOT_KEY, ATCA_ECDH, 0, key_slot, 0);
+        return false;
+    }
+    // The same keys give the same secret, so a replay is harmless
+    return atecc_execute(ATCA_ECDH, mode, key_slot, public_key, ECC_P256_KEY_SIZE, response, response_length,
+                         ATECC_EXEC_REPLAYABLE) == ATECC_OK;
+}
+
+/**
+ * @brief Computes an ECDH shared secret and returns it in clear.
+ *
+ * @param[in]  key_slot      A slot holding a P-256 private key with ECDH enabled.
+ * @param[in]  public_key    The peer's public key, X || Y.
+ * @param[out] shared_secret Receives the 32-byte shared secret.
+ * @return true on success, false otherwise (also if the device only allows protected output).
+ */
+bool ecc_ecdh(uint8_t key_slot, const uint8_t *public_key, uint8_t *shared_secret) {
+    uint8_t response[ECC_SHARED_SECRET_SIZE + 3];
+
+    if (!ecdh(ATCA_ECDH_MODE_COPY_OUTPUT, key_slot, public_key, response, sizeof(response))) {
+        return false;
+    }
+    memcpy(shared_secret, &response[1], ECC_SHARED_SECRET_SIZE);
+    memset(response, 0, sizeof(response));
+    return true;
+}
+
+/**
+ * @brief Computes an ECDH shared secret that crosses the bus encrypted.
+ *
+ * @param[in]  key_slot      A slot holding a P-256 private key with ECDH enabled.
+ * @param[in]  public_key    The peer's public key, X || Y.
+ * @param[in]  io_key        The 32-byte IO protection key provisioned in the device.
+ * @param[out] shared_secret Receives the decrypted 32-byte shared secret.
+ * @return true on success, false otherwise.
+ */
+bool ecc_ecdh_encrypted(uint8_t key_slot, const uint8_t *public_key, const uint8_t *io_key, uint8_t *shared_secret) {
+    uint8_t response[2 * ECC_SHARED_SECRET_SIZE + 3];
+
+    if (!ecdh(ATCA_ECDH_MODE_COPY_OUTPUT | ATCA_ECDH_MODE_ENCRYPT, key_slot, public_key, response,
+              sizeof(response))) {
+        return false;
+    }
+    memcpy(shared_secret, &response[1], ECC_SHARED_SECRET_SIZE);
+    atecc_io_decrypt(io_key, &response[1 + ECC_SHARED_SECRET_SIZE], shared_secret, ECC_SHARED_SECRET_SIZE);
+    memset(response, 0, sizeof(response));
+    return true;
+}
+
+/**
+ * @brief Computes an ECDH shared secret into TempKey, for a following KDF.
+ *
+ * @param[in] key_slot   A slot holding a P-256 private key with ECDH enabled.
+ * @param[in] public_key The peer's public key, X || Y.
+ * @return true on success, false otherwise.
+ */
+bool ecc_ecdh_to_tempkey(uint8_t key_slot, const uint8_t *public_key) {
+    uint8_t response[4];
+    return ecdh(ATCA_ECDH_MODE_COPY_TEMPKEY, key_slot, public_key, response, sizeof(response));
+}
+
+/**
+ * @brief Computes an ECDH shared secret into the slot after the key (key_slot | 1).
+ *
+ * @param[in] key_slot   An even slot holding a P-256 private key with ECDH enabled.
+ * @param[in] public_key The peer's public key, X || Y.
+ * @return true on success, false otherwise.
+ */
+bool ecc_ecdh_to_slot(uint8_t key_slot, const uint8_t *public_key) {
+    uint8_t response[4];
+    return ecdh(ATCA_ECDH_MODE_COPY_SLOT, key_slot, public_key, response, sizeof(response));
+}
+
+/**
+ * @brief Signs a series of digests in one awake session.
+ *
+ * Each digest is loaded into TempKey and its Sign command submitted asynchronously;
+ * while the device signs, the source produces the next digest. TempKey holds one
+ * digest, so the next Nonce can only follow the signature: the overlap is with the
+ * host's work, which should therefore include hashing the next message. A signature
+ * lost in the pipeline is redone with retries. The source runs outside interrupt
+ * context but must not issue commands.
+ *
+ * @param[in]  key_slot   A slot holding a P-256 private key.
+ * @param[in]  count      The number of digests.
+ * @param[in]  source     Writes digest number index; returning false ends the batch.
+ * @param[in]  user_data  Passed to the source.
+ * @param[out] signatures Receives count signatures of ECC_P256_SIG_SIZE bytes, in order.
+ * @return the number of digests signed, all of them unless the source or the device failed.
+ */
+size_t ecc_sign_batch(uint8_t key_slot, size_t count, ecc_digest_source_t source, void *user_data,
+                      uint8_t *signatures) {
+    uint8_t digests[2][ECC_DIGEST_SIZE];
+    uint8_t response[ECC_P256_SIG_SIZE + 3];
+    atecc_async_t op = {0};
+    size_t done = 0;
+
+    if (count == 0) {
+        return 0;
+    }
+    if (!atecc_slot_is_p256_key(key_slot)) {
+        ATECC_LOG(ECC_SLOT_NOT_KEY, ATCA_SIGN, 0, key_slot, 0);
+        return 0;
+    }
+    if (!atecc_session_begin()) {
+        ATECC_LOG(ECC_WAKE_FAILED, ATCA_SIGN, 0, 0, 0);
+        return 0;
+    }
+
+    bool have_digest = source(0, digests[0], user_data);
+    for (size_t i = 0; have_digest && i < count; i++) {
+        const uint8_t *digest = digests[i & 1];
+        uint8_t *signature = &signatures[i * ECC_P256_SIG_SIZE];
+        uint8_t status[4];
+
+        bool submitted = atecc_execute(ATCA_NONCE, NONCE_MODE_PASSTHROUGH, 0x0000, digest, ECC_DIGEST_SIZE,
+                                       status, sizeof(status), ATECC_EXEC_REPLAYABLE) == ATECC_OK &&
+                         atecc_command_async(&op, ATCA_SIGN, ATCA_SIGN_MODE_EXTERNAL, key_slot, NULL, 0,
+                                             response, sizeof(response), NULL, NULL);
+
+        // Host work while the device signs
+        have_digest = i + 1 < count && source(i + 1, digests[(i + 1) & 1], user_data);
+
+        if (submitted && atecc_async_wait(&op) == ATECC_ASYNC_DONE) {
+            memcpy(signature, &response[1], ECC_P256_SIG_SIZE);
+        } else if (run_with_digest(digest, ATCA_SIGN, ATCA_SIGN_MODE_EXTERNAL, key_slot, NULL, 0,
+                                   response, sizeof(response)) == ATECC_OK) {
+            memcpy(signature, &response[1], ECC_P256_SIG_SIZE);
+        } else {
+            break;
+        }
+        done++;
+    }
+
+    atecc_session_end();
+    memset(digests, 0, sizeof(digests));
+    if (done < count) {
+        ATECC_LOG(ECC_BATCH_FAILED, ATCA_SIGN, 0, done, count);
+    }
+    return done;
+}
+
+// Source for ecc_sign_digests(): the digests are consecutive in memory
+static bool array_source(size_t index, uint8_t *digest, void *user_data) {
+    memcpy(digest, (const uint8_t *)user_data + index * ECC_DIGEST_SIZE, ECC_DIGEST_SIZE);
+    return true;
+}
+
+/**
+ * @brief Signs an array of digests in one awake session; see ecc_sign_batch().
+ *
+ * @param[in]  key_slot   A slot holding a P-256 private key.
+ * @param[in]  digests    count consecutive 32-byte digests.
+ * @param[in]  count      The number of digests.
+ * @param[out] signatures Receives count signatures, in order.
+ * @return the number of digests signed.
+ */
+size_t ecc_sign_digests(uint8_t key_slot, const uint8_t *digests, size_t count, uint8_t *signatures) {
+    return ecc_sign_batch(key_slot, count, array_source, (void *)digests, signatures);
+}
@@ -0,0 +1,51 @@
+#ifndef ATECC_ECC_H
+#define ATECC_ECC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ECC_P256_KEY_SIZE           (64u)           // Public key X || Y
+#define ECC_P256_SIG_SIZE           (64u)           // Signature R || S
+#define ECC_DIGEST_SIZE             (32u)           // Message digest signed or verified
+#define ATCA_GENKEY_MODE_PRIVATE    ((uint8_t)0x04) // GenKey mode: create a private key, return its public key
+#define ATCA_GENKEY_MODE_PUBLIC     ((uint8_t)0x00) // GenKey mode: return the public key of a stored private key
+#define ATCA_SIGN_MODE_EXTERNAL     ((uint8_t)0x80) // Sign mode: sign the external digest in TempKey
+#define ATCA_VERIFY_MODE_STORED     ((uint8_t)0x00) // Verify mode: public key in a slot
+#define ATCA_VERIFY_MODE_EXTERNAL   ((uint8_t)0x02) // Verify mode: public key in the command
+#define ATCA_VERIFY_KEY_P256        ((uint16_t)0x0004) // Verify KeyType of an external public key
+#define ECC_SHARED_SECRET_SIZE      (32u)           // ECDH premaster secret, the shared X coordinate
+#define ATCA_ECDH_MODE_ENCRYPT      ((uint8_t)0x02) // ECDH mode: encrypt the output with the IO protection key
+#define ATCA_ECDH_MODE_COPY_SLOT    ((uint8_t)0x04) // ECDH mode: write the secret to slot key_slot | 1
+#define ATCA_ECDH_MODE_COPY_TEMPKEY ((uint8_t)0x08) // ECDH mode: keep the secret in TempKey
+#define ATCA_ECDH_MODE_COPY_OUTPUT  ((uint8_t)0x0C) // ECDH mode: return the secret
+
+// Supplies digest number index of a batch; return false to end the batch early
+typedef bool (*ecc_digest_source_t)(size_t index, uint8_t *digest, void *user_data);
+
+bool ecc_genkey(uint8_t key_slot, uint8_t *public_key);
+bool ecc_get_public_key(uint8_t key_slot, uint8_t *public_key);
+bool ecc_sign_digest(uint8_t key_slot, const uint8_t *digest, uint8_t *signature);
+bool ecc_verify_extern(const uint8_t *digest, const uint8_t *signature, const uint8_t *public_key, bool *valid);
+bool ecc_verify_stored(const uint8_t *digest, const uint8_t *signature, uint8_t key_slot, bool *valid);
+
+// ECDH with the private key in a slot; the secret stays on the device unless returned
+bool ecc_ecdh(uint8_t key_slot, const uint8_t *public_key, uint8_t *shared_secret);
+bool ecc_ecdh_encrypted(uint8_t key_slot, const uint8_t *public_key, const uint8_t *io_key, uint8_t *shared_secret);
+bool ecc_ecdh_to_tempkey(uint8_t key_slot, const uint8_t *public_key);
+bool ecc_ecdh_to_slot(uint8_t key_slot, const uint8_t *public_key);
+
+// Batch signing in one awake session; the source runs while the device signs
+size_t ecc_sign_batch(uint8_t key_slot, size_t count, ecc_digest_source_t source, void *user_data,
+                      uint8_t *signatures);
+size_t ecc_sign_digests(uint8_t key_slot, const uint8_t *digests, size_t count, uint8_t *signatures);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ATECC_ECC_H
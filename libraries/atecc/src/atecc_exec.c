@@ -0,0 +1,120 @@
+#include "atecc_exec.h"
+#include "atecc_bus.h"
+#include "atecc_cmd.h"
+#include "atecc_device.h"
+#include "hal_pico_i2c.h"
+
+// Execution times for the ATECC608A (default clock divider). Maximum values are the
+// datasheet limits; typical values are where the first poll is issued. Underestimating
+// a typical value only costs an extra poll, so they are kept on the short side.
+static const atecc_exec_time_t exec_times[] = {
+    { ATCA_AES,           1000u,  27000u },
+    { ATCA_CHECKMAC,      5000u,  40000u },
+    { ATCA_COUNTER,       1000u,  25000u },
+    { ATCA_DERIVE_KEY,    2000u,  50000u },
+    { ATCA_ECDH,         38000u,  75000u },
+    { ATCA_GENDIG,        1000u,  25000u },
+    { ATCA_GENKEY,       59000u, 115000u },
+    { ATCA_HMAC,          5000u,  23000u },
+    { ATCA_INFO,           100u,   5000u },
+    { ATCA_KDF,           2000u, 165000u },
+    { ATCA_LOCK,          8000u,  35000u },
+    { ATCA_MAC,           5000u,  55000u },
+    { ATCA_NONCE,          100u,  20000u },
+    { ATCA_PRIVWRITE,    30000u,  50000u },
+    { ATCA_RANDOM,        1000u,  23000u },
+    { ATCA_READ,           100u,   5000u },
+    { ATCA_SHA,            200u,  36000u },
+    { ATCA_SIGN,         42000u, 115000u },
+    { ATCA_UPDATE_EXTRA,  8000u,  10000u },
+    { ATCA_VERIFY,       38000u, 105000u },
+    { ATCA_WRITE,         7000u,  45000u },
+};
+
+// Used for op-codes missing from the table: poll early, allow the longest limit
+static const atecc_exec_time_t exec_time_default = { 0x00, 100u, 165000u };
+
+/**
+ * @brief Looks up the execution time bounds of an ATECC608A command.
+ *
+ * @param opcode The command op-code.
+ * @return Pointer to the table entry, or to a conservative default for unknown op-codes.
+ */
+const atecc_exec_time_t *atecc_exec_lookup(uint8_t opcode) {
+    for (size_t i = 0; i < sizeof(exec_times) / sizeof(exec_times[0]); i++) {
+        if (exec_times[i].opcode == opcode) {
+            return &exec_times[i];
+        }
+    }
+    return &exec_time_default;
+}
+
+/**
+ * @brief Marks the start of command execution on the device.
+ *
+ * Called once a command packet has been written to the bus. The next call to
+ * atecc_wait_response() times its polling relative to this point.
+ *
+ * @param opcode The op-code of the command that was sent.
+ */
+void atecc_exec_begin(uint8_t opcode) {
+    atecc_exec_start(atecc_exec_lookup(opcode));
+}
+
+/**
+ * @brief Marks the start of a command whose execution time bounds the caller knows.
+ *
+ * @param timing The bounds, with the op-code of the command that was sent; must
+ *               stay valid until its response has been read.
+ */
+void atecc_exec_start(const atecc_exec_time_t *timing) {
+    atecc_exec_pending_t *pending = &atecc_device_current()->exec;
+    pending->timing = timing;
+    pending->opcode = timing->opcode;
+    pending->start_us = time_us_64();
+    pending->outstanding = true;
+}
+
+/**
+ * @brief Waits for the pending command to complete and reads its response.
+ *
+ * The device NACKs its address while it is busy, so instead of sleeping for the
+ * worst-case execution time this function sleeps until the typical execution time
+ * has elapsed and then polls the device every ATECC_POLL_INTERVAL_US until the read
+ * is acknowledged or the maximum execution time has passed.
+ *
+ * @param[out] response Buffer receiving the raw response (count byte included).
+ * @param[in]  length   Number of bytes to read.
+ * @return true if the response was read, false if the device never answered.
+ */
+bool atecc_wait_response(uint8_t *response, size_t length) {
+    atecc_device_t *device = atecc_device_current();
+    atecc_exec_pending_t *pending = &device->exec;
+    uint64_t first_poll = pending->start_us + pending->timing->typical_us;
+    uint64_t deadline = pending->start_us + pending->timing->max_us;
+    uint64_t now = time_us_64();
+
+    if (now < first_poll) {
+        sleep_us(first_poll - now);
+        ATECC_STATS_WAIT(&pending->stats, first_poll - now);
+    }
+
+    for (;;) {
+        bool expired = time_us_64() >= deadline;
+        ATECC_STATS_POLL_BEGIN(&pending->stats);
+        bool received = hal_i2c_receive(response, length) == (int)length;
+        ATECC_STATS_POLL_END(&pending->stats);
+        if (received || expired) {
+            pending->outstanding = false;
+            if (received) {
+                atecc_bus_note_response(device->bus, response, length);
+            } else {
+                atecc_bus_note_timeout(device->bus);
+            }
+            ATECC_STATS_DONE(&pending->stats, pending->opcode, pending->start_us, length, received);
+            return received;
+        }
+        sleep_us(ATECC_POLL_INTERVAL_US);
+        ATECC_STATS_WAIT(&pending->stats, ATECC_POLL_INTERVAL_US);
+    }
+}
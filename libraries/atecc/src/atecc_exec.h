@@ -0,0 +1,44 @@
+#ifndef ATECC_EXEC_H
+#define ATECC_EXEC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "atecc_stats.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Delay between response polls while the device is still busy (NACKing)
+#define ATECC_POLL_INTERVAL_US  (250u)
+
+// Typical and maximum execution time of one ATECC608A command
+typedef struct {
+    uint8_t  opcode;        // Command op-code
+    uint32_t typical_us;    // Time after which the first response poll is issued
+    uint32_t max_us;        // Time after which the command is considered failed
+} atecc_exec_time_t;
+
+// Command currently executing on a device
+typedef struct {
+    const atecc_exec_time_t *timing;
+    uint8_t  opcode;
+    uint64_t start_us;
+    bool outstanding;       // Sent and its response not yet read
+#if ATECC_STATS
+    atecc_stats_cmd_t stats;
+#endif
+} atecc_exec_pending_t;
+
+const atecc_exec_time_t *atecc_exec_lookup(uint8_t opcode);
+void atecc_exec_begin(uint8_t opcode);
+void atecc_exec_start(const atecc_exec_time_t *timing);
+bool atecc_wait_response(uint8_t *response, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ATECC_EXEC_H
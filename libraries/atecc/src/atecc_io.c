@@ -0,0 +1,237 @@
+#include "hal_pico_i2c.h"
+#include "atecc_bus.h"
+#include "atecc_cmd.h"
+#include "atecc_config.h"
+#include "atecc_device.h"
+#include "atecc_exec.h"
+#include "atecc_log.h"
+#include "atecc_power.h"
+#include "atecc_response.h"
+
+// Command packets and device power commands on top of hal_i2c_send() and
+// hal_i2c_receive(), shared by the Pico transfer engine and the host simulator
+
+// Sends the packet waiting in the device's buffer and starts timing the command
+static atecc_result_t send_packet(atecc_device_t *device, size_t length, const atecc_exec_time_t *timing) {
+    atecc_bus_service(device->bus);
+    if (!atecc_power_ensure_awake(timing->max_us)) {
+        return ATECC_ERR_WAKE_FAILED;
+    }
+
+    ATECC_STATS_SUBMIT(&device->exec.stats);
+    if (hal_i2c_send(device->packet, length) < 0) {
+        atecc_bus_note_timeout(device->bus);
+        ATECC_STATS_SEND_FAILED(timing->opcode);
+        return ATECC_ERR_NACK;
+    }
+
+    atecc_config_note_command(device->packet[2], device->packet[3]);
+    atecc_exec_start(timing);
+    ATECC_STATS_SENT(&device->exec.stats, timing->opcode, length, device->exec.start_us);
+    return ATECC_OK;
+}
+
+/**
+ * @brief Sends a command whose payload is given as scatter-gather fragments.
+ *
+ * The packet is built in place in the selected device's packet buffer, so the
+ * fragments are copied exactly once on their way to the bus.
+ *
+ * @param[in] opcode    The command op-code.
+ * @param[in] param1    The first parameter.
+ * @param[in] param2    The second parameter.
+ * @param[in] fragments The payload fragments, in order.
+ * @param[in] count     The number of fragments.
+ *
+ * @return ATECC_OK if the command was sent, otherwise why it was not.
+ */
+atecc_result_t atecc_command_send(uint8_t opcode, uint8_t param1, uint16_t param2,
+                                  const atecc_fragment_t *fragments, size_t count) {
+    atecc_device_t *device = atecc_device_current();
+    if (ATECC_PACKET_OVERHEAD + atecc_packet_payload_length(fragments, count) > sizeof(device->packet)) {
+        return ATECC_ERR_PARAM;
+    }
+
+    // The watchdog window is only meaningful once any asynchronous command is done,
+    // and until then the packet buffer may still feed its transfer
+    hal_i2c_wait_idle();
+    size_t length = atecc_packet_build(device->packet, sizeof(device->packet), opcode, param1, param2, fragments, count);
+    if (length == 0) {
+        return ATECC_ERR_PARAM;
+    }
+    return send_packet(device, length, atecc_exec_lookup(opcode));
+}
+
+/**
+ * @brief Sends a complete command packet built by the caller.
+ *
+ * For packets whose layout is fixed at compile time (see atecc_command.hpp). The
+ * caller also supplies the execution time bounds, so waking and polling need no
+ * table lookup.
+ *
+ * @param[in] packet The packet, word address first and CRC last.
+ * @param[in] length The packet length.
+ * @param[in] timing The execution time bounds of the command it carries.
+ *
+ * @return ATECC_OK if the command was sent, otherwise why it was not.
+ */
+atecc_result_t atecc_packet_send(const uint8_t *packet, size_t length, const atecc_exec_time_t *timing) {
+    atecc_device_t *device = atecc_device_current();
+    if (length < ATECC_PACKET_OVERHEAD || length > sizeof(device->packet)) {
+        return ATECC_ERR_PARAM;
+    }
+
+    // As in atecc_command_send(), the asynchronous command must be done first
+    hal_i2c_wait_idle();
+    memcpy(device->packet, packet, length);
+    return send_packet(device, length, timing);
+}
+
+/**
+ * @brief Sends a command whose payload is given as scatter-gather fragments.
+ *
+ * Boolean form of atecc_command_send() for callers that read the response themselves.
+ *
+ * @param[in] opcode    The command op-code.
+ * @param[in] param1    The first parameter.
+ * @param[in] param2    The second parameter.
+ * @param[in] fragments The payload fragments, in order.
+ * @param[in] count     The number of fragments.
+ *
+ * @return true if the command was sent, false otherwise.
+ */
+bool send_atecc_command_sg(uint8_t opcode, uint8_t param1, uint16_t param2, const atecc_fragment_t *fragments, size_t count) {
+    return atecc_command_send(opcode, param1, param2, fragments, count) == ATECC_OK;
+}
+
+/**
+ * @brief Sends a command to an ATECC device over the I2C bus on a Pico microcontroller.
+ *
+ * Convenience wrapper around send_atecc_command_sg() for a contiguous payload.
+ *
+ * @param[in] opcode   The command op-code.
+ * @param[in] param1   The first parameter.
+ * @param[in] param2   The second parameter.
+ * @param[in] data     The command data, or NULL.
+ * @param[in] data_len The length of the data.
+ *
+ * @return true if the command was sent, false otherwise.
+ */
+bool send_atecc_command(uint8_t opcode, uint8_t param1, uint16_t param2, const uint8_t *data, size_t data_len) {
+    atecc_fragment_t fragment = { data, data_len };
+    return send_atecc_command_sg(opcode, param1, param2, &fragment, data_len > 0 ? 1 : 0);
+}
+
+/**
+ * @brief Reads a response from the ATECC608A device via I2C into a provided buffer.
+ *
+ * This function reads a response from the ATECC608A device using the I2C protocol. 
+ * It handles either a full response or a partial response based on the full_response flag.
+ * The read is deferred until the command sent last has completed (see atecc_wait_response).
+ *
+ * @param[out] buffer The buffer to store the response read from the device.
+ * @param[in] buffer_size The size of the buffer.
+ * @param[in] full_response A flag indicating whether to read a full response (true) or a partial response (false).
+ * @return bool Returns true if the response was successfully read, otherwise false.
+ */
+bool receive_atecc_response(uint8_t *buffer, size_t length, bool full_response) {
+    uint8_t response[7];
+    size_t read_length = full_response ? 7 : length + 1;
+    
+    if (!atecc_wait_response(response, read_length)) {
+        ATECC_LOG(RESPONSE_FAILED, atecc_device_current()->exec.opcode, 0, 0, 0);
+        return false;
+    }
+    
+    memcpy(buffer, &response[1], length);
+    return true;
+}
+
+/**
+ * @brief Sends an idle command via I2C.
+ *
+ * This function sends an idle command using the hal_i2c_send function. 
+ * It returns true if the command is successfully sent, otherwise it 
+ * prints an error message and returns false. The power manager is told the
+ * device is now idle.
+ *
+ * @return true if the command is successfully sent, false otherwise.
+ */
+bool send_idle_command() {
+    uint8_t idle_cmd = ATCA_IDLE; // Idle command op-code
+    int res = hal_i2c_send((uint8_t*)&idle_cmd, sizeof(idle_cmd));
+    if (res != sizeof(idle_cmd)) {
+        ATECC_LOG(IDLE_FAILED, 0, 0, res, 0);
+        return false;
+    }
+    
+    atecc_power_note_state(ATECC_POWER_IDLE);
+    ATECC_STATS_POWER_COMMAND(ATCA_IDLE);
+    return true;
+}
+
+/**
+ * @brief Sends a sleep command via I2C.
+ *
+ * This function puts the device into its lowest power state. TempKey and the
+ * RNG state are lost, unlike with the idle command.
+ *
+ * @return true if the command is successfully sent, false otherwise.
+ */
+bool send_sleep_command() {
+    uint8_t sleep_cmd = ATCA_SLEEP; // Sleep command op-code
+    int res = hal_i2c_send((uint8_t*)&sleep_cmd, sizeof(sleep_cmd));
+    if (res != sizeof(sleep_cmd)) {
+        ATECC_LOG(SLEEP_FAILED, 0, 0, res, 0);
+        return false;
+    }
+
+    atecc_power_note_state(ATECC_POWER_SLEEP);
+    ATECC_STATS_POWER_COMMAND(ATCA_SLEEP);
+    return true;
+}
+
+/**
+ * @brief Wakes up the ATECC device.
+ *
+ * This function sends a wake-up sequence to the ATECC device using the hal_i2c_send function. 
+ * It then receives a response from the device and checks if the wake-up was successful.
+ * A bus running faster than ATECC_BUS_WAKE_HZ is slowed down for the wake byte.
+ *
+ * @return true if the wake-up was successful, false otherwise.
+ */
+bool wake_atecc_device() {    
+    uint8_t data = 0x00;
+    uint8_t wake_response[4] = { 0 };
+    i2c_inst_t *bus = atecc_device_current()->bus;
+    uint32_t rate = atecc_bus_rate(bus);
+    ATECC_STATS_WAKE_BEGIN(wake_start);
+
+    // Send wakeup sequence with proper delays; the 0x00 byte only holds SDA low
+    // long enough at a slow clock
+    if (rate > ATECC_BUS_WAKE_HZ) {
+        i2c_set_baudrate(bus, ATECC_BUS_WAKE_HZ);
+    }
+    hal_i2c_send(&data, sizeof(data));
+    if (rate > ATECC_BUS_WAKE_HZ) {
+        i2c_set_baudrate(bus, rate);
+    }
+    sleep_ms(1);
+
+    int res = hal_i2c_receive(wake_response, sizeof(wake_response));
+    uint32_t packed = ((uint32_t)wake_response[0] << 24) | ((uint32_t)wake_response[1] << 16) |
+                      ((uint32_t)wake_response[2] << 8) | wake_response[3];
+
+    // Check if wake-up response matches expected value
+    if (res > 0 && wake_response[0] == 0x04 && wake_response[1] == 0x11 &&
+        wake_response[2] == 0x33 && wake_response[3] == 0x43) {
+        ATECC_LOG(WAKE_OK, 0, wake_response[1], packed, 0);
+        atecc_power_note_state(ATECC_POWER_AWAKE);
+        ATECC_STATS_WAKE_END(wake_start, true);
+        return true;
+    } else {
+        ATECC_LOG(WAKE_FAILED, 0, 0, packed, 0);
+        ATECC_STATS_WAKE_END(wake_start, false);
+        return false;
+    }
+}
@@ -0,0 +1,149 @@
+#include "atecc_kdf.h"
+#include "atecc_cmd.h"
+#include "atecc_log.h"
+#include "atecc_response.h"
+#include "sw_sha256.h"
+
+/**
+ * @brief Decrypts data the device returned under IO protection.
+ *
+ * Each 32-byte block is XORed with SHA-256(IO key || 16 bytes of the output nonce),
+ * as the ATECC608 does for encrypted ECDH and KDF output.
+ *
+ * @param[in]     io_key    The 32-byte IO protection key.
+ * @param[in]     out_nonce The 32-byte nonce returned after the data.
+ * @param[in,out] data      The data to decrypt in place.
+ * @param[in]     length    The data length, 32 or 64 bytes.
+ */
+void atecc_io_decrypt(const uint8_t *io_key, const uint8_t *out_nonce, uint8_t *data, size_t length) {
+    uint8_t mask[32];
+
+    for (size_t block = 0; block * 32 < length; block++) {
+        sw_sha256_ctx_t ctx;
+        sw_sha256_init(&ctx);
+        sw_sha256_update(&ctx, io_key, ATECC_IO_KEY_SIZE);
+        sw_sha256_update(&ctx, &out_nonce[16 * block], 16);
+        sw_sha256_final(&ctx, mask);
+        for (size_t i = 0; i < 32 && block * 32 + i < length; i++) {
+            data[block * 32 + i] ^= mask[i];
+        }
+    }
+    memset(mask, 0, sizeof(mask));
+}
+
+/**
+ * @brief Runs a KDF command.
+ *
+ * The result goes to TempKey, a slot, or back to the host in clear or encrypted
+ * with the IO protection key, as selected by the target bits of the mode. Commands
+ * that do not write TempKey are retried after transient failures; one that derives
+ * TempKey from itself cannot be replayed.
+ *
+ * @param[in]  mode           Source, target and algorithm (ATCA_KDF_*).
+ * @param[in]  key_id         Source slot in the low byte, target slot in the high byte.
+ * @param[in]  details        The algorithm details word (KDF_DETAILS_*), message length included.
+ * @param[in]  message        The message input, or NULL.
+ * @param[in]  message_length The message length, at most KDF_MESSAGE_MAX.
+ * @param[in]  io_key         The IO protection key for ATCA_KDF_TARGET_OUTPUT_ENC, else NULL.
+ * @param[out] output         Receives the result for the output targets, else NULL.
+ * @param[in]  output_length  The result length, 32 or 64 bytes, for the output targets.
+ * @return true on success, false otherwise.
+ */
+bool atecc_kdf(uint8_t mode, uint16_t key_id, uint32_t details, const uint8_t *message, size_t message_length,
+               const uint8_t *io_key, uint8_t *output, size_t output_length) {
+    uint8_t response[KDF_OUTPUT_MAX + 32 + 3];
+    uint8_t target = mode & 0x1C;
+    bool to_output = target == ATCA_KDF_TARGET_OUTPUT || target == ATCA_KDF_TARGET_OUTPUT_ENC;
+    bool encrypted = target == ATCA_KDF_TARGET_OUTPUT_ENC;
+
+    if (message_length > KDF_MESSAGE_MAX ||
+        (to_output && (output_length == 0 || output_length > KDF_OUTPUT_MAX || output == NULL)) ||
+        (encrypted && io_key == NULL)) {
+        ATECC_LOG(KDF_LENGTH_INVALID, ATCA_KDF, 0, message_length, output_length);
+        return false;
+    }
+
+    uint8_t details_le[4] = {
+        (uint8_t)details, (uint8_t)(details >> 8), (uint8_t)(details >> 16), (uint8_t)(details >> 24),
+    };
+    atecc_fragment_t fragments[2] = {
+        { details_le, sizeof(details_le) },
+        { message, message_length },
+    };
+    size_t length = to_output ? output_length + (encrypted ? 32 : 0) + 3 : 4;
+    uint8_t flags = target == ATCA_KDF_TARGET_TEMPKEY ? 0 : ATECC_EXEC_REPLAYABLE;
+
+    if (atecc_execute_sg(ATCA_KDF, mode, key_id, fragments, message_length > 0 ? 2 : 1, response, length,
+                         flags) != ATECC_OK) {
+        return false;
+    }
+
+    if (to_output) {
+        memcpy(output, &response[1], output_length);
+        if (encrypted) {
+            atecc_io_decrypt(io_key, &response[1 + output_length], output, output_length);
+        }
+    }
+    memset(response, 0, sizeof(response));
+    return true;
+}
+
+/**
+ * @brief HKDF-Extract without a salt: replaces TempKey with HMAC-SHA256(0^32, TempKey).
+ *
+ * TempKey typically holds an ECDH shared secret; the pseudorandom key that replaces
+ * it never leaves the device.
+ *
+ * @return true on success, false otherwise.
+ */
+bool kdf_hkdf_extract_tempkey() {
+    return atecc_kdf(ATCA_KDF_SOURCE_TEMPKEY | ATCA_KDF_TARGET_TEMPKEY | ATCA_KDF_ALG_HKDF, 0x0000,
+                     KDF_DETAILS_HKDF_MSG_TEMPKEY | KDF_DETAILS_HKDF_ZERO_KEY | KDF_DETAILS_MSG_LENGTH(32),
+                     NULL, 0, NULL, NULL, 0);
+}
+
+/**
+ * @brief One block of HKDF-Expand: HMAC-SHA256(TempKey, info || 0x01).
+ *
+ * @param[in]  info        The context and application specific information.
+ * @param[in]  info_length The info length, at most KDF_MESSAGE_MAX - 1.
+ * @param[in]  io_key      The IO protection key to receive the result encrypted, or NULL for clear.
+ * @param[out] output      Receives the 32-byte output keying material.
+ * @return true on success, false otherwise.
+ */
+bool kdf_hkdf_expand(const uint8_t *info, size_t info_length, const uint8_t *io_key, uint8_t *output) {
+    uint8_t message[KDF_MESSAGE_MAX];
+
+    if (info_length >= KDF_MESSAGE_MAX) {
+        ATECC_LOG(KDF_LENGTH_INVALID, ATCA_KDF, 0, info_length, 32);
+        return false;
+    }
+    memcpy(message, info, info_length);
+    message[info_length] = 0x01;
+
+    uint8_t target = io_key != NULL ? ATCA_KDF_TARGET_OUTPUT_ENC : ATCA_KDF_TARGET_OUTPUT;
+    return atecc_kdf(ATCA_KDF_SOURCE_TEMPKEY | target | ATCA_KDF_ALG_HKDF, 0x0000,
+                     KDF_DETAILS_HKDF_MSG_INPUT | KDF_DETAILS_MSG_LENGTH(info_length + 1),
+                     message, info_length + 1, io_key, output, 32);
+}
+
+/**
+ * @brief TLS 1.2 PRF (P_SHA256) keyed with TempKey, returned in clear.
+ *
+ * @param[in]  label_seed    The label followed by the seed.
+ * @param[in]  length        The label and seed length, at most KDF_MESSAGE_MAX.
+ * @param[out] output        Receives the output.
+ * @param[in]  output_length 32 or 64 bytes.
+ * @return true on success, false otherwise.
+ */
+bool kdf_prf(const uint8_t *label_seed, size_t length, uint8_t *output, size_t output_length) {
+    uint32_t details = KDF_DETAILS_PRF_KEY_32 | KDF_DETAILS_MSG_LENGTH(length) |
+                       (output_length == 64 ? KDF_DETAILS_PRF_TARGET_64 : 0);
+
+    if (output_length != 32 && output_length != 64) {
+        ATECC_LOG(KDF_LENGTH_INVALID, ATCA_KDF, 0, length, output_length);
+        return false;
+    }
+    return atecc_kdf(ATCA_KDF_SOURCE_TEMPKEY | ATCA_KDF_TARGET_OUTPUT | ATCA_KDF_ALG_PRF, 0x0000, details,
+                     label_seed, length, NULL, output, output_length);
+}
@@ -0,0 +1,41 @@
+#ifndef ATECC_KDF_H
+#define ATECC_KDF_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define ATECC_IO_KEY_SIZE           (32u)           // IO protection key shared with the device
+#define KDF_MESSAGE_MAX             (128u)          // Longest KDF message input
+#define KDF_OUTPUT_MAX              (64u)           // PRF with a 64-byte target
+
+// KDF mode: key source, target and algorithm
+#define ATCA_KDF_SOURCE_TEMPKEY     ((uint8_t)0x00)
+#define ATCA_KDF_SOURCE_SLOT        ((uint8_t)0x02)
+#define ATCA_KDF_TARGET_TEMPKEY     ((uint8_t)0x00)
+#define ATCA_KDF_TARGET_SLOT        ((uint8_t)0x08)
+#define ATCA_KDF_TARGET_OUTPUT      ((uint8_t)0x10) // Return the result in clear
+#define ATCA_KDF_TARGET_OUTPUT_ENC  ((uint8_t)0x14) // Return the result encrypted with the IO protection key
+#define ATCA_KDF_ALG_PRF            ((uint8_t)0x00) // TLS 1.2 PRF, P_SHA256
+#define ATCA_KDF_ALG_HKDF           ((uint8_t)0x40) // One HMAC-SHA256 step of HKDF
+
+// KDF details (little-endian 32-bit word before the message)
+#define KDF_DETAILS_PRF_KEY_32      (0x00000001u)   // PRF source key is 32 bytes
+#define KDF_DETAILS_PRF_TARGET_64   (0x00000100u)   // PRF produces 64 bytes instead of 32
+// HKDF message location, bits 0-1, as CryptoAuthLib's KDF_DETAILS_HKDF_MSG_LOC_*
+#define KDF_DETAILS_HKDF_MSG_SLOT   (0x00000000u)   // HKDF message is in a slot
+#define KDF_DETAILS_HKDF_MSG_TEMPKEY (0x00000001u)  // HKDF message is TempKey
+#define KDF_DETAILS_HKDF_MSG_INPUT  (0x00000002u)   // HKDF message follows the details
+#define KDF_DETAILS_HKDF_MSG_IV     (0x00000003u)   // HKDF message is the IV of the Alt key buffer
+#define KDF_DETAILS_HKDF_ZERO_KEY   (0x00000004u)   // HKDF key is 32 zero bytes (Extract without salt)
+#define KDF_DETAILS_MSG_LENGTH(n)   ((uint32_t)(n) << 24)
+
+bool atecc_kdf(uint8_t mode, uint16_t key_id, uint32_t details, const uint8_t *message, size_t message_length,
+               const uint8_t *io_key, uint8_t *output, size_t output_length);
+bool kdf_hkdf_extract_tempkey();
+bool kdf_hkdf_expand(const uint8_t *info, size_t info_length, const uint8_t *io_key, uint8_t *output);
+bool kdf_prf(const uint8_t *label_seed, size_t length, uint8_t *output, size_t output_length);
+
+void atecc_io_decrypt(const uint8_t *io_key, const uint8_t *out_nonce, uint8_t *data, size_t length);
+
+#endif // ATECC_KDF_H
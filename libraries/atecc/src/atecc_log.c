@@ -0,0 +1,172 @@
+#include "atecc_log.h"
+
+#include <stdio.h>
+
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+
+#if (ATECC_LOG_ENTRIES & (ATECC_LOG_ENTRIES - 1)) != 0
+#error "ATECC_LOG_ENTRIES must be a power of two"
+#endif
+
+#define LOG_CORES   (2u)
+
+_Static_assert(sizeof(atecc_log_record_t) == 16, "atecc_log_decode.py expects 16-byte records");
+
+// One ring per core, so writers on different cores never share an index. head is
+// only written by the core that owns the ring, with its interrupts disabled so an
+// interrupt handler logging on the same core cannot interleave; tail is only
+// written by the drain. A full ring drops new records rather than wait.
+typedef struct {
+    atecc_log_record_t records[ATECC_LOG_ENTRIES];
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile uint32_t dropped;
+} log_ring_t;
+
+static log_ring_t rings[LOG_CORES];
+
+#if ATECC_LOG_TEXT
+// Level and format of each event, indexed by event id
+static const struct {
+    uint8_t level;
+    const char *format;
+} events[ATECC_EV_COUNT] = {
+#define ATECC_LOG_EVENT(name, level, format) { ATECC_LOG_LEVEL_##level, format },
+#include "atecc_log_events.h"
+#undef ATECC_LOG_EVENT
+};
+
+static const char *const level_marks[] = { "", "❌", "⚠️", "🔹", "🔍" };
+#endif
+
+/**
+ * @brief Appends a record to the current core's ring.
+ *
+ * Safe from interrupt handlers and from either core; never blocks. Use the
+ * ATECC_LOG() macro, which drops filtered events at compile time.
+ *
+ * @param[in] event  The event id.
+ * @param[in] opcode The command op-code, or 0.
+ * @param[in] status The device status byte, or 0.
+ * @param[in] arg0   First event argument.
+ * @param[in] arg1   Second event argument.
+ */
+void atecc_log_write(uint16_t event, uint8_t opcode, uint8_t status, uint32_t arg0, uint32_t arg1) {
+    uint32_t timestamp = (uint32_t)time_us_64();
+    uint32_t irq = save_and_disable_interrupts();
+    log_ring_t *ring = &rings[get_core_num()];
+
+    uint32_t head = ring->head;
+    if (head - ring->tail == ATECC_LOG_ENTRIES) {
+        ring->dropped++;
+    } else {
+        atecc_log_record_t *record = &ring->records[head & (ATECC_LOG_ENTRIES - 1)];
+        record->timestamp_us = timestamp;
+        record->event = event;
+        record->opcode = opcode;
+        record->status = status;
+        record->args[0] = arg0;
+        record->args[1] = arg1;
+        __dmb();
+        ring->head = head + 1;
+    }
+
+    restore_interrupts(irq);
+}
+
+/**
+ * @brief Removes the oldest record from the log.
+ *
+ * Records from both cores are returned in timestamp order. Only one context may
+ * consume the log at a time.
+ *
+ * @param[out] record Receives the record.
+ * @return true if a record was removed, false if the log is empty.
+ */
+bool atecc_log_pop(atecc_log_record_t *record) {
+    log_ring_t *oldest = NULL;
+    for (size_t i = 0; i < LOG_CORES; i++) {
+        log_ring_t *ring = &rings[i];
+        if (ring->tail == ring->head) {
+            continue;
+        }
+        const atecc_log_record_t *next = &ring->records[ring->tail & (ATECC_LOG_ENTRIES - 1)];
+        if (oldest == NULL ||
+            (int32_t)(next->timestamp_us - oldest->records[oldest->tail & (ATECC_LOG_ENTRIES - 1)].timestamp_us) < 0) {
+            oldest = ring;
+        }
+    }
+    if (oldest == NULL) {
+        return false;
+    }
+
+    __dmb();
+    *record = oldest->records[oldest->tail & (ATECC_LOG_ENTRIES - 1)];
+    __dmb();
+    oldest->tail = oldest->tail + 1;
+    return true;
+}
+
+/**
+ * @brief Returns the number of records dropped because the log was full.
+ *
+ * @return the count since boot.
+ */
+uint32_t atecc_log_dropped() {
+    uint32_t dropped = 0;
+    for (size_t i = 0; i < LOG_CORES; i++) {
+        dropped += rings[i].dropped;
+    }
+    return dropped;
+}
+
+static void print_record(const atecc_log_record_t *record) {
+#if ATECC_LOG_TEXT
+    if (record->event >= ATECC_EV_COUNT) {
+        printf("❓ [%10lu us] Unknown event %u\n", (unsigned long)record->timestamp_us, record->event);
+        return;
+    }
+
+    printf("%s [%10lu us] ", level_marks[events[record->event].level], (unsigned long)record->timestamp_us);
+    printf(events[record->event].format, (unsigned)record->args[0], (unsigned)record->args[1]);
+    if (record->opcode != 0 || record->status != 0) {
+        printf(" (op %02X, status %02X)", record->opcode, record->status);
+    }
+    printf("\n");
+#else
+    const uint8_t *bytes = (const uint8_t *)record;
+    printf("@ATL ");
+    for (size_t i = 0; i < sizeof(*record); i++) {
+        printf("%02X", bytes[i]);
+    }
+    printf("\n");
+#endif
+}
+
+/**
+ * @brief Prints and removes up to max_records records from the log.
+ *
+ * Call from the idle loop or whenever the output is wanted; this is the only
+ * place the log touches stdio.
+ *
+ * @param[in] max_records Upper bound on the records printed; SIZE_MAX for all.
+ * @return the number of records printed.
+ */
+size_t atecc_log_drain(size_t max_records) {
+    static uint32_t dropped_reported;
+    atecc_log_record_t record;
+    size_t count = 0;
+
+    while (count < max_records && atecc_log_pop(&record)) {
+        print_record(&record);
+        count++;
+    }
+
+    uint32_t dropped = atecc_log_dropped();
+    if (dropped != dropped_reported) {
+        printf("⚠️ %lu log records dropped\n", (unsigned long)(dropped - dropped_reported));
+        dropped_reported = dropped;
+    }
+    return count;
+}
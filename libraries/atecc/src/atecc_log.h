@@ -0,0 +1,81 @@
+#ifndef ATECC_LOG_H
+#define ATECC_LOG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Deferred trace log. Library code writes fixed-size binary records into a RAM ring,
+// which never blocks; the application drains the ring to stdio from its idle loop
+// or on demand with atecc_log_drain().
+
+// Levels; events above ATECC_LOG_LEVEL are removed at compile time
+#define ATECC_LOG_LEVEL_OFF     0
+#define ATECC_LOG_LEVEL_ERROR   1
+#define ATECC_LOG_LEVEL_WARN    2
+#define ATECC_LOG_LEVEL_INFO    3
+#define ATECC_LOG_LEVEL_DEBUG   4
+
+#ifndef ATECC_LOG_LEVEL
+#define ATECC_LOG_LEVEL         ATECC_LOG_LEVEL_INFO
+#endif
+
+// 1 = drain formats records as text; 0 = drain prints them as hex for
+// scripts/atecc_log_decode.py, and the format strings are left out of the image
+#ifndef ATECC_LOG_TEXT
+#define ATECC_LOG_TEXT          1
+#endif
+
+// Records per core; must be a power of two
+#ifndef ATECC_LOG_ENTRIES
+#define ATECC_LOG_ENTRIES       (64u)
+#endif
+
+// Event ids, in the order of atecc_log_events.h
+typedef enum {
+#define ATECC_LOG_EVENT(name, level, format) ATECC_EV_##name,
+#include "atecc_log_events.h"
+#undef ATECC_LOG_EVENT
+    ATECC_EV_COUNT
+} atecc_log_event_t;
+
+// Level of each event, for the compile-time filter
+enum {
+#define ATECC_LOG_EVENT(name, level, format) ATECC_EV_LEVEL_##name = ATECC_LOG_LEVEL_##level,
+#include "atecc_log_events.h"
+#undef ATECC_LOG_EVENT
+};
+
+// One trace record; 16 bytes, little-endian when dumped
+typedef struct {
+    uint32_t timestamp_us;  // Low 32 bits of time_us_64()
+    uint16_t event;         // atecc_log_event_t
+    uint8_t  opcode;        // Command op-code, 0 if none
+    uint8_t  status;        // Device status byte, 0 if none
+    uint32_t args[2];       // Event-specific arguments
+} atecc_log_record_t;
+
+void atecc_log_write(uint16_t event, uint8_t opcode, uint8_t status, uint32_t arg0, uint32_t arg1);
+bool atecc_log_pop(atecc_log_record_t *record);
+size_t atecc_log_drain(size_t max_records);
+uint32_t atecc_log_dropped();
+
+/**
+ * @brief Records a trace event if its level passes ATECC_LOG_LEVEL.
+ *
+ * Filtering is on constants, so filtered events compile to nothing.
+ *
+ * @param event  Event name from atecc_log_events.h, without the ATECC_EV_ prefix.
+ * @param opcode Command op-code, or 0.
+ * @param status Device status byte, or 0.
+ * @param arg0   First argument of the event format.
+ * @param arg1   Second argument of the event format.
+ */
+#define ATECC_LOG(event, opcode, status, arg0, arg1)                                        \
+    do {                                                                                    \
+        if (ATECC_EV_LEVEL_##event <= ATECC_LOG_LEVEL) {                                    \
+            atecc_log_write(ATECC_EV_##event, (opcode), (status), (uint32_t)(arg0), (uint32_t)(arg1)); \
+        }                                                                                   \
+    } while (0)
+
+#endif // ATECC_LOG_H
@@ -0,0 +1,59 @@
+// Trace log events: ATECC_LOG_EVENT(name, level, format). The format takes up to two
+// 32-bit arguments using only %u, %d, %X and zero-padded widths, so that
+// scripts/atecc_log_decode.py can read this file and format records on the host.
+// Append new events at the end; the record stores the position as the event id.
+
+ATECC_LOG_EVENT(RESPONSE_FAILED,            ERROR, "Failed to read response from ATECC608A")
+ATECC_LOG_EVENT(IDLE_FAILED,                ERROR, "Failed to send idle command (result %d)")
+ATECC_LOG_EVENT(SLEEP_FAILED,               ERROR, "Failed to send sleep command (result %d)")
+ATECC_LOG_EVENT(WAKE_OK,                    DEBUG, "Wake-up successful, response %08X")
+ATECC_LOG_EVENT(WAKE_FAILED,                ERROR, "Wake-up failed, response %08X")
+ATECC_LOG_EVENT(READ_SEND_FAILED,           ERROR, "Failed to send read command for address %04X")
+ATECC_LOG_EVENT(READ_RESPONSE_FAILED,       ERROR, "Failed to read zone data at address %04X")
+ATECC_LOG_EVENT(READ_RESPONSE_INVALID,      ERROR, "Invalid read response at address %04X")
+ATECC_LOG_EVENT(CONFIG_LOAD_FAILED,         ERROR, "Failed to load configuration zone shadow")
+ATECC_LOG_EVENT(NONCE_SEND,                 DEBUG, "Sending Nonce command")
+ATECC_LOG_EVENT(NONCE_SEND_FAILED,          ERROR, "I2C write failed for Nonce command")
+ATECC_LOG_EVENT(NONCE_RESPONSE_FAILED,      ERROR, "Failed to read Nonce response")
+ATECC_LOG_EVENT(NONCE_DONE,                 DEBUG, "Nonce generated")
+ATECC_LOG_EVENT(NONCE_LOAD_SEND_FAILED,     ERROR, "Failed to send pass-through Nonce command")
+ATECC_LOG_EVENT(NONCE_LOAD_FAILED,          ERROR, "Pass-through Nonce command failed")
+ATECC_LOG_EVENT(AES_SEND_FAILED,            ERROR, "I2C write failed for AES command")
+ATECC_LOG_EVENT(AES_RESPONSE_FAILED,        ERROR, "I2C read failed (no %u-byte AES response)")
+ATECC_LOG_EVENT(AES_CRC_MISMATCH,           ERROR, "AES response CRC mismatch: expected %04X, got %04X")
+ATECC_LOG_EVENT(AES_SLOT_NOT_KEY,           ERROR, "Slot %u is not configured as an AES key")
+ATECC_LOG_EVENT(AES_WAKE_FAILED,            ERROR, "Failed to wake device for AES")
+ATECC_LOG_EVENT(AES_ENCRYPT_SEND_FAILED,    ERROR, "Failed to send AES encrypt command")
+ATECC_LOG_EVENT(AES_ENCRYPT_RESPONSE_FAILED, ERROR, "Failed to receive AES encrypt response")
+ATECC_LOG_EVENT(AES_DECRYPT_SEND_FAILED,    ERROR, "Failed to send AES decrypt command")
+ATECC_LOG_EVENT(AES_DECRYPT_RESPONSE_FAILED, ERROR, "Failed to receive AES decrypt response")
+ATECC_LOG_EVENT(AES_BLOCKS_FAILED,          ERROR, "AES failed after %u blocks")
+ATECC_LOG_EVENT(AES_PADDING_INVALID,        WARN,  "Invalid PKCS#7 padding")
+ATECC_LOG_EVENT(AES_GFM_SEND_FAILED,        ERROR, "Failed to send AES GFM command")
+ATECC_LOG_EVENT(AES_GCM_TAG_MISMATCH,       WARN,  "GCM tag mismatch")
+ATECC_LOG_EVENT(AES_ECB_LENGTH_INVALID,     ERROR, "ECB length must be a multiple of %u bytes")
+ATECC_LOG_EVENT(RANDOM_SEND_FAILED,         ERROR, "Failed to send Random command")
+ATECC_LOG_EVENT(RANDOM_RESPONSE_FAILED,     ERROR, "Failed to read random number response")
+ATECC_LOG_EVENT(RANDOM_RESPONSE_INVALID,    ERROR, "Invalid random number response")
+ATECC_LOG_EVENT(RANDOM_BACKGROUND_FAILED,   ERROR, "Background Random command failed")
+ATECC_LOG_EVENT(SHA_START_FAILED,           ERROR, "SHA Start command failed")
+ATECC_LOG_EVENT(SHA_UPDATE_FAILED,          ERROR, "SHA Update command failed")
+ATECC_LOG_EVENT(SHA_DIGEST_FAILED,          ERROR, "Failed to retrieve SHA-256 digest")
+ATECC_LOG_EVENT(COMMAND_RETRY,              WARN,  "Command failed with result %03X, retry %u")
+ATECC_LOG_EVENT(COMMAND_FAILED,             ERROR, "Command failed with result %03X after %u attempts")
+ATECC_LOG_EVENT(READ_FAILED,                ERROR, "Failed to read address %04X")
+ATECC_LOG_EVENT(ECC_SLOT_NOT_KEY,           ERROR, "Slot %u is not configured as a P-256 private key")
+ATECC_LOG_EVENT(ECC_SLOT_NOT_PUBLIC,        ERROR, "Slot %u is not configured as a P-256 public key")
+ATECC_LOG_EVENT(ECC_WAKE_FAILED,            ERROR, "Failed to wake device for ECC")
+ATECC_LOG_EVENT(ECC_BATCH_FAILED,           ERROR, "ECDSA batch stopped after %u of %u signatures")
+ATECC_LOG_EVENT(KDF_LENGTH_INVALID,         ERROR, "KDF message of %u bytes or output of %u bytes out of range")
+ATECC_LOG_EVENT(CHANNEL_REKEY,              INFO,  "Channel rekeyed to epoch %u after %u bytes")
+ATECC_LOG_EVENT(CHANNEL_REKEY_FAILED,       ERROR, "Channel key derivation for epoch %u failed")
+ATECC_LOG_EVENT(CHANNEL_EPOCH_INVALID,      WARN,  "Message for channel epoch %u, at epoch %u")
+ATECC_LOG_EVENT(CHANNEL_REPLAY,             WARN,  "Channel message %u replayed or reordered, next accepted %u")
+ATECC_LOG_EVENT(COUNTER_INVALID,            ERROR, "Counter %u does not exist")
+ATECC_LOG_EVENT(COUNTER_BLOCK_RESERVED,     DEBUG, "Counter %u reserved block %u")
+ATECC_LOG_EVENT(DATA_RANGE_INVALID,         ERROR, "Range at offset %u of %u bytes does not fit or align")
+ATECC_LOG_EVENT(WRITE_FAILED,               ERROR, "Failed to write address %04X")
+ATECC_LOG_EVENT(DATA_WAKE_FAILED,           ERROR, "Failed to wake device for data zone access")
+ATECC_LOG_EVENT(RPC_REQUEST_FAILED,         WARN,  "RPC request %u answered with status %u")
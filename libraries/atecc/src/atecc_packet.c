@@ -0,0 +1,69 @@
+#include "atecc_packet.h"
+#include "atecc_crc.h"
+
+#include <string.h>
+
+/**
+ * @brief Sums the lengths of the fragments of a command payload.
+ *
+ * @param fragments The payload fragments.
+ * @param count     The number of fragments.
+ * @return The payload length in bytes.
+ */
+size_t atecc_packet_payload_length(const atecc_fragment_t *fragments, size_t count) {
+    size_t length = 0;
+    for (size_t i = 0; i < count; i++) {
+        length += fragments[i].length;
+    }
+    return length;
+}
+
+/**
+ * @brief Builds a complete I2C command packet in place.
+ *
+ * Header, parameters, payload and CRC are written straight into the packet buffer,
+ * and the CRC is accumulated while each fragment is copied, so every payload byte
+ * is touched once.
+ *
+ * @param[out] packet    Buffer receiving the packet, word address included.
+ * @param[in]  capacity  The size of the packet buffer.
+ * @param[in]  opcode    The command op-code.
+ * @param[in]  param1    The first parameter.
+ * @param[in]  param2    The second parameter.
+ * @param[in]  fragments The payload fragments, in order; may be NULL if count is 0.
+ * @param[in]  count     The number of fragments.
+ * @return The packet length, or 0 if the packet does not fit the buffer or the count byte.
+ */
+size_t atecc_packet_build(uint8_t *packet, size_t capacity, uint8_t opcode, uint8_t param1, uint16_t param2,
+                          const atecc_fragment_t *fragments, size_t count) {
+    size_t data_len = atecc_packet_payload_length(fragments, count);
+    size_t length = ATECC_PACKET_OVERHEAD + data_len;
+
+    if (length > capacity || length - 1 > UINT8_MAX) {
+        return 0;
+    }
+
+    packet[0] = ATECC_WORD_ADDRESS_COMMAND;
+    packet[1] = (uint8_t)(length - 1);
+    packet[2] = opcode;
+    packet[3] = param1;
+    packet[4] = (uint8_t)(param2 & 0xFF);
+    packet[5] = (uint8_t)(param2 >> 8);
+
+    atecc_crc_ctx_t crc;
+    atecc_crc_init(&crc);
+    atecc_crc_update(&crc, &packet[1], 5);
+
+    uint8_t *cursor = &packet[6];
+    for (size_t i = 0; i < count; i++) {
+        if (fragments[i].length == 0) {
+            continue;
+        }
+        memcpy(cursor, fragments[i].data, fragments[i].length);
+        atecc_crc_update(&crc, cursor, fragments[i].length);
+        cursor += fragments[i].length;
+    }
+
+    atecc_crc_final(&crc, cursor);
+    return length;
+}
@@ -0,0 +1,30 @@
+#ifndef ATECC_PACKET_H
+#define ATECC_PACKET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ATECC_WORD_ADDRESS_COMMAND  ((uint8_t)0x03) // I2C word address preceding a command packet
+#define ATECC_PACKET_OVERHEAD       (8u)            // Word address, count, op-code, param1, param2, CRC
+
+// One piece of a command payload. A payload may be spread over several fragments so
+// that e.g. a buffered partial block and the caller's data go out without being joined.
+typedef struct {
+    const uint8_t *data;
+    size_t length;
+} atecc_fragment_t;
+
+size_t atecc_packet_payload_length(const atecc_fragment_t *fragments, size_t count);
+size_t atecc_packet_build(uint8_t *packet, size_t capacity, uint8_t opcode, uint8_t param1, uint16_t param2,
+                          const atecc_fragment_t *fragments, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ATECC_PACKET_H
@@ -0,0 +1,298 @@
+#include "atecc_pool.h"
+#include "atecc_aes.h"
+#include "atecc_cmd.h"
+#include "atecc_log.h"
+#include "atecc_random.h"
+#include "atecc_sha.h"
+
+// A batch of independent commands spread over the pool. Each round sends one
+// command to every device, so they all execute at the same time, then collects
+// the responses in the same order.
+typedef struct pool_job pool_job_t;
+struct pool_job {
+    size_t items;
+    bool (*send)(pool_job_t *job, size_t index);
+    bool (*receive)(pool_job_t *job, size_t index);
+    uint8_t mode;
+    uint8_t key_slot;
+    const uint8_t *input;
+    uint8_t *output;
+    size_t length;
+    size_t response_length;     // Raw response of one command, count byte and CRC included
+};
+
+/**
+ * @brief Initializes an empty device pool.
+ *
+ * @param pool   The pool to initialize.
+ * @param policy How commands are spread over the devices.
+ */
+void atecc_pool_init(atecc_pool_t *pool, atecc_pool_policy_t policy) {
+    memset(pool, 0, sizeof(*pool));
+    pool->policy = policy;
+}
+
+/**
+ * @brief Adds an initialized device to a pool.
+ *
+ * @param pool   The pool.
+ * @param device The device; must stay valid as long as the pool is used.
+ * @return true if added, false if the pool is full.
+ */
+bool atecc_pool_add(atecc_pool_t *pool, atecc_device_t *device) {
+    if (pool->count == ATECC_POOL_MAX_DEVICES) {
+        return false;
+    }
+    pool->devices[pool->count++] = device;
+    return true;
+}
+
+// When a device is expected to accept its next command
+static uint64_t device_ready_us(const atecc_device_t *device) {
+    if (!device->exec.outstanding) {
+        return 0;
+    }
+    return device->exec.start_us + device->exec.timing->typical_us;
+}
+
+// Pick a device not yet in the exclude mask, advancing the rotation
+static atecc_device_t *pick_excluding(atecc_pool_t *pool, uint32_t exclude, size_t *picked) {
+    size_t best = pool->count;
+    uint64_t best_ready = UINT64_MAX;
+
+    for (size_t n = 0; n < pool->count; n++) {
+        size_t i = (pool->next + n) % pool->count;
+        if (exclude & (1u << i)) {
+            continue;
+        }
+        if (pool->policy == ATECC_POOL_ROUND_ROBIN) {
+            best = i;
+            break;
+        }
+        uint64_t ready = device_ready_us(pool->devices[i]);
+        if (ready < best_ready) {
+            best = i;
+            best_ready = ready;
+        }
+    }
+
+    if (best == pool->count) {
+        return NULL;
+    }
+    pool->next = (best + 1) % pool->count;
+    *picked = best;
+    return pool->devices[best];
+}
+
+/**
+ * @brief Picks the device for the next single command according to the pool policy.
+ *
+ * @param pool The pool.
+ * @return The device, or NULL if the pool is empty.
+ */
+atecc_device_t *atecc_pool_pick(atecc_pool_t *pool) {
+    size_t index;
+    return pick_excluding(pool, 0, &index);
+}
+
+/**
+ * @brief Applies the idle/sleep policy to every device of a pool.
+ *
+ * atecc_power_poll() only looks at the selected device; call this instead from the
+ * main loop of an application that uses a pool.
+ *
+ * @param pool The pool.
+ */
+void atecc_pool_power_poll(atecc_pool_t *pool) {
+    atecc_device_t *previous = atecc_device_current();
+
+    for (size_t i = 0; i < pool->count; i++) {
+        atecc_device_select(pool->devices[i]);
+        atecc_power_poll();
+    }
+    atecc_device_select(previous);
+}
+
+/**
+ * @brief Runs a batch of commands across all devices of a pool.
+ *
+ * Every device is held awake for the whole batch. If a command fails, the commands
+ * still executing on other devices are collected before returning.
+ *
+ * @param pool The pool.
+ * @param job  The batch to run.
+ * @return true if every command succeeded, false otherwise.
+ */
+static bool pool_run_job(atecc_pool_t *pool, pool_job_t *job) {
+    atecc_device_t *round[ATECC_POOL_MAX_DEVICES];
+    atecc_device_t *previous = atecc_device_current();
+    size_t awake = 0;
+    bool ok = pool->count > 0;
+
+    for (; ok && awake < pool->count; awake++) {
+        atecc_device_select(pool->devices[awake]);
+        ok = atecc_session_begin();
+    }
+    if (!ok) {
+        awake--;
+    }
+
+    for (size_t item = 0; ok && item < job->items;) {
+        uint32_t used = 0;
+        size_t sent = 0;
+
+        while (ok && sent < pool->count && item + sent < job->items) {
+            size_t index;
+            round[sent] = pick_excluding(pool, used, &index);
+            used |= 1u << index;
+            atecc_device_select(round[sent]);
+            ok = job->send(job, item + sent);
+            if (ok) {
+                sent++;
+            }
+        }
+
+        for (size_t i = 0; i < sent; i++) {
+            atecc_device_select(round[i]);
+            if (ok) {
+                ok = job->receive(job, item + i);
+            } else {
+                uint8_t discard[ATECC_I2C_MAX_TRANSFER];
+                atecc_wait_response(discard, job->response_length);
+            }
+        }
+        item += sent;
+    }
+
+    while (awake > 0) {
+        atecc_device_select(pool->devices[--awake]);
+        atecc_session_end();
+    }
+    atecc_device_select(previous);
+    return ok;
+}
+
+static bool random_send(pool_job_t *job, size_t index) {
+    (void)job;
+    (void)index;
+    return send_atecc_command(ATCA_RANDOM, RANDOM_SEED_UPDATE, 0x0000, NULL, 0);
+}
+
+static bool random_receive(pool_job_t *job, size_t index) {
+    uint8_t response[ATECC_RANDOM_BLOCK_SIZE + 3];
+    size_t offset = index * ATECC_RANDOM_BLOCK_SIZE;
+    size_t chunk = job->length - offset < ATECC_RANDOM_BLOCK_SIZE ? job->length - offset : ATECC_RANDOM_BLOCK_SIZE;
+
+    if (!atecc_wait_response(response, sizeof(response)) ||
+        response[0] != sizeof(response) || !validate_crc(response, sizeof(response))) {
+        return false;
+    }
+
+    memcpy(&job->output[offset], &response[1], chunk);
+    memset(response, 0, sizeof(response));
+    return true;
+}
+
+static bool aes_send(pool_job_t *job, size_t index) {
+    return send_aes_command(job->mode, job->key_slot, &job->input[index * AES_BLOCK_SIZE]);
+}
+
+static bool aes_receive(pool_job_t *job, size_t index) {
+    return receive_aes_response(&job->output[index * AES_BLOCK_SIZE]);
+}
+
+/**
+ * @brief Fills a buffer with random bytes from all devices of a pool at once.
+ *
+ * Each device contributes 32-byte Random blocks; the commands of one round execute
+ * concurrently, so throughput scales with the number of devices.
+ *
+ * @param pool   The pool.
+ * @param buffer The buffer to fill.
+ * @param length The number of random bytes.
+ * @return true if the buffer was filled, false otherwise.
+ */
+bool atecc_pool_random(atecc_pool_t *pool, uint8_t *buffer, size_t length) {
+    pool_job_t job = {
+        .items = (length + ATECC_RANDOM_BLOCK_SIZE - 1) / ATECC_RANDOM_BLOCK_SIZE,
+        .send = random_send,
+        .receive = random_receive,
+        .output = buffer,
+        .length = length,
+        .response_length = ATECC_RANDOM_BLOCK_SIZE + 3,
+    };
+    return pool_run_job(pool, &job);
+}
+
+/**
+ * @brief Hashes a buffer on the pool device picked by the pool policy.
+ *
+ * The SHA-256 dispatcher still decides whether the device or the MCU is faster.
+ *
+ * @param pool   The pool.
+ * @param data   The message.
+ * @param length The message length in bytes.
+ * @param digest The buffer to store the SHA256_DIGEST_SIZE digest bytes.
+ * @return true if the digest was computed, false otherwise.
+ */
+bool atecc_pool_sha256(atecc_pool_t *pool, const uint8_t *data, size_t length, uint8_t *digest) {
+    atecc_device_t *device = atecc_pool_pick(pool);
+    if (device == NULL) {
+        return false;
+    }
+
+    atecc_device_t *previous = atecc_device_select(device);
+    bool ok = sha256_digest(data, length, 0, digest);
+    atecc_device_select(previous);
+    return ok;
+}
+
+// Spread ECB blocks over the pool
+static bool pool_aes_ecb(atecc_pool_t *pool, uint8_t mode, uint8_t key_slot,
+                         const uint8_t *input, uint8_t *output, size_t length) {
+    if (length % AES_BLOCK_SIZE != 0) {
+        ATECC_LOG(AES_ECB_LENGTH_INVALID, 0, 0, AES_BLOCK_SIZE, 0);
+        return false;
+    }
+
+    pool_job_t job = {
+        .items = length / AES_BLOCK_SIZE,
+        .send = aes_send,
+        .receive = aes_receive,
+        .mode = mode,
+        .key_slot = key_slot,
+        .input = input,
+        .output = output,
+        .length = length,
+        .response_length = AES_BLOCK_SIZE + 3,
+    };
+    return pool_run_job(pool, &job);
+}
+
+/**
+ * @brief Encrypts blocks in ECB mode, spread over all devices of a pool.
+ *
+ * @param pool     The pool.
+ * @param key_slot The AES key slot, provisioned with the same key on every device.
+ * @param input    The plaintext.
+ * @param output   The ciphertext; may equal input.
+ * @param length   The length in bytes, a multiple of AES_BLOCK_SIZE.
+ * @return true on success, false otherwise.
+ */
+bool atecc_pool_aes_ecb_encrypt(atecc_pool_t *pool, uint8_t key_slot, const uint8_t *input, uint8_t *output, size_t length) {
+    return pool_aes_ecb(pool, ATCA_AES_MODE_ENCRYPT, key_slot, input, output, length);
+}
+
+/**
+ * @brief Decrypts blocks in ECB mode, spread over all devices of a pool.
+ *
+ * @param pool     The pool.
+ * @param key_slot The AES key slot, provisioned with the same key on every device.
+ * @param input    The ciphertext.
+ * @param output   The plaintext; may equal input.
+ * @param length   The length in bytes, a multiple of AES_BLOCK_SIZE.
+ * @return true on success, false otherwise.
+ */
+bool atecc_pool_aes_ecb_decrypt(atecc_pool_t *pool, uint8_t key_slot, const uint8_t *input, uint8_t *output, size_t length) {
+    return pool_aes_ecb(pool, ATCA_AES_MODE_DECRYPT, key_slot, input, output, length);
+}
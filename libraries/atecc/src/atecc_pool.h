@@ -0,0 +1,40 @@
+#ifndef ATECC_POOL_H
+#define ATECC_POOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "atecc_device.h"
+
+// Devices one pool can hold
+#ifndef ATECC_POOL_MAX_DEVICES
+#define ATECC_POOL_MAX_DEVICES  (8u)
+#endif
+
+// How a pool picks the device for the next command
+typedef enum {
+    ATECC_POOL_ROUND_ROBIN,     // Strict rotation
+    ATECC_POOL_LEAST_BUSY,      // The device expected to finish its current command first
+} atecc_pool_policy_t;
+
+// A set of devices that can stand in for each other for stateless operations.
+// AES keys must be provisioned into the same slot on every device.
+typedef struct {
+    atecc_device_t *devices[ATECC_POOL_MAX_DEVICES];
+    size_t count;
+    size_t next;                // Round-robin position
+    atecc_pool_policy_t policy;
+} atecc_pool_t;
+
+void atecc_pool_init(atecc_pool_t *pool, atecc_pool_policy_t policy);
+bool atecc_pool_add(atecc_pool_t *pool, atecc_device_t *device);
+atecc_device_t *atecc_pool_pick(atecc_pool_t *pool);
+void atecc_pool_power_poll(atecc_pool_t *pool);
+
+bool atecc_pool_random(atecc_pool_t *pool, uint8_t *buffer, size_t length);
+bool atecc_pool_sha256(atecc_pool_t *pool, const uint8_t *data, size_t length, uint8_t *digest);
+bool atecc_pool_aes_ecb_encrypt(atecc_pool_t *pool, uint8_t key_slot, const uint8_t *input, uint8_t *output, size_t length);
+bool atecc_pool_aes_ecb_decrypt(atecc_pool_t *pool, uint8_t key_slot, const uint8_t *input, uint8_t *output, size_t length);
+
+#endif // ATECC_POOL_H
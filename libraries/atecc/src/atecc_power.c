@@ -0,0 +1,148 @@
+#include "atecc_power.h"
+#include "atecc_device.h"
+#include "hal_pico_i2c.h"
+
+/**
+ * @brief Sets the idle/sleep timeout policy applied when no session is open.
+ *
+ * @param policy The new policy.
+ */
+void atecc_power_set_policy(const atecc_power_policy_t *policy) {
+    atecc_power_t *power = &atecc_device_current()->power;
+    power->policy = *policy;
+}
+
+/**
+ * @brief Records a power state transition performed on the bus.
+ *
+ * Called by the wake, idle and sleep primitives so the tracked state always
+ * matches what was last sent to the device.
+ *
+ * @param state The state the device has just entered.
+ */
+void atecc_power_note_state(atecc_power_state_t state) {
+    atecc_power_t *power = &atecc_device_current()->power;
+    uint64_t now = time_us_64();
+    if (state == ATECC_POWER_AWAKE) {
+        power->wake_us = now;
+    }
+    power->state = state;
+    power->state_since_us = now;
+}
+
+/**
+ * @brief Returns the tracked power state, accounting for watchdog expiry.
+ *
+ * @return The current power state of the device.
+ */
+atecc_power_state_t atecc_power_state() {
+    atecc_power_t *power = &atecc_device_current()->power;
+    if (power->state == ATECC_POWER_AWAKE && time_us_64() - power->wake_us >= ATECC_WATCHDOG_US) {
+        // The device put itself to sleep when the watchdog expired
+        power->state = ATECC_POWER_SLEEP;
+        power->state_since_us = power->wake_us + ATECC_WATCHDOG_US;
+    }
+    return power->state;
+}
+
+/**
+ * @brief Returns how much of the watchdog window is left.
+ *
+ * @return Microseconds until the device falls asleep, or 0 if it is not awake.
+ */
+uint32_t atecc_power_watchdog_remaining_us() {
+    atecc_power_t *power = &atecc_device_current()->power;
+    if (atecc_power_state() != ATECC_POWER_AWAKE) {
+        return 0;
+    }
+    return (uint32_t)(ATECC_WATCHDOG_US - (time_us_64() - power->wake_us));
+}
+
+/**
+ * @brief Makes sure the device is awake long enough to run a command.
+ *
+ * Does nothing if the device is awake and the watchdog has at least needed_us plus
+ * ATECC_WATCHDOG_MARGIN_US left. If the window is too short the device is sent to
+ * idle and woken again, which restarts the watchdog while keeping TempKey.
+ *
+ * @param needed_us The time the next command may take (its max execution time).
+ * @return true if the device is awake, false if the wake failed.
+ */
+bool atecc_power_ensure_awake(uint32_t needed_us) {
+    atecc_power_state_t state = atecc_power_state();
+
+    if (state == ATECC_POWER_AWAKE) {
+        if (atecc_power_watchdog_remaining_us() >= needed_us + ATECC_WATCHDOG_MARGIN_US) {
+            return true;
+        }
+        send_idle_command();
+    }
+
+    return wake_atecc_device();
+}
+
+/**
+ * @brief Opens a power session.
+ *
+ * While a session is open the device is kept awake and only re-woken when the
+ * watchdog window runs short. Sessions nest; the idle/sleep policy applies once the
+ * outermost session ends.
+ *
+ * @return true if the device is awake, false if the wake failed.
+ */
+bool atecc_session_begin() {
+    atecc_power_t *power = &atecc_device_current()->power;
+    power->session_depth++;
+    if (!atecc_power_ensure_awake(0)) {
+        power->session_depth--;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Closes a power session opened with atecc_session_begin().
+ */
+void atecc_session_end() {
+    atecc_power_t *power = &atecc_device_current()->power;
+    if (power->session_depth == 0) {
+        return;
+    }
+
+    if (--power->session_depth == 0) {
+        power->state_since_us = time_us_64();
+        if (power->policy.idle_after_us == 0 && atecc_power_state() == ATECC_POWER_AWAKE) {
+            send_idle_command();
+        }
+    }
+}
+
+/**
+ * @brief Applies the idle/sleep policy; call periodically from the main loop.
+ *
+ * Moves an awake device without an open session to idle after idle_after_us, and an
+ * idle device to sleep after sleep_after_us. Acts on the selected device; see
+ * atecc_pool_power_poll() for a pool.
+ */
+void atecc_power_poll() {
+    atecc_power_t *power = &atecc_device_current()->power;
+    if (power->session_depth > 0) {
+        return;
+    }
+
+    uint64_t elapsed = time_us_64() - power->state_since_us;
+    switch (atecc_power_state()) {
+        case ATECC_POWER_AWAKE:
+            if (elapsed >= power->policy.idle_after_us) {
+                send_idle_command();
+            }
+            break;
+        case ATECC_POWER_IDLE:
+            if (power->policy.sleep_after_us != 0 && elapsed >= power->policy.sleep_after_us) {
+                send_sleep_command();
+            }
+            break;
+        default:
+            break;
+    }
+}
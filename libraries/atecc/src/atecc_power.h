@@ -0,0 +1,47 @@
+#ifndef ATECC_POWER_H
+#define ATECC_POWER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Device watchdog: the ATECC608A returns to sleep this long after a wake
+#define ATECC_WATCHDOG_US           (1300000u)
+// Minimum watchdog time left (beyond a command's max execution time) before re-waking
+#define ATECC_WATCHDOG_MARGIN_US    (20000u)
+
+// Power states of the device as tracked by the host
+typedef enum {
+    ATECC_POWER_SLEEP,      // Lowest power, TempKey and RNG state lost
+    ATECC_POWER_IDLE,       // Low power, TempKey retained, watchdog stopped
+    ATECC_POWER_AWAKE,      // Accepting commands, watchdog running
+} atecc_power_state_t;
+
+// When to drop to a lower power state once no session is open
+typedef struct {
+    uint32_t idle_after_us;     // Awake -> idle after this long without a session (0 = at session end)
+    uint32_t sleep_after_us;    // Idle -> sleep after this long (0 = never)
+} atecc_power_policy_t;
+
+// Default policy for a new device
+#define ATECC_POWER_POLICY_DEFAULT  { .idle_after_us = 10000u, .sleep_after_us = 1000000u }
+
+// Host-side view of one device's power state
+typedef struct {
+    atecc_power_state_t state;
+    uint64_t wake_us;           // When the watchdog was last started
+    uint64_t state_since_us;    // When the current state (or last session end) began
+    uint32_t session_depth;
+    atecc_power_policy_t policy;
+} atecc_power_t;
+
+void atecc_power_set_policy(const atecc_power_policy_t *policy);
+void atecc_power_note_state(atecc_power_state_t state);
+atecc_power_state_t atecc_power_state();
+uint32_t atecc_power_watchdog_remaining_us();
+
+bool atecc_power_ensure_awake(uint32_t needed_us);
+bool atecc_session_begin();
+void atecc_session_end();
+void atecc_power_poll();
+
+#endif // ATECC_POWER_H
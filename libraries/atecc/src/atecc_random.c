@@ -0,0 +1,221 @@
+#include "atecc_random.h"
+#include "atecc_cmd.h"
+#include "atecc_exec.h"
+#include "atecc_log.h"
+#include "atecc_response.h"
+#include "hal_pico_i2c.h"
+
+// Buffered device entropy; bytes are handed out from the end and wiped once used.
+// random_pool_service() refills it one asynchronous Random command at a time.
+static struct {
+    uint8_t bytes[ATECC_RANDOM_POOL_SIZE];
+    size_t available;
+    size_t low_water;
+    bool filling;                   // Below low water; refill until full
+    atecc_async_t refill;
+    uint8_t response[ATECC_RANDOM_BLOCK_SIZE + 3];
+} pool = { .low_water = ATECC_RANDOM_BLOCK_SIZE };
+
+/**
+ * @brief Runs one Random command and returns its 32 bytes.
+ *
+ * @param output The buffer to store ATECC_RANDOM_BLOCK_SIZE random bytes.
+ * @return true if the random bytes were read, possibly after retries, false otherwise.
+ */
+static bool fetch_random_block(uint8_t *output) {
+    uint8_t response[ATECC_RANDOM_BLOCK_SIZE + 3];
+
+    if (atecc_execute(ATCA_RANDOM, RANDOM_SEED_UPDATE, 0x0000, NULL, 0, response, sizeof(response),
+                      ATECC_EXEC_REPLAYABLE) != ATECC_OK) {
+        return false;
+    }
+
+    memcpy(output, &response[1], ATECC_RANDOM_BLOCK_SIZE);
+    memset(response, 0, sizeof(response));
+    return true;
+}
+
+/**
+ * @brief Adds the block of a finished background refill to the pool.
+ *
+ * @param wait true to sleep until a refill in flight has finished.
+ * @return true unless the refill failed.
+ */
+static bool pool_collect(bool wait) {
+    atecc_async_state_t state = wait ? atecc_async_wait(&pool.refill) : atecc_async_poll(&pool.refill);
+
+    if (state == ATECC_ASYNC_FAILED) {
+        ATECC_LOG(RANDOM_BACKGROUND_FAILED, ATCA_RANDOM, 0, 0, 0);
+        return false;
+    }
+
+    if (state == ATECC_ASYNC_DONE) {
+        memcpy(&pool.bytes[pool.available], &pool.response[1], ATECC_RANDOM_BLOCK_SIZE);
+        pool.available += ATECC_RANDOM_BLOCK_SIZE;
+        memset(pool.response, 0, sizeof(pool.response));
+    }
+    return true;
+}
+
+/**
+ * @brief Tops the pool up with whole Random blocks until it is full.
+ *
+ * @return true if the pool is full, false if a Random command failed.
+ */
+static bool pool_fill() {
+    // A refill in flight has room reserved in the pool
+    if (!pool_collect(true)) {
+        return false;
+    }
+
+    while (ATECC_RANDOM_POOL_SIZE - pool.available >= ATECC_RANDOM_BLOCK_SIZE) {
+        if (!fetch_random_block(&pool.bytes[pool.available])) {
+            return false;
+        }
+        pool.available += ATECC_RANDOM_BLOCK_SIZE;
+    }
+    return true;
+}
+
+/**
+ * @brief Configures the entropy pool.
+ *
+ * @param low_water Refill threshold used by random_pool_service(), in bytes.
+ * @param prefill   true to fill the pool now so the first draws need no bus traffic.
+ * @return true on success, false if the prefill failed.
+ */
+bool random_pool_init(size_t low_water, bool prefill) {
+    pool.low_water = low_water < ATECC_RANDOM_POOL_SIZE ? low_water : ATECC_RANDOM_POOL_SIZE;
+    return prefill ? pool_fill() : true;
+}
+
+/**
+ * @brief Refills the pool in the background once it drops below the low-water mark.
+ *
+ * Never waits for the device: each call collects a finished Random command and, while
+ * the pool is refilling, submits the next one asynchronously. Call it regularly from
+ * the main loop so draws seldom have to wait for a Random command.
+ *
+ * @return true unless a background Random command failed or could not be submitted.
+ */
+bool random_pool_service() {
+    if (pool.refill.state == ATECC_ASYNC_BUSY) {
+        return true;
+    }
+    if (!pool_collect(false)) {
+        return false;
+    }
+
+    if (pool.available < pool.low_water) {
+        pool.filling = true;
+    }
+    if (!pool.filling || ATECC_RANDOM_POOL_SIZE - pool.available < ATECC_RANDOM_BLOCK_SIZE) {
+        pool.filling = false;
+        return true;
+    }
+
+    // Another command owns the device; try again on the next call
+    if (atecc_async_busy()) {
+        return true;
+    }
+
+    return atecc_command_async(&pool.refill, ATCA_RANDOM, RANDOM_SEED_UPDATE, 0x0000, NULL, 0,
+                               pool.response, sizeof(pool.response), NULL, NULL);
+}
+
+/**
+ * @brief Returns the number of random bytes currently buffered.
+ *
+ * @return Buffered bytes.
+ */
+size_t random_pool_available() {
+    return pool.available;
+}
+
+/**
+ * @brief Fills a buffer with random bytes from the ATECC608A.
+ *
+ * Draws come from the pool, waiting for a background refill if one is in flight.
+ * When the pool runs dry, Random commands refill it in 32-byte steps; large
+ * requests take whole blocks straight into the caller's buffer.
+ *
+ * @param buffer The buffer to fill.
+ * @param length The number of random bytes.
+ * @return true if the buffer was filled, false if a Random command failed.
+ */
+bool get_random_bytes(uint8_t *buffer, size_t length) {
+    while (length > 0) {
+        if (pool.available == 0 && !pool_collect(true)) {
+            return false;
+        }
+        if (pool.available == 0) {
+            if (length >= ATECC_RANDOM_BLOCK_SIZE) {
+                if (!fetch_random_block(buffer)) {
+                    return false;
+                }
+                buffer += ATECC_RANDOM_BLOCK_SIZE;
+                length -= ATECC_RANDOM_BLOCK_SIZE;
+                continue;
+            }
+            if (!pool_fill()) {
+                return false;
+            }
+        }
+
+        size_t chunk = length < pool.available ? length : pool.available;
+        pool.available -= chunk;
+        memcpy(buffer, &pool.bytes[pool.available], chunk);
+        memset(&pool.bytes[pool.available], 0, chunk);
+        buffer += chunk;
+        length -= chunk;
+    }
+    return true;
+}
+
+/**
+ * @brief Draws an unbiased random integer from [min, max].
+ *
+ * Uses rejection sampling: just enough random bytes for the range are masked to the
+ * next power of two and redrawn if they fall outside the range, so every value in
+ * the range is equally likely. Fewer than two draws are needed on average.
+ *
+ * @param min   The lower bound (inclusive).
+ * @param max   The upper bound (inclusive), not below min.
+ * @param value Set to the random integer.
+ * @return true on success, false if min > max or the device failed.
+ */
+bool random_uniform(uint64_t min, uint64_t max, uint64_t *value) {
+    if (min > max) {
+        return false;
+    }
+
+    uint64_t span = max - min;      // Range size minus one
+    uint64_t mask = span;
+    mask |= mask >> 1;
+    mask |= mask >> 2;
+    mask |= mask >> 4;
+    mask |= mask >> 8;
+    mask |= mask >> 16;
+    mask |= mask >> 32;
+
+    size_t byte_count = 0;
+    for (uint64_t m = mask; m != 0; m >>= 8) {
+        byte_count++;
+    }
+
+    uint64_t candidate;
+    do {
+        uint8_t bytes[8];
+        if (!get_random_bytes(bytes, byte_count)) {
+            return false;
+        }
+        candidate = 0;
+        for (size_t i = 0; i < byte_count; i++) {
+            candidate = (candidate << 8) | bytes[i];
+        }
+        candidate &= mask;
+    } while (candidate > span);
+
+    *value = min + candidate;
+    return true;
+}
@@ -0,0 +1,21 @@
+#ifndef ATECC_RANDOM_H
+#define ATECC_RANDOM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define ATECC_RANDOM_BLOCK_SIZE     (32u)   // Bytes returned by one Random command
+
+// Pool capacity in bytes, a multiple of ATECC_RANDOM_BLOCK_SIZE
+#ifndef ATECC_RANDOM_POOL_SIZE
+#define ATECC_RANDOM_POOL_SIZE      (64u)
+#endif
+
+bool random_pool_init(size_t low_water, bool prefill);
+bool random_pool_service();
+size_t random_pool_available();
+bool get_random_bytes(uint8_t *buffer, size_t length);
+bool random_uniform(uint64_t min, uint64_t max, uint64_t *value);
+
+#endif // ATECC_RANDOM_H
@@ -0,0 +1,38 @@
+#include "atecc_service.h"
+#include "atecc_aes.h"
+#include "atecc_cmd.h"
+#include "atecc_ecc.h"
+#include "atecc_random.h"
+#include "atecc_sha.h"
+
+/**
+ * @brief Runs one request on the calling core.
+ *
+ * The core1 service runs its queue through this; anything else that owns the device
+ * can run requests with it directly. The caller holds the power session.
+ *
+ * @param request The request to run.
+ * @return true if the operation succeeded, false otherwise.
+ */
+bool atecc_request_run(atecc_request_t *request) {
+    switch (request->type) {
+        case ATECC_REQUEST_RANDOM:
+            return get_random_bytes(request->output, request->output_length);
+        case ATECC_REQUEST_SHA256:
+            return request->output_length >= SHA256_DIGEST_SIZE &&
+                   sha256_digest(request->input, request->input_length, 0, request->output);
+        case ATECC_REQUEST_AES_ENCRYPT:
+            return request->output_length >= request->input_length &&
+                   aes_ecb_encrypt(request->key_slot, request->input, request->output, request->input_length);
+        case ATECC_REQUEST_AES_DECRYPT:
+            return request->output_length >= request->input_length &&
+                   aes_ecb_decrypt(request->key_slot, request->input, request->output, request->input_length);
+        case ATECC_REQUEST_READ_CONFIG:
+            return request->output_length >= CONFIG_ZONE_SIZE && read_config_zone(request->output);
+        case ATECC_REQUEST_SIGN:
+            return request->input_length == ECC_DIGEST_SIZE && request->output_length >= ECC_P256_SIG_SIZE &&
+                   ecc_sign_digest(request->key_slot, request->input, request->output);
+        default:
+            return false;
+    }
+}
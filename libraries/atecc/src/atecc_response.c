@@ -0,0 +1,260 @@
+#include "atecc_response.h"
+#include "atecc_bus.h"
+#include "atecc_cmd.h"
+#include "atecc_device.h"
+#include "atecc_exec.h"
+#include "atecc_log.h"
+#include "atecc_power.h"
+#include "hal_pico_i2c.h"
+
+/**
+ * @brief Decodes a raw response read for a command.
+ *
+ * A 4-byte packet is a status packet whichever length was expected; its status
+ * byte becomes the result. Any other packet must have the expected count byte and
+ * a valid CRC. Does not record anything.
+ *
+ * @param[in] response The raw response, count byte first.
+ * @param[in] length   The expected response length (4 for commands that only return a status).
+ * @return ATECC_OK, the device status, or the response error.
+ */
+atecc_result_t atecc_response_decode(const uint8_t *response, size_t length) {
+    if (length < 4) {
+        return ATECC_ERR_PARAM;
+    }
+
+    if (response[0] == 4) {
+        if (!crc_matches(response, 4)) {
+            return ATECC_ERR_RESPONSE_CRC;
+        }
+        switch (response[1]) {
+            case ATECC_OK:
+                return length == 4 ? ATECC_OK : ATECC_ERR_RESPONSE_LENGTH;
+            case ATECC_ERR_MISCOMPARE:
+            case ATECC_ERR_PARSE:
+            case ATECC_ERR_ECC_FAULT:
+            case ATECC_ERR_SELF_TEST:
+            case ATECC_ERR_HEALTH_TEST:
+            case ATECC_ERR_EXECUTION:
+            case ATECC_ERR_WAKE:
+            case ATECC_ERR_WATCHDOG:
+            case ATECC_ERR_BAD_CRC:
+                return (atecc_result_t)response[1];
+            default:
+                return ATECC_ERR_STATUS;
+        }
+    }
+
+    if (response[0] != length) {
+        return ATECC_ERR_RESPONSE_LENGTH;
+    }
+    return crc_matches(response, length) ? ATECC_OK : ATECC_ERR_RESPONSE_CRC;
+}
+
+/**
+ * @brief Tells whether sending a command again may succeed where it just failed.
+ *
+ * Results that mean the device never ran the command (a damaged packet, a reset,
+ * too little watchdog time, a NACK, a failed wake) and ECC faults are always worth
+ * a retry. A damaged or missing response means the command may have run, so it is
+ * only retried for commands flagged ATECC_EXEC_REPLAYABLE. Everything else is a
+ * permanent refusal.
+ *
+ * @param[in] result The result of the last attempt.
+ * @param[in] flags  The atecc_execute() flags of the command.
+ * @return true if the command should be sent again.
+ */
+bool atecc_result_is_transient(atecc_result_t result, uint8_t flags) {
+    switch (result) {
+        case ATECC_ERR_ECC_FAULT:
+        case ATECC_ERR_WAKE:
+        case ATECC_ERR_WATCHDOG:
+        case ATECC_ERR_BAD_CRC:
+        case ATECC_ERR_NACK:
+        case ATECC_ERR_WAKE_FAILED:
+            return true;
+        case ATECC_ERR_RESPONSE_CRC:
+        case ATECC_ERR_RESPONSE_LENGTH:
+        case ATECC_ERR_TIMEOUT:
+            return (flags & ATECC_EXEC_REPLAYABLE) != 0;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Returns the device status byte behind a result.
+ *
+ * @param[in] result The result.
+ * @return the status byte, or 0 for results detected by the host.
+ */
+uint8_t atecc_result_status(atecc_result_t result) {
+    return result < ATECC_ERR_STATUS ? (uint8_t)result : 0;
+}
+
+// Bring the host's view of the device back in line after a failed attempt
+static void resync(atecc_result_t result) {
+    switch (result) {
+        case ATECC_ERR_WAKE:
+        case ATECC_ERR_WATCHDOG:
+            // Awake, but not on the watchdog window the host tracks: restart it
+            send_idle_command();
+            break;
+        case ATECC_ERR_NACK:
+        case ATECC_ERR_TIMEOUT:
+            // Probably asleep; the next attempt wakes it
+            atecc_power_note_state(ATECC_POWER_SLEEP);
+            break;
+        default:
+            break;
+    }
+}
+
+// A command for the retry loop: either the parts for atecc_packet_build(), or a
+// packet built by the caller with its execution time bounds
+typedef struct {
+    uint8_t opcode;
+    uint8_t param1;
+    uint16_t param2;
+    const atecc_fragment_t *fragments;
+    size_t count;
+    const uint8_t *packet;
+    size_t packet_length;
+    const atecc_exec_time_t *timing;
+} command_t;
+
+// One send, wait and decode
+static atecc_result_t attempt(const command_t *command, uint8_t *response, size_t length) {
+    atecc_result_t result = command->packet != NULL
+                                ? atecc_packet_send(command->packet, command->packet_length, command->timing)
+                                : atecc_command_send(command->opcode, command->param1, command->param2,
+                                                     command->fragments, command->count);
+    if (result != ATECC_OK) {
+        return result;
+    }
+    if (!atecc_wait_response(response, length)) {
+        return ATECC_ERR_TIMEOUT;
+    }
+
+    result = atecc_response_decode(response, length);
+    if (result == ATECC_ERR_RESPONSE_CRC) {
+        atecc_bus_note_crc_error(atecc_device_current()->bus);
+        ATECC_STATS_CRC_ERROR(command->opcode);
+    }
+    return result;
+}
+
+// The retry loop behind atecc_execute_sg() and atecc_execute_packet()
+static atecc_result_t execute(const command_t *command, uint8_t *response, size_t length, uint8_t flags) {
+    uint8_t opcode = command->opcode;
+    uint32_t backoff_us = ATECC_RETRY_BACKOFF_US;
+    atecc_result_t result;
+    uint32_t retries = 0;
+
+    for (;;) {
+        result = attempt(command, response, length);
+        if (result == ATECC_OK) {
+            return ATECC_OK;
+        }
+
+        resync(result);
+        if (flags & ATECC_EXEC_NO_RETRY) {
+            return result;
+        }
+        if (retries == ATECC_RETRY_LIMIT || !atecc_result_is_transient(result, flags)) {
+            break;
+        }
+
+        retries++;
+        ATECC_LOG(COMMAND_RETRY, opcode, atecc_result_status(result), result, retries);
+        ATECC_STATS_RETRY(opcode);
+        sleep_us(backoff_us);
+        backoff_us = backoff_us * 2 < ATECC_RETRY_BACKOFF_MAX_US ? backoff_us * 2 : ATECC_RETRY_BACKOFF_MAX_US;
+    }
+
+    // A miscompare is the answer to a Verify or CheckMac, not a failure
+    if (result != ATECC_ERR_MISCOMPARE) {
+        ATECC_LOG(COMMAND_FAILED, opcode, atecc_result_status(result), result, retries + 1);
+    }
+    return result;
+}
+
+/**
+ * @brief Runs a command and reads its response, retrying transient failures.
+ *
+ * Up to ATECC_RETRY_LIMIT retries follow a failed attempt, after a delay that starts
+ * at ATECC_RETRY_BACKOFF_US and doubles up to ATECC_RETRY_BACKOFF_MAX_US. Before a
+ * retry the device is re-woken if it lost its watchdog window or stopped answering,
+ * and a bus that keeps collecting errors drops its clock (see atecc_bus_service()).
+ * Permanent errors such as a slot configuration refusing the command return at once.
+ * With ATECC_EXEC_NO_RETRY the first failure is returned unlogged, for callers that
+ * must repeat a sequence of commands (a TempKey load and its use) rather than one.
+ *
+ * @param[in]  opcode    The command op-code.
+ * @param[in]  param1    The first parameter.
+ * @param[in]  param2    The second parameter.
+ * @param[in]  fragments The payload fragments, in order.
+ * @param[in]  count     The number of fragments.
+ * @param[out] response  Buffer receiving the raw response, count byte first.
+ * @param[in]  length    The expected response length (4 for commands that only return a status).
+ * @param[in]  flags     ATECC_EXEC_REPLAYABLE if running the command twice is harmless,
+ *                       ATECC_EXEC_NO_RETRY to make a single attempt.
+ * @return ATECC_OK with the response in place, or the result of the last attempt.
+ */
+atecc_result_t atecc_execute_sg(uint8_t opcode, uint8_t param1, uint16_t param2,
+                                const atecc_fragment_t *fragments, size_t count,
+                                uint8_t *response, size_t length, uint8_t flags) {
+    command_t command = {
+        .opcode = opcode,
+        .param1 = param1,
+        .param2 = param2,
+        .fragments = fragments,
+        .count = count,
+    };
+    return execute(&command, response, length, flags);
+}
+
+/**
+ * @brief Runs a command with a contiguous payload; see atecc_execute_sg().
+ *
+ * @param[in]  opcode   The command op-code.
+ * @param[in]  param1   The first parameter.
+ * @param[in]  param2   The second parameter.
+ * @param[in]  data     The command data, or NULL.
+ * @param[in]  data_len The length of the data.
+ * @param[out] response Buffer receiving the raw response, count byte first.
+ * @param[in]  length   The expected response length.
+ * @param[in]  flags    ATECC_EXEC_REPLAYABLE if running the command twice is harmless.
+ * @return ATECC_OK with the response in place, or the result of the last attempt.
+ */
+atecc_result_t atecc_execute(uint8_t opcode, uint8_t param1, uint16_t param2, const uint8_t *data, size_t data_len,
+                             uint8_t *response, size_t length, uint8_t flags) {
+    atecc_fragment_t fragment = { data, data_len };
+    return atecc_execute_sg(opcode, param1, param2, &fragment, data_len > 0 ? 1 : 0, response, length, flags);
+}
+
+/**
+ * @brief Runs a command from a complete packet; see atecc_execute_sg().
+ *
+ * The packet is resent unchanged on a retry, and the given bounds replace the
+ * execution time table, so commands described at compile time (atecc_command.hpp)
+ * skip both the packet build and the lookup.
+ *
+ * @param[in]  packet        The packet, word address first and CRC last.
+ * @param[in]  packet_length The packet length.
+ * @param[in]  timing        The execution time bounds of the command.
+ * @param[out] response      Buffer receiving the raw response, count byte first.
+ * @param[in]  length        The expected response length.
+ * @param[in]  flags         ATECC_EXEC_REPLAYABLE if running the command twice is harmless.
+ * @return ATECC_OK with the response in place, or the result of the last attempt.
+ */
+atecc_result_t atecc_execute_packet(const uint8_t *packet, size_t packet_length, const atecc_exec_time_t *timing,
+                                    uint8_t *response, size_t length, uint8_t flags) {
+    command_t command = {
+        .opcode = timing->opcode,
+        .packet = packet,
+        .packet_length = packet_length,
+        .timing = timing,
+    };
+    return execute(&command, response, length, flags);
+}
@@ -0,0 +1,72 @@
+#ifndef ATECC_RESPONSE_H
+#define ATECC_RESPONSE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "atecc_exec.h"
+#include "atecc_packet.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Response decoding and the retry engine. A response is either the expected
+// count/data/CRC packet or a 4-byte status packet; atecc_response_decode() turns
+// both into an atecc_result_t, and atecc_execute() retries the transient ones.
+
+#ifndef ATECC_RETRY_LIMIT
+#define ATECC_RETRY_LIMIT           (3u)        // Attempts after the first; 0 disables retries
+#endif
+#define ATECC_RETRY_BACKOFF_US      (1000u)     // Delay before the first retry, doubled for each one after
+#define ATECC_RETRY_BACKOFF_MAX_US  (8000u)
+
+// Outcome of a command. Device status codes keep their byte value, so a result
+// below 0x100 is what the device sent in its status packet.
+typedef enum {
+    ATECC_OK                    = 0x00,
+    ATECC_ERR_MISCOMPARE        = 0x01,     // CheckMac or Verify mismatch
+    ATECC_ERR_PARSE             = 0x03,     // Illegal op-code, parameter or length
+    ATECC_ERR_ECC_FAULT         = 0x05,     // ECC computation fault; the datasheet advises a retry
+    ATECC_ERR_SELF_TEST         = 0x07,
+    ATECC_ERR_HEALTH_TEST       = 0x08,     // RNG health test failed
+    ATECC_ERR_EXECUTION         = 0x0F,     // Refused by the slot or zone configuration
+    ATECC_ERR_WAKE              = 0x11,     // The device reset and lost the command
+    ATECC_ERR_WATCHDOG          = 0xEE,     // Not enough watchdog time left to run the command
+    ATECC_ERR_BAD_CRC           = 0xFF,     // The device received a damaged packet
+    ATECC_ERR_STATUS            = 0x100,    // Any other status byte
+    ATECC_ERR_RESPONSE_CRC,                 // The response was damaged on the way back
+    ATECC_ERR_RESPONSE_LENGTH,              // Unexpected count byte
+    ATECC_ERR_NACK,                         // The device did not acknowledge the packet
+    ATECC_ERR_TIMEOUT,                      // No response within the maximum execution time
+    ATECC_ERR_WAKE_FAILED,
+    ATECC_ERR_PARAM,                        // Packet or response buffer too large
+} atecc_result_t;
+
+// atecc_execute() flags
+#define ATECC_EXEC_REPLAYABLE       (0x01u)     // Running the command twice is harmless
+#define ATECC_EXEC_NO_RETRY         (0x02u)     // One attempt; the caller retries a whole command sequence
+
+atecc_result_t atecc_response_decode(const uint8_t *response, size_t length);
+bool atecc_result_is_transient(atecc_result_t result, uint8_t flags);
+uint8_t atecc_result_status(atecc_result_t result);
+
+atecc_result_t atecc_command_send(uint8_t opcode, uint8_t param1, uint16_t param2,
+                                  const atecc_fragment_t *fragments, size_t count);
+atecc_result_t atecc_execute_sg(uint8_t opcode, uint8_t param1, uint16_t param2,
+                                const atecc_fragment_t *fragments, size_t count,
+                                uint8_t *response, size_t length, uint8_t flags);
+atecc_result_t atecc_execute(uint8_t opcode, uint8_t param1, uint16_t param2, const uint8_t *data, size_t data_len,
+                             uint8_t *response, size_t length, uint8_t flags);
+
+// Prebuilt packets with caller-supplied execution time bounds
+atecc_result_t atecc_packet_send(const uint8_t *packet, size_t length, const atecc_exec_time_t *timing);
+atecc_result_t atecc_execute_packet(const uint8_t *packet, size_t packet_length, const atecc_exec_time_t *timing,
+                                    uint8_t *response, size_t length, uint8_t flags);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ATECC_RESPONSE_H
@@ -0,0 +1,143 @@
+#include <string.h>
+
+#include "atecc_rpc.h"
+#include "atecc_crc.h"
+
+static uint16_t get_le16(const uint8_t *in) {
+    return (uint16_t)(in[0] | (in[1] << 8));
+}
+
+/**
+ * @brief Builds a frame around a payload.
+ *
+ * The payload may already sit at frame + ATECC_RPC_HEADER_SIZE, so responses can be
+ * produced in place.
+ *
+ * @param[in]  opcode  The opcode, with ATECC_RPC_RESPONSE set for responses.
+ * @param[in]  param   The opcode's parameter byte.
+ * @param[in]  status  ATECC_RPC_OK in requests, the result in responses.
+ * @param[in]  id      The request id.
+ * @param[in]  payload The payload, or NULL if length is 0.
+ * @param[in]  length  The payload length, at most ATECC_RPC_MAX_PAYLOAD.
+ * @param[out] frame   Receives the frame, at least ATECC_RPC_MAX_FRAME bytes.
+ * @return The frame length, or 0 if the payload is too long.
+ */
+size_t atecc_rpc_encode(uint8_t opcode, uint8_t param, uint8_t status, uint16_t id,
+                        const uint8_t *payload, size_t length, uint8_t *frame) {
+    if (length > ATECC_RPC_MAX_PAYLOAD) {
+        return 0;
+    }
+
+    frame[0] = ATECC_RPC_SYNC;
+    frame[1] = opcode;
+    frame[2] = param;
+    frame[3] = status;
+    frame[4] = (uint8_t)id;
+    frame[5] = (uint8_t)(id >> 8);
+    frame[6] = (uint8_t)length;
+    frame[7] = (uint8_t)(length >> 8);
+    if (length > 0 && payload != &frame[ATECC_RPC_HEADER_SIZE]) {
+        memmove(&frame[ATECC_RPC_HEADER_SIZE], payload, length);
+    }
+    calc_crc16_ccitt(ATECC_RPC_HEADER_SIZE - 1 + length, &frame[1], &frame[ATECC_RPC_HEADER_SIZE + length]);
+    return ATECC_RPC_HEADER_SIZE + length + ATECC_RPC_CRC_SIZE;
+}
+
+/**
+ * @brief Starts reassembling frames from the beginning of a stream.
+ *
+ * @param[out] parser The parser state.
+ */
+void atecc_rpc_parser_init(atecc_rpc_parser_t *parser) {
+    memset(parser, 0, sizeof(*parser));
+}
+
+// Drops the first start buffered bytes and any after them up to the next sync byte,
+// returning the number dropped
+static size_t restart_at_sync(atecc_rpc_parser_t *parser, size_t start) {
+    size_t next = start;
+    while (next < parser->filled && parser->buffer[next] != ATECC_RPC_SYNC) {
+        next++;
+    }
+    parser->filled -= next;
+    memmove(parser->buffer, &parser->buffer[next], parser->filled);
+    return next;
+}
+
+// Drops the buffered sync byte and restarts at the next one buffered after it
+static void resync(atecc_rpc_parser_t *parser) {
+    parser->dropped_bytes += (uint32_t)restart_at_sync(parser, 1);
+}
+
+/**
+ * @brief Feeds stream bytes to the parser, stopping after the first complete frame.
+ *
+ * Bytes after that frame are not consumed; feed them again for the next one. After a
+ * resync the buffer may hold more than the frame found in it; the rest is kept, so
+ * the next call can complete a frame without new bytes.
+ *
+ * @param[in,out] parser   The parser state.
+ * @param[in]     data     Bytes received.
+ * @param[in]     length   The number of bytes received.
+ * @param[out]    frame    Receives the frame when one is complete.
+ * @param[out]    complete Set to true if frame was filled.
+ * @return The number of bytes consumed.
+ */
+size_t atecc_rpc_parse(atecc_rpc_parser_t *parser, const uint8_t *data, size_t length,
+                       atecc_rpc_frame_t *frame, bool *complete) {
+    size_t consumed = 0;
+
+    *complete = false;
+    for (;;) {
+        size_t payload_length = parser->filled >= ATECC_RPC_HEADER_SIZE ? get_le16(&parser->buffer[6]) : 0;
+        size_t needed = parser->filled < ATECC_RPC_HEADER_SIZE
+                            ? ATECC_RPC_HEADER_SIZE
+                            : ATECC_RPC_HEADER_SIZE + payload_length + ATECC_RPC_CRC_SIZE;
+
+        if (parser->filled >= ATECC_RPC_HEADER_SIZE && payload_length > ATECC_RPC_MAX_PAYLOAD) {
+            resync(parser);
+            continue;
+        }
+
+        if (parser->filled >= needed) {
+            uint8_t crc[ATECC_RPC_CRC_SIZE];
+            calc_crc16_ccitt(needed - 1 - ATECC_RPC_CRC_SIZE, &parser->buffer[1], crc);
+            if (memcmp(crc, &parser->buffer[needed - ATECC_RPC_CRC_SIZE], sizeof(crc)) != 0) {
+                parser->crc_errors++;
+                resync(parser);
+                continue;
+            }
+
+            frame->opcode = parser->buffer[1];
+            frame->param = parser->buffer[2];
+            frame->status = parser->buffer[3];
+            frame->id = get_le16(&parser->buffer[4]);
+            frame->length = (uint16_t)payload_length;
+            memcpy(frame->payload, &parser->buffer[ATECC_RPC_HEADER_SIZE], payload_length);
+            parser->dropped_bytes += (uint32_t)(restart_at_sync(parser, needed) - needed);
+            *complete = true;
+            return consumed;
+        }
+
+        if (consumed == length) {
+            return consumed;
+        }
+        if (parser->filled == 0) {
+            // Outside a frame, skip to the next sync byte
+            if (data[consumed++] != ATECC_RPC_SYNC) {
+                parser->dropped_bytes++;
+                continue;
+            }
+            parser->buffer[parser->filled++] = ATECC_RPC_SYNC;
+            continue;
+        }
+
+        size_t chunk = needed - parser->filled;
+        if (chunk > length - consumed) {
+            chunk = length - consumed;
+        }
+        memcpy(&parser->buffer[parser->filled], &data[consumed], chunk);
+        parser->filled += chunk;
+        consumed += chunk;
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef ATECC_RPC_H
+#define ATECC_RPC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Framed binary protocol that lets a host use the ATECC608 as a crypto accelerator
+// over a byte stream (USB CDC on the Pico). Every frame is
+//
+//   sync | opcode | param | status | request id | length | payload | CRC16
+//    1      1        1       1        2 (LE)      2 (LE)   length    2 (LE)
+//
+// with the ATECC608 CRC16 over everything from the opcode to the end of the payload.
+// A response echoes the request id and sets ATECC_RPC_RESPONSE in the opcode. Up to
+// ATECC_RPC_MAX_IN_FLIGHT requests may be outstanding; responses come back in
+// completion order, so the host matches them by id.
+
+#define ATECC_RPC_SYNC              ((uint8_t)0xA5)
+#define ATECC_RPC_HEADER_SIZE       (8u)
+#define ATECC_RPC_CRC_SIZE          (2u)
+#define ATECC_RPC_MAX_PAYLOAD       (512u)
+#define ATECC_RPC_MAX_FRAME         (ATECC_RPC_HEADER_SIZE + ATECC_RPC_MAX_PAYLOAD + ATECC_RPC_CRC_SIZE)
+#define ATECC_RPC_RESPONSE          ((uint8_t)0x80)     // Opcode bit of responses
+
+// Requests the device accepts before it stops reading the stream
+#ifndef ATECC_RPC_MAX_IN_FLIGHT
+#define ATECC_RPC_MAX_IN_FLIGHT     (8u)
+#endif
+
+typedef enum {
+    ATECC_RPC_PING        = 0x01,   // Echoes the payload without touching the device
+    ATECC_RPC_RANDOM      = 0x02,   // Payload: byte count (LE16); response: that many random bytes
+    ATECC_RPC_SHA256      = 0x03,   // Payload: message; response: 32-byte digest
+    ATECC_RPC_AES_ENCRYPT = 0x04,   // Param: key slot; payload: 16-byte blocks, ECB
+    ATECC_RPC_AES_DECRYPT = 0x05,
+    ATECC_RPC_SIGN        = 0x06,   // Param: key slot; payload: 32-byte digest; response: R || S
+} atecc_rpc_opcode_t;
+
+typedef enum {
+    ATECC_RPC_OK          = 0x00,
+    ATECC_RPC_ERR_OPCODE  = 0x01,   // Unknown opcode
+    ATECC_RPC_ERR_LENGTH  = 0x02,   // Payload length not valid for the opcode
+    ATECC_RPC_ERR_FAILED  = 0x03,   // The device operation failed
+    ATECC_RPC_ERR_BUSY    = 0x04,   // The request could not be queued
+} atecc_rpc_status_t;
+
+// A decoded frame
+typedef struct {
+    uint8_t  opcode;
+    uint8_t  param;
+    uint8_t  status;
+    uint16_t id;
+    uint16_t length;
+    uint8_t  payload[ATECC_RPC_MAX_PAYLOAD];
+} atecc_rpc_frame_t;
+
+// Reassembles frames from a byte stream. Bytes that cannot start a frame, frames
+// announcing an oversized payload and frames failing the CRC are skipped by scanning
+// for the next sync byte.
+typedef struct {
+    uint8_t  buffer[ATECC_RPC_MAX_FRAME];
+    size_t   filled;
+    uint32_t crc_errors;
+    uint32_t dropped_bytes;
+} atecc_rpc_parser_t;
+
+// Non-blocking byte stream; each call moves what it can and returns the byte count.
+// The client side may block in read up to a timeout, returning 0 if nothing arrived.
+typedef struct {
+    size_t (*read)(uint8_t *data, size_t length, void *context);
+    size_t (*write)(const uint8_t *data, size_t length, void *context);
+    void *context;
+} atecc_rpc_transport_t;
+
+size_t atecc_rpc_encode(uint8_t opcode, uint8_t param, uint8_t status, uint16_t id,
+                        const uint8_t *payload, size_t length, uint8_t *frame);
+void atecc_rpc_parser_init(atecc_rpc_parser_t *parser);
+size_t atecc_rpc_parse(atecc_rpc_parser_t *parser, const uint8_t *data, size_t length,
+                       atecc_rpc_frame_t *frame, bool *complete);
+
+#endif // ATECC_RPC_H
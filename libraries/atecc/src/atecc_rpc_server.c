@@ -0,0 +1,200 @@
+#include <string.h>
+
+#include "atecc_rpc_server.h"
+#include "atecc_ecc.h"
+#include "atecc_log.h"
+#include "atecc_sha.h"
+
+#if (ATECC_RPC_MAX_IN_FLIGHT & (ATECC_RPC_MAX_IN_FLIGHT - 1)) != 0
+#error "ATECC_RPC_MAX_IN_FLIGHT must be a power of two"
+#endif
+
+// Queues a finished slot's response behind those already waiting
+static void reply(atecc_rpc_slot_t *slot, uint8_t status, size_t length) {
+    atecc_rpc_server_t *server = slot->server;
+
+    if (status != ATECC_RPC_OK) {
+        ATECC_LOG(RPC_REQUEST_FAILED, 0, 0, slot->id, status);
+        server->errors++;
+        length = 0;
+    }
+    slot->frame_length = atecc_rpc_encode(slot->opcode | ATECC_RPC_RESPONSE, slot->param, status, slot->id,
+                                          &slot->frame[ATECC_RPC_HEADER_SIZE], length, slot->frame);
+    slot->sent = 0;
+    server->replies[server->reply_head++ % ATECC_RPC_MAX_IN_FLIGHT] = slot;
+}
+
+// Executor callback, on the polling core
+static void request_done(atecc_request_t *request, void *user_data) {
+    atecc_rpc_slot_t *slot = user_data;
+
+    if (request->status == ATECC_REQUEST_DONE) {
+        reply(slot, ATECC_RPC_OK, request->output_length);
+    } else {
+        reply(slot, ATECC_RPC_ERR_FAILED, 0);
+    }
+}
+
+/**
+ * @brief Turns a request frame into a service request and queues it.
+ *
+ * Outputs go straight into the payload area of the slot's response frame.
+ *
+ * @param server The server.
+ * @param slot   A free slot.
+ * @param frame  The request.
+ */
+static void dispatch(atecc_rpc_server_t *server, atecc_rpc_slot_t *slot, const atecc_rpc_frame_t *frame) {
+    atecc_request_t *request = &slot->request;
+    uint8_t *output = &slot->frame[ATECC_RPC_HEADER_SIZE];
+    size_t length = frame->length;
+
+    slot->busy = true;
+    slot->opcode = frame->opcode;
+    slot->param = frame->param;
+    slot->id = frame->id;
+    server->busy++;
+    server->requests++;
+
+    *request = (atecc_request_t){
+        .key_slot = frame->param,
+        .input = slot->input,
+        .input_length = length,
+        .output = output,
+        .output_length = length,
+        .callback = request_done,
+        .user_data = slot,
+    };
+    memcpy(slot->input, frame->payload, length);
+
+    switch (frame->opcode) {
+        case ATECC_RPC_PING:
+            memcpy(output, frame->payload, length);
+            reply(slot, ATECC_RPC_OK, length);
+            return;
+        case ATECC_RPC_RANDOM:
+            request->type = ATECC_REQUEST_RANDOM;
+            request->output_length = length == 2 ? (size_t)(frame->payload[0] | (frame->payload[1] << 8)) : 0;
+            if (request->output_length == 0 || request->output_length > ATECC_RPC_MAX_PAYLOAD) {
+                reply(slot, ATECC_RPC_ERR_LENGTH, 0);
+                return;
+            }
+            break;
+        case ATECC_RPC_SHA256:
+            request->type = ATECC_REQUEST_SHA256;
+            request->output_length = SHA256_DIGEST_SIZE;
+            break;
+        case ATECC_RPC_AES_ENCRYPT:
+        case ATECC_RPC_AES_DECRYPT:
+            request->type = frame->opcode == ATECC_RPC_AES_ENCRYPT ? ATECC_REQUEST_AES_ENCRYPT
+                                                                   : ATECC_REQUEST_AES_DECRYPT;
+            if (length == 0 || length % 16 != 0) {
+                reply(slot, ATECC_RPC_ERR_LENGTH, 0);
+                return;
+            }
+            break;
+        case ATECC_RPC_SIGN:
+            request->type = ATECC_REQUEST_SIGN;
+            request->output_length = ECC_P256_SIG_SIZE;
+            if (length != ECC_DIGEST_SIZE) {
+                reply(slot, ATECC_RPC_ERR_LENGTH, 0);
+                return;
+            }
+            break;
+        default:
+            reply(slot, ATECC_RPC_ERR_OPCODE, 0);
+            return;
+    }
+
+    if (!server->executor.submit(request)) {
+        reply(slot, ATECC_RPC_ERR_BUSY, 0);
+    }
+}
+
+// Writes queued responses in order; a slot is free once its frame is out
+static bool flush(atecc_rpc_server_t *server) {
+    bool progress = false;
+
+    while (server->reply_tail != server->reply_head) {
+        atecc_rpc_slot_t *slot = server->replies[server->reply_tail % ATECC_RPC_MAX_IN_FLIGHT];
+        size_t written = server->transport.write(&slot->frame[slot->sent], slot->frame_length - slot->sent,
+                                                 server->transport.context);
+        slot->sent += written;
+        progress |= written > 0;
+        if (slot->sent < slot->frame_length) {
+            break;
+        }
+        slot->busy = false;
+        server->busy--;
+        server->reply_tail++;
+    }
+    return progress;
+}
+
+// Parses and dispatches requests while a slot is free
+static bool receive(atecc_rpc_server_t *server) {
+    bool progress = false;
+
+    while (server->busy < ATECC_RPC_MAX_IN_FLIGHT) {
+        // The parser may complete a frame it buffered without new bytes, so it runs
+        // before the transport is read
+        bool complete;
+        server->rx_offset += atecc_rpc_parse(&server->parser, &server->rx[server->rx_offset],
+                                             server->rx_length - server->rx_offset, &server->frame, &complete);
+        if (complete) {
+            atecc_rpc_slot_t *slot = server->slots;
+            while (slot->busy) {
+                slot++;
+            }
+            dispatch(server, slot, &server->frame);
+            progress = true;
+            continue;
+        }
+
+        // Everything read so far is consumed
+        server->rx_offset = 0;
+        server->rx_length = server->transport.read(server->rx, sizeof(server->rx), server->transport.context);
+        if (server->rx_length == 0) {
+            break;
+        }
+        progress = true;
+    }
+    return progress;
+}
+
+/**
+ * @brief Starts serving RPC requests.
+ *
+ * @param[out] server    The server state.
+ * @param[in]  transport The byte stream to the host.
+ * @param[in]  executor  Runs the requests.
+ */
+void atecc_rpc_server_init(atecc_rpc_server_t *server, const atecc_rpc_transport_t *transport,
+                           const atecc_rpc_executor_t *executor) {
+    memset(server, 0, sizeof(*server));
+    server->transport = *transport;
+    server->executor = *executor;
+    atecc_rpc_parser_init(&server->parser);
+    for (size_t i = 0; i < ATECC_RPC_MAX_IN_FLIGHT; i++) {
+        server->slots[i].server = server;
+    }
+}
+
+/**
+ * @brief Moves the server along without blocking.
+ *
+ * Collects finished requests, writes their responses and reads new requests while
+ * slots are free. Call it in a loop; between calls that report no progress the
+ * caller may sleep until the transport or the executor has something.
+ *
+ * @param[in,out] server The server.
+ * @return true if anything was read, written or completed.
+ */
+bool atecc_rpc_server_poll(atecc_rpc_server_t *server) {
+    bool progress = server->executor.poll() > 0;
+
+    progress |= flush(server);
+    progress |= receive(server);
+    progress |= flush(server);
+    return progress;
+}
@@ -0,0 +1,61 @@
+#ifndef ATECC_RPC_SERVER_H
+#define ATECC_RPC_SERVER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "atecc_rpc.h"
+#include "atecc_service.h"
+
+// Device end of the RPC protocol. Requests are parsed from the transport and handed
+// to an executor as they arrive, so the stream keeps flowing while the device works;
+// responses are written back as the executor completes them. When all
+// ATECC_RPC_MAX_IN_FLIGHT slots are taken the server stops reading, which leaves
+// flow control to the transport.
+
+// Where requests run: the core1 service on the Pico, or anything with its contract
+// (submit queues without waiting, poll runs the callbacks of finished requests)
+typedef struct {
+    bool (*submit)(atecc_request_t *request);
+    size_t (*poll)();
+} atecc_rpc_executor_t;
+
+typedef struct atecc_rpc_server atecc_rpc_server_t;
+
+// One request in flight; the response frame is built in place around the output
+typedef struct {
+    atecc_rpc_server_t *server;
+    bool busy;
+    uint8_t opcode;
+    uint8_t param;
+    uint16_t id;
+    atecc_request_t request;
+    uint8_t input[ATECC_RPC_MAX_PAYLOAD];
+    uint8_t frame[ATECC_RPC_MAX_FRAME];
+    size_t frame_length;
+    size_t sent;
+} atecc_rpc_slot_t;
+
+struct atecc_rpc_server {
+    atecc_rpc_transport_t transport;
+    atecc_rpc_executor_t executor;
+    atecc_rpc_parser_t parser;
+    atecc_rpc_frame_t frame;                            // The request being parsed
+    uint8_t rx[64];
+    size_t rx_length;
+    size_t rx_offset;
+    atecc_rpc_slot_t slots[ATECC_RPC_MAX_IN_FLIGHT];
+    uint32_t busy;
+    atecc_rpc_slot_t *replies[ATECC_RPC_MAX_IN_FLIGHT]; // Finished, in completion order
+    uint32_t reply_head;
+    uint32_t reply_tail;
+    uint32_t requests;
+    uint32_t errors;                                    // Responses with a status other than OK
+};
+
+void atecc_rpc_server_init(atecc_rpc_server_t *server, const atecc_rpc_transport_t *transport,
+                           const atecc_rpc_executor_t *executor);
+bool atecc_rpc_server_poll(atecc_rpc_server_t *server);
+
+#endif // ATECC_RPC_SERVER_H
@@ -0,0 +1,188 @@
+#include "atecc_service.h"
+#include "atecc_power.h"
+#include "atecc_random.h"
+#include "hal_pico_i2c.h"
+#include "hardware/sync.h"
+#include "pico/multicore.h"
+
+#if (ATECC_SERVICE_QUEUE_SIZE & (ATECC_SERVICE_QUEUE_SIZE - 1)) != 0
+#error "ATECC_SERVICE_QUEUE_SIZE must be a power of two"
+#endif
+
+// Single-producer single-consumer ring of request pointers. head is only written by
+// the producer and tail only by the consumer; the barriers order the slot accesses
+// against the index updates between the cores.
+typedef struct {
+    atecc_request_t *slots[ATECC_SERVICE_QUEUE_SIZE];
+    volatile uint32_t head;
+    volatile uint32_t tail;
+} request_ring_t;
+
+static request_ring_t submitted;    // core0 -> core1
+static request_ring_t completed;    // core1 -> core0
+
+// core0 bookkeeping; at most ATECC_SERVICE_QUEUE_SIZE requests are in flight, so
+// neither ring can overflow
+static struct {
+    volatile bool running;
+    uint32_t in_flight;
+} service;
+
+static bool ring_push(request_ring_t *ring, atecc_request_t *request) {
+    uint32_t head = ring->head;
+    if (head - ring->tail == ATECC_SERVICE_QUEUE_SIZE) {
+        return false;
+    }
+    ring->slots[head & (ATECC_SERVICE_QUEUE_SIZE - 1)] = request;
+    __dmb();
+    ring->head = head + 1;
+    __sev();
+    return true;
+}
+
+static atecc_request_t *ring_pop(request_ring_t *ring) {
+    uint32_t tail = ring->tail;
+    if (tail == ring->head) {
+        return NULL;
+    }
+    __dmb();
+    atecc_request_t *request = ring->slots[tail & (ATECC_SERVICE_QUEUE_SIZE - 1)];
+    __dmb();
+    ring->tail = tail + 1;
+    return request;
+}
+
+/**
+ * @brief core1 entry point: owns the I2C bus and the device.
+ *
+ * Everything queued while the service is busy runs in one power session, so a burst
+ * of requests costs a single wake. Between bursts the random pool is topped up and
+ * the power policy is applied.
+ */
+static void service_main() {
+    hal_i2c_irq_enable(true);
+
+    for (;;) {
+        atecc_request_t *request = ring_pop(&submitted);
+        if (request == NULL) {
+            random_pool_service();
+            atecc_power_poll();
+            best_effort_wfe_or_timeout(make_timeout_time_us(ATECC_SERVICE_IDLE_POLL_US));
+            continue;
+        }
+
+        bool session = atecc_session_begin();
+        do {
+            // core0 publishes the status once it has collected the request, so it
+            // never sees a final status for a request still in the ring
+            request->ok = session && atecc_request_run(request);
+            ring_push(&completed, request);
+        } while ((request = ring_pop(&submitted)) != NULL);
+
+        if (session) {
+            atecc_session_end();
+        }
+    }
+}
+
+/**
+ * @brief Hands the I2C bus and the ATECC608A over to core1.
+ *
+ * After this call core0 must use the library only through atecc_service_submit(),
+ * atecc_service_poll() and atecc_service_wait(); core1 is the only caller of
+ * everything else.
+ *
+ * @return true if the service was started, false if it was already running.
+ */
+bool atecc_service_start() {
+    if (service.running) {
+        return false;
+    }
+
+    // Transfer completions must interrupt the core that waits for them
+    hal_i2c_irq_enable(false);
+    service.running = true;
+    multicore_launch_core1(service_main);
+    return true;
+}
+
+/**
+ * @brief Reports whether core1 owns the device.
+ *
+ * @return true once atecc_service_start() has run.
+ */
+bool atecc_service_running() {
+    return service.running;
+}
+
+/**
+ * @brief Queues a request for core1 without waiting for it.
+ *
+ * Safe to call from core0 thread context and core0 interrupt handlers; interrupts
+ * are masked while queueing so both act as a single producer. The request and its
+ * buffers must stay valid until its status leaves ATECC_REQUEST_QUEUED.
+ *
+ * @param request The request to queue.
+ * @return true if queued, false if the service is not running or the queue is full.
+ */
+bool atecc_service_submit(atecc_request_t *request) {
+    if (!service.running) {
+        return false;
+    }
+
+    uint32_t saved = save_and_disable_interrupts();
+    bool queued = service.in_flight < ATECC_SERVICE_QUEUE_SIZE;
+    if (queued) {
+        request->status = ATECC_REQUEST_QUEUED;
+        service.in_flight++;
+        ring_push(&submitted, request);
+    }
+    restore_interrupts(saved);
+    return queued;
+}
+
+/**
+ * @brief Collects finished requests and runs their callbacks on core0.
+ *
+ * @return The number of requests collected.
+ */
+size_t atecc_service_poll() {
+    size_t count = 0;
+
+    for (;;) {
+        uint32_t saved = save_and_disable_interrupts();
+        atecc_request_t *request = ring_pop(&completed);
+        if (request != NULL) {
+            service.in_flight--;
+        }
+        restore_interrupts(saved);
+
+        if (request == NULL) {
+            return count;
+        }
+        request->status = request->ok ? ATECC_REQUEST_DONE : ATECC_REQUEST_FAILED;
+        count++;
+        if (request->callback) {
+            request->callback(request, request->user_data);
+        }
+    }
+}
+
+/**
+ * @brief Waits on core0 until a request has finished.
+ *
+ * Sleeps in WFE between completions and collects other finished requests on the way.
+ * Returns once the request itself has been collected, so it may be reused or freed.
+ *
+ * @param request A queued request.
+ * @return true if the request succeeded, false otherwise.
+ */
+bool atecc_service_wait(atecc_request_t *request) {
+    while (request->status == ATECC_REQUEST_QUEUED) {
+        if (atecc_service_poll() == 0 && request->status == ATECC_REQUEST_QUEUED) {
+            __wfe();
+        }
+    }
+    atecc_service_poll();
+    return request->status == ATECC_REQUEST_DONE;
+}
@@ -0,0 +1,62 @@
+#ifndef ATECC_SERVICE_H
+#define ATECC_SERVICE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Requests that can be queued at once, a power of two
+#ifndef ATECC_SERVICE_QUEUE_SIZE
+#define ATECC_SERVICE_QUEUE_SIZE    (8u)
+#endif
+
+// How often the idle service loop applies the power policy
+#define ATECC_SERVICE_IDLE_POLL_US  (5000u)
+
+// Operations the core1 service can run
+typedef enum {
+    ATECC_REQUEST_RANDOM,           // output_length random bytes
+    ATECC_REQUEST_SHA256,           // Digest of input into a 32-byte output
+    ATECC_REQUEST_AES_ENCRYPT,      // ECB over input, a multiple of 16 bytes, with key_slot
+    ATECC_REQUEST_AES_DECRYPT,
+    ATECC_REQUEST_READ_CONFIG,      // The 128-byte configuration zone
+    ATECC_REQUEST_SIGN,             // ECDSA over a 32-byte input digest with key_slot, 64-byte output
+} atecc_request_type_t;
+
+// Life cycle of a request
+typedef enum {
+    ATECC_REQUEST_IDLE,
+    ATECC_REQUEST_QUEUED,           // Owned by the service until collected; buffers must stay valid
+    ATECC_REQUEST_DONE,
+    ATECC_REQUEST_FAILED,
+} atecc_request_status_t;
+
+typedef struct atecc_request atecc_request_t;
+
+// Completion callback, called on core0 from atecc_service_poll()
+typedef void (*atecc_request_callback_t)(atecc_request_t *request, void *user_data);
+
+// One queued operation, owned by the caller
+struct atecc_request {
+    atecc_request_type_t type;
+    uint8_t key_slot;
+    const uint8_t *input;
+    size_t input_length;
+    uint8_t *output;
+    size_t output_length;
+    atecc_request_callback_t callback;
+    void *user_data;
+    volatile atecc_request_status_t status;
+    bool ok;                        // Outcome on core1, published as status when collected
+};
+
+bool atecc_service_start();
+bool atecc_service_running();
+bool atecc_service_submit(atecc_request_t *request);
+size_t atecc_service_poll();
+bool atecc_service_wait(atecc_request_t *request);
+
+// Runs a request in place, on whichever core owns the device
+bool atecc_request_run(atecc_request_t *request);
+
+#endif // ATECC_SERVICE_H
@@ -0,0 +1,492 @@
+#include "atecc_sha.h"
+#include "atecc_cmd.h"
+#include "atecc_device.h"
+#include "atecc_exec.h"
+#include "atecc_log.h"
+#include "atecc_power.h"
+#include "atecc_response.h"
+#include "hal_pico_i2c.h"
+
+/**
+ * @brief Sends one SHA command and reads its response.
+ *
+ * Only Start is replayed after a lost response; running Update or End twice would
+ * change the digest, so those fail instead.
+ *
+ * @param mode            The SHA mode (ATCA_SHA_MODE_*).
+ * @param fragments       The message bytes for this command, in order.
+ * @param count           The number of fragments.
+ * @param response        The buffer to store the raw response.
+ * @param response_length The expected response length (4 for status, 35 for a digest).
+ * @return true if the command succeeded, false otherwise.
+ */
+static bool sha_command(uint8_t mode, const atecc_fragment_t *fragments, size_t count,
+                        uint8_t *response, size_t response_length) {
+    size_t length = atecc_packet_payload_length(fragments, count);
+    uint8_t flags = mode == ATCA_SHA_MODE_START ? ATECC_EXEC_REPLAYABLE : 0;
+    return atecc_execute_sg(ATCA_SHA, mode, (uint16_t)(mode == ATCA_SHA_MODE_END ? length : 0), fragments, count,
+                            response, response_length, flags) == ATECC_OK;
+}
+
+/**
+ * @brief Sends one full 64-byte block as a SHA Update command.
+ *
+ * The block may be split over two fragments, a buffered head and the rest taken
+ * directly from the caller's message.
+ *
+ * @param head        The first bytes of the block.
+ * @param head_length The number of bytes in head.
+ * @param tail        The remaining SHA256_BLOCK_SIZE - head_length bytes.
+ * @return true on success, false otherwise.
+ */
+static bool sha_update_block(const uint8_t *head, size_t head_length, const uint8_t *tail) {
+    uint8_t status[4];
+    const atecc_fragment_t block[] = {
+        { head, head_length },
+        { tail, SHA256_BLOCK_SIZE - head_length },
+    };
+    if (!sha_command(ATCA_SHA_MODE_UPDATE, block, 2, status, sizeof(status))) {
+        ATECC_LOG(SHA_UPDATE_FAILED, ATCA_SHA, 0, 0, 0);
+        return false;
+    }
+    return true;
+}
+
+// Closes the power session of a device computation, once whichever way it ends
+static void atecc_sha256_release(sha256_ctx_t *ctx) {
+    if (ctx->atecc.session) {
+        ctx->atecc.session = false;
+        atecc_session_end();
+    }
+}
+
+/**
+ * @brief Starts a SHA-256 computation on the ATECC608A.
+ *
+ * Opens a power session that stays open until atecc_sha256_final(), since the device
+ * loses its SHA context if it is put to sleep.
+ *
+ * @param ctx The SHA-256 state to initialize.
+ * @return true if the device SHA context was started, false otherwise.
+ */
+static bool atecc_sha256_init(sha256_ctx_t *ctx) {
+    uint8_t status[4];
+
+    ctx->atecc.block_length = 0;
+    ctx->atecc.session = atecc_session_begin();
+    if (!ctx->atecc.session) {
+        return false;
+    }
+
+    if (!sha_command(ATCA_SHA_MODE_START, NULL, 0, status, sizeof(status))) {
+        ATECC_LOG(SHA_START_FAILED, ATCA_SHA, 0, 0, 0);
+        atecc_sha256_release(ctx);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Adds message bytes to a SHA-256 computation.
+ *
+ * Full 64-byte blocks are sent to the device as soon as they are available, directly
+ * from the caller's buffer; only a trailing partial block is buffered.
+ * On failure the session is closed and the context must be restarted; further
+ * updates and the final fail without touching the device.
+ *
+ * @param ctx    The SHA-256 state.
+ * @param data   The message bytes.
+ * @param length The number of message bytes.
+ * @return true on success, false otherwise.
+ */
+static bool atecc_sha256_update(sha256_ctx_t *ctx, const uint8_t *data, size_t length) {
+    if (!ctx->atecc.session) {
+        return false;
+    }
+
+    // Complete a buffered partial block first, sending its head and the new bytes as
+    // two fragments rather than joining them
+    if (ctx->atecc.block_length > 0) {
+        size_t chunk = SHA256_BLOCK_SIZE - ctx->atecc.block_length;
+        if (chunk > length) {
+            memcpy(&ctx->atecc.block[ctx->atecc.block_length], data, length);
+            ctx->atecc.block_length += length;
+            return true;
+        }
+
+        size_t head_length = ctx->atecc.block_length;
+        ctx->atecc.block_length = 0;
+        if (!sha_update_block(ctx->atecc.block, head_length, data)) {
+            atecc_sha256_release(ctx);
+            return false;
+        }
+        data += chunk;
+        length -= chunk;
+    }
+
+    // Whole blocks go straight from the caller's buffer
+    while (length >= SHA256_BLOCK_SIZE) {
+        if (!sha_update_block(NULL, 0, data)) {
+            atecc_sha256_release(ctx);
+            return false;
+        }
+        data += SHA256_BLOCK_SIZE;
+        length -= SHA256_BLOCK_SIZE;
+    }
+
+    memcpy(ctx->atecc.block, data, length);
+    ctx->atecc.block_length = length;
+    return true;
+}
+
+/**
+ * @brief Finishes a SHA-256 computation and returns the digest.
+ *
+ * Sends the buffered bytes with SHA End, validates the response CRC and closes the
+ * power session opened by atecc_sha256_init().
+ *
+ * @param ctx    The SHA-256 state.
+ * @param digest The buffer to store the SHA256_DIGEST_SIZE digest bytes.
+ * @return true if the digest was computed, false otherwise.
+ */
+static bool atecc_sha256_final(sha256_ctx_t *ctx, uint8_t *digest) {
+    uint8_t response[SHA256_DIGEST_SIZE + 3];
+
+    if (!ctx->atecc.session) {
+        return false;
+    }
+
+    atecc_fragment_t tail = { ctx->atecc.block, ctx->atecc.block_length };
+    bool ok = sha_command(ATCA_SHA_MODE_END, &tail, 1, response, sizeof(response));
+    atecc_sha256_release(ctx);
+
+    if (!ok) {
+        ATECC_LOG(SHA_DIGEST_FAILED, ATCA_SHA, 0, 0, 0);
+        return false;
+    }
+
+    memcpy(digest, &response[1], SHA256_DIGEST_SIZE);
+    ctx->atecc.block_length = 0;
+    return true;
+}
+
+// Assumed message size when the caller gives no size hint
+#define SHA256_DEFAULT_SIZE_HINT    (1024u)
+// Calibration message sizes: 1 and 16 padded blocks
+#define SHA256_CALIBRATION_SHORT    (55u)
+#define SHA256_CALIBRATION_LONG     (55u + 15u * SHA256_BLOCK_SIZE)
+#define SHA256_CALIBRATION_REPS     (8u)
+
+// Engine costs; estimates for a 100 kHz bus until sha256_calibrate() has run
+static sha256_calibration_t calibration = {
+    .calibrated = false,
+    .engine = {
+        [SHA256_ENGINE_ATECC] = { .fixed_us = 3000u, .per_block_us = 7000u },
+        [SHA256_ENGINE_HW]    = { .fixed_us = 10u,   .per_block_us = 2u },
+#if PICO_RP2350
+        [SHA256_ENGINE_SW]    = { .fixed_us = 5u,    .per_block_us = 25u },
+#else
+        [SHA256_ENGINE_SW]    = { .fixed_us = 5u,    .per_block_us = 100u },
+#endif
+    },
+    .nonce_us = 4500u,
+};
+
+// Whether an engine exists on this build
+static inline bool engine_available(sha256_engine_t engine) {
+#if LIB_PICO_SHA256
+    return engine < SHA256_ENGINE_COUNT;
+#else
+    return engine != SHA256_ENGINE_HW && engine < SHA256_ENGINE_COUNT;
+#endif
+}
+
+// Estimated time to hash size bytes on an engine
+static uint64_t engine_cost(sha256_engine_t engine, size_t size) {
+    uint64_t blocks = ((uint64_t)size + 9u + SHA256_BLOCK_SIZE - 1u) / SHA256_BLOCK_SIZE;
+    const sha256_engine_cost_t *cost = &calibration.engine[engine];
+    return cost->fixed_us + blocks * cost->per_block_us;
+}
+
+/**
+ * @brief Picks the fastest SHA-256 engine for a message.
+ *
+ * When the digest must end up in TempKey, hashing on the device is weighed against
+ * hashing on the MCU and loading the digest with a pass-through Nonce.
+ *
+ * @param size_hint     The expected message length, or SHA256_SIZE_UNKNOWN.
+ * @param flags         SHA256_FLAG_* options.
+ * @param bind_tempkey  Set to true if the chosen MCU engine must load its digest into TempKey.
+ * @return The engine to use.
+ */
+sha256_engine_t sha256_select_engine(size_t size_hint, uint32_t flags, bool *bind_tempkey) {
+    size_t size = size_hint == SHA256_SIZE_UNKNOWN ? SHA256_DEFAULT_SIZE_HINT : size_hint;
+    sha256_engine_t best_mcu = SHA256_ENGINE_SW;
+
+    if (engine_available(SHA256_ENGINE_HW) &&
+        engine_cost(SHA256_ENGINE_HW, size) < engine_cost(SHA256_ENGINE_SW, size)) {
+        best_mcu = SHA256_ENGINE_HW;
+    }
+
+    uint64_t mcu_cost = engine_cost(best_mcu, size);
+    uint64_t atecc_cost = engine_cost(SHA256_ENGINE_ATECC, size);
+    bool bind = (flags & SHA256_FLAG_TEMPKEY) != 0;
+    if (bind) {
+        mcu_cost += calibration.nonce_us;
+    }
+
+    *bind_tempkey = false;
+    if (atecc_cost <= mcu_cost) {
+        return SHA256_ENGINE_ATECC;
+    }
+    *bind_tempkey = bind;
+    return best_mcu;
+}
+
+/**
+ * @brief Starts a SHA-256 computation on a given engine.
+ *
+ * Bypasses the dispatcher, e.g. to benchmark or test one engine. Falls back to
+ * software if the hardware accelerator is in use elsewhere.
+ *
+ * @param ctx          The SHA-256 state to initialize.
+ * @param engine       The engine to use.
+ * @param bind_tempkey true to load the digest into TempKey at final (MCU engines only).
+ * @return true if the computation was started, false otherwise.
+ */
+bool sha256_start(sha256_ctx_t *ctx, sha256_engine_t engine, bool bind_tempkey) {
+    ctx->engine = engine;
+    ctx->bind_tempkey = bind_tempkey;
+    ctx->device = atecc_device_current();
+
+    switch (engine) {
+        case SHA256_ENGINE_ATECC:
+            return atecc_sha256_init(ctx);
+#if LIB_PICO_SHA256
+        case SHA256_ENGINE_HW:
+            if (pico_sha256_try_start(&ctx->hw, SHA256_BIG_ENDIAN, false) == PICO_OK) {
+                return true;
+            }
+            ctx->engine = SHA256_ENGINE_SW;
+            // fall through
+#endif
+        default:
+            ctx->engine = SHA256_ENGINE_SW;
+            sw_sha256_init(&ctx->sw);
+            return true;
+    }
+}
+
+/**
+ * @brief Starts a SHA-256 computation on the engine best suited to the message.
+ *
+ * @param ctx       The SHA-256 state to initialize.
+ * @param size_hint The expected message length, or SHA256_SIZE_UNKNOWN.
+ * @param flags     SHA256_FLAG_* options.
+ * @return true if the computation was started, false otherwise.
+ */
+bool sha256_init_ex(sha256_ctx_t *ctx, size_t size_hint, uint32_t flags) {
+    bool bind_tempkey;
+    sha256_engine_t engine = sha256_select_engine(size_hint, flags, &bind_tempkey);
+    return sha256_start(ctx, engine, bind_tempkey);
+}
+
+/**
+ * @brief Starts a SHA-256 computation of unknown length.
+ *
+ * @param ctx The SHA-256 state to initialize.
+ * @return true if the computation was started, false otherwise.
+ */
+bool sha256_init(sha256_ctx_t *ctx) {
+    return sha256_init_ex(ctx, SHA256_SIZE_UNKNOWN, 0);
+}
+
+/**
+ * @brief Adds message bytes to a SHA-256 computation.
+ *
+ * @param ctx    The SHA-256 state.
+ * @param data   The message bytes.
+ * @param length The number of message bytes.
+ * @return true on success, false otherwise.
+ */
+bool sha256_update(sha256_ctx_t *ctx, const uint8_t *data, size_t length) {
+    switch (ctx->engine) {
+        case SHA256_ENGINE_ATECC: {
+            atecc_device_t *previous = atecc_device_select(ctx->device);
+            bool ok = atecc_sha256_update(ctx, data, length);
+            atecc_device_select(previous);
+            return ok;
+        }
+#if LIB_PICO_SHA256
+        case SHA256_ENGINE_HW:
+            pico_sha256_update_blocking(&ctx->hw, data, length);
+            return true;
+#endif
+        default:
+            sw_sha256_update(&ctx->sw, data, length);
+            return true;
+    }
+}
+
+/**
+ * @brief Finishes a SHA-256 computation and returns the digest.
+ *
+ * If the computation ran on the MCU but the digest must be bound to device state,
+ * it is loaded into TempKey with a pass-through Nonce.
+ *
+ * @param ctx    The SHA-256 state.
+ * @param digest The buffer to store the SHA256_DIGEST_SIZE digest bytes.
+ * @return true if the digest was computed, false otherwise.
+ */
+bool sha256_final(sha256_ctx_t *ctx, uint8_t *digest) {
+    atecc_device_t *previous = atecc_device_select(ctx->device);
+    bool ok = true;
+
+    switch (ctx->engine) {
+        case SHA256_ENGINE_ATECC:
+            ok = atecc_sha256_final(ctx, digest);
+            break;
+#if LIB_PICO_SHA256
+        case SHA256_ENGINE_HW: {
+            sha256_result_t result;
+            pico_sha256_finish(&ctx->hw, &result);
+            memcpy(digest, result.bytes, SHA256_DIGEST_SIZE);
+            break;
+        }
+#endif
+        default:
+            sw_sha256_final(&ctx->sw, digest);
+            break;
+    }
+
+    if (ok && ctx->bind_tempkey) {
+        ok = nonce_load_tempkey(digest);
+    }
+    atecc_device_select(previous);
+    return ok;
+}
+
+/**
+ * @brief Abandons a SHA-256 computation without a digest.
+ *
+ * Closes the power session of a device computation unless a failed update already
+ * did, and releases the hardware accelerator claimed at start; harmless after
+ * sha256_final() and on the software engine.
+ *
+ * @param ctx The SHA-256 state.
+ */
+void sha256_abort(sha256_ctx_t *ctx) {
+    switch (ctx->engine) {
+        case SHA256_ENGINE_ATECC: {
+            atecc_device_t *previous = atecc_device_select(ctx->device);
+            atecc_sha256_release(ctx);
+            atecc_device_select(previous);
+            break;
+        }
+#if LIB_PICO_SHA256
+        case SHA256_ENGINE_HW:
+            pico_sha256_cleanup(&ctx->hw);
+            break;
+#endif
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Hashes a complete buffer on the engine best suited to its size.
+ *
+ * @param data   The message.
+ * @param length The message length in bytes.
+ * @param flags  SHA256_FLAG_* options.
+ * @param digest The buffer to store the SHA256_DIGEST_SIZE digest bytes.
+ * @return true if the digest was computed, false otherwise.
+ */
+bool sha256_digest(const uint8_t *data, size_t length, uint32_t flags, uint8_t *digest) {
+    sha256_ctx_t ctx;
+    return sha256_init_ex(&ctx, length, flags) &&
+           sha256_update(&ctx, data, length) &&
+           sha256_final(&ctx, digest);
+}
+
+// Time hashing length bytes on one engine, averaged over reps runs
+static bool time_engine(sha256_engine_t engine, const uint8_t *data, size_t length, uint32_t reps, uint32_t *elapsed_us) {
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    sha256_ctx_t ctx;
+
+    uint64_t start = time_us_64();
+    for (uint32_t i = 0; i < reps; i++) {
+        if (!sha256_start(&ctx, engine, false)) {
+            return false;
+        }
+        if (ctx.engine != engine || !sha256_update(&ctx, data, length) || !sha256_final(&ctx, digest)) {
+            sha256_abort(&ctx);
+            return false;
+        }
+    }
+    *elapsed_us = (uint32_t)((time_us_64() - start) / reps);
+    return true;
+}
+
+/**
+ * @brief Measures every available engine and updates the cost model.
+ *
+ * Hashes a 1-block and a 16-block message on each engine and times a pass-through
+ * Nonce; the engine selection thresholds follow from the fitted costs. Takes a few
+ * hundred milliseconds, dominated by the device engine on a 100 kHz bus.
+ *
+ * @return true if all measurements succeeded, false otherwise (estimates are kept).
+ */
+bool sha256_calibrate() {
+    static uint8_t message[SHA256_CALIBRATION_LONG];
+    sha256_calibration_t result = calibration;
+
+    for (size_t i = 0; i < sizeof(message); i++) {
+        message[i] = (uint8_t)(i * 13u + 1u);
+    }
+
+    if (!atecc_session_begin()) {
+        return false;
+    }
+
+    bool ok = true;
+    for (int engine = 0; ok && engine < SHA256_ENGINE_COUNT; engine++) {
+        if (!engine_available((sha256_engine_t)engine)) {
+            continue;
+        }
+
+        uint32_t reps = engine == SHA256_ENGINE_ATECC ? 1u : SHA256_CALIBRATION_REPS;
+        uint32_t short_us, long_us;
+        ok = time_engine((sha256_engine_t)engine, message, SHA256_CALIBRATION_SHORT, reps, &short_us) &&
+             time_engine((sha256_engine_t)engine, message, SHA256_CALIBRATION_LONG, reps, &long_us);
+        if (ok) {
+            uint32_t per_block = long_us > short_us ? (long_us - short_us) / 15u : 0u;
+            result.engine[engine].per_block_us = per_block;
+            result.engine[engine].fixed_us = short_us > per_block ? short_us - per_block : 0u;
+        }
+    }
+
+    if (ok) {
+        uint8_t digest[SHA256_DIGEST_SIZE] = {0};
+        uint64_t start = time_us_64();
+        ok = nonce_load_tempkey(digest);
+        result.nonce_us = (uint32_t)(time_us_64() - start);
+    }
+
+    atecc_session_end();
+
+    if (ok) {
+        result.calibrated = true;
+        calibration = result;
+    }
+    return ok;
+}
+
+/**
+ * @brief Returns the cost model used by the engine selection.
+ *
+ * @return Pointer to the current calibration.
+ */
+const sha256_calibration_t *sha256_get_calibration() {
+    return &calibration;
+}
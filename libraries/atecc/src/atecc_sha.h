@@ -0,0 +1,82 @@
+#ifndef ATECC_SHA_H
+#define ATECC_SHA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sw_sha256.h"
+
+#if LIB_PICO_SHA256
+#include "pico/sha256.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SHA256_BLOCK_SIZE       (64u)           // SHA-256 message block size
+#define SHA256_DIGEST_SIZE      (32u)           // SHA-256 digest size
+#define ATCA_SHA_MODE_START     ((uint8_t)0x00) // SHA mode: initialize context
+#define ATCA_SHA_MODE_UPDATE    ((uint8_t)0x01) // SHA mode: add one 64-byte block
+#define ATCA_SHA_MODE_END       ((uint8_t)0x02) // SHA mode: add final 0-63 bytes, return digest
+
+#define SHA256_SIZE_UNKNOWN     SIZE_MAX        // Size hint when the message length is not known
+#define SHA256_FLAG_TEMPKEY     (1u << 0)       // The digest must also end up in device TempKey
+
+// Engines the SHA-256 dispatcher can choose from
+typedef enum {
+    SHA256_ENGINE_ATECC,    // SHA command on the ATECC608A
+    SHA256_ENGINE_HW,       // RP2350 SHA-256 accelerator
+    SHA256_ENGINE_SW,       // Software on the MCU
+    SHA256_ENGINE_COUNT,
+} sha256_engine_t;
+
+// Cost model of one engine: fixed_us + per_block_us per 64-byte block
+typedef struct {
+    uint32_t fixed_us;
+    uint32_t per_block_us;
+} sha256_engine_cost_t;
+
+// Calibration results used to pick an engine
+typedef struct {
+    bool calibrated;
+    sha256_engine_cost_t engine[SHA256_ENGINE_COUNT];
+    uint32_t nonce_us;      // Cost of loading an MCU digest into TempKey
+} sha256_calibration_t;
+
+// Streaming SHA-256 state
+typedef struct {
+    sha256_engine_t engine;
+    bool bind_tempkey;      // Load the MCU-computed digest into TempKey at final
+    struct atecc_device *device;    // Device selected when the computation started
+    union {
+        struct {
+            uint8_t  block[SHA256_BLOCK_SIZE];
+            size_t   block_length;
+            bool     session;       // Holding the power session opened at start
+        } atecc;
+        sw_sha256_ctx_t sw;
+#if LIB_PICO_SHA256
+        pico_sha256_state_t hw;
+#endif
+    };
+} sha256_ctx_t;
+
+bool sha256_init(sha256_ctx_t *ctx);
+bool sha256_init_ex(sha256_ctx_t *ctx, size_t size_hint, uint32_t flags);
+bool sha256_start(sha256_ctx_t *ctx, sha256_engine_t engine, bool bind_tempkey);
+bool sha256_update(sha256_ctx_t *ctx, const uint8_t *data, size_t length);
+bool sha256_final(sha256_ctx_t *ctx, uint8_t *digest);
+void sha256_abort(sha256_ctx_t *ctx);
+bool sha256_digest(const uint8_t *data, size_t length, uint32_t flags, uint8_t *digest);
+
+sha256_engine_t sha256_select_engine(size_t size_hint, uint32_t flags, bool *bind_tempkey);
+bool sha256_calibrate();
+const sha256_calibration_t *sha256_get_calibration();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ATECC_SHA_H
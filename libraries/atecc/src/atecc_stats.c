@@ -0,0 +1,255 @@
+#include "atecc_stats.h"
+
+#if ATECC_STATS
+
+#include <stdio.h>
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "atecc_cmd.h"
+
+// Counters are shared by all devices and updated without locking: an update racing
+// an interrupt-driven command on the other core may be lost, which a statistic can afford.
+static atecc_stats_t stats;
+
+// Index + 1 into stats.opcodes for each op-code seen, 0 if never seen
+static uint8_t opcode_slot[256];
+
+// Names for the dump; unknown op-codes are printed in hex
+static const struct {
+    uint8_t opcode;
+    const char *name;
+} opcode_names[] = {
+    { ATCA_AES,          "AES" },
+    { ATCA_CHECKMAC,     "CheckMac" },
+    { ATCA_COUNTER,      "Counter" },
+    { ATCA_DERIVE_KEY,   "DeriveKey" },
+    { ATCA_ECDH,         "ECDH" },
+    { ATCA_GENDIG,       "GenDig" },
+    { ATCA_GENKEY,       "GenKey" },
+    { ATCA_HMAC,         "HMAC" },
+    { ATCA_INFO,         "Info" },
+    { ATCA_KDF,          "KDF" },
+    { ATCA_LOCK,         "Lock" },
+    { ATCA_MAC,          "MAC" },
+    { ATCA_NONCE,        "Nonce" },
+    { ATCA_PRIVWRITE,    "PrivWrite" },
+    { ATCA_RANDOM,       "Random" },
+    { ATCA_READ,         "Read" },
+    { ATCA_SHA,          "SHA" },
+    { ATCA_SIGN,         "Sign" },
+    { ATCA_UPDATE_EXTRA, "UpdateExtra" },
+    { ATCA_VERIFY,       "Verify" },
+    { ATCA_WRITE,        "Write" },
+};
+
+// Entry for an op-code, claimed on first use; the last entry absorbs any overflow
+static atecc_opcode_stats_t *entry(uint8_t opcode) {
+    uint8_t slot = opcode_slot[opcode];
+    if (slot != 0) {
+        return &stats.opcodes[slot - 1];
+    }
+
+    if (stats.opcode_count < ATECC_STATS_MAX_OPCODES) {
+        atecc_opcode_stats_t *e = &stats.opcodes[stats.opcode_count++];
+        e->opcode = opcode;
+        opcode_slot[opcode] = (uint8_t)stats.opcode_count;
+        return e;
+    }
+    return &stats.opcodes[ATECC_STATS_MAX_OPCODES - 1];
+}
+
+// log2 bucket of a latency: 0 for under 1 µs, n for [2^(n-1), 2^n)
+static size_t hist_bucket(uint64_t us) {
+    if (us == 0) {
+        return 0;
+    }
+    if (us >= (1ull << (ATECC_STATS_HIST_BUCKETS - 2))) {
+        return ATECC_STATS_HIST_BUCKETS - 1;
+    }
+    return 32u - (size_t)__builtin_clz((uint32_t)us);
+}
+
+/**
+ * @brief Records a command packet that was written to the bus.
+ *
+ * Starts the per-command bus and wait accumulators.
+ *
+ * @param[in,out] cmd           In-flight state; submit_us set before sending.
+ * @param[in]     opcode        The command op-code.
+ * @param[in]     length        The packet length in bytes.
+ * @param[in]     exec_start_us When the packet finished sending.
+ */
+void atecc_stats_sent(atecc_stats_cmd_t *cmd, uint8_t opcode, size_t length, uint64_t exec_start_us) {
+    atecc_opcode_stats_t *e = entry(opcode);
+    e->calls++;
+    e->bytes_sent += length;
+    cmd->bus_us = (uint32_t)(exec_start_us - cmd->submit_us);
+    cmd->wait_us = 0;
+}
+
+/**
+ * @brief Records a command packet that could not be sent.
+ *
+ * @param[in] opcode The command op-code.
+ */
+void atecc_stats_send_failed(uint8_t opcode) {
+    atecc_opcode_stats_t *e = entry(opcode);
+    e->calls++;
+    e->failures++;
+}
+
+/**
+ * @brief Records the end of response polling.
+ *
+ * @param[in] cmd           In-flight state of the command.
+ * @param[in] opcode        The command op-code.
+ * @param[in] exec_start_us When the packet finished sending.
+ * @param[in] length        The response length in bytes.
+ * @param[in] ok            true if the response was read, false if the device never answered.
+ */
+void atecc_stats_done(const atecc_stats_cmd_t *cmd, uint8_t opcode, uint64_t exec_start_us, size_t length, bool ok) {
+    atecc_opcode_stats_t *e = entry(opcode);
+    uint64_t now = time_us_64();
+
+    e->bus_us += cmd->bus_us;
+    e->wait_us += cmd->wait_us;
+    if (!ok) {
+        e->failures++;
+        return;
+    }
+
+    e->bytes_received += length;
+    e->busy_us += cmd->poll_us - exec_start_us;
+    e->latency_hist[hist_bucket(now - cmd->submit_us)]++;
+}
+
+/**
+ * @brief Records a response rejected for its CRC.
+ *
+ * Counted as a failure too, since the response was read successfully before the check.
+ *
+ * @param[in] opcode The command op-code.
+ */
+void atecc_stats_crc_error(uint8_t opcode) {
+    atecc_opcode_stats_t *e = entry(opcode);
+    e->crc_errors++;
+    e->failures++;
+}
+
+/**
+ * @brief Records a command sent again after a transient failure.
+ *
+ * @param[in] opcode The command op-code.
+ */
+void atecc_stats_retry(uint8_t opcode) {
+    entry(opcode)->retries++;
+}
+
+/**
+ * @brief Records a wake sequence.
+ *
+ * @param[in] start_us When the wake token was sent.
+ * @param[in] ok       true if the device answered with the wake status.
+ */
+void atecc_stats_wake(uint64_t start_us, bool ok) {
+    stats.wakes++;
+    stats.wake_us += time_us_64() - start_us;
+    if (!ok) {
+        stats.wake_failures++;
+    }
+}
+
+/**
+ * @brief Records an idle or sleep command.
+ *
+ * @param[in] word_address ATCA_IDLE or ATCA_SLEEP.
+ */
+void atecc_stats_power_command(uint8_t word_address) {
+    if (word_address == ATCA_SLEEP) {
+        stats.sleeps++;
+    } else {
+        stats.idles++;
+    }
+}
+
+/**
+ * @brief Returns all counters.
+ *
+ * @return Pointer to the live counters; valid until the next atecc_stats_reset().
+ */
+const atecc_stats_t *atecc_stats_get() {
+    return &stats;
+}
+
+/**
+ * @brief Returns the counters of one op-code.
+ *
+ * @param[in] opcode The command op-code.
+ * @return Pointer to the live counters, or NULL if the op-code was never sent.
+ */
+const atecc_opcode_stats_t *atecc_stats_opcode(uint8_t opcode) {
+    uint8_t slot = opcode_slot[opcode];
+    return slot != 0 ? &stats.opcodes[slot - 1] : NULL;
+}
+
+/**
+ * @brief Clears all counters.
+ */
+void atecc_stats_reset() {
+    memset(&stats, 0, sizeof(stats));
+    memset(opcode_slot, 0, sizeof(opcode_slot));
+}
+
+static const char *opcode_name(uint8_t opcode) {
+    for (size_t i = 0; i < sizeof(opcode_names) / sizeof(opcode_names[0]); i++) {
+        if (opcode_names[i].opcode == opcode) {
+            return opcode_names[i].name;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Prints the counters, one line per op-code followed by its non-empty latency buckets.
+ *
+ * Times are totals in µs. Histogram buckets are printed as "<upper bound>:<count>".
+ */
+void atecc_stats_dump() {
+    printf("📊 ATECC stats: %lu wakes (%lu failed, %llu us), %lu idle, %lu sleep\n",
+           (unsigned long)stats.wakes, (unsigned long)stats.wake_failures,
+           (unsigned long long)stats.wake_us, (unsigned long)stats.idles, (unsigned long)stats.sleeps);
+    printf("   %-11s %7s %5s %4s %5s %9s %9s %10s %10s %10s\n",
+           "opcode", "calls", "fail", "crc", "retry", "tx", "rx", "bus_us", "wait_us", "busy_us");
+
+    for (size_t i = 0; i < stats.opcode_count; i++) {
+        const atecc_opcode_stats_t *e = &stats.opcodes[i];
+        const char *name = opcode_name(e->opcode);
+        char hex[8];
+        if (name == NULL) {
+            snprintf(hex, sizeof(hex), "0x%02X", e->opcode);
+            name = hex;
+        }
+
+        printf("   %-11s %7lu %5lu %4lu %5lu %9llu %9llu %10llu %10llu %10llu\n", name,
+               (unsigned long)e->calls, (unsigned long)e->failures, (unsigned long)e->crc_errors,
+               (unsigned long)e->retries,
+               (unsigned long long)e->bytes_sent, (unsigned long long)e->bytes_received,
+               (unsigned long long)e->bus_us, (unsigned long long)e->wait_us, (unsigned long long)e->busy_us);
+
+        printf("     latency");
+        for (size_t b = 0; b < ATECC_STATS_HIST_BUCKETS; b++) {
+            if (e->latency_hist[b] == 0) {
+                continue;
+            }
+            if (b == ATECC_STATS_HIST_BUCKETS - 1) {
+                printf(" >=%lu:%lu", 1ul << (b - 1), (unsigned long)e->latency_hist[b]);
+            } else {
+                printf(" <%lu:%lu", 1ul << b, (unsigned long)e->latency_hist[b]);
+            }
+        }
+        printf("\n");
+    }
+}
+
+#endif // ATECC_STATS
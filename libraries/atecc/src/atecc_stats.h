@@ -0,0 +1,102 @@
+#ifndef ATECC_STATS_H
+#define ATECC_STATS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Per-opcode command statistics, enabled with ATECC_STATS=1. When disabled every
+// recording hook below expands to nothing.
+#ifndef ATECC_STATS
+#define ATECC_STATS                 0
+#endif
+
+#define ATECC_STATS_MAX_OPCODES     (24u)   // Distinct op-codes tracked; later ones share the last entry
+#define ATECC_STATS_HIST_BUCKETS    (20u)   // Bucket n counts latencies in [2^(n-1), 2^n) µs; the last is open-ended
+
+// Counters for one op-code
+typedef struct {
+    uint8_t  opcode;
+    uint32_t calls;                 // Command packets sent
+    uint32_t failures;              // Send failed, the device never answered, or the response CRC was bad
+    uint32_t crc_errors;            // Responses with a bad CRC
+    uint32_t retries;               // Attempts repeated by atecc_execute()
+    uint64_t bytes_sent;            // Command packet bytes, word address included
+    uint64_t bytes_received;        // Response bytes
+    uint64_t bus_us;                // Time in I2C transfers: the packet and every response read attempt
+    uint64_t wait_us;               // Time the host slept between response polls
+    uint64_t busy_us;               // Packet sent to the response read that succeeded: device execution, bounded above
+    uint32_t latency_hist[ATECC_STATS_HIST_BUCKETS];    // Start of send to end of response read
+} atecc_opcode_stats_t;
+
+// Counters for everything the library recorded
+typedef struct {
+    atecc_opcode_stats_t opcodes[ATECC_STATS_MAX_OPCODES];
+    size_t   opcode_count;
+    uint32_t wakes;
+    uint32_t wake_failures;
+    uint64_t wake_us;               // Time spent in wake sequences
+    uint32_t idles;
+    uint32_t sleeps;
+} atecc_stats_t;
+
+// In-flight state of one command, kept next to the command it measures
+typedef struct {
+    uint64_t submit_us;             // Sending the packet began
+    uint64_t poll_us;               // The latest response read began
+    uint32_t bus_us;
+    uint32_t wait_us;
+} atecc_stats_cmd_t;
+
+#if ATECC_STATS
+
+const atecc_stats_t *atecc_stats_get();
+const atecc_opcode_stats_t *atecc_stats_opcode(uint8_t opcode);
+void atecc_stats_reset();
+void atecc_stats_dump();
+
+// Recording, called through the macros below
+void atecc_stats_sent(atecc_stats_cmd_t *cmd, uint8_t opcode, size_t length, uint64_t exec_start_us);
+void atecc_stats_send_failed(uint8_t opcode);
+void atecc_stats_done(const atecc_stats_cmd_t *cmd, uint8_t opcode, uint64_t exec_start_us, size_t length, bool ok);
+void atecc_stats_crc_error(uint8_t opcode);
+void atecc_stats_retry(uint8_t opcode);
+void atecc_stats_wake(uint64_t start_us, bool ok);
+void atecc_stats_power_command(uint8_t word_address);
+
+#define ATECC_STATS_SUBMIT(cmd)                         ((cmd)->submit_us = time_us_64())
+#define ATECC_STATS_SENT(cmd, opcode, length, start)    atecc_stats_sent((cmd), (opcode), (length), (start))
+#define ATECC_STATS_SEND_FAILED(opcode)                 atecc_stats_send_failed(opcode)
+#define ATECC_STATS_POLL_BEGIN(cmd)                     ((cmd)->poll_us = time_us_64())
+#define ATECC_STATS_POLL_END(cmd)                       ((cmd)->bus_us += (uint32_t)(time_us_64() - (cmd)->poll_us))
+#define ATECC_STATS_WAIT(cmd, us)                       ((cmd)->wait_us += (uint32_t)(us))
+#define ATECC_STATS_DONE(cmd, opcode, start, length, ok) atecc_stats_done((cmd), (opcode), (start), (length), (ok))
+#define ATECC_STATS_CRC_ERROR(opcode)                   atecc_stats_crc_error(opcode)
+#define ATECC_STATS_RETRY(opcode)                       atecc_stats_retry(opcode)
+#define ATECC_STATS_WAKE_BEGIN(var)                     uint64_t var = time_us_64()
+#define ATECC_STATS_WAKE_END(var, ok)                   atecc_stats_wake((var), (ok))
+#define ATECC_STATS_POWER_COMMAND(word_address)         atecc_stats_power_command(word_address)
+
+#else
+
+static inline const atecc_stats_t *atecc_stats_get() { return NULL; }
+static inline const atecc_opcode_stats_t *atecc_stats_opcode(uint8_t opcode) { (void)opcode; return NULL; }
+static inline void atecc_stats_reset() {}
+static inline void atecc_stats_dump() {}
+
+#define ATECC_STATS_SUBMIT(cmd)                         ((void)0)
+#define ATECC_STATS_SENT(cmd, opcode, length, start)    ((void)0)
+#define ATECC_STATS_SEND_FAILED(opcode)                 ((void)0)
+#define ATECC_STATS_POLL_BEGIN(cmd)                     ((void)0)
+#define ATECC_STATS_POLL_END(cmd)                       ((void)0)
+#define ATECC_STATS_WAIT(cmd, us)                       ((void)0)
+#define ATECC_STATS_DONE(cmd, opcode, start, length, ok) ((void)0)
+#define ATECC_STATS_CRC_ERROR(opcode)                   ((void)0)
+#define ATECC_STATS_RETRY(opcode)                       ((void)0)
+#define ATECC_STATS_WAKE_BEGIN(var)                     ((void)0)
+#define ATECC_STATS_WAKE_END(var, ok)                   ((void)0)
+#define ATECC_STATS_POWER_COMMAND(word_address)         ((void)0)
+
+#endif // ATECC_STATS
+
+#endif // ATECC_STATS_H
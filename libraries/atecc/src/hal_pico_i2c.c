@@ -1,21 +1,229 @@
 #include "hal_pico_i2c.h"
 #include "hardware/i2c.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "atecc_bus.h"
 #include "atecc_cmd.h"
+#include "atecc_exec.h"
+#include "atecc_config.h"
+#include "atecc_device.h"
+#include "atecc_power.h"
+#include "atecc_response.h"
 
-/** @brief Send a command to an ATECC device.
+// The transfer engine moves bytes with two DMA channels and finishes in the I2C
+// interrupt on STOP, so the CPU is free while the bus is busy. One transfer and one
+// asynchronous command are in flight at a time.
+static struct {
+    bool initialized;
+    i2c_inst_t *bus;                // Bus of the transfer in progress
+    uint tx_channel;                // Feeds IC_DATA_CMD with data or read commands
+    uint rx_channel;                // Drains received bytes
+    volatile bool busy;
+    volatile bool aborted;          // NACK or arbitration loss
+    void (*complete)(bool ok);      // Called from the I2C interrupt
+    uint16_t commands[ATECC_I2C_MAX_TRANSFER];
+} transfer;
+
+// Asynchronous command currently owning the device
+static atecc_async_t *volatile active;
+
+// Timers one core's alarm pool can hold; only the poll alarm is ever pending
+#define ATECC_ALARM_POOL_TIMERS (2u)
+
+// Poll alarms go to the pool of the core that takes the transfer interrupt, so that
+// core's WFI wakes for them. NULL until hal_i2c_irq_enable() picks one: the default
+// pool, which runs on core0.
+static alarm_pool_t *alarm_pool;
+static alarm_pool_t *core_alarm_pools[NUM_CORES];
+
+// I2C interrupt: finish the transfer once the controller has issued STOP
+static void i2c_irq_handler() {
+    i2c_hw_t *hw = i2c_get_hw(transfer.bus);
+    uint32_t status = hw->intr_stat;
+
+    if (status & I2C_IC_INTR_STAT_R_TX_ABRT_BITS) {
+        dma_channel_abort(transfer.tx_channel);
+        dma_channel_abort(transfer.rx_channel);
+        transfer.aborted = true;
+        (void)hw->clr_tx_abrt;
+    }
+
+    if (status & I2C_IC_INTR_STAT_R_STOP_DET_BITS) {
+        (void)hw->clr_stop_det;
+        if (!transfer.aborted) {
+            // The last bytes may still be on their way out of the RX FIFO
+            dma_channel_wait_for_finish_blocking(transfer.rx_channel);
+        }
+        hw->intr_mask = 0;
+        transfer.busy = false;
+        if (transfer.complete) {
+            transfer.complete(!transfer.aborted);
+        }
+    }
+}
+
+// Claim the DMA channels and hook the interrupts of both I2C blocks on first use
+static void transfer_init() {
+    transfer.tx_channel = (uint)dma_claim_unused_channel(true);
+    transfer.rx_channel = (uint)dma_claim_unused_channel(true);
+
+    irq_set_exclusive_handler(I2C0_IRQ, i2c_irq_handler);
+    irq_set_exclusive_handler(I2C1_IRQ, i2c_irq_handler);
+    irq_set_enabled(I2C0_IRQ, true);
+    irq_set_enabled(I2C1_IRQ, true);
+    transfer.initialized = true;
+}
+
+/**
+ * @brief Enables or disables the I2C transfer interrupt on the calling core.
+ *
+ * Transfers complete in this interrupt, so it must be enabled on the core that
+ * issues them. Used to hand the bus over to another core. Enabling also moves the
+ * asynchronous poll alarms to this core, creating an alarm pool for it on first
+ * use if the default pool runs on the other core.
+ *
+ * @param[in] enabled true to take the interrupt on this core, false to release it.
+ */
+void hal_i2c_irq_enable(bool enabled) {
+    if (!transfer.initialized) {
+        transfer_init();
+    }
+    irq_set_enabled(I2C0_IRQ, enabled);
+    irq_set_enabled(I2C1_IRQ, enabled);
+
+    if (enabled) {
+        uint core = get_core_num();
+        if (core_alarm_pools[core] == NULL) {
+            alarm_pool_t *pool = alarm_pool_get_default();
+            if (alarm_pool_core_num(pool) != core) {
+                pool = alarm_pool_create_with_unused_hardware_alarm(ATECC_ALARM_POOL_TIMERS);
+            }
+            core_alarm_pools[core] = pool;
+        }
+        alarm_pool = core_alarm_pools[core];
+    }
+}
+
+/**
+ * @brief Starts a DMA-driven I2C transfer to an ATECC device.
+ *
+ * Returns as soon as the DMA channels are armed; complete is called from the I2C
+ * interrupt once the controller has issued STOP.
+ *
+ * @param[in]  device   The device to address.
+ * @param[in]  txdata   The bytes to write, or NULL to read.
+ * @param[out] rxdata   The buffer for a read, or NULL to write.
+ * @param[in]  length   The number of bytes to transfer.
+ * @param[in]  complete Completion callback, or NULL.
+ *
+ * @return true if the transfer was started, false if the bus is busy or length is out of range.
+ */
+static bool transfer_start(atecc_device_t *device, const uint8_t *txdata, uint8_t *rxdata, size_t length, void (*complete)(bool ok)) {
+    if (transfer.busy || length == 0 || length > ATECC_I2C_MAX_TRANSFER) {
+        return false;
+    }
+    if (!transfer.initialized) {
+        transfer_init();
+    }
+
+    for (size_t i = 0; i < length; i++) {
+        transfer.commands[i] = txdata ? txdata[i] : I2C_IC_DATA_CMD_CMD_BITS;
+    }
+    transfer.commands[length - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+
+    i2c_hw_t *hw = i2c_get_hw(device->bus);
+    hw->enable = 0;
+    hw->tar = device->address;
+    hw->dma_tdlr = 4;
+    hw->dma_rdlr = 0;
+    hw->dma_cr = I2C_IC_DMA_CR_TDMAE_BITS | I2C_IC_DMA_CR_RDMAE_BITS;
+    hw->enable = 1;
+
+    transfer.bus = device->bus;
+    transfer.busy = true;
+    transfer.aborted = false;
+    transfer.complete = complete;
+
+    if (rxdata) {
+        dma_channel_config rx = dma_channel_get_default_config(transfer.rx_channel);
+        channel_config_set_transfer_data_size(&rx, DMA_SIZE_8);
+        channel_config_set_read_increment(&rx, false);
+        channel_config_set_write_increment(&rx, true);
+        channel_config_set_dreq(&rx, i2c_get_dreq(device->bus, false));
+        dma_channel_configure(transfer.rx_channel, &rx, rxdata, &hw->data_cmd, length, true);
+    }
+
+    (void)hw->clr_intr;
+    hw->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+
+    dma_channel_config tx = dma_channel_get_default_config(transfer.tx_channel);
+    channel_config_set_transfer_data_size(&tx, DMA_SIZE_16);
+    channel_config_set_read_increment(&tx, true);
+    channel_config_set_write_increment(&tx, false);
+    channel_config_set_dreq(&tx, i2c_get_dreq(device->bus, true));
+    dma_channel_configure(transfer.tx_channel, &tx, &hw->data_cmd, transfer.commands, length, true);
+    return true;
+}
+
+// Busy conditions the blocking wrappers sleep on
+static bool transfer_busy(const void *arg) {
+    (void)arg;
+    return transfer.busy;
+}
+
+static bool command_busy(const void *arg) {
+    (void)arg;
+    return active != NULL;
+}
+
+static bool op_busy(const void *arg) {
+    return ((const atecc_async_t *)arg)->state == ATECC_ASYNC_BUSY;
+}
+
+// Sleep in WFI until busy(arg) turns false. Interrupts are masked while testing the
+// condition so a completion between the test and the WFI still wakes the core.
+static void sleep_while(bool (*busy)(const void *), const void *arg) {
+    for (;;) {
+        uint32_t saved = save_and_disable_interrupts();
+        bool waiting = busy(arg);
+        if (waiting) {
+            __wfi();
+        }
+        restore_interrupts(saved);
+        if (!waiting) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Sleeps until no asynchronous command owns the device.
+ */
+void hal_i2c_wait_idle() {
+    sleep_while(command_busy, NULL);
+}
+
+/**
+ * @brief Sends data over the I2C bus.
  *
- * The send_atecc_command function sends a command to an ATECC (Atmel CryptoAuthentication)
- * device, using the specified opcode, parameters, and data.
+ * Blocking wrapper around the DMA transfer engine. Waits for any asynchronous
+ * command to finish first, since the device cannot accept a new packet while it
+ * is executing one.
  *
- * @param[in]  opcode    The opcode of the command to send.
- * @param[in]  param1    The first parameter of the command.
- * @param[in]  param2    The second parameter of the command.
- * @param[in]  data      The data to send with the command.
+ * @param[in] txdata   The bytes to send.
+ * @param[in] txlength The number of bytes to send.
  *
- * @return true on success, false on failure.
+ * @return the number of bytes written, or PICO_ERROR_GENERIC on failure.
  */
 int hal_i2c_send(uint8_t *txdata, size_t txlength) {
-    return i2c_write_blocking(I2C_PORT, I2C_ADDR, txdata, txlength, false);
+    sleep_while(command_busy, NULL);
+    sleep_while(transfer_busy, NULL);
+    if (!transfer_start(atecc_device_current(), txdata, NULL, txlength, NULL)) {
+        return PICO_ERROR_GENERIC;
+    }
+    sleep_while(transfer_busy, NULL);
+    return transfer.aborted ? PICO_ERROR_GENERIC : (int)txlength;
 }
 
 /**
@@ -23,136 +231,221 @@ int hal_i2c_send(uint8_t *txdata, size_t txlength) {
  *
  * This function reads data from the I2C bus and stores it in the provided
  * rxdata buffer of length rxlength. If the read operation fails, the function
- * returns -1.
+ * returns -1. A busy device NACKs its address, so failures are expected while
+ * polling and are not reported here. Waits for any asynchronous command to finish
+ * first, so the read cannot take that command's response.
  *
- * @param[in]  bus      The I2C bus to read from.
  * @param[out] rxdata   Pointer to the buffer where received data will be stored.
  * @param[in]  rxlength The length of the data to be received.
  *
  * @return the number of bytes read, or -1 on failure.
  */
 int hal_i2c_receive(uint8_t *rxdata, size_t rxlength) {
-   int res = i2c_read_blocking(I2C_PORT, I2C_ADDR, rxdata, rxlength, false);
-   if (res != rxlength) {
-       printf("❌ ERROR: I2C read failed (expected %zu, got %d)\n", rxlength, res);
-       return -1;
-   }
+    sleep_while(command_busy, NULL);
+    sleep_while(transfer_busy, NULL);
+    if (!transfer_start(atecc_device_current(), NULL, rxdata, rxlength, NULL)) {
+        return -1;
+    }
+    sleep_while(transfer_busy, NULL);
+    return transfer.aborted ? -1 : (int)rxlength;
+}
+
+// Asynchronous command state machine. Each step runs in the I2C or timer interrupt:
+// packet sent -> alarm at the typical execution time -> read -> NACK re-arms the
+// alarm every ATECC_POLL_INTERVAL_US until the maximum execution time.
+static void async_read_done(bool ok);
 
-   return res;
+static void async_finish(atecc_async_state_t state) {
+    atecc_async_t *op = active;
+    active = NULL;
+    op->state = state;
+    if (op->callback) {
+        op->callback(op, op->user_data);
+    }
 }
 
-/**
- * @brief Sends a command to an ATECC device over the I2C bus on a Pico microcontroller.
- *
- * This function constructs the command with the given parameters, calculates the CRC16-CCITT checksum,
- * and sends the full command using the hal_i2c_send function.
- *
- * @param[in] device_address The I2C address of the ATECC device.
- * @param[in] command The command to send to the ATECC device.
- * @param[in] param1 The first parameter for the command.
- * @param[in] param2 The second parameter for the command.
- * @param[in] data The data to send with the command.
- * @param[in] data_length The length of the data to send.
- *
- * @return int Returns 0 on success, or a negative error code on failure.
- */
-// Send an ATECC command over I2C bus (Pico) 
-bool send_atecc_command(uint8_t opcode, uint8_t param1, uint16_t param2, const uint8_t *data, size_t data_len) {
-    uint8_t command[7 + data_len];
-    command[0] = 0x07 + data_len;
-    command[1] = opcode;
-    command[2] = param1;
-    command[3] = param2 & 0xFF;
-    command[4] = (param2 >> 8) & 0xFF;
+static void async_schedule_poll(uint32_t delay_us);
+
+static int64_t async_poll_alarm(alarm_id_t id, void *user_data) {
+    (void)id;
+    (void)user_data;
+    atecc_async_t *op = active;
+
+    ATECC_STATS_POLL_BEGIN(&op->stats);
+    if (!transfer_start(op->device, NULL, op->response, op->response_length, async_read_done)) {
+        // The bus is still carrying another transfer; try again on the next poll
+        if (time_us_64() - op->start_us < op->timing->max_us) {
+            async_schedule_poll(ATECC_POLL_INTERVAL_US);
+        } else {
+            ATECC_STATS_DONE(&op->stats, op->opcode, op->start_us, 0, false);
+            async_finish(ATECC_ASYNC_FAILED);
+        }
+    }
+    return 0;
+}
 
-    if (data_len > 0) {
-        memcpy(&command[5], data, data_len);
+static void async_schedule_poll(uint32_t delay_us) {
+    ATECC_STATS_WAIT(&active->stats, delay_us);
+    alarm_pool_t *pool = alarm_pool ? alarm_pool : alarm_pool_get_default();
+    if (alarm_pool_add_alarm_in_us(pool, delay_us, async_poll_alarm, NULL, true) < 0) {
+        ATECC_STATS_DONE(&active->stats, active->opcode, active->start_us, 0, false);
+        async_finish(ATECC_ASYNC_FAILED);
     }
+}
 
-    calc_crc16_ccitt(5 + data_len, command, &command[5 + data_len]);
+static void async_read_done(bool ok) {
+    atecc_async_t *op = active;
+    ATECC_STATS_POLL_END(&op->stats);
 
-    uint8_t full_command[8 + data_len];
-    full_command[0] = 0x03;
-    memcpy(&full_command[1], command, sizeof(command));
+    if (!ok) {
+        // Still busy; keep polling until the datasheet limit has passed
+        if (time_us_64() - op->start_us < op->timing->max_us) {
+            async_schedule_poll(ATECC_POLL_INTERVAL_US);
+        } else {
+            atecc_bus_note_timeout(op->device->bus);
+            ATECC_STATS_DONE(&op->stats, op->opcode, op->start_us, op->response_length, false);
+            async_finish(ATECC_ASYNC_FAILED);
+        }
+        return;
+    }
 
-    return hal_i2c_send((uint8_t*)&full_command, sizeof(full_command)) >= 0;
+    atecc_bus_note_response(op->device->bus, op->response, op->response_length);
+    ATECC_STATS_DONE(&op->stats, op->opcode, op->start_us, op->response_length, true);
+    // A status packet is checked over its own 4 bytes, so a device error is not
+    // taken for a bus CRC error
+    atecc_result_t result = atecc_response_decode(op->response, op->response_length);
+    if (result == ATECC_ERR_RESPONSE_CRC) {
+        atecc_bus_note_crc_error(op->device->bus);
+        ATECC_STATS_CRC_ERROR(op->opcode);
+    }
+    async_finish(result == ATECC_OK ? ATECC_ASYNC_DONE : ATECC_ASYNC_FAILED);
+}
+
+static void async_write_done(bool ok) {
+    if (!ok) {
+        atecc_bus_note_timeout(active->device->bus);
+        ATECC_STATS_SEND_FAILED(active->opcode);
+        async_finish(ATECC_ASYNC_FAILED);
+        return;
+    }
+
+    active->start_us = time_us_64();
+    ATECC_STATS_SENT(&active->stats, active->opcode, active->device->packet[1] + 1u, active->start_us);
+    async_schedule_poll(active->timing->typical_us);
 }
 
 /**
- * @brief Reads a response from the ATECC608A device via I2C into a provided buffer.
+ * @brief Submits a command without waiting for it to execute.
+ *
+ * Wakes the selected device if needed, starts sending the packet and returns. The response
+ * is read in the background once the device has finished; the CPU can sleep or do
+ * other work meanwhile. The device is kept awake until the command is retired with
+ * atecc_async_poll() or atecc_async_wait().
  *
- * This function reads a response from the ATECC608A device using the I2C protocol. 
- * It handles either a full response or a partial response based on the full_response flag.
+ * @param[out] op              Caller-owned command state, zero-initialised before first use;
+ *                             must stay valid until retired.
+ * @param[in]  opcode          The command op-code.
+ * @param[in]  param1          The first parameter.
+ * @param[in]  param2          The second parameter.
+ * @param[in]  data            The command data.
+ * @param[in]  data_len        The length of the data.
+ * @param[out] response        Buffer for the raw response, count byte and CRC included.
+ * @param[in]  response_length The expected response length.
+ * @param[in]  callback        Called from interrupt context on completion, or NULL.
+ * @param[in]  user_data       Passed to the callback.
  *
- * @param[out] buffer The buffer to store the response read from the device.
- * @param[in] buffer_size The size of the buffer.
- * @param[in] full_response A flag indicating whether to read a full response (true) or a partial response (false).
- * @return bool Returns true if the response was successfully read, otherwise false.
+ * @return true if the command was submitted, false if another command is in flight or the device did not wake.
  */
-bool receive_atecc_response(uint8_t *buffer, size_t length, bool full_response) {
-    uint8_t response[7];
-    size_t read_length = full_response ? 7 : length + 1;
-    
-    if (hal_i2c_receive(response, read_length) != (int)read_length) {
-        printf("❌ ERROR: Failed to read response from ATECC608A\n");
+bool atecc_command_async(atecc_async_t *op, uint8_t opcode, uint8_t param1, uint16_t param2,
+                         const uint8_t *data, size_t data_len, uint8_t *response, size_t response_length,
+                         atecc_async_callback_t callback, void *user_data) {
+    if (active != NULL || ATECC_PACKET_OVERHEAD + data_len > ATECC_I2C_MAX_TRANSFER ||
+        response_length < 4 || response_length > ATECC_I2C_MAX_TRANSFER) {
+        return false;
+    }
+
+    // A finished but unretired command still holds its power session
+    atecc_async_poll(op);
+
+    op->device = atecc_device_current();
+    atecc_bus_service(op->device->bus);
+    op->timing = atecc_exec_lookup(opcode);
+    op->opcode = opcode;
+    if (!atecc_session_begin()) {
+        return false;
+    }
+    if (!atecc_power_ensure_awake(op->timing->max_us)) {
+        atecc_session_end();
+        return false;
+    }
+
+    atecc_fragment_t fragment = { data, data_len };
+    size_t length = atecc_packet_build(op->device->packet, sizeof(op->device->packet), opcode, param1, param2,
+                                       &fragment, data_len > 0 ? 1 : 0);
+
+    op->response = response;
+    op->response_length = response_length;
+    op->callback = callback;
+    op->user_data = user_data;
+    op->in_session = true;
+    op->state = ATECC_ASYNC_BUSY;
+    active = op;
+
+    sleep_while(transfer_busy, NULL);
+    ATECC_STATS_SUBMIT(&op->stats);
+    if (!transfer_start(op->device, op->device->packet, NULL, length, async_write_done)) {
+        active = NULL;
+        op->state = ATECC_ASYNC_IDLE;
+        op->in_session = false;
+        atecc_session_end();
         return false;
     }
-    
-    memcpy(buffer, &response[1], length);
+
+    atecc_config_note_command(opcode, param1);
     return true;
 }
 
 /**
- * @brief Sends an idle command via I2C.
+ * @brief Checks an asynchronous command and retires it once it has finished.
  *
- * This function sends an idle command using the hal_i2c_send function. 
- * It returns true if the command is successfully sent, otherwise it 
- * prints an error message and returns false.
+ * Returns ATECC_ASYNC_DONE or ATECC_ASYNC_FAILED exactly once; later calls return
+ * ATECC_ASYNC_IDLE. Must be called from thread context.
  *
- * @return true if the command is successfully sent, false otherwise.
+ * @param[in,out] op The command state.
+ *
+ * @return the command state.
  */
-bool send_idle_command() {
-    uint8_t idle_cmd = ATCA_IDLE; // Idle command op-code
-    int res = hal_i2c_send((uint8_t*)&idle_cmd, sizeof(idle_cmd));
-    if (res != sizeof(idle_cmd)) {
-        printf("❌ ERROR: Failed to send idle command! (Expected %d, got %d)\n", (int)sizeof(idle_cmd), res);
-        return false;
+atecc_async_state_t atecc_async_poll(atecc_async_t *op) {
+    atecc_async_state_t state = op->state;
+    if (state == ATECC_ASYNC_DONE || state == ATECC_ASYNC_FAILED) {
+        op->state = ATECC_ASYNC_IDLE;
+        if (op->in_session) {
+            atecc_device_t *previous = atecc_device_select(op->device);
+            op->in_session = false;
+            atecc_session_end();
+            atecc_device_select(previous);
+        }
     }
-    
-    return true;
+    return state;
 }
 
 /**
- * @brief Wakes up the ATECC device.
+ * @brief Sleeps until an asynchronous command has finished, then retires it.
  *
- * This function sends a wake-up sequence to the ATECC device using the hal_i2c_send function. 
- * It then receives a response from the device and checks if the wake-up was successful.
+ * @param[in,out] op The command state.
  *
- * @return true if the wake-up was successful, false otherwise.
+ * @return ATECC_ASYNC_DONE, ATECC_ASYNC_FAILED, or ATECC_ASYNC_IDLE if nothing was pending.
  */
-bool wake_atecc_device() {    
-    uint8_t data = 0x00;
-    uint8_t wake_response[4];
-
-    // Send wakeup sequence with proper delays
-    hal_i2c_send(&data, sizeof(data));
-    sleep_ms(1);
-
-    int res = hal_i2c_receive(wake_response, sizeof(wake_response));
-    printf("Wake-up Response: ");
-    for (int i = 0; i < 4; i++) {
-        printf("%02X ", wake_response[i]);
-    }
-    printf("\n");
-
-    // Check if wake-up response matches expected value
-    if (res > 0 && wake_response[0] == 0x04 && wake_response[1] == 0x11 &&
-        wake_response[2] == 0x33 && wake_response[3] == 0x43) {
-        printf("✅ Wake-up successful!\n");
-        return true;
-    } else {
-        printf("❌ ERROR: Wake-up failed! Unexpected response.\n");
-        return false;
-    }
+atecc_async_state_t atecc_async_wait(atecc_async_t *op) {
+    sleep_while(op_busy, op);
+    return atecc_async_poll(op);
 }
 
+/**
+ * @brief Reports whether an asynchronous command is in flight.
+ *
+ * @return true while a command is on the bus or executing on the device.
+ */
+bool atecc_async_busy() {
+    return active != NULL;
+}
@@ -7,21 +7,68 @@
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
 #include "atecc_crc.h"
+#include "atecc_exec.h"
+#include "atecc_packet.h"
 
-// ATECC608 I2C Configuration
+// ATECC608 I2C Configuration of the default device (see atecc_device.h)
 #define I2C_ADDR  0x60  // ATECC608 I2C address
 #define I2C_PORT  i2c0  // I2C Port
 #define I2C_SDA_PIN 4   // SDA Pin
 #define I2C_SCL_PIN 5   // SCL Pin
 
+// Largest I2C transfer: word address plus the longest command packet
+#define ATECC_I2C_MAX_TRANSFER  (152u)
+
+// State of an asynchronous command
+typedef enum {
+    ATECC_ASYNC_IDLE,       // Never submitted, or already retired
+    ATECC_ASYNC_BUSY,       // On the bus or executing on the device
+    ATECC_ASYNC_DONE,       // Response read, count byte and CRC valid
+    ATECC_ASYNC_FAILED,     // Bus error, timeout or corrupt response
+} atecc_async_state_t;
+
+typedef struct atecc_async atecc_async_t;
+typedef struct atecc_device atecc_device_t;
+
+// Completion callback; runs in interrupt context and must not issue commands
+typedef void (*atecc_async_callback_t)(atecc_async_t *op, void *user_data);
+
+// One asynchronous command, owned by the caller until it is retired
+struct atecc_async {
+    volatile atecc_async_state_t state;
+    atecc_device_t *device;
+    const atecc_exec_time_t *timing;
+    uint8_t opcode;
+    uint64_t start_us;              // When the command packet finished sending
+    uint8_t *response;
+    size_t response_length;
+    atecc_async_callback_t callback;
+    void *user_data;
+    bool in_session;
+#if ATECC_STATS
+    atecc_stats_cmd_t stats;
+#endif
+};
+
 // I2C Communication
 int hal_i2c_send(uint8_t *txdata, size_t txlength);
 int hal_i2c_receive(uint8_t *rxdata, size_t rxlength);
+void hal_i2c_irq_enable(bool enabled);
+void hal_i2c_wait_idle();
+
+bool atecc_command_async(atecc_async_t *op, uint8_t opcode, uint8_t param1, uint16_t param2,
+                         const uint8_t *data, size_t data_len, uint8_t *response, size_t response_length,
+                         atecc_async_callback_t callback, void *user_data);
+atecc_async_state_t atecc_async_poll(atecc_async_t *op);
+atecc_async_state_t atecc_async_wait(atecc_async_t *op);
+bool atecc_async_busy();
 
 bool send_atecc_command(uint8_t opcode, uint8_t param1, uint16_t param2, const uint8_t *data, size_t data_len);
+bool send_atecc_command_sg(uint8_t opcode, uint8_t param1, uint16_t param2, const atecc_fragment_t *fragments, size_t count);
 bool receive_atecc_response(uint8_t *buffer, size_t length, bool full_response);
 
 bool send_idle_command();
+bool send_sleep_command();
 bool wake_atecc_device();
 
 #endif // ATECC_HAL_H
\ No newline at end of file
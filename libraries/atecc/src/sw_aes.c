@@ -0,0 +1,322 @@
+#include <string.h>
+
+#include "sw_aes.h"
+
+// AES S-box (FIPS 197)
+static const uint8_t sbox[256] = {
+    0x63, 0x7C, 0x77, 0x7B, 0xF2, 0x6B, 0x6F, 0xC5, 0x30, 0x01, 0x67, 0x2B, 0xFE, 0xD7, 0xAB, 0x76,
+    0xCA, 0x82, 0xC9, 0x7D, 0xFA, 0x59, 0x47, 0xF0, 0xAD, 0xD4, 0xA2, 0xAF, 0x9C, 0xA4, 0x72, 0xC0,
+    0xB7, 0xFD, 0x93, 0x26, 0x36, 0x3F, 0xF7, 0xCC, 0x34, 0xA5, 0xE5, 0xF1, 0x71, 0xD8, 0x31, 0x15,
+    0x04, 0xC7, 0x23, 0xC3, 0x18, 0x96, 0x05, 0x9A, 0x07, 0x12, 0x80, 0xE2, 0xEB, 0x27, 0xB2, 0x75,
+    0x09, 0x83, 0x2C, 0x1A, 0x1B, 0x6E, 0x5A, 0xA0, 0x52, 0x3B, 0xD6, 0xB3, 0x29, 0xE3, 0x2F, 0x84,
+    0x53, 0xD1, 0x00, 0xED, 0x20, 0xFC, 0xB1, 0x5B, 0x6A, 0xCB, 0xBE, 0x39, 0x4A, 0x4C, 0x58, 0xCF,
+    0xD0, 0xEF, 0xAA, 0xFB, 0x43, 0x4D, 0x33, 0x85, 0x45, 0xF9, 0x02, 0x7F, 0x50, 0x3C, 0x9F, 0xA8,
+    0x51, 0xA3, 0x40, 0x8F, 0x92, 0x9D, 0x38, 0xF5, 0xBC, 0xB6, 0xDA, 0x21, 0x10, 0xFF, 0xF3, 0xD2,
+    0xCD, 0x0C, 0x13, 0xEC, 0x5F, 0x97, 0x44, 0x17, 0xC4, 0xA7, 0x7E, 0x3D, 0x64, 0x5D, 0x19, 0x73,
+    0x60, 0x81, 0x4F, 0xDC, 0x22, 0x2A, 0x90, 0x88, 0x46, 0xEE, 0xB8, 0x14, 0xDE, 0x5E, 0x0B, 0xDB,
+    0xE0, 0x32, 0x3A, 0x0A, 0x49, 0x06, 0x24, 0x5C, 0xC2, 0xD3, 0xAC, 0x62, 0x91, 0x95, 0xE4, 0x79,
+    0xE7, 0xC8, 0x37, 0x6D, 0x8D, 0xD5, 0x4E, 0xA9, 0x6C, 0x56, 0xF4, 0xEA, 0x65, 0x7A, 0xAE, 0x08,
+    0xBA, 0x78, 0x25, 0x2E, 0x1C, 0xA6, 0xB4, 0xC6, 0xE8, 0xDD, 0x74, 0x1F, 0x4B, 0xBD, 0x8B, 0x8A,
+    0x70, 0x3E, 0xB5, 0x66, 0x48, 0x03, 0xF6, 0x0E, 0x61, 0x35, 0x57, 0xB9, 0x86, 0xC1, 0x1D, 0x9E,
+    0xE1, 0xF8, 0x98, 0x11, 0x69, 0xD9, 0x8E, 0x94, 0x9B, 0x1E, 0x87, 0xE9, 0xCE, 0x55, 0x28, 0xDF,
+    0x8C, 0xA1, 0x89, 0x0D, 0xBF, 0xE6, 0x42, 0x68, 0x41, 0x99, 0x2D, 0x0F, 0xB0, 0x54, 0xBB, 0x16,
+};
+
+// Reduction constants for the four bits shifted out of a GHASH step
+static const uint16_t ghash_last4[16] = {
+    0x0000, 0x1C20, 0x3840, 0x2460, 0x7080, 0x6CA0, 0x48C0, 0x54E0,
+    0xE100, 0xFD20, 0xD940, 0xC560, 0x9180, 0x8DA0, 0xA9C0, 0xB5E0,
+};
+
+static inline uint8_t xtime(uint8_t value) {
+    return (uint8_t)((value << 1) ^ ((value & 0x80) ? 0x1B : 0x00));
+}
+
+static inline uint64_t get_be64(const uint8_t *src) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) {
+        value = (value << 8) | src[i];
+    }
+    return value;
+}
+
+static inline void put_be64(uint8_t *dest, uint64_t value) {
+    for (int i = 7; i >= 0; i--) {
+        dest[i] = (uint8_t)value;
+        value >>= 8;
+    }
+}
+
+static void expand_key(uint8_t *round_keys, const uint8_t *key) {
+    uint8_t rcon = 0x01;
+    memcpy(round_keys, key, SW_AES_KEY_SIZE);
+    for (size_t i = 16; i < 176; i += 4) {
+        uint8_t t[4];
+        memcpy(t, &round_keys[i - 4], 4);
+        if (i % 16 == 0) {
+            uint8_t first = t[0];
+            t[0] = (uint8_t)(sbox[t[1]] ^ rcon);
+            t[1] = sbox[t[2]];
+            t[2] = sbox[t[3]];
+            t[3] = sbox[first];
+            rcon = xtime(rcon);
+        }
+        for (size_t j = 0; j < 4; j++) {
+            round_keys[i + j] = (uint8_t)(round_keys[i - 16 + j] ^ t[j]);
+        }
+    }
+}
+
+// Table of H times every 4-bit value, in the bit-reflected GCM field
+static void ghash_init(sw_aes_ctx_t *ctx, const uint8_t *h) {
+    uint64_t vh = get_be64(h);
+    uint64_t vl = get_be64(&h[8]);
+
+    ctx->hh[0] = 0;
+    ctx->hl[0] = 0;
+    ctx->hh[8] = vh;
+    ctx->hl[8] = vl;
+    for (int i = 4; i > 0; i >>= 1) {
+        uint64_t reduce = (vl & 1) ? 0xE100000000000000ull : 0;
+        vl = (vh << 63) | (vl >> 1);
+        vh = (vh >> 1) ^ reduce;
+        ctx->hh[i] = vh;
+        ctx->hl[i] = vl;
+    }
+    for (int i = 2; i <= 8; i *= 2) {
+        for (int j = 1; j < i; j++) {
+            ctx->hh[i + j] = ctx->hh[i] ^ ctx->hh[j];
+            ctx->hl[i + j] = ctx->hl[i] ^ ctx->hl[j];
+        }
+    }
+}
+
+// x = x * H, four bits at a time
+static void ghash_mult(const sw_aes_ctx_t *ctx, uint8_t *x) {
+    uint8_t lo = x[15] & 0x0F;
+    uint64_t zh = ctx->hh[lo];
+    uint64_t zl = ctx->hl[lo];
+
+    for (int i = 15; i >= 0; i--) {
+        uint8_t hi = x[i] >> 4;
+        lo = x[i] & 0x0F;
+        uint8_t rem;
+
+        if (i != 15) {
+            rem = (uint8_t)(zl & 0x0F);
+            zl = (zh << 60) | (zl >> 4);
+            zh = (zh >> 4) ^ ((uint64_t)ghash_last4[rem] << 48) ^ ctx->hh[lo];
+            zl ^= ctx->hl[lo];
+        }
+        rem = (uint8_t)(zl & 0x0F);
+        zl = (zh << 60) | (zl >> 4);
+        zh = (zh >> 4) ^ ((uint64_t)ghash_last4[rem] << 48) ^ ctx->hh[hi];
+        zl ^= ctx->hl[hi];
+    }
+    put_be64(x, zh);
+    put_be64(&x[8], zl);
+}
+
+// Absorb data into the GHASH state, zero-padding the last block
+static void ghash_update(const sw_aes_ctx_t *ctx, uint8_t *state, const uint8_t *data, size_t length) {
+    while (length > 0) {
+        size_t chunk = length < SW_AES_BLOCK_SIZE ? length : SW_AES_BLOCK_SIZE;
+        for (size_t i = 0; i < chunk; i++) {
+            state[i] ^= data[i];
+        }
+        ghash_mult(ctx, state);
+        data += chunk;
+        length -= chunk;
+    }
+}
+
+/**
+ * @brief Expands an AES-128 key and its GHASH table.
+ *
+ * @param ctx The context to initialize.
+ * @param key The 16-byte key.
+ */
+void sw_aes_init(sw_aes_ctx_t *ctx, const uint8_t *key) {
+    uint8_t h[SW_AES_BLOCK_SIZE] = {0};
+
+    expand_key(ctx->round_keys, key);
+    sw_aes_encrypt_block(ctx, h, h);
+    ghash_init(ctx, h);
+    memset(h, 0, sizeof(h));
+}
+
+/**
+ * @brief Clears a context so that no key material remains in RAM.
+ *
+ * @param ctx The context to clear.
+ */
+void sw_aes_wipe(sw_aes_ctx_t *ctx) {
+    volatile uint8_t *bytes = (volatile uint8_t *)ctx;
+    for (size_t i = 0; i < sizeof(*ctx); i++) {
+        bytes[i] = 0;
+    }
+}
+
+/**
+ * @brief Encrypts one block.
+ *
+ * @param ctx    The expanded key.
+ * @param input  The 16-byte plaintext block.
+ * @param output The buffer to store the ciphertext block; may equal input.
+ */
+void sw_aes_encrypt_block(const sw_aes_ctx_t *ctx, const uint8_t *input, uint8_t *output) {
+    uint8_t state[SW_AES_BLOCK_SIZE];
+
+    for (size_t i = 0; i < SW_AES_BLOCK_SIZE; i++) {
+        state[i] = input[i] ^ ctx->round_keys[i];
+    }
+
+    for (size_t round = 1; round <= 10; round++) {
+        uint8_t shifted[SW_AES_BLOCK_SIZE];
+        // SubBytes and ShiftRows; the state is column-major
+        for (size_t c = 0; c < 4; c++) {
+            for (size_t r = 0; r < 4; r++) {
+                shifted[r + 4 * c] = sbox[state[r + 4 * ((c + r) % 4)]];
+            }
+        }
+
+        const uint8_t *round_key = &ctx->round_keys[16 * round];
+        for (size_t c = 0; c < 4; c++) {
+            uint8_t *col = &shifted[4 * c];
+            if (round < 10) {
+                uint8_t all = (uint8_t)(col[0] ^ col[1] ^ col[2] ^ col[3]);
+                uint8_t first = col[0];
+                state[4 * c + 0] = (uint8_t)(col[0] ^ all ^ xtime((uint8_t)(col[0] ^ col[1])));
+                state[4 * c + 1] = (uint8_t)(col[1] ^ all ^ xtime((uint8_t)(col[1] ^ col[2])));
+                state[4 * c + 2] = (uint8_t)(col[2] ^ all ^ xtime((uint8_t)(col[2] ^ col[3])));
+                state[4 * c + 3] = (uint8_t)(col[3] ^ all ^ xtime((uint8_t)(col[3] ^ first)));
+            } else {
+                memcpy(&state[4 * c], col, 4);
+            }
+            for (size_t r = 0; r < 4; r++) {
+                state[4 * c + r] ^= round_key[4 * c + r];
+            }
+        }
+    }
+
+    memcpy(output, state, SW_AES_BLOCK_SIZE);
+}
+
+/**
+ * @brief Encrypts or decrypts in CTR mode.
+ *
+ * The whole 16-byte counter block is incremented as a big-endian integer.
+ *
+ * @param ctx     The expanded key.
+ * @param counter The counter block; on return, the next unused counter.
+ * @param input   The input data.
+ * @param output  The buffer to store the output; may equal input.
+ * @param length  The data length in bytes; need not be a multiple of the block size.
+ */
+void sw_aes_ctr(const sw_aes_ctx_t *ctx, uint8_t *counter, const uint8_t *input, uint8_t *output, size_t length) {
+    uint8_t keystream[SW_AES_BLOCK_SIZE];
+
+    while (length > 0) {
+        size_t chunk = length < SW_AES_BLOCK_SIZE ? length : SW_AES_BLOCK_SIZE;
+        sw_aes_encrypt_block(ctx, counter, keystream);
+        for (int i = SW_AES_BLOCK_SIZE - 1; i >= 0 && ++counter[i] == 0; i--) {
+        }
+        for (size_t i = 0; i < chunk; i++) {
+            output[i] = input[i] ^ keystream[i];
+        }
+        input += chunk;
+        output += chunk;
+        length -= chunk;
+    }
+    memset(keystream, 0, sizeof(keystream));
+}
+
+// GCM with a 96-bit IV: CTR from inc32(J0), GHASH over AAD and ciphertext, tag mask E(K, J0)
+static void gcm_crypt(const sw_aes_ctx_t *ctx, const uint8_t *iv, const uint8_t *aad, size_t aad_length,
+                      const uint8_t *input, uint8_t *output, size_t length, bool decrypt, uint8_t *tag) {
+    uint8_t j0[SW_AES_BLOCK_SIZE] = {0};
+    uint8_t counter[SW_AES_BLOCK_SIZE];
+    uint8_t ghash[SW_AES_BLOCK_SIZE] = {0};
+    uint8_t lengths[SW_AES_BLOCK_SIZE];
+
+    memcpy(j0, iv, SW_AES_GCM_IV_SIZE);
+    j0[15] = 0x01;
+    memcpy(counter, j0, sizeof(counter));
+    counter[15] = 0x02;
+
+    ghash_update(ctx, ghash, aad, aad_length);
+    if (decrypt) {
+        ghash_update(ctx, ghash, input, length);
+    }
+
+    // inc32: only the low 32 bits count
+    uint8_t keystream[SW_AES_BLOCK_SIZE];
+    for (size_t offset = 0; offset < length; offset += SW_AES_BLOCK_SIZE) {
+        size_t chunk = length - offset < SW_AES_BLOCK_SIZE ? length - offset : SW_AES_BLOCK_SIZE;
+        sw_aes_encrypt_block(ctx, counter, keystream);
+        for (int i = 15; i >= 12 && ++counter[i] == 0; i--) {
+        }
+        for (size_t i = 0; i < chunk; i++) {
+            output[offset + i] = input[offset + i] ^ keystream[i];
+        }
+    }
+
+    if (!decrypt) {
+        ghash_update(ctx, ghash, output, length);
+    }
+    put_be64(lengths, (uint64_t)aad_length * 8);
+    put_be64(&lengths[8], (uint64_t)length * 8);
+    ghash_update(ctx, ghash, lengths, sizeof(lengths));
+
+    sw_aes_encrypt_block(ctx, j0, keystream);
+    for (size_t i = 0; i < SW_AES_GCM_TAG_SIZE; i++) {
+        tag[i] = ghash[i] ^ keystream[i];
+    }
+    memset(keystream, 0, sizeof(keystream));
+}
+
+/**
+ * @brief Encrypts and authenticates with AES-GCM.
+ *
+ * @param ctx        The expanded key.
+ * @param iv         The 12-byte IV; never reuse one under the same key.
+ * @param aad        Additional authenticated data, or NULL.
+ * @param aad_length The AAD length in bytes.
+ * @param input      The plaintext.
+ * @param output     The buffer to store the ciphertext; may equal input.
+ * @param length     The plaintext length in bytes.
+ * @param tag        The buffer to store the 16-byte tag.
+ */
+void sw_aes_gcm_encrypt(const sw_aes_ctx_t *ctx, const uint8_t *iv, const uint8_t *aad, size_t aad_length,
+                        const uint8_t *input, uint8_t *output, size_t length, uint8_t *tag) {
+    gcm_crypt(ctx, iv, aad, aad_length, input, output, length, false, tag);
+}
+
+/**
+ * @brief Decrypts and checks an AES-GCM message.
+ *
+ * @param ctx        The expanded key.
+ * @param iv         The 12-byte IV.
+ * @param aad        Additional authenticated data, or NULL.
+ * @param aad_length The AAD length in bytes.
+ * @param input      The ciphertext.
+ * @param output     The buffer to store the plaintext; may equal input.
+ * @param length     The ciphertext length in bytes.
+ * @param tag        The 16-byte tag.
+ * @return true if the tag matches; otherwise false and the output is cleared.
+ */
+bool sw_aes_gcm_decrypt(const sw_aes_ctx_t *ctx, const uint8_t *iv, const uint8_t *aad, size_t aad_length,
+                        const uint8_t *input, uint8_t *output, size_t length, const uint8_t *tag) {
+    uint8_t expected[SW_AES_GCM_TAG_SIZE];
+    uint8_t diff = 0;
+
+    gcm_crypt(ctx, iv, aad, aad_length, input, output, length, true, expected);
+    for (size_t i = 0; i < SW_AES_GCM_TAG_SIZE; i++) {
+        diff |= expected[i] ^ tag[i];
+    }
+    if (diff != 0) {
+        memset(output, 0, length);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,29 @@
+#ifndef SW_AES_H
+#define SW_AES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SW_AES_KEY_SIZE     (16u)   // AES-128
+#define SW_AES_BLOCK_SIZE   (16u)
+#define SW_AES_GCM_IV_SIZE  (12u)
+#define SW_AES_GCM_TAG_SIZE (16u)
+
+// Software AES-128 with the key schedule and the GHASH table of the key
+typedef struct {
+    uint8_t  round_keys[176];
+    uint64_t hl[16];        // Multiples of the hash subkey H, for 4-bit GHASH steps
+    uint64_t hh[16];
+} sw_aes_ctx_t;
+
+void sw_aes_init(sw_aes_ctx_t *ctx, const uint8_t *key);
+void sw_aes_wipe(sw_aes_ctx_t *ctx);
+void sw_aes_encrypt_block(const sw_aes_ctx_t *ctx, const uint8_t *input, uint8_t *output);
+void sw_aes_ctr(const sw_aes_ctx_t *ctx, uint8_t *counter, const uint8_t *input, uint8_t *output, size_t length);
+void sw_aes_gcm_encrypt(const sw_aes_ctx_t *ctx, const uint8_t *iv, const uint8_t *aad, size_t aad_length,
+                        const uint8_t *input, uint8_t *output, size_t length, uint8_t *tag);
+bool sw_aes_gcm_decrypt(const sw_aes_ctx_t *ctx, const uint8_t *iv, const uint8_t *aad, size_t aad_length,
+                        const uint8_t *input, uint8_t *output, size_t length, const uint8_t *tag);
+
+#endif // SW_AES_H
@@ -0,0 +1,197 @@
+#include <string.h>
+
+#include "sw_sha256.h"
+
+// SHA-256 round constants (FIPS 180-4)
+static const uint32_t round_constants[64] = {
+    0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+    0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+    0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+    0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+    0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+    0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+    0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+    0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2,
+};
+
+static inline uint32_t rotr32(uint32_t value, unsigned bits) {
+    return (value >> bits) | (value << (32u - bits));
+}
+
+// Process one 64-byte block
+static void sha256_transform(uint32_t *state, const uint8_t *block) {
+    uint32_t w[64];
+
+    for (int i = 0; i < 16; i++) {
+        w[i] = ((uint32_t)block[4 * i] << 24) | ((uint32_t)block[4 * i + 1] << 16) |
+               ((uint32_t)block[4 * i + 2] << 8) | block[4 * i + 3];
+    }
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = rotr32(w[i - 15], 7) ^ rotr32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = rotr32(w[i - 2], 17) ^ rotr32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for (int i = 0; i < 64; i++) {
+        uint32_t s1 = rotr32(e, 6) ^ rotr32(e, 11) ^ rotr32(e, 25);
+        uint32_t ch = (e & f) ^ (~e & g);
+        uint32_t t1 = h + s1 + ch + round_constants[i] + w[i];
+        uint32_t s0 = rotr32(a, 2) ^ rotr32(a, 13) ^ rotr32(a, 22);
+        uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+        uint32_t t2 = s0 + maj;
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+/**
+ * @brief Starts a software SHA-256 computation.
+ *
+ * @param ctx The state to initialize.
+ */
+void sw_sha256_init(sw_sha256_ctx_t *ctx) {
+    static const uint32_t initial_state[8] = {
+        0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19,
+    };
+    memcpy(ctx->state, initial_state, sizeof(initial_state));
+    ctx->block_length = 0;
+    ctx->total_length = 0;
+}
+
+/**
+ * @brief Adds message bytes to a software SHA-256 computation.
+ *
+ * @param ctx    The state.
+ * @param data   The message bytes.
+ * @param length The number of bytes.
+ */
+void sw_sha256_update(sw_sha256_ctx_t *ctx, const uint8_t *data, size_t length) {
+    ctx->total_length += length;
+
+    if (ctx->block_length > 0) {
+        size_t chunk = sizeof(ctx->block) - ctx->block_length;
+        if (chunk > length) {
+            chunk = length;
+        }
+        memcpy(&ctx->block[ctx->block_length], data, chunk);
+        ctx->block_length += chunk;
+        data += chunk;
+        length -= chunk;
+        if (ctx->block_length < sizeof(ctx->block)) {
+            return;
+        }
+        sha256_transform(ctx->state, ctx->block);
+        ctx->block_length = 0;
+    }
+
+    while (length >= sizeof(ctx->block)) {
+        sha256_transform(ctx->state, data);
+        data += sizeof(ctx->block);
+        length -= sizeof(ctx->block);
+    }
+
+    memcpy(ctx->block, data, length);
+    ctx->block_length = length;
+}
+
+/**
+ * @brief Finishes a software SHA-256 computation.
+ *
+ * @param ctx    The state.
+ * @param digest The buffer to store the 32-byte digest.
+ */
+void sw_sha256_final(sw_sha256_ctx_t *ctx, uint8_t *digest) {
+    uint64_t bit_length = ctx->total_length * 8u;
+    size_t used = ctx->block_length;
+
+    ctx->block[used++] = 0x80;
+    if (used > 56) {
+        memset(&ctx->block[used], 0, sizeof(ctx->block) - used);
+        sha256_transform(ctx->state, ctx->block);
+        used = 0;
+    }
+    memset(&ctx->block[used], 0, 56 - used);
+    for (int i = 0; i < 8; i++) {
+        ctx->block[63 - i] = (uint8_t)(bit_length >> (8 * i));
+    }
+    sha256_transform(ctx->state, ctx->block);
+
+    for (int i = 0; i < 8; i++) {
+        digest[4 * i] = (uint8_t)(ctx->state[i] >> 24);
+        digest[4 * i + 1] = (uint8_t)(ctx->state[i] >> 16);
+        digest[4 * i + 2] = (uint8_t)(ctx->state[i] >> 8);
+        digest[4 * i + 3] = (uint8_t)ctx->state[i];
+    }
+}
+
+/**
+ * @brief Computes the SHA-256 digest of a buffer in software.
+ *
+ * @param data   The message.
+ * @param length The message length in bytes.
+ * @param digest The buffer to store the 32-byte digest.
+ */
+void sw_sha256(const uint8_t *data, size_t length, uint8_t *digest) {
+    sw_sha256_ctx_t ctx;
+    sw_sha256_init(&ctx);
+    sw_sha256_update(&ctx, data, length);
+    sw_sha256_final(&ctx, digest);
+}
+
+/**
+ * @brief Computes HMAC-SHA256 (RFC 2104) in software.
+ *
+ * @param key        The key; keys longer than 64 bytes are hashed first.
+ * @param key_length The key length in bytes.
+ * @param data       The message.
+ * @param length     The message length in bytes.
+ * @param mac        The buffer to store the 32-byte MAC.
+ */
+void sw_hmac_sha256(const uint8_t *key, size_t key_length, const uint8_t *data, size_t length, uint8_t *mac) {
+    uint8_t pad[64] = {0};
+    uint8_t inner[32];
+    sw_sha256_ctx_t ctx;
+
+    if (key_length > sizeof(pad)) {
+        sw_sha256(key, key_length, pad);
+    } else {
+        memcpy(pad, key, key_length);
+    }
+
+    for (size_t i = 0; i < sizeof(pad); i++) {
+        pad[i] ^= 0x36;
+    }
+    sw_sha256_init(&ctx);
+    sw_sha256_update(&ctx, pad, sizeof(pad));
+    sw_sha256_update(&ctx, data, length);
+    sw_sha256_final(&ctx, inner);
+
+    for (size_t i = 0; i < sizeof(pad); i++) {
+        pad[i] ^= 0x36 ^ 0x5C;
+    }
+    sw_sha256_init(&ctx);
+    sw_sha256_update(&ctx, pad, sizeof(pad));
+    sw_sha256_update(&ctx, inner, sizeof(inner));
+    sw_sha256_final(&ctx, mac);
+
+    memset(pad, 0, sizeof(pad));
+    memset(inner, 0, sizeof(inner));
+}
@@ -0,0 +1,29 @@
+#ifndef SW_SHA256_H
+#define SW_SHA256_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Software SHA-256 state
+typedef struct {
+    uint32_t state[8];
+    uint8_t  block[64];
+    size_t   block_length;
+    uint64_t total_length;
+} sw_sha256_ctx_t;
+
+void sw_sha256_init(sw_sha256_ctx_t *ctx);
+void sw_sha256_update(sw_sha256_ctx_t *ctx, const uint8_t *data, size_t length);
+void sw_sha256_final(sw_sha256_ctx_t *ctx, uint8_t *digest);
+void sw_sha256(const uint8_t *data, size_t length, uint8_t *digest);
+void sw_hmac_sha256(const uint8_t *key, size_t key_length, const uint8_t *data, size_t length, uint8_t *mac);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SW_SHA256_H
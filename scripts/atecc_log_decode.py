@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+"""Decode ATECC trace log records captured from the Pico's serial output.
+
+Firmware built with -DATECC_LOG_TEXT=OFF drains its trace log as lines of the form
+"@ATL <32 hex digits>", one 16-byte record each. This script reads such a capture
+(a file or stdin), formats the records using the event table in
+libraries/atecc/src/atecc_log_events.h and passes every other line through unchanged.
+
+    python3 scripts/atecc_log_decode.py capture.txt
+    picocom -b 115200 /dev/ttyACM0 | python3 scripts/atecc_log_decode.py
+"""
+
+import argparse
+import re
+import struct
+import sys
+from pathlib import Path
+
+REPO_ROOT = Path(__file__).resolve().parent.parent
+EVENTS_HEADER = REPO_ROOT / "libraries" / "atecc" / "src" / "atecc_log_events.h"
+
+LEVEL_MARKS = {"ERROR": "❌", "WARN": "⚠️", "INFO": "🔹", "DEBUG": "🔍"}
+
+# timestamp_us, event, opcode, status, args[0], args[1]
+RECORD = struct.Struct("<IHBBII")
+
+EVENT_RE = re.compile(r'^ATECC_LOG_EVENT\(\s*(\w+)\s*,\s*(\w+)\s*,\s*"((?:[^"\\]|\\.)*)"\s*\)', re.M)
+CONVERSION_RE = re.compile(r"%(0?\d*)([udX%])")
+
+
+def load_events(path):
+    """Return [(name, level, format)] indexed by event id."""
+    return EVENT_RE.findall(path.read_text(encoding="utf-8"))
+
+
+def format_message(fmt, args):
+    """Apply a C format restricted to %u, %d and %X to 32-bit arguments."""
+    values = iter(args)
+
+    def convert(match):
+        width, kind = match.groups()
+        if kind == "%":
+            return "%"
+        value = next(values, 0)
+        if kind == "d" and value >= 0x80000000:
+            value -= 1 << 32
+        return ("%" + width + ("X" if kind == "X" else "d")) % value
+
+    return CONVERSION_RE.sub(convert, fmt)
+
+
+def decode_record(data, events):
+    timestamp, event, opcode, status, arg0, arg1 = RECORD.unpack(data)
+    if event >= len(events):
+        return "❓ [%10u us] Unknown event %u" % (timestamp, event)
+
+    name, level, fmt = events[event]
+    text = "%s [%10u us] %s" % (LEVEL_MARKS.get(level, "?"), timestamp, format_message(fmt, (arg0, arg1)))
+    if opcode or status:
+        text += " (op %02X, status %02X)" % (opcode, status)
+    return text
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("capture", nargs="?", help="serial capture to decode (default: stdin)")
+    parser.add_argument("--events", type=Path, default=EVENTS_HEADER, help="path to atecc_log_events.h")
+    options = parser.parse_args()
+
+    events = load_events(options.events)
+    source = open(options.capture, encoding="utf-8", errors="replace") if options.capture else sys.stdin
+
+    with source:
+        for line in source:
+            line = line.rstrip("\r\n")
+            marker = line.find("@ATL ")
+            if marker < 0:
+                print(line)
+                continue
+            try:
+                record = bytes.fromhex(line[marker + 5:marker + 5 + 2 * RECORD.size])
+                print(line[:marker] + decode_record(record, events))
+            except (ValueError, struct.error):
+                print(line)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,291 @@
+#include "atecc_bench.h"
+#include "hal_pico_i2c.h"
+#include "atecc_cmd.h"
+#include "atecc_aes.h"
+#include "atecc_counter.h"
+#include "atecc_ecc.h"
+#include "atecc_sha.h"
+#include "atecc_service.h"
+#include "sw_sha256.h"
+
+#define BENCH_CRC_BUFFER_SIZE   (256u)
+#define BENCH_CRC_ROUNDS        (200u)
+#define BENCH_AES_RECORD_SIZE   (256u)
+#define BENCH_SERVICE_REQUESTS  ATECC_SERVICE_QUEUE_SIZE
+#define BENCH_ECC_SIGNATURES    (8u)
+#define BENCH_ECC_MESSAGE_SIZE  (1024u)
+#define BENCH_COUNTER_NUMBERS   (64u)
+#define BENCH_COUNTER_BLOCK     (32u)
+
+/**
+ * @brief Measures CRC16 throughput of the compiled-in implementation.
+ *
+ * Runs the CRC over a 256-byte buffer repeatedly and prints the result in bytes/µs,
+ * once as a single pass and once fed in 7-byte pieces through the incremental API.
+ */
+void bench_crc16() {
+    static uint8_t buffer[BENCH_CRC_BUFFER_SIZE];
+    uint8_t crc[2];
+    uint8_t check = 0;
+
+    for (size_t i = 0; i < sizeof(buffer); i++) {
+        buffer[i] = (uint8_t)(i * 31u + 7u);
+    }
+
+    uint64_t start = time_us_64();
+    for (uint32_t round = 0; round < BENCH_CRC_ROUNDS; round++) {
+        calc_crc16_ccitt(sizeof(buffer), buffer, crc);
+        check += crc[0];
+    }
+    uint64_t single_us = time_us_64() - start;
+
+    start = time_us_64();
+    for (uint32_t round = 0; round < BENCH_CRC_ROUNDS; round++) {
+        atecc_crc_ctx_t ctx;
+        atecc_crc_init(&ctx);
+        for (size_t offset = 0; offset < sizeof(buffer); offset += 7) {
+            size_t chunk = sizeof(buffer) - offset < 7 ? sizeof(buffer) - offset : 7;
+            atecc_crc_update(&ctx, &buffer[offset], chunk);
+        }
+        atecc_crc_final(&ctx, crc);
+        check += crc[1];
+    }
+    uint64_t incremental_us = time_us_64() - start;
+
+    uint32_t total_bytes = BENCH_CRC_BUFFER_SIZE * BENCH_CRC_ROUNDS;
+    printf("⏱️ CRC16 (impl %d): %.2f bytes/µs single pass, %.2f bytes/µs incremental (check %02X)\n",
+           ATECC_CRC_IMPL,
+           single_us ? (double)total_bytes / (double)single_us : 0.0,
+           incremental_us ? (double)total_bytes / (double)incremental_us : 0.0,
+           check);
+}
+
+// Print a blocks/second figure for one AES benchmark run
+static void report_aes(const char *name, bool ok, size_t blocks, uint64_t elapsed_us) {
+    if (!ok) {
+        printf("❌ %s benchmark failed\n", name);
+        return;
+    }
+    printf("⏱️ AES %s: %zu blocks in %llu µs (%.1f blocks/s)\n", name, blocks,
+           (unsigned long long)elapsed_us, elapsed_us ? blocks * 1e6 / (double)elapsed_us : 0.0);
+}
+
+/**
+ * @brief Measures AES throughput for a telemetry-sized record.
+ *
+ * Encrypts a 256-byte record block by block with aes_encrypt() and then with the
+ * bulk ECB, CBC and CTR functions, and prints blocks/second for each.
+ *
+ * @param key_slot The key slot where the AES 128-bit key is stored.
+ */
+void bench_aes(uint8_t key_slot) {
+    static uint8_t record[BENCH_AES_RECORD_SIZE];
+    static uint8_t output[BENCH_AES_RECORD_SIZE + AES_BLOCK_SIZE];
+    uint8_t iv[AES_BLOCK_SIZE] = {0};
+    size_t blocks = BENCH_AES_RECORD_SIZE / AES_BLOCK_SIZE;
+    size_t output_length = 0;
+    bool ok = true;
+
+    for (size_t i = 0; i < sizeof(record); i++) {
+        record[i] = (uint8_t)i;
+    }
+
+    uint64_t start = time_us_64();
+    for (size_t i = 0; ok && i < blocks; i++) {
+        ok = aes_encrypt(&record[i * AES_BLOCK_SIZE], &output[i * AES_BLOCK_SIZE], key_slot);
+    }
+    report_aes("single block", ok, blocks, time_us_64() - start);
+
+    start = time_us_64();
+    ok = aes_ecb_encrypt(key_slot, record, output, sizeof(record));
+    report_aes("ECB", ok, blocks, time_us_64() - start);
+
+    start = time_us_64();
+    ok = aes_cbc_encrypt(key_slot, iv, record, sizeof(record), output, sizeof(output), &output_length);
+    report_aes("CBC", ok, output_length / AES_BLOCK_SIZE, time_us_64() - start);
+
+    start = time_us_64();
+    ok = aes_ctr_crypt(key_slot, iv, record, output, sizeof(record));
+    report_aes("CTR", ok, blocks, time_us_64() - start);
+}
+
+/**
+ * @brief Calibrates the SHA-256 dispatcher and prints the fitted engine costs.
+ *
+ * Also prints which engine the dispatcher now picks for a few message sizes, with
+ * and without the digest being bound to TempKey.
+ */
+void bench_sha256() {
+    static const char *names[SHA256_ENGINE_COUNT] = {"ATECC", "RP2350", "software"};
+    static const size_t sizes[] = {32u, 256u, 4096u};
+
+    if (!sha256_calibrate()) {
+        printf("❌ SHA-256 calibration failed\n");
+        return;
+    }
+
+    const sha256_calibration_t *calibration = sha256_get_calibration();
+    for (int engine = 0; engine < SHA256_ENGINE_COUNT; engine++) {
+#if !LIB_PICO_SHA256
+        if (engine == SHA256_ENGINE_HW) {
+            continue;
+        }
+#endif
+        printf("⏱️ SHA-256 %s: %lu µs + %lu µs/block\n", names[engine],
+               (unsigned long)calibration->engine[engine].fixed_us,
+               (unsigned long)calibration->engine[engine].per_block_us);
+    }
+    printf("⏱️ SHA-256 TempKey load: %lu µs\n", (unsigned long)calibration->nonce_us);
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        bool bind_tempkey;
+        sha256_engine_t plain = sha256_select_engine(sizes[i], 0, &bind_tempkey);
+        sha256_engine_t bound = sha256_select_engine(sizes[i], SHA256_FLAG_TEMPKEY, &bind_tempkey);
+        printf("🔹 SHA-256 %zu bytes: %s, %s when bound to TempKey\n",
+               sizes[i], names[plain], names[bound]);
+    }
+}
+
+// Digest source for the signing benchmark: hashes a message in software, as an
+// application signing its records would
+static bool bench_digest(size_t index, uint8_t *digest, void *user_data) {
+    uint8_t *message = user_data;
+    sw_sha256_ctx_t ctx;
+
+    message[0] = (uint8_t)index;
+    sw_sha256_init(&ctx);
+    sw_sha256_update(&ctx, message, BENCH_ECC_MESSAGE_SIZE);
+    sw_sha256_final(&ctx, digest);
+    return true;
+}
+
+// Print a signatures/second figure for one signing run
+static void report_ecc(const char *name, bool ok, uint64_t elapsed_us) {
+    if (!ok) {
+        printf("❌ ECDSA %s benchmark failed\n", name);
+        return;
+    }
+    printf("⏱️ ECDSA sign %s: %u signatures in %llu µs (%.2f signatures/s)\n", name, BENCH_ECC_SIGNATURES,
+           (unsigned long long)elapsed_us, elapsed_us ? BENCH_ECC_SIGNATURES * 1e6 / (double)elapsed_us : 0.0);
+}
+
+/**
+ * @brief Measures ECDSA P-256 signing throughput.
+ *
+ * Signs the SHA-256 digests of 1 KiB messages, hashing each one and then signing it
+ * with ecc_sign_digest(), and again with ecc_sign_batch() hashing the next message
+ * while the device signs. Prints signatures/second for both.
+ *
+ * @param key_slot The key slot holding a P-256 private key.
+ */
+void bench_ecc_sign(uint8_t key_slot) {
+    static uint8_t message[BENCH_ECC_MESSAGE_SIZE];
+    static uint8_t signatures[BENCH_ECC_SIGNATURES][ECC_P256_SIG_SIZE];
+    uint8_t digest[ECC_DIGEST_SIZE];
+    bool ok = true;
+
+    for (size_t i = 0; i < sizeof(message); i++) {
+        message[i] = (uint8_t)(i * 13u);
+    }
+
+    uint64_t start = time_us_64();
+    for (size_t i = 0; ok && i < BENCH_ECC_SIGNATURES; i++) {
+        bench_digest(i, digest, message);
+        ok = ecc_sign_digest(key_slot, digest, signatures[i]);
+    }
+    report_ecc("one at a time", ok, time_us_64() - start);
+
+    start = time_us_64();
+    ok = ecc_sign_batch(key_slot, BENCH_ECC_SIGNATURES, bench_digest, message, &signatures[0][0]) ==
+         BENCH_ECC_SIGNATURES;
+    report_ecc("batched", ok, time_us_64() - start);
+}
+
+// Print a numbers/second figure for one counter run
+static void report_counter(const char *name, bool ok, uint64_t elapsed_us) {
+    if (!ok) {
+        printf("❌ Counter %s benchmark failed\n", name);
+        return;
+    }
+    printf("⏱️ Counter %s: %u numbers in %llu µs (%.1f numbers/s)\n", name, BENCH_COUNTER_NUMBERS,
+           (unsigned long long)elapsed_us, elapsed_us ? BENCH_COUNTER_NUMBERS * 1e6 / (double)elapsed_us : 0.0);
+}
+
+/**
+ * @brief Measures sequence numbers/second from a monotonic counter.
+ *
+ * Takes numbers with one Counter increment each, then from blocks reserved with one
+ * increment per BENCH_COUNTER_BLOCK numbers. Each run advances the chip counter for
+ * good, by BENCH_COUNTER_NUMBERS plus the blocks reserved, out of 2097151.
+ *
+ * @param counter_id The counter to use, 0 or 1.
+ */
+void bench_counter(uint8_t counter_id) {
+    counter_reservation_t reservation;
+    uint64_t sequence;
+    uint32_t value;
+    bool ok = true;
+
+    uint64_t start = time_us_64();
+    for (size_t i = 0; ok && i < BENCH_COUNTER_NUMBERS; i++) {
+        ok = counter_increment(counter_id, &value);
+    }
+    report_counter("increment each", ok, time_us_64() - start);
+
+    start = time_us_64();
+    ok = counter_reserve_init(&reservation, counter_id, BENCH_COUNTER_BLOCK);
+    for (size_t i = 0; ok && i < BENCH_COUNTER_NUMBERS; i++) {
+        ok = counter_reserve_next(&reservation, &sequence);
+    }
+    report_counter("reserved blocks", ok, time_us_64() - start);
+}
+
+/**
+ * @brief Compares inline AES on core0 with the same work queued to the core1 service.
+ *
+ * Reports the total time for both, and how long core0 spent submitting to the
+ * service. Starts the service, so it must be the last benchmark to run.
+ *
+ * @param key_slot The key slot where the AES 128-bit key is stored.
+ */
+void bench_service(uint8_t key_slot) {
+    static uint8_t input[BENCH_SERVICE_REQUESTS][AES_BLOCK_SIZE];
+    static uint8_t output[BENCH_SERVICE_REQUESTS][AES_BLOCK_SIZE];
+    static atecc_request_t requests[BENCH_SERVICE_REQUESTS];
+    bool ok = true;
+
+    for (size_t i = 0; i < BENCH_SERVICE_REQUESTS; i++) {
+        memset(input[i], (int)i, AES_BLOCK_SIZE);
+    }
+
+    uint64_t start = time_us_64();
+    for (size_t i = 0; ok && i < BENCH_SERVICE_REQUESTS; i++) {
+        ok = aes_encrypt(input[i], output[i], key_slot);
+    }
+    report_aes("inline on core0", ok, BENCH_SERVICE_REQUESTS, time_us_64() - start);
+
+    if (!atecc_service_start()) {
+        printf("❌ Could not start the core1 service\n");
+        return;
+    }
+
+    start = time_us_64();
+    for (size_t i = 0; ok && i < BENCH_SERVICE_REQUESTS; i++) {
+        requests[i] = (atecc_request_t){
+            .type = ATECC_REQUEST_AES_ENCRYPT,
+            .key_slot = key_slot,
+            .input = input[i],
+            .input_length = AES_BLOCK_SIZE,
+            .output = output[i],
+            .output_length = AES_BLOCK_SIZE,
+        };
+        ok = atecc_service_submit(&requests[i]);
+    }
+    uint64_t submit_us = time_us_64() - start;
+
+    for (size_t i = 0; i < BENCH_SERVICE_REQUESTS; i++) {
+        ok = atecc_service_wait(&requests[i]) && ok;
+    }
+    report_aes("via core1 service", ok, BENCH_SERVICE_REQUESTS, time_us_64() - start);
+    printf("⏱️ core0 busy submitting: %llu µs\n", (unsigned long long)submit_us);
+}
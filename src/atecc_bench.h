@@ -0,0 +1,15 @@
+#ifndef ATECC_BENCH_H
+#define ATECC_BENCH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Throughput benchmarks, enabled with -DPICO_ATECC_BENCHMARK=ON
+void bench_crc16();
+void bench_aes(uint8_t key_slot);
+void bench_sha256();
+void bench_ecc_sign(uint8_t key_slot);
+void bench_counter(uint8_t counter_id);
+void bench_service(uint8_t key_slot);
+
+#endif // ATECC_BENCH_H
@@ -0,0 +1,55 @@
+#include "atecc_rpc_usb.h"
+#include "hal_pico_i2c.h"
+#include "atecc_log.h"
+#include "atecc_rpc_server.h"
+#include "atecc_service.h"
+#include "pico/stdio_usb.h"
+
+#define RPC_IDLE_POLL_US    (1000u)     // Longest sleep between polls with nothing to do
+
+#if ATECC_RPC_MAX_IN_FLIGHT > ATECC_SERVICE_QUEUE_SIZE
+#error "ATECC_RPC_MAX_IN_FLIGHT must not exceed ATECC_SERVICE_QUEUE_SIZE"
+#endif
+
+// The CDC driver's own FIFO calls, bypassing stdio so printf never lands in the stream
+static size_t usb_read(uint8_t *data, size_t length, void *context) {
+    (void)context;
+    int count = stdio_usb.in_chars((char *)data, (int)length);
+    return count > 0 ? (size_t)count : 0;
+}
+
+// Waits for room in the CDC FIFO, or drops the bytes once the host has gone
+static size_t usb_write(const uint8_t *data, size_t length, void *context) {
+    (void)context;
+    stdio_usb.out_chars((const char *)data, (int)length);
+    return length;
+}
+
+/**
+ * @brief Runs the device as an RPC accelerator for a USB host; does not return.
+ *
+ * core1 owns the ATECC608A through the service, so core0 keeps moving frames over
+ * USB while requests execute. Text output stays on the UART.
+ *
+ * @return 1 if the core1 service could not be started.
+ */
+int rpc_serve() {
+    static atecc_rpc_server_t server;
+    static const atecc_rpc_transport_t transport = { usb_read, usb_write, NULL };
+    static const atecc_rpc_executor_t executor = { atecc_service_submit, atecc_service_poll };
+
+    stdio_set_driver_enabled(&stdio_usb, false);
+    if (!atecc_service_start()) {
+        printf("❌ ERROR: Could not start the core1 service\n");
+        return 1;
+    }
+    atecc_rpc_server_init(&server, &transport, &executor);
+    printf("🔌 Serving RPC over USB CDC, up to %u requests in flight\n", ATECC_RPC_MAX_IN_FLIGHT);
+
+    for (;;) {
+        if (!atecc_rpc_server_poll(&server)) {
+            atecc_log_drain(SIZE_MAX);
+            best_effort_wfe_or_timeout(make_timeout_time_us(RPC_IDLE_POLL_US));
+        }
+    }
+}
@@ -0,0 +1,7 @@
+#ifndef ATECC_RPC_USB_H
+#define ATECC_RPC_USB_H
+
+// Serves the binary RPC protocol over USB CDC, enabled with -DPICO_ATECC_RPC=ON
+int rpc_serve();
+
+#endif // ATECC_RPC_USB_H
@@ -1,5 +1,22 @@
 #include "hal_pico_i2c.h"
 #include "atecc_cmd.h"
+#include "atecc_power.h"
+#include "atecc_random.h"
+#include "atecc_bench.h"
+#include "atecc_rpc_usb.h"
+#include "atecc_bus.h"
+#include "atecc_log.h"
+#include "atecc_stats.h"
+
+#define ECC_SIGN_SLOT   (0u)    // P-256 private key slot used by the signing benchmark
+#define BENCH_COUNTER   (1u)    // Counter advanced by the counter benchmark
+
+// Print what the library logged, then the demo's own error
+static int demo_failed(const char *message) {
+    atecc_log_drain(SIZE_MAX);
+    printf("❌ ERROR: %s\n", message);
+    return 1;
+}
 
 // Main function to test the ATECC608A device
 int main() {
@@ -12,49 +29,74 @@ int main() {
 
     printf("📡 Initializing ATECC608A...\n");
 
-    // Send a wake-up sequence
-    if (!wake_atecc_device()) {
-        printf("❌ ERROR: Failed to wake up ATECC608A\n");
-        return 1;
+    // Run the bus as fast as the wiring allows
+    uint32_t rate = atecc_bus_negotiate();
+    if (rate == 0) {
+        return demo_failed("No response from ATECC608A at 100 kHz");
+    }
+    printf("⚡ I2C clock: %lu kHz\n", (unsigned long)(rate / 1000));
+
+    // Wake the device and keep it awake for the whole demo
+    if (!atecc_session_begin()) {
+        return demo_failed("Failed to wake up ATECC608A");
     }
     
     // Read the serial number
-    if (!read_atecc_serial_number()) {
-        printf("❌ ERROR: Failed to read Serial Number\n");
-        return 1;
+    uint8_t serial[ATCA_SERIAL_NUM_SIZE];
+    if (!read_atecc_serial_number(serial)) {
+        return demo_failed("Failed to read Serial Number");
+    }
+    printf("🆔 Serial Number: ");
+    for (int i = 0; i < ATCA_SERIAL_NUM_SIZE; i++) {
+        printf("%02X", serial[i]);
+    }
+    printf("\n");
+
+    // Prefill the entropy pool so small random draws need no bus traffic
+    if (!random_pool_init(ATECC_RANDOM_BLOCK_SIZE, true)) {
+        return demo_failed("Failed to fill the entropy pool");
     }
 
+#ifdef PICO_ATECC_RPC
+    // Serve a USB host instead of running the demo; core1 takes the device over
+    atecc_session_end();
+    return rpc_serve();
+#endif
+
     // Generate a random number in a specific range
     generate_random_number_in_range(100, 65535);
 
     // Compute a SHA-256 hash
     if (!compute_sha256_hash("COLD WAR")) {
-        printf(" ERROR: Failed to compute a SHA-256 hash\n");
-        return 1;
+        return demo_failed("Failed to compute a SHA-256 hash");
     }
     
     // Read the configuration of a specific slot
     if (!read_slot_config(0x03)) {
-        printf("❌ ERROR: Failed to read slot configuration\n");
-        return 1;
+        return demo_failed("Failed to read slot configuration");
     }
 
     // Generate a random value of specific length
     if (!generate_random_value(16)) {
-        printf("❌ ERROR: Failed to generate random value\n");
-        return 1;
+        return demo_failed("Failed to generate random value");
     }
     
     // Read the configuration data of all slots
-    if (!read_config_zone()) {
-        printf("❌ ERROR: Failed to read configuration data\n");
-        return 1;
+    uint8_t config_data[CONFIG_ZONE_SIZE];
+    printf("🔎 Reading Configuration Data...\n");
+    if (!read_config_zone(config_data)) {
+        return demo_failed("Failed to read configuration data");
+    }
+    for (int i = 0; i < CONFIG_ZONE_SIZE; i++) {
+        printf("%02X ", config_data[i]);
+        if ((i + 1) % 16 == 0) {
+            printf("\n");
+        }
     }
 
     // Read the configuration data of all slots and check the lock status
     if (!check_lock_status()) {
-        printf("❌ ERROR: Failed to check lock status\n");
-        return 1;
+        return demo_failed("Failed to check lock status");
     }
     
     // This will fail if you have not setup the ATECC608A for AES
@@ -77,6 +119,7 @@ int main() {
         }
         printf("\n");
     } else {
+        atecc_log_drain(SIZE_MAX);
         printf("❌ AES 128-bit encryption failed!\n");
         printf("❓ Is the slot configured for AES?\n");
         return 1;
@@ -97,11 +140,29 @@ int main() {
             printf("❌ AES Decryption Failed! Plaintext Mismatch!\n");
         }
     } else {
-        printf("❌ AES Decryption Failed!\n");
-        return 1;
+        return demo_failed("AES Decryption Failed!");
     }
 
+    atecc_session_end();
+    atecc_log_drain(SIZE_MAX);
     printf("🎉 ATECC608A Test Complete!\n");
 
+#ifdef PICO_ATECC_BENCHMARK
+    bench_crc16();
+    bench_aes(key_slot);
+    bench_sha256();
+    bench_ecc_sign(ECC_SIGN_SLOT);
+    bench_counter(BENCH_COUNTER);
+    bench_service(key_slot);
+#endif
+
+    atecc_log_drain(SIZE_MAX);
+    atecc_stats_dump();
+
+    const atecc_bus_state_t *bus = atecc_bus_state(I2C_PORT);
+    printf("📊 I2C at %lu kHz: %lu responses, %lu CRC errors, %lu timeouts, %lu downgrades\n",
+           (unsigned long)(bus->rate_hz / 1000), (unsigned long)bus->responses, (unsigned long)bus->crc_errors,
+           (unsigned long)bus->timeouts, (unsigned long)bus->downgrades);
+
     return 0;
 }